@@ -0,0 +1,42 @@
+#include "engine_benchmarks.h"
+
+using namespace tremble;
+
+//------------------------------------------------------------------------------------------------------
+void BenchmarkFrames(UINT num_frames)
+{
+	GameManager* game_manager = GameManager::Create(1000000000);
+	game_manager->Startup("Tremble Benchmarks", 1280, 720, num_frames);
+
+	SGNode* camera = Get::Scene()->AddChild(false, Vector3(0.0f, 0.4f, 0.0f));
+	Get::Renderer()->SetCamera(camera->AddComponent<Camera>());
+
+	if (Get::Config().load_scene == true && Get::Config().scene < Get::ConfigManager()->GetScenes().size())
+	{
+		Get::SceneLoader()->LoadScene(Get::ConfigManager()->GetScenes()[Get::Config().scene]);
+	}
+
+	Light* sun = Get::Scene()->AddChild()->AddComponent<Light>();
+	sun->SetLightType(LightTypeDirectional);
+	sun->SetDirection(Vector3(0.0f, -1.0f, -1.0f));
+	sun->SetColor(Vector4(1.0f, 1.0f, 1.0f));
+
+	// the same lights every run, so runs can be compared
+	uint32_t seed = 12345;
+	for (UINT i = 0; i < Get::Config().num_lights; i++)
+	{
+		seed = seed * 1664525u + 1013904223u;
+		SGNode* node = Get::Scene()->AddChild(false, Vector3(((seed >> 8) % 120) - 60.0f, static_cast<float>((seed >> 16) % 40), ((seed >> 4) % 60) - 30.0f));
+
+		Light* light = node->AddComponent<Light>();
+		light->SetLightType(LightTypePoint);
+		light->SetColor(Vector4(0.5f, 0.5f, 0.5f, 1.0f));
+		light->SetFalloffEnd(Scalar(25.0f));
+	}
+
+	// logs the statistics & stops after the frames
+	game_manager->MainLoop();
+
+	game_manager->ShutDown();
+	GameManager::Delete(game_manager);
+}
\ No newline at end of file
@@ -0,0 +1,7 @@
+#pragma once
+
+/**
+* @brief Starts the engine headless, without the setup dialog & a device, & runs frames of the configured scene through the null render backend
+* @param[in] num_frames The number of frames after which the extraction, recording, physics & audio statistics are logged & the engine stops
+*/
+void BenchmarkFrames(UINT num_frames);
\ No newline at end of file
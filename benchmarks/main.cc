@@ -0,0 +1,34 @@
+#include "rendering_checks.h"
+#include "rendering_benchmarks.h"
+#include "physics_benchmarks.h"
+#include "engine_benchmarks.h"
+
+/**
+* Runs the self checks & micro benchmarks of the engine's plain data structures. None of them need a window, a
+* device or a scene, so they also run on machines without a GPU. Returns the number of checks that failed.
+*
+* With "--frames <count>" the whole engine is benchmarked instead: it starts headless & renders that many frames of
+* the configured scene through the null render backend, which needs a window but no GPU either.
+*/
+int main(int argc, char** argv)
+{
+	if (argc > 2 && std::string(argv[1]) == "--frames")
+	{
+		BenchmarkFrames(static_cast<UINT>(std::max(std::atoi(argv[2]), 1)));
+		return 0;
+	}
+
+	int num_failed = 0;
+	num_failed += CheckSpriteBatcher() == true ? 0 : 1;
+	num_failed += CheckDrawList() == true ? 0 : 1;
+	num_failed += CheckInstanceBatcher(1000) == true ? 0 : 1;
+	num_failed += CheckLightGrid(2000) == true ? 0 : 1;
+
+	BenchmarkDrawList(100000);
+	BenchmarkLightGrid();
+	BenchmarkParticles(100000);
+	BenchmarkLagCompensation(32, 100000);
+
+	DLOG(num_failed << " checks failed");
+	return num_failed;
+}
\ No newline at end of file
@@ -0,0 +1,7 @@
+#pragma once
+
+#pragma message("precompiling benchmarks pch")
+#pragma warning(disable:4099) // disable "no pdf was found with linked library"
+
+#include <iostream>
+#include "tremble/engine_include.h"
\ No newline at end of file
@@ -0,0 +1,55 @@
+#include "physics_benchmarks.h"
+
+using namespace tremble;
+using namespace physx;
+
+//------------------------------------------------------------------------------------------------------
+void BenchmarkLagCompensation(uint32_t num_players, uint32_t num_rays)
+{
+	LagCompensation history;
+	num_players = std::min(num_players, static_cast<uint32_t>(LAG_COMPENSATION_MAX_HITBOXES / 2));
+
+	// the hitboxes have no collider, their poses are stored by hand
+	for (uint32_t i = 0; i < num_players; i++)
+	{
+		history.AddSlot(nullptr, PxVec3(0.25f, 0.3f, 0.25f), i + 1);
+		history.AddSlot(nullptr, PxVec3(0.5f, 0.7f, 0.5f), i + 1);
+	}
+
+	// the players run in circles around a common center, so the rays have something to hit in every tick
+	Stopwatch stopwatch;
+	for (uint32_t tick = 0; tick < LAG_COMPENSATION_HISTORY_SIZE; tick++)
+	{
+		double time = tick / static_cast<double>(LAG_COMPENSATION_HISTORY_SIZE);
+		uint32_t first = history.BeginTick(time);
+
+		for (uint32_t i = 0; i < num_players; i++)
+		{
+			float angle = static_cast<float>(time) * 3.0f + i * (PxTwoPi / num_players);
+			PxVec3 position(cosf(angle) * 10.0f, 1.0f, sinf(angle) * 10.0f);
+			PxQuat rotation(-angle, PxVec3(0.0f, 1.0f, 0.0f));
+
+			history.StorePose(first, i * 2, PxTransform(position + PxVec3(0.0f, 0.5f, 0.0f), rotation));
+			history.StorePose(first, i * 2 + 1, PxTransform(position - PxVec3(0.0f, 0.5f, 0.0f), rotation));
+		}
+	}
+	float record_time = stopwatch.OutputAndReset() * 1000.0f;
+
+	uint32_t num_hits = 0;
+	for (uint32_t i = 0; i < num_rays; i++)
+	{
+		// every ray starts at the center & points at a player, at a view time spread over the whole history
+		float angle = (i % 360) * (PxTwoPi / 360.0f);
+		double view_time = (i % 1000) / 1000.0;
+
+		LagCompensation::Hit hit;
+		if (history.Raycast(Vector3(0.0f, 1.0f, 0.0f), Vector3(cosf(angle), 0.0f, sinf(angle)), 50.0f, view_time, 0, hit) == true)
+		{
+			num_hits++;
+		}
+	}
+	float rewind_time = stopwatch.Output() * 1000.0f;
+
+	DLOG("lag compensation benchmark: " << num_players << " players, recording " << LAG_COMPENSATION_HISTORY_SIZE << " ticks took " << record_time << " ms, "
+		<< num_rays << " rewound rays took " << rewind_time << " ms (" << num_hits << " hits)");
+}
\ No newline at end of file
@@ -0,0 +1,8 @@
+#pragma once
+
+/**
+* @brief Fills a lag compensation history with moving hitboxes & measures recording it & casting rewound rays against it
+* @param[in] num_players The number of players, each with two hitboxes
+* @param[in] num_rays The number of rewound rays cast
+*/
+void BenchmarkLagCompensation(uint32_t num_players, uint32_t num_rays);
\ No newline at end of file
@@ -0,0 +1,110 @@
+#include "rendering_benchmarks.h"
+#include "rendering_checks.h"
+
+using namespace tremble;
+
+//------------------------------------------------------------------------------------------------------
+void BenchmarkDrawList(uint32_t num_draws)
+{
+	DrawList list;
+	std::vector<DrawList::DrawItem> reference;
+	reference.reserve(num_draws);
+
+	// a few pipelines, a few hundred materials & meshes, like a level, at random depths
+	uint32_t seed = 12345;
+	for (uint32_t i = 0; i < num_draws; i++)
+	{
+		seed = seed * 1664525u + 1013904223u;
+		uint64_t key = DrawList::MakeKey(DrawList::PassOpaque, (seed >> 8) % 8, (seed >> 12) % 300, (seed >> 20) % 500, static_cast<float>(seed & 0xFFFF) / 0xFFFF);
+		list.Add(key, i);
+		reference.push_back({ key, i });
+	}
+
+	Stopwatch stopwatch;
+	list.Sort();
+	float radix_time = stopwatch.OutputAndReset() * 1000.0f;
+
+	std::sort(reference.begin(), reference.end(), [](const DrawList::DrawItem& a, const DrawList::DrawItem& b)
+	{
+		return a.key < b.key || (a.key == b.key && a.payload < b.payload);
+	});
+	float std_sort_time = stopwatch.Output() * 1000.0f;
+
+	DLOG("draw sort benchmark: sorting " << num_draws << " draws took " << radix_time << " ms with the radix sort ("
+		<< num_draws / std::max(radix_time, 0.001f) / 1000.0f << " million draws per second) & " << std_sort_time << " ms with std::sort, "
+		<< (list.IsSorted() == true ? "in order" : "NOT in order"));
+}
+
+//------------------------------------------------------------------------------------------------------
+void BenchmarkLightGrid()
+{
+	const uint32_t light_counts[] = { 1000, 5000, 10000 };
+	const uint32_t num_builds = 10;
+
+	for (uint32_t i = 0; i < sizeof(light_counts) / sizeof(light_counts[0]); i++)
+	{
+		LightGrid grid;
+		std::vector<ClusterLight> lights;
+		MakeRandomLights(light_counts[i], grid, lights);
+
+		// the first build touches all cluster slots, the builds after it are what a frame costs
+		grid.Build(lights);
+
+		Stopwatch stopwatch;
+		for (uint32_t b = 0; b < num_builds; b++)
+		{
+			grid.Build(lights);
+		}
+		float build_time = stopwatch.Output() * 1000.0f / num_builds;
+
+		DLOG("light grid benchmark: binning " << light_counts[i] << " lights into " << grid.GetNumClusters() << " clusters took "
+			<< build_time << " ms, " << grid.GetIndices().size() << " cluster entries & " << grid.GetNumDroppedLights() << " dropped");
+	}
+}
+
+//------------------------------------------------------------------------------------------------------
+void BenchmarkParticles(uint32_t count)
+{
+	const uint32_t num_frames = 10;
+	const float delta_time = 1.0f / 60.0f;
+
+	ParticlePool pool;
+	ParticleRandom random;
+
+	// a cloud of smoke in front of the camera, a few of the particles expire every frame so the swap-removes are measured too
+	Stopwatch stopwatch;
+	for (uint32_t i = 0; i < count; i++)
+	{
+		DirectX::XMFLOAT3 position(random.Next() * 20.0f - 10.0f, random.Next() * 20.0f, random.Next() * 20.0f + 5.0f);
+		DirectX::XMFLOAT3 velocity(random.Next() - 0.5f, random.Next() * 2.0f, random.Next() - 0.5f);
+		pool.Spawn(position, velocity, 1.0f + random.Next() * 9.0f, DirectX::XMFLOAT4(0.5f, 0.5f, 0.5f, 0.8f), DirectX::XMFLOAT4(0.2f, 0.2f, 0.2f, 0.0f), 0.5f, 2.0f);
+	}
+	float spawn_time = stopwatch.OutputAndReset() * 1000.0f;
+
+	DirectX::XMMATRIX view = DirectX::XMMatrixLookAtLH(DirectX::XMVectorSet(0.0f, 10.0f, -10.0f, 1.0f), DirectX::XMVectorSet(0.0f, 10.0f, 15.0f, 1.0f), DirectX::XMVectorSet(0.0f, 1.0f, 0.0f, 0.0f));
+	DirectX::XMMATRIX view_projection = DirectX::XMMatrixMultiply(view, DirectX::XMMatrixPerspectiveFovLH(DirectX::XM_PIDIV4, 16.0f / 9.0f, 0.1f, 1000.0f));
+
+	float simulate_time = 0.0f;
+	float write_time = 0.0f;
+	float sort_time = 0.0f;
+
+	for (uint32_t frame = 0; frame < num_frames; frame++)
+	{
+		stopwatch.Reset();
+		pool.Simulate(delta_time);
+		simulate_time += stopwatch.OutputAndReset() * 1000.0f;
+
+		bool transparent = pool.WriteRenderables(DirectX::XMFLOAT3(0.0f, 0.0f, 0.0f));
+		write_time += stopwatch.OutputAndReset() * 1000.0f;
+
+		if (transparent == true)
+		{
+			pool.SortRenderables(view_projection, false);
+		}
+		sort_time += stopwatch.Output() * 1000.0f;
+	}
+
+	DLOG("particle benchmark: spawning " << count << " particles took " << spawn_time << " ms, per frame simulating took " << simulate_time / num_frames
+		<< " ms, writing the renderables " << write_time / num_frames << " ms & sorting them " << sort_time / num_frames << " ms, "
+		<< pool.GetCount() << " particles were left");
+}
\ No newline at end of file
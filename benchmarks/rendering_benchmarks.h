@@ -0,0 +1,15 @@
+#pragma once
+
+/**
+* @brief Measures sorting random keys with the draw list's radix sort & with std::sort
+* @param[in] num_draws The number of draw records sorted
+*/
+void BenchmarkDrawList(uint32_t num_draws);
+
+void BenchmarkLightGrid(); //!< Measures binning 1k, 5k & 10k random lights into the default light grid
+
+/**
+* @brief Fills a particle pool with random transparent particles & measures every stage of a frame
+* @param[in] count The number of particles spawned
+*/
+void BenchmarkParticles(uint32_t count);
\ No newline at end of file
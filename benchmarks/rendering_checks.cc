@@ -0,0 +1,322 @@
+#include "rendering_checks.h"
+
+#define LIGHT_GRID_CHECK_TOLERANCE 1e-3f // sphere/box tests within this fraction of the squared range are on the edge, either outcome is accepted
+
+/**
+* @def CHECK(condition)
+* Logs a condition that doesn't hold & fails the check it's part of, unlike ASSERT it also fails in release builds
+*/
+#define CHECK(condition)                      \
+{                                             \
+	if ((condition) == false)                 \
+	{                                         \
+		DLOG("check failed: " << #condition); \
+		passed = false;                       \
+	}                                         \
+}
+
+using namespace tremble;
+
+//------------------------------------------------------------------------------------------------------
+bool CheckSpriteBatcher()
+{
+	bool passed = true;
+
+	// the batcher only uses the textures as keys & never dereferences them, so the pages of the sample HUD only
+	// have to be distinct addresses, creating real textures would need a device
+	char pages[3];
+	Texture* panels = reinterpret_cast<Texture*>(&pages[0]);
+	Texture* icons = reinterpret_cast<Texture*>(&pages[1]);
+	Texture* font = reinterpret_cast<Texture*>(&pages[2]);
+
+	// the submission index is stored in the uvs, to check that the sprites of a batch keep the order they were added in
+	SpriteBatcher batcher;
+	InterfaceSpriteObjectConstants sprite;
+	auto add = [&](Texture* texture, float layer)
+	{
+		sprite.uv_min.x = static_cast<float>(batcher.GetNumSprites());
+		batcher.Add(sprite, texture, layer);
+	};
+
+	// the health, ammo & score panels behind everything else
+	for (int i = 0; i < 3; i++)
+	{
+		add(panels, 0.0f);
+	}
+
+	// an icon followed by its four digits in every panel, interleaved like the HUD adds them
+	for (int i = 0; i < 3; i++)
+	{
+		add(icons, 1.0f);
+		for (int j = 0; j < 4; j++)
+		{
+			add(font, 1.0f);
+		}
+	}
+
+	// the crosshair on top
+	add(icons, 2.0f);
+
+	batcher.Build();
+
+	// panels, icons & digits of layer 1, crosshair
+	const std::vector<SpriteBatcher::Batch>& batches = batcher.GetBatches();
+	CHECK(batches.size() == 4);
+	if (batches.size() == 4)
+	{
+		CHECK(batches[0].texture == panels && batches[0].count == 3);
+		CHECK(batches[1].texture == icons && batches[1].count == 3);
+		CHECK(batches[2].texture == font && batches[2].count == 12);
+		CHECK(batches[3].texture == icons && batches[3].count == 1);
+	}
+
+	const std::vector<InterfaceSpriteObjectConstants>& instances = batcher.GetInstances();
+	for (size_t i = 0; i < batches.size(); i++)
+	{
+		for (int j = batches[i].offset + 1; j < batches[i].offset + batches[i].count; j++)
+		{
+			CHECK(instances[j - 1].uv_min.x < instances[j].uv_min.x);
+		}
+	}
+
+	DLOG("sprite batcher check: " << batcher.GetNumSprites() << " sprites of the sample HUD were drawn in " << batches.size() << " batches");
+	return passed;
+}
+
+//------------------------------------------------------------------------------------------------------
+bool CheckDrawList()
+{
+	bool passed = true;
+
+	const uint32_t num_pipelines = 2;
+	const uint32_t num_materials = 3;
+	const uint32_t num_meshes = 4;
+	const uint32_t num_repeats = 5;
+	const uint32_t num_draws = num_pipelines * num_materials * num_meshes * num_repeats;
+
+	// the cache compares the state by address only, so plain ids stand in for the real objects
+	uint32_t pipelines[num_pipelines];
+	uint32_t materials[num_materials];
+	uint32_t meshes[num_meshes];
+
+	struct Draw
+	{
+		uint32_t pipeline;
+		uint32_t material;
+		uint32_t mesh;
+	};
+	std::vector<Draw> draws;
+
+	// every repeat draws the whole scene with the order of its draws scrambled & the repeats at different depths
+	DrawList list;
+	for (uint32_t i = 0; i < num_draws; i++)
+	{
+		uint32_t scrambled = (i * 7) % num_draws;
+		Draw draw = { scrambled % num_pipelines, (scrambled / num_pipelines) % num_materials, (scrambled / (num_pipelines * num_materials)) % num_meshes };
+		float depth = static_cast<float>((i * 13) % num_draws) / num_draws;
+
+		list.Add(DrawList::MakeKey(DrawList::PassOpaque, draw.pipeline, draw.material, draw.mesh, depth), static_cast<uint32_t>(draws.size()));
+		draws.push_back(draw);
+	}
+
+	list.Sort();
+	CHECK(list.IsSorted() == true);
+
+	DrawStateCache cache;
+	for (size_t i = 0; i < list.GetSize(); i++)
+	{
+		const Draw& draw = draws[list.GetItems()[i].payload];
+		cache.Apply(DrawStateCache::SlotPipeline, &pipelines[draw.pipeline]);
+		cache.Apply(DrawStateCache::SlotMaterial, &materials[draw.material]);
+		cache.Apply(DrawStateCache::SlotMesh, &meshes[draw.mesh]);
+	}
+
+	// sorted, every pipeline, every material per pipeline & every mesh per material is bound exactly once
+	const unsigned int expected_changes = num_pipelines + num_pipelines * num_materials + num_pipelines * num_materials * num_meshes;
+	CHECK(cache.GetNumChanges() == expected_changes);
+	CHECK(cache.GetNumSkipped() == num_draws * DrawStateCache::SlotCount - expected_changes);
+
+	DLOG("draw list check: " << num_draws << " draws needed " << cache.GetNumChanges() << " state changes, "
+		<< cache.GetNumSkipped() << " redundant binds were skipped");
+	return passed;
+}
+
+//------------------------------------------------------------------------------------------------------
+bool CheckInstanceBatcher(uint32_t num_items)
+{
+	bool passed = true;
+
+	// the batcher compares the mesh & material by address only, so plain ids stand in for the real objects
+	const uint32_t num_meshes = 3;
+	const uint32_t num_materials = 2;
+	uint32_t meshes[num_meshes];
+	uint32_t materials[num_materials];
+
+	// items that all share a mesh & material become a single batch with their instances in order
+	InstanceBatcher batcher;
+	for (uint32_t i = 0; i < num_items; i++)
+	{
+		uint32_t slot = batcher.Add(&meshes[0], &materials[0], 0, i);
+		CHECK(slot == i);
+	}
+	CHECK(batcher.GetBatches().size() == 1 && batcher.GetBatches()[0].num_instances == num_items);
+
+	// a mixed scene in draw list order, near items use LOD 0 & far ones LOD 1, so every mesh, material & LOD is one batch
+	DrawList list;
+	for (uint32_t i = 0; i < num_items; i++)
+	{
+		float depth = static_cast<float>((i * 7) % num_items) / num_items;
+		list.Add(DrawList::MakeKey(DrawList::PassOpaque, 0, i % num_materials, (i / num_materials) % num_meshes, depth), i);
+	}
+	list.Sort();
+
+	batcher.Clear();
+	for (size_t i = 0; i < list.GetSize(); i++)
+	{
+		uint32_t payload = list.GetItems()[i].payload;
+		float depth = static_cast<float>((payload * 7) % num_items) / num_items;
+		batcher.Add(&meshes[(payload / num_materials) % num_meshes], &materials[payload % num_materials], depth < 0.5f ? 0 : 1, payload);
+	}
+
+	size_t num_batches = batcher.GetBatches().size();
+	// with only a few items a mesh might not have items both near & far, so the count is only exact for larger scenes
+	CHECK(num_items < 100 || num_batches == num_meshes * num_materials * 2);
+	CHECK(batcher.GetNumInstances() == num_items);
+
+	DLOG("instance batcher check: " << num_items << " draws of " << num_meshes << " meshes with " << num_materials
+		<< " materials were merged into " << num_batches << " instanced draws");
+	return passed;
+}
+
+//------------------------------------------------------------------------------------------------------
+bool CheckLightGrid(uint32_t num_lights)
+{
+	bool passed = true;
+
+	LightGrid grid;
+	std::vector<ClusterLight> lights;
+	MakeRandomLights(num_lights, grid, lights);
+	grid.Build(lights);
+
+	const std::vector<LightGrid::Range>& ranges = grid.GetRanges();
+	const std::vector<uint32_t>& indices = grid.GetIndices();
+	const DirectX::XMFLOAT4X4& projection = grid.GetProjection();
+	const uint32_t tiles_x = grid.GetNumTilesX();
+	const uint32_t tiles_y = grid.GetNumTilesY();
+
+	uint32_t min_dropped = 0;
+	uint32_t max_dropped = 0;
+	std::vector<bool> in_cluster(lights.size(), false);
+
+	for (uint32_t z = 0; z < grid.GetNumSlices() && passed == true; z++)
+	{
+		const float d0 = grid.GetSliceDepth(z);
+		const float d1 = grid.GetSliceDepth(z + 1);
+
+		for (uint32_t y = 0; y < tiles_y && passed == true; y++)
+		{
+			for (uint32_t x = 0; x < tiles_x && passed == true; x++)
+			{
+				// the view space bounds of the cluster, computed the same way the grid does
+				float ndc_x0 = -1.0f + 2.0f * x / tiles_x;
+				float ndc_x1 = -1.0f + 2.0f * (x + 1) / tiles_x;
+				float ndc_y0 = 1.0f - 2.0f * (y + 1) / tiles_y;
+				float ndc_y1 = 1.0f - 2.0f * y / tiles_y;
+				float min_x = std::min(ndc_x0 * d0, ndc_x0 * d1) / projection._11;
+				float max_x = std::max(ndc_x1 * d0, ndc_x1 * d1) / projection._11;
+				float min_y = std::min(ndc_y0 * d0, ndc_y0 * d1) / projection._22;
+				float max_y = std::max(ndc_y1 * d0, ndc_y1 * d1) / projection._22;
+
+				// every light is in a cluster at most once & the lights of a cluster are in order
+				const LightGrid::Range& range = ranges[grid.GetClusterIndex(x, y, z)];
+				uint32_t num_listed = 0;
+				for (uint32_t i = 0; i < range.count && passed == true; i++)
+				{
+					uint32_t light = indices[range.offset + i];
+					CHECK(light < lights.size() && in_cluster[light] == false && (i == 0 || indices[range.offset + i - 1] < light));
+					if (passed == true)
+					{
+						in_cluster[light] = true;
+						num_listed++;
+					}
+				}
+
+				uint32_t num_required = 0;
+				uint32_t num_optional = 0;
+
+				for (uint32_t l = 0; l < lights.size() && passed == true; l++)
+				{
+					const DirectX::XMFLOAT3& p = lights[l].position_view;
+					float dx = p.x - std::min(std::max(p.x, min_x), max_x);
+					float dy = p.y - std::min(std::max(p.y, min_y), max_y);
+					float dz = p.z - std::min(std::max(p.z, d0), d1);
+					float distance_sq = dx * dx + dy * dy + dz * dz;
+					float range_sq = lights[l].range * lights[l].range;
+					float tolerance = LIGHT_GRID_CHECK_TOLERANCE * range_sq;
+
+					if (distance_sq < range_sq - tolerance)
+					{
+						num_required++;
+						// a full cluster stops at the limit, so only a cluster with room has to hold every overlapping light
+						CHECK(in_cluster[l] == true || range.count == LIGHT_GRID_MAX_LIGHTS_PER_CLUSTER);
+					}
+					else if (distance_sq <= range_sq + tolerance)
+					{
+						num_optional++;
+					}
+					else
+					{
+						CHECK(in_cluster[l] == false);
+					}
+				}
+
+				for (uint32_t i = 0; i < num_listed; i++)
+				{
+					in_cluster[indices[range.offset + i]] = false;
+				}
+
+				min_dropped += num_required > LIGHT_GRID_MAX_LIGHTS_PER_CLUSTER ? num_required - LIGHT_GRID_MAX_LIGHTS_PER_CLUSTER : 0;
+				max_dropped += num_required + num_optional > LIGHT_GRID_MAX_LIGHTS_PER_CLUSTER ? num_required + num_optional - LIGHT_GRID_MAX_LIGHTS_PER_CLUSTER : 0;
+			}
+		}
+	}
+
+	if (passed == true)
+	{
+		CHECK(grid.GetNumDroppedLights() >= min_dropped && grid.GetNumDroppedLights() <= max_dropped);
+	}
+
+	DLOG("light grid check: " << num_lights << " lights were binned into " << indices.size() << " cluster entries, "
+		<< grid.GetNumDroppedLights() << " didn't fit, " << (passed == true ? "matching" : "NOT matching") << " the brute force test");
+	return passed;
+}
+
+//------------------------------------------------------------------------------------------------------
+void MakeRandomLights(uint32_t num_lights, LightGrid& grid, std::vector<ClusterLight>& lights)
+{
+	const float near_z = 0.1f;
+	const float far_z = 1000.0f;
+	const float aspect = 16.0f / 9.0f;
+
+	DirectX::XMFLOAT4X4 projection;
+	DirectX::XMStoreFloat4x4(&projection, DirectX::XMMatrixPerspectiveFovLH(DirectX::XM_PIDIV4, aspect, near_z, far_z));
+	grid.Configure(LIGHT_GRID_TILES_X, LIGHT_GRID_TILES_Y, LIGHT_GRID_SLICES, projection, near_z, far_z);
+
+	// most lights are close to the camera, like in a level, some of them reach just outside of the frustum
+	uint32_t seed = 12345;
+	auto random = [&seed]()
+	{
+		seed = seed * 1664525u + 1013904223u;
+		return static_cast<float>(seed >> 8) / static_cast<float>(1 << 24);
+	};
+
+	lights.resize(num_lights);
+	for (uint32_t i = 0; i < num_lights; i++)
+	{
+		float depth = 1.0f + 299.0f * random() * random();
+		lights[i].position_view.x = (random() * 2.0f - 1.0f) * depth * aspect / projection._22;
+		lights[i].position_view.y = (random() * 2.0f - 1.0f) * depth / projection._22;
+		lights[i].position_view.z = depth;
+		lights[i].range = 1.0f + 9.0f * random();
+	}
+}
\ No newline at end of file
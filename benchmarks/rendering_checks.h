@@ -0,0 +1,35 @@
+#pragma once
+
+/**
+* @brief Batches a sample HUD & checks the number of batches & the order of the sprites in them
+* @return Whether the sample HUD was batched as expected
+*/
+bool CheckSpriteBatcher();
+
+/**
+* @brief Sorts a synthetic scene of shuffled draws & checks the order & the number of state changes a DrawStateCache lets through
+* @return Whether every pipeline, material & mesh was bound exactly once
+*/
+bool CheckDrawList();
+
+/**
+* @brief Batches synthetic scenes of repeated meshes & checks how many draw calls are left
+* @param[in] num_items The number of draws of every scene
+* @return Whether the scenes were merged into the expected batches
+*/
+bool CheckInstanceBatcher(uint32_t num_items);
+
+/**
+* @brief Bins random lights into a grid & checks the result against a brute force sphere/box test of every light against every cluster
+* @param[in] num_lights The number of lights
+* @return Whether every cluster holds exactly the lights that overlap it, up to the cluster limit, & the dropped count matches
+*/
+bool CheckLightGrid(uint32_t num_lights);
+
+/**
+* @brief Configures a grid like the renderer does & fills it with random lights spread through the frustum
+* @param[in] num_lights The number of lights
+* @param[out] grid The grid to configure
+* @param[out] lights The random lights
+*/
+void MakeRandomLights(uint32_t num_lights, tremble::LightGrid& grid, std::vector<tremble::ClusterLight>& lights);
\ No newline at end of file
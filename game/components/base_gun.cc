@@ -234,6 +234,9 @@ namespace tremble
     }
     void BaseGun::Update()
     {
+        //the bullets fired last frame hit before anything else happens, even if the gun was switched since
+        ProcessShots();
+
         if (enabled == true)
         {
             //Set all text of hud elements
@@ -339,6 +342,14 @@ namespace tremble
             //add recoil to the gun offset
             current_recoil_offset_ -= recoil_;
 
+            //the shapes of the player holding this gun
+            SGNode* shooter_node = GetNode()->GetParent()->GetParent();
+            QueryOwner shooter_owner = shooter_node->FindComponent<Player>()->query_owner_;
+
+            //the shooter saw the other players where they were a latency ago, so the hitboxes are rewound to that time
+            LagCompensation* lag_compensation = Get::LagCompensation();
+            double view_time = lag_compensation->GetViewTime(Get::NetworkManager()->GetLatency(shooter_node->GetAssociatedPeer()));
+
             //spray bullets
             for (int i = 0; i < spray_amount_; i++)
             {
@@ -346,84 +357,81 @@ namespace tremble
                 Vector3 direction = (camera_node_->GetForwardVectorWorld() + Vector3(RandomRange(-spread_amount_, spread_amount_), RandomRange(-spread_amount_, spread_amount_), RandomRange(-spread_amount_, spread_amount_))).Normalize();
 
 
-                //buffer which stores all the data for the raycast
-                physx::PxRaycastBuffer raycast_buffer;
-
-
                 Vector3 orgin_for_ray_ = camera_node_->GetPosition();
 
-                //ignored raycast layer
-                std::vector<Component*> raycast_ignore;
-
-                std::vector<CharacterController*> all_characters = camera_node_->GetParent()->FindAllComponents<CharacterController>();
-                for each(CharacterController* character in all_characters)
+                //test the ray in front + spread offset of the character against the rewound hitboxes, skipping the shooter's own
+                PendingShot shot;
+                LagCompensation::Hit hitbox_hit;
+                float world_distance = bullet_travel_distance_;
+                shot.hitbox = nullptr;
+                if (lag_compensation->Raycast(orgin_for_ray_, direction, bullet_travel_distance_, view_time, shooter_owner, hitbox_hit))
                 {
-                    raycast_ignore.push_back(character);
+                    shot.hitbox = hitbox_hit.collider;
+                    world_distance = hitbox_hit.distance;
                 }
 
-                std::vector<TriggerCollider*>all_trigggers_ = Get::Scene()->FindAllComponents<TriggerCollider>();
+                //the level can still be in the way, all pellets are cast together after the update
+                //bullets pass through character capsules & plain triggers
+                shot.world_query = Get::PhysicsManager()->GetSceneQueries()->QueueRaycast(orgin_for_ray_, direction, world_distance, MASK_WORLD);
+                pending_shots_.push_back(shot);
+            }
+        }
+    }
 
-                for each (TriggerCollider* trigger in all_trigggers_)
-                {
-                    //GetNode()->GetParent()->FindComponent<Player>()->player_head_hitbox_;
-                    if (trigger == GetNode()->GetParent()->GetParent()->FindComponent<Player>()->player_head_hitbox_)
-                    {
-                        raycast_ignore.push_back(trigger);
-                        continue;
-                    }
+    void BaseGun::ProcessShots()
+    {
+        SceneQueryBatch* scene_queries = Get::PhysicsManager()->GetSceneQueries();
 
-                    if (trigger == GetNode()->GetParent()->GetParent()->FindComponent<Player>()->player_body_hitbox_)
-                    {
-                        raycast_ignore.push_back(trigger);
-                        continue;
-                    }
-                }
+        for each (const PendingShot& shot in pending_shots_)
+        {
+            if (scene_queries->IsReady(shot.world_query) == false)
+            {
+                continue;
+            }
 
-                //raycasting in front + spread offset of the character
-                if (Get::PhysicsManager()->Raycast(&raycast_buffer, orgin_for_ray_, direction, bullet_travel_distance_, &raycast_ignore))
-                {
+            const SceneQueryResult& result = scene_queries->GetResult(shot.world_query);
 
-                    //Returns a component that was hit by the raycast
-                    Component* component = Get::PhysicsManager()->GetComponentFromRaycast(&raycast_buffer);
+            //Returns a component that was hit by the raycast
+            Component* component = result.component;
 
+            //nothing in the level was in front of the hitbox
+            if (result.hit == false && shot.hitbox != nullptr)
+            {
+                TriggerCollider* trigger_collider_ = shot.hitbox;
 
-                    if (component != nullptr)
-                    {
-                        if (component->GetType() == typeid(TriggerCollider))
-                        {
-                            TriggerCollider* trigger_collider_ = static_cast<TriggerCollider*>(component);
-
-                            if (trigger_collider_->tag == "Head")
-                            {
-                                DLOG("HIT THEM IN THE HEAD");
-                                component->GetNode()->GetParent()->FindComponent<Player>()->OnDamage(damage_ * 2);
-                            }
-                            else if (trigger_collider_->tag == "Body")
-                            {
-                                DLOG("HIT THEM IN THE BODY");
-                                component->GetNode()->GetParent()->FindComponent<Player>()->OnDamage(damage_);
-                            }
-                        }
+                if (trigger_collider_->tag == "Head")
+                {
+                    DLOG("HIT THEM IN THE HEAD");
+                    trigger_collider_->GetNode()->GetParent()->FindComponent<Player>()->OnDamage(damage_ * 2);
+                }
+                else if (trigger_collider_->tag == "Body")
+                {
+                    DLOG("HIT THEM IN THE BODY");
+                    trigger_collider_->GetNode()->GetParent()->FindComponent<Player>()->OnDamage(damage_);
+                }
+            }
 
-                        if (component->GetType() == typeid(RigidbodyStatic))
-                        {
-                            //data to spawn a single particle 
-                            ParticleDescription p;
-                            p.lifetime = 30;
-                            p.size = 0.15f;
-                            p.sizeEnd = p.size;
-                            p.color = { 1, 1, 1, 1 };
-                            p.colorEnd = { 1, 1, 1, 0 };
-                            p.velocity = { 0, 0, 0 };
-                            //set the position of the particl on the position of the raycast hit
-                            p.position = raycast_buffer.block.position + raycast_buffer.block.normal*p.size / 2;
-                            BaseGun::bullet_hole_->Spawn(p);
-                            bullet_holes_.push_back(p.position);
-                        }
-                    }
+            if (result.hit == true && component != nullptr)
+            {
+                if (component->GetType() == typeid(RigidbodyStatic))
+                {
+                    //data to spawn a single particle 
+                    ParticleDescription p;
+                    p.lifetime = 30;
+                    p.size = 0.15f;
+                    p.sizeEnd = p.size;
+                    p.color = { 1, 1, 1, 1 };
+                    p.colorEnd = { 1, 1, 1, 0 };
+                    p.velocity = { 0, 0, 0 };
+                    //set the position of the particl on the position of the raycast hit
+                    p.position = result.position + result.normal*p.size / 2;
+                    BaseGun::bullet_hole_->Spawn(p);
+                    bullet_holes_.push_back(p.position);
                 }
             }
         }
+
+        pending_shots_.clear();
     }
 
     void BaseGun::Reloading()
@@ -80,6 +80,8 @@ namespace tremble
 
         void BaseGun::Shooting(bool soundLoop);
 
+        void BaseGun::ProcessShots();
+
         void BaseGun::Reloading();
 
         void BaseGun::FireRate();
@@ -96,6 +98,14 @@ namespace tremble
 
         //bullet holes, stacked before serialization
         std::vector<Vector3> bullet_holes_;
+
+        //a bullet fired last frame, processed once the physics manager executed its raycast
+        struct PendingShot
+        {
+            SceneQueryHandle world_query; //raycast against the level, up to the hitbox if one was hit
+            TriggerCollider* hitbox; //hitbox the rewound ray hit, nullptr if none
+        };
+        std::vector<PendingShot> pending_shots_;
         //AudioClip* laser_end_clip_;
     };
 }
\ No newline at end of file
@@ -155,18 +155,10 @@ namespace tremble
 
         Vector3 ShootHookRaycast()
         {
-            std::vector<Component*> raycast_ignore;
-            raycast_ignore.push_back(camera_node_->GetParent()->FindComponentInChildren<CharacterController>());
-
-            for (int i = 0; i < GetNode()->FindAllComponents<TriggerCollider>().size(); i++)
-            {
-                raycast_ignore.push_back(GetNode()->FindAllComponents<TriggerCollider>()[i]);
-            }
-
             Vector3 direction = camera_node_->GetForwardVectorWorld().Normalize();
             physx::PxRaycastBuffer raycast_buffer;
 
-            if (Get::PhysicsManager()->Raycast(&raycast_buffer, camera_node_->GetPosition() + direction * 0.8f, direction, grapple_distance, &raycast_ignore))
+            if (Get::PhysicsManager()->Raycast(&raycast_buffer, camera_node_->GetPosition() + direction * 0.8f, direction, grapple_distance, MASK_SOLID, player->query_owner_))
             {
                 Component* component = Get::PhysicsManager()->GetComponentFromRaycast(&raycast_buffer);
 
@@ -59,6 +59,18 @@ namespace tremble
         player_body_hitbox_ = player_hitbox_body_node->AddComponent<TriggerCollider>(&PhysicsBoxGeometry(Vector3(0.5f, 0.7f, 0.5f)));
         player_body_hitbox_->tag = "Body";
 
+        query_owner_ = Get::PhysicsManager()->CreateQueryOwner();
+        player_head_hitbox_->SetCollisionLayer(LAYER_HITBOX, query_owner_);
+        player_body_hitbox_->SetCollisionLayer(LAYER_HITBOX, query_owner_);
+        if (character_controller_ != nullptr)
+        {
+            character_controller_->SetCollisionLayer(LAYER_CHARACTER, query_owner_);
+        }
+
+        //the host rewinds the hitboxes to where a shooter saw them
+        Get::LagCompensation()->AddHitbox(player_head_hitbox_, query_owner_);
+        Get::LagCompensation()->AddHitbox(player_body_hitbox_, query_owner_);
+
 
         //Adds a gun to the camera
         gun_node_ = camera_node_->AddChild(false, camera_node_->GetPosition(), camera_node_->GetRotationRadians(), Vector3(1, 1, 1));
@@ -72,6 +72,8 @@ namespace tremble
         static std::vector<SGNode*> spawnpoints;
 
         bool other_player_ = false;
+
+        QueryOwner query_owner_; //!< Marks the character controller & hitboxes of this player, so its own shots & hooks skip them
     private:
         Scalar camera_pitch_ = -70;
 
@@ -13,7 +13,9 @@ namespace tremble
 		volume = 1.0f;
 		pitch = 1.0f;
 		pan = 0.0f;
-		original_frequency = 0.0f;
+		priority = VOICE_DEFAULT_PRIORITY;
+		voice = 0;
+		saved_clip = nullptr;
 
 		mode = FMOD_LOOP_OFF;
 	}
@@ -21,7 +23,13 @@ namespace tremble
 	//------------------------------------------------------------------------------------------------------
 	void AudioSource::Awake()
 	{
-		channel_ID = Get::AudioManager()->AddAudioSource(this);
+		Get::AudioManager()->AddAudioSource(this);
+	}
+
+	//------------------------------------------------------------------------------------------------------
+	void AudioSource::Shutdown()
+	{
+		Get::AudioManager()->GetVoiceManager()->Release(voice, this);
 	}
 	
 	//------------------------------------------------------------------------------------------------------
@@ -33,29 +41,33 @@ namespace tremble
 	//------------------------------------------------------------------------------------------------------
 	void AudioSource::Set3DSettings(float min, float max)
 	{
-		FMOD_RESULT result = saved_clip->sound->set3DMinMaxDistance(min, max);
-		Get::AudioManager()->ErrorCheck(result);
+		saved_clip->Set3DMinMaxDistance(min, max);
 	}
 
 	//------------------------------------------------------------------------------------------------------
 	FMOD::Channel* AudioSource::GetChannel()
 	{
-		FMOD::Channel* chan;
-		Get::AudioManager()->GetSystem()->getChannel(channel_ID, &chan);
-		return chan;
+		return Get::AudioManager()->GetVoiceManager()->GetChannel(voice);
 	}
 
 	//------------------------------------------------------------------------------------------------------
-	void AudioSource::SetChannelAtrributes()
+	bool AudioSource::IsPlaying() const
 	{
-		if(original_frequency <= 0)
-		{
-			channel->getFrequency(&original_frequency);
-		}
-		channel->setVolume(volume * max_volume_multiplier);
-		channel->setPan(pan);
-		channel->setMode(mode);
-		channel->setFrequency(original_frequency * pitch);
+		return Get::AudioManager()->GetVoiceManager()->IsPlaying(voice);
+	}
+
+	//------------------------------------------------------------------------------------------------------
+	VoiceRequest AudioSource::CreateVoiceRequest()
+	{
+		VoiceRequest request;
+		request.clip = saved_clip;
+		request.owner = this;
+		request.priority = priority;
+		request.volume = volume * max_volume_multiplier;
+		request.pitch = pitch;
+		request.pan = pan;
+		request.mode = mode;
+		return request;
 	}
 
 	//------------------------------------------------------------------------------------------------------
@@ -63,48 +75,36 @@ namespace tremble
 	{
         if (saved_clip != nullptr)
         {
-            FMOD::Channel* temp_channel = GetChannel();
-            FMOD_RESULT result = Get::AudioManager()->GetSystem()->playSound(static_cast<FMOD_CHANNELINDEX>(channel_ID), saved_clip->sound, true, &channel);
-            Get::AudioManager()->ErrorCheck(result);
-            SetChannelAtrributes();
-            channel->setPaused(false);
-
-            Get::AudioManager()->ErrorCheck(result);
+            // playing again restarts the sound, like a channel of its own would
+            VoiceManager* voice_manager = Get::AudioManager()->GetVoiceManager();
+            voice_manager->Stop(voice, this);
+            voice = voice_manager->Play(CreateVoiceRequest());
         }
 	}
 
 	//------------------------------------------------------------------------------------------------------
 	void AudioSource::TogglePaused(bool paused)
 	{
-		GetChannel()->setPaused(paused);
+		Get::AudioManager()->GetVoiceManager()->SetPaused(voice, paused);
 	}
 
 	//------------------------------------------------------------------------------------------------------
 	void AudioSource::Enable3DAudio(Vector3 position, Vector3 velocity)
 	{
-		FMOD_RESULT result = channel->set3DPanLevel(1.0f);
-		Get::AudioManager()->ErrorCheck(result);
-
-		FMOD_VECTOR pos = Get::AudioManager()->Vector3toFMODVector(position);
-		FMOD_VECTOR vel = Get::AudioManager()->Vector3toFMODVector(velocity);
-
-		result = channel->set3DAttributes(&pos, 0);
-		Get::AudioManager()->ErrorCheck(result);
+		Get::AudioManager()->GetVoiceManager()->SetPosition(voice, position);
 	}
 	//------------------------------------------------------------------------------------------------------
 	void AudioSource::SetAudioPosition(int time_in_seconds)
 	{
-		int timeMS = time_in_seconds * 1000;
 		//int loopendMS = loop_end * 1000;
 		//saved_clip->sound->setLoopPoints(loopstartMS, FMOD_TIMEUNIT_MS, loopendMS, FMOD_TIMEUNIT_MS);
-		FMOD_RESULT result = channel->setPosition(timeMS, FMOD_TIMEUNIT_MS);
-		Get::AudioManager()->ErrorCheck(result);
+		Get::AudioManager()->GetVoiceManager()->SetTime(voice, static_cast<float>(time_in_seconds));
 	}
 
 	//------------------------------------------------------------------------------------------------------
 	void AudioSource::Stop()
 	{
-		GetChannel()->stop();
+		Get::AudioManager()->GetVoiceManager()->Stop(voice, this);
 	}
 
 	//------------------------------------------------------------------------------------------------------
@@ -112,13 +112,7 @@ namespace tremble
 	{
 		if (saved_clip != nullptr && !IsPlaying())
 		{
-			FMOD::Channel* temp_channel = GetChannel();
-			FMOD_RESULT result = Get::AudioManager()->GetSystem()->playSound(static_cast<FMOD_CHANNELINDEX>(channel_ID), saved_clip->sound, true, &channel);
-			Get::AudioManager()->ErrorCheck(result);
-			SetChannelAtrributes();
-			channel->setPaused(false);
-
-			Get::AudioManager()->ErrorCheck(result);
+			voice = Get::AudioManager()->GetVoiceManager()->Play(CreateVoiceRequest());
 		}
 	}
 }
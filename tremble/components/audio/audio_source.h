@@ -1,5 +1,6 @@
 #pragma once
 #include "core/scene_graph/component.h"
+#include "core/audio/voice_manager.h"
 #include <fmod.hpp>
 
 namespace tremble
@@ -8,6 +9,9 @@ namespace tremble
 
 	/**
 	* @brief A class that contains the audio source component and functionality
+	*
+	* Sources don't own a channel, playing requests a voice from the voice manager, which follows the source's node
+	* & only gets a real channel while it's important & audible enough.
 	* @class tremble::AudioSource
 	* @author Max Blom
 	*/
@@ -16,6 +20,7 @@ namespace tremble
 	public:
 		AudioSource();
 		void Awake();
+		void Shutdown() override; //!< Stops a looping voice, a one-shot plays on at the last position of the source
 		void Play();
 		void TogglePaused(bool paused);
 
@@ -54,14 +59,16 @@ namespace tremble
 		void SetPitch(float set_pitch) { pitch = set_pitch; }
 		void SetPanning(float set_pan) { pan = set_pan; }
 		void SetMode(FMOD_MODE set_mode) { mode = set_mode; }
+		void SetPriority(int set_priority) { priority = set_priority; } //!< Sets the priority of the voices this source plays, lower values are more important
 
 		AudioClip* GetAudioClip() const { return saved_clip; }
-		float GetVolume() const { float vol; channel->getVolume(&vol); return vol; }
+		float GetVolume() const { return volume * max_volume_multiplier; }
 		float GetPitch() const { return pitch; }
 		float GetPanning() const { return pan; }
 		FMOD_MODE GetMode() const { return mode; }
-		bool IsPlaying() const { bool playing; channel->isPlaying(&playing); return playing; }
-		FMOD::Channel* GetChannel();
+		int GetPriority() const { return priority; }
+		bool IsPlaying() const; //!< Whether the voice of this source is still playing, also when it's virtual
+		FMOD::Channel* GetChannel(); //!< The channel the voice of this source plays on, nullptr if it's virtual or stopped
 
 	private:
 		AudioClip* saved_clip;//!< the audioClip associated with this audioSource
@@ -70,14 +77,13 @@ namespace tremble
 		float pitch;//!< pitch of the clip
 		float pan;//!< pan of the audio
 
-		float original_frequency;//!< original frequency of the track. Remains unchanged
+		int priority;//!< priority of the voices, lower values are more important
 
-		FMOD::Channel *channel;//!< Channel attached to this track
-		int channel_ID;//!< ID of the channel 
+		VoiceHandle voice;//!< The voice this source played last
 
 		FMOD_MODE mode;//!< mode of the channel
 
-		void SetChannelAtrributes();//!< Used to set the values of the above variables on the trakc whne it is paused.
+		VoiceRequest CreateVoiceRequest();//!< Used to request a voice with the values of the above variables
 
 		float max_volume_multiplier;//!< Used to hold the value of the config windows slider thingy
 	};
@@ -30,6 +30,7 @@ namespace tremble
 		{
 			px_controller_ = manager->px_controller_manager_->createController(desc);
             px_controller_->getActor()->userData = ((Component*)this);
+            PhysicsManager::SetCollisionLayer(px_controller_->getActor(), LAYER_CHARACTER);
 		}
 	}
 
@@ -111,6 +112,12 @@ namespace tremble
 		is_controllable_ = !is_frozen;
 	}
 
+	//------------------------------------------------------------------------------------------------------
+	void CharacterController::SetCollisionLayer(CollisionLayer layer, QueryOwner owner)
+	{
+		PhysicsManager::SetCollisionLayer(px_controller_->getActor(), layer, owner);
+	}
+
 	//------------------------------------------------------------------------------------------------------
 	void CharacterController::ZeroVelocities()
 	{
@@ -25,6 +25,7 @@ namespace tremble
 		void SetFreezePosition(bool is_frozen);
 		void ZeroVelocities();
 		float GetGravity() { return gravity_; }//!< returns the gravity
+		void SetCollisionLayer(CollisionLayer layer, QueryOwner owner = 0); //!< Put the capsule on a collision layer, characters start on LAYER_CHARACTER
 	private:
 		bool is_on_ground_; //!< Is the character standing on the ground?
 		bool is_controllable_;//!< can you control the player? (aka move him)
@@ -2,6 +2,7 @@
 #include "../../core/scene_graph/scene_graph.h"
 #include "../../core/physics/physics_manager.h"
 #include "../../core/physics/physics_material.h"
+#include "../../core/utilities/debug.h"
 
 namespace tremble
 {
@@ -10,6 +11,13 @@ namespace tremble
     //------------------------------------------------------------------------------------------------------
 	PhysicsMaterial* Rigidbody::GetMaterial()
 	{
+		// merged static rigidbodies have no actor of their own, their triangles are part of a shared chunk
+		ASSERT(GetPxRigidbodyActor() != nullptr);
+		if (GetPxRigidbodyActor() == nullptr)
+		{
+			return nullptr;
+		}
+
 		PxShape* px_shape;
 		PxMaterial* px_material;
 		GetPxRigidbodyActor()->getShapes(&px_shape, sizeof(PxShape*));
@@ -20,6 +28,12 @@ namespace tremble
     //------------------------------------------------------------------------------------------------------
 	PhysicsGeometryHolder Rigidbody::GetGeometry()
 	{
+		ASSERT(GetPxRigidbodyActor() != nullptr);
+		if (GetPxRigidbodyActor() == nullptr)
+		{
+			return PhysicsGeometryHolder();
+		}
+
 		PxShape* shape;
         GetPxRigidbodyActor()->getShapes(&shape, sizeof(PxShape*));
 		PxGeometryHolder px_geometry_holder = shape->getGeometry();
@@ -29,6 +43,12 @@ namespace tremble
     //------------------------------------------------------------------------------------------------------
 	void Rigidbody::SetMaterial(PhysicsMaterial* physics_material)
 	{
+		ASSERT(GetPxRigidbodyActor() != nullptr);
+		if (GetPxRigidbodyActor() == nullptr)
+		{
+			return;
+		}
+
 		PxShape* shape;
         GetPxRigidbodyActor()->getShapes(&shape, sizeof(PxShape*));
 		PxMaterial* px_material = physics_material->GetPxMaterial();
@@ -38,11 +58,29 @@ namespace tremble
     //------------------------------------------------------------------------------------------------------
 	void Rigidbody::SetGeometry(PhysicsGeometry* physics_geometry)
 	{
+		ASSERT(GetPxRigidbodyActor() != nullptr);
+		if (GetPxRigidbodyActor() == nullptr)
+		{
+			return;
+		}
+
 		PxShape* shape;
         GetPxRigidbodyActor()->getShapes(&shape, sizeof(PxShape*));
 		shape->setGeometry(*physics_geometry->GetPxGeometry());
 	}
 
+    //------------------------------------------------------------------------------------------------------
+	void Rigidbody::SetCollisionLayer(CollisionLayer layer, QueryOwner owner)
+	{
+		ASSERT(GetPxRigidbodyActor() != nullptr);
+		if (GetPxRigidbodyActor() == nullptr)
+		{
+			return;
+		}
+
+		PhysicsManager::SetCollisionLayer(GetPxRigidbodyActor(), layer, owner);
+	}
+
     //------------------------------------------------------------------------------------------------------
 	void Rigidbody::Shutdown()
 	{
@@ -59,7 +97,7 @@ namespace tremble
     }
 
     //------------------------------------------------------------------------------------------------------
-    void Rigidbody::AttachScaledShape(PhysicsGeometry* geometry, PhysicsMaterial* material, PhysicsGeometry::ScalingType scaling_type)
+    void Rigidbody::AttachScaledShape(PhysicsGeometry* geometry, PhysicsMaterial* material, PhysicsGeometry::ScalingType scaling_type, CollisionLayer layer)
     {
         PhysicsGeometry* scaled = geometry->CreateCopyForScaled();
         if (material == nullptr)
@@ -78,7 +116,7 @@ namespace tremble
             scaled->Scale(GetNode()->GetParent()->GetScale());
             break;
         }
-        physx::PxShape* px_shape = Get::PhysicsManager()->CreatePxShape(scaled, material);
+        physx::PxShape* px_shape = Get::PhysicsManager()->CreatePxShape(scaled, material, true, layer);
         AttachShape(px_shape);
         px_shape->release();
     }
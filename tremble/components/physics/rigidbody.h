@@ -5,6 +5,7 @@
 #include "../../core/scene_graph/component_manager.h"
 #include "../../core/physics/physics_geometry.h"
 #include "../../core/physics/physics_geometry_holder.h"
+#include "../../core/physics/physics_layers.h"
 #include "../../core/get.h"
 
 namespace tremble
@@ -15,11 +16,12 @@ namespace tremble
 	{
 	protected:
 	public:
-		PhysicsMaterial* GetMaterial();
-		PhysicsGeometryHolder GetGeometry();
+		PhysicsMaterial* GetMaterial(); //!< The material of the first shape, nullptr for merged static rigidbodies
+		PhysicsGeometryHolder GetGeometry(); //!< The geometry of the first shape, empty for merged static rigidbodies
 
-		void SetMaterial(PhysicsMaterial* physics_material);
-		void SetGeometry(PhysicsGeometry* physics_geometry);
+		void SetMaterial(PhysicsMaterial* physics_material); //!< Sets the material of the first shape, merged static rigidbodies can't be changed
+		void SetGeometry(PhysicsGeometry* physics_geometry); //!< Sets the geometry of the first shape, merged static rigidbodies can't be changed
+		void SetCollisionLayer(CollisionLayer layer, QueryOwner owner = 0); //!< Put all shapes of this rigidbody on a collision layer, merged static rigidbodies stay on the static layer
 
 		void Shutdown() override;
 		virtual physx::PxRigidActor* GetPxRigidbodyActor() = 0;
@@ -38,7 +40,7 @@ namespace tremble
         }
 	protected:
 
-        void AttachScaledShape(PhysicsGeometry* geometry, PhysicsMaterial* material, PhysicsGeometry::ScalingType scaling_type);
+        void AttachScaledShape(PhysicsGeometry* geometry, PhysicsMaterial* material, PhysicsGeometry::ScalingType scaling_type, CollisionLayer layer);
         virtual void AttachShape(physx::PxShape* px_shape) = 0;
 
         std::vector<std::function<void(const CollisionData&)>> collision_callbacks_; //!< Collision callback functions
@@ -16,7 +16,7 @@ namespace tremble
     void RigidbodyDynamic::Awake(PhysicsGeometry* geometry, PhysicsMaterial* material, PhysicsGeometry::ScalingType scaling_type)
     {
         InitRigidbodyDynamic();
-        AttachScaledShape(geometry, material, scaling_type);
+        AttachScaledShape(geometry, material, scaling_type, LAYER_DYNAMIC);
         PxRigidBodyExt::updateMassAndInertia(*px_rigid_dynamic_, 10.0f);
         Get::PhysicsManager()->AddPxActor(px_rigid_dynamic_, this);
     }
@@ -27,7 +27,7 @@ namespace tremble
         for (int i = 0; i < model->GetMeshes().size(); ++i)
         {
             PhysicsGeometry* geometry = model->GetMeshes()[i]->GetPhysicsTriangleMeshGeometry();
-            AttachScaledShape(geometry, material, scaling_type);
+            AttachScaledShape(geometry, material, scaling_type, LAYER_DYNAMIC);
         }
         PxRigidBodyExt::updateMassAndInertia(*px_rigid_dynamic_, 10.0f);
         Get::PhysicsManager()->AddPxActor(px_rigid_dynamic_, this);
@@ -52,20 +52,16 @@ namespace tremble
         }
 	}
 
-    void RigidbodyDynamic::UpdateAfterPhysics()
+    void RigidbodyDynamic::SetPoseFromPhysics_(const PxTransform& pose)
     {
-        if (!px_rigid_dynamic_->isSleeping())
-        {
-            PxTransform get_transform(px_rigid_dynamic_->getGlobalPose());
-            GetNode()->SetPositionForPhysics_(Vector3(
-                get_transform.p.x,
-                get_transform.p.y,
-                get_transform.p.z
-            ));
-            GetNode()->SetRotationQuaternionForPhysics_(
-                Quaternion(get_transform.q)
-            );
-        }
+        GetNode()->SetPositionForPhysics_(Vector3(
+            pose.p.x,
+            pose.p.y,
+            pose.p.z
+        ));
+        GetNode()->SetRotationQuaternionForPhysics_(
+            Quaternion(pose.q)
+        );
     }
 
 	void RigidbodyDynamic::AddImpulseAtPos(Vector3 force, Vector3 world_pos)
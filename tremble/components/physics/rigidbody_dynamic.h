@@ -12,7 +12,13 @@ namespace tremble
 		void Awake(PhysicsGeometry* geometry, PhysicsMaterial* = nullptr, PhysicsGeometry::ScalingType scaling_type = PhysicsGeometry::ScalingType::RELATIVE_TO_NODE);
 		void Awake(tremble::Model* model, PhysicsMaterial* = nullptr, PhysicsGeometry::ScalingType scaling_type = PhysicsGeometry::ScalingType::RELATIVE_TO_NODE);
 	    void UpdateBeforePhysics();
-		void UpdateAfterPhysics();
+
+		/**
+		* @brief Moves the node to the pose PhysX moved the body to, only called by the physics manager for bodies that moved during the step
+		* @param[in] pose The new world pose of the body
+		*/
+		void SetPoseFromPhysics_(const physx::PxTransform& pose);
+
 		void AddImpulseAtPos(Vector3 force, Vector3 world_pos);
 		void AddLocalImpulseAtLocalPos(Vector3 force, Vector3 local_pos);
 		void SetMass(float mass);
@@ -5,6 +5,7 @@
 #include "../../core/physics/physics_manager.h"
 #include "../../core/physics/physics_material.h"
 #include "../../core/physics/physics_triangle_mesh_geometry.h"
+#include "../../core/physics/static_geometry_merger.h"
 #include "../../core/resources/model.h"
 #include "../../core/resources/mesh.h"
 
@@ -22,22 +23,41 @@ namespace tremble
     void RigidbodyStatic::Awake(PhysicsGeometry* geometry, PhysicsMaterial* material, PhysicsGeometry::ScalingType scaling_type)
     {
         InitRigidbodyStatic();
-        AttachScaledShape(geometry, material, scaling_type);
+        AttachScaledShape(geometry, material, scaling_type, LAYER_STATIC);
         Get::PhysicsManager()->AddPxActor(px_rigid_static_, this);
     }
 
     //------------------------------------------------------------------------------------------------------
     void RigidbodyStatic::Awake(tremble::Model* model, PhysicsMaterial* material, PhysicsGeometry::ScalingType scaling_type)
     {
+        // the scene loader adds a rigidbody to every brush, only the static ones are merged, like CollectColliders expects
+        if (Get::PhysicsManager()->GetStaticGeometryMerger()->IsCollecting() == true && GetNode()->IsStatic() == true)
+        {
+            MergeModel(model, material, scaling_type);
+            return;
+        }
+
         InitRigidbodyStatic();
         for (int i = 0; i < model->GetMeshes().size(); ++i)
         {
             PhysicsGeometry* geometry = model->GetMeshes()[i]->GetPhysicsTriangleMeshGeometry();
-            AttachScaledShape(geometry, material, scaling_type);
+            AttachScaledShape(geometry, material, scaling_type, LAYER_STATIC);
         }
         Get::PhysicsManager()->AddPxActor(px_rigid_static_, this);
     }
 
+    //------------------------------------------------------------------------------------------------------
+    void RigidbodyStatic::Shutdown()
+    {
+        Rigidbody::Shutdown();
+
+        // the merged actors outlive the rigidbody, their triangles can't resolve to it anymore
+        if (merged_ == true)
+        {
+            Get::PhysicsManager()->GetStaticGeometryMerger()->Remove(this);
+        }
+    }
+
     //------------------------------------------------------------------------------------------------------
     void RigidbodyStatic::InitRigidbodyStatic()
     {
@@ -51,6 +71,39 @@ namespace tremble
         px_rigid_static_ = Get::PhysicsManager()->GetPxPhysics()->createRigidStatic(transform);
     }
 
+    //------------------------------------------------------------------------------------------------------
+    void RigidbodyStatic::MergeModel(tremble::Model* model, PhysicsMaterial* material, PhysicsGeometry::ScalingType scaling_type)
+    {
+        ASSERT(GetNode()->IsStatic() == true);
+        px_rigid_static_ = nullptr;
+        px_shape_ = nullptr;
+        merged_ = true;
+
+        if (material == nullptr)
+        {
+            material = Get::PhysicsManager()->GetMaterial("default");
+        }
+
+        Vector3 scale(1.0f, 1.0f, 1.0f);
+        switch (scaling_type)
+        {
+        case PhysicsGeometry::ScalingType::GLOBAL_SCALE:
+            break;
+        case PhysicsGeometry::ScalingType::RELATIVE_TO_NODE:
+            scale = GetNode()->GetScale();
+            break;
+        case PhysicsGeometry::ScalingType::RELATIVE_TO_PARENT:
+            scale = GetNode()->GetParent()->GetScale();
+            break;
+        }
+
+        PxTransform pose(GetNode()->GetPosition().ToPxVec3(), GetNode()->GetRotationQuaternion().ToPxQuat());
+        for (int i = 0; i < model->GetMeshes().size(); ++i)
+        {
+            Get::PhysicsManager()->GetStaticGeometryMerger()->Add(this, model->GetMeshes()[i], pose, scale.ToPxVec3(), material);
+        }
+    }
+
     //------------------------------------------------------------------------------------------------------
     void RigidbodyStatic::AttachShape(physx::PxShape* px_shape)
     {
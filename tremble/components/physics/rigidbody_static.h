@@ -9,15 +9,32 @@ namespace tremble
     class RigidbodyStatic : public Rigidbody
     {
     public:
-        physx::PxRigidActor* GetPxRigidbodyActor() override;
+        physx::PxRigidActor* GetPxRigidbodyActor() override; //!< The actor of the rigidbody, nullptr if it was merged
         void Awake(PhysicsGeometry* geometry, PhysicsMaterial* material = nullptr, PhysicsGeometry::ScalingType scaling_type = PhysicsGeometry::ScalingType::RELATIVE_TO_NODE);
+
+        /**
+        * @brief Creates an actor with a triangle mesh shape for every mesh of a model, or hands the meshes to the static geometry merger while it collects
+        * @param[in] model The model
+        * @param[in] material The physics material, nullptr for the default one
+        * @param[in] scaling_type How the node's scale is applied to the meshes
+        */
         void Awake(tremble::Model* model, PhysicsMaterial* material = nullptr, PhysicsGeometry::ScalingType scaling_type = PhysicsGeometry::ScalingType::RELATIVE_TO_NODE);
+        void Shutdown() override; //!< Removes the rigidbody from the static geometry merger if its meshes were merged
     private:
 
         void InitRigidbodyStatic();
+
+        /**
+        * @brief Hands the meshes of a model to the static geometry merger, the rigidbody gets no actor of its own
+        * @param[in] model The model
+        * @param[in] material The physics material
+        * @param[in] scaling_type How the node's scale is applied to the meshes
+        */
+        void MergeModel(tremble::Model* model, PhysicsMaterial* material, PhysicsGeometry::ScalingType scaling_type);
         void AttachShape(physx::PxShape* px_shape) override;
 
         physx::PxRigidStatic* px_rigid_static_;
         physx::PxShape* px_shape_;
+        bool merged_ = false; //!< Whether the meshes were handed to the static geometry merger
     };
 }
\ No newline at end of file
@@ -1,6 +1,7 @@
 #include "trigger_collider.h"
 #include "../../core/scene_graph/scene_graph.h"
 #include "../../core/physics/physics_manager.h"
+#include "../../core/physics/lag_compensation.h"
 #include "../../core/physics/physics_box_geometry.h"
 #include "../../core/physics/physics_capsule_geometry.h"
 #include "../../core/physics/physics_sphere_geometry.h"
@@ -24,8 +25,14 @@ namespace tremble
         shape->setGeometry(*physics_geometry->GetPxGeometry());
     }
 
+    void TriggerCollider::SetCollisionLayer(CollisionLayer layer, QueryOwner owner)
+    {
+        PhysicsManager::SetCollisionLayer(px_rigid_static_, layer, owner);
+    }
+
     void TriggerCollider::Shutdown()
     {
+        Get::LagCompensation()->RemoveHitbox(this);
         //Get::PhysicsManager()->RemovePxActor(px_rigidbody_);
     }
 
@@ -70,7 +77,7 @@ namespace tremble
             break;
         }
         px_rigid_static_ = Get::PhysicsManager()->px_physics_->createRigidStatic(transform);
-        physx::PxShape* px_shape_ = Get::PhysicsManager()->CreatePxShape(scaled, Get::PhysicsManager()->GetMaterial("default"));
+        physx::PxShape* px_shape_ = Get::PhysicsManager()->CreatePxShape(scaled, Get::PhysicsManager()->GetMaterial("default"), true, LAYER_TRIGGER);
         px_shape_->setFlag(PxShapeFlag::eSIMULATION_SHAPE, false);
         px_shape_->setFlag(PxShapeFlag::eTRIGGER_SHAPE, true);
         px_rigid_static_->attachShape(*px_shape_);
@@ -5,6 +5,7 @@
 #include "../../core/scene_graph/component_manager.h"
 #include "../../core/physics/physics_geometry.h"
 #include "../../core/physics/physics_geometry_holder.h"
+#include "../../core/physics/physics_layers.h"
 #include "../../core/get.h"
 
 namespace tremble
@@ -18,6 +19,7 @@ namespace tremble
         void UpdateBeforePhysics();
         PhysicsGeometryHolder GetGeometry();
         void SetGeometry(PhysicsGeometry* physics_geometry);
+        void SetCollisionLayer(CollisionLayer layer, QueryOwner owner = 0); //!< Put the trigger on a collision layer, triggers start on LAYER_TRIGGER
 
 		std::string tag;
 
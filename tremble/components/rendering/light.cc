@@ -10,9 +10,7 @@ namespace tremble
 		color_(1.0f, 1.0f, 1.0f, 1.0f),
 		falloff_end_(0.0f),
 		cos_cone_(0.0f),
-		cast_shadow_(false),
-		shadow_index_(0),
-		shadow_range_(0)
+		cast_shadow_(false)
 	{
 
 	}
@@ -32,10 +32,6 @@ namespace tremble
 		const Scalar& GetCone() const { return Scalar(std::acos(cos_cone_)); }
 		const Scalar& GetCosCone() const { return cos_cone_; }
 
-		void SetShadowRange(int index, int range) { shadow_index_ = index; shadow_range_ = range; }
-		int GetShadowIndex() { return shadow_index_; }
-		int GetShadowRange() { return shadow_range_; }
-
 		bool GetShadowCasting() { return cast_shadow_; }
 		void SetShadowCasting(bool casting) { cast_shadow_ = casting; }
 
@@ -47,8 +43,5 @@ namespace tremble
 		Scalar cos_cone_;
 
 		bool cast_shadow_;
-
-		int shadow_index_;
-		int shadow_range_;
 	};
 }
\ No newline at end of file
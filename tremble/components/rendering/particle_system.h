@@ -3,6 +3,7 @@
 #include "../../core/math/math.h"
 #include "../../core/rendering/structured_buffer.h"
 #include "../../core/rendering/particle_renderer.h"
+#include "../../core/rendering/particle_pool.h"
 
 namespace tremble 
 {
@@ -15,20 +16,6 @@ namespace tremble
 		System
 	};
 
-	struct Particle {
-		Vector3 position;
-		Vector3 velocity;
-
-		float age;
-		float lifetime;
-
-		Vector4 color;
-		Vector4 colorEnd;
-
-		float size;
-		float sizeEnd;
-	};
-
 	struct ParticleDescription {
 		Vector3 position;
 		Vector3 velocity;
@@ -56,14 +43,11 @@ namespace tremble
 		/// Returns texture assigned to particle system
 		Texture* GetTexture() { return texture_; }
 
-		/// Returns GPU buffer for renderable particles
-		StructuredBuffer& GetBuffer() { return particle_buffer_; }
-
 		/// Returns CPU buffer with renderable particles
-		ParticleRenderable* GetParticles() { return renderables_; }
+		ParticleRenderable* GetParticles() { return pool_.GetRenderables(); }
 
 		/// Returns amount of particles in system
-		int GetParticleCount() { return (int)particles_.size(); }
+		int GetParticleCount() { return (int)pool_.GetCount(); }
 
 		/// Sets alignment space
 		void SetSpace(ParticleSpace space) { space_ = space; }
@@ -78,19 +62,9 @@ namespace tremble
 		std::vector<ParticleEmitter*>& GetEmitters() { return emitters_; }
 
 	private:
-		void CreateBuffer();
-
 		Texture* texture_;
 
-		StructuredBuffer particle_buffer_;
-
-		std::vector<Particle> particles_;
-
-		ParticleRenderable* renderables_;
-
-		int buffer_size_;
-
-		int particle_barrier_;
+		ParticlePool pool_;
 
 		ParticleSpace space_ = System;
 
@@ -165,5 +139,7 @@ namespace tremble
 		Vector3 spawn_size_;
 
 		ParticleType type_;
+
+		ParticleRandom random_;
 	};
 }
\ No newline at end of file
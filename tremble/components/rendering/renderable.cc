@@ -71,293 +71,56 @@ namespace tremble
 	}
 
 	//------------------------------------------------------------------------------------------------------
-	void Renderable::Draw(GraphicsContext& context, Camera* camera)
+	Mat44 Renderable::GetMeshWorldTransform(int mesh_id)
 	{
-		if (active_)
-		{
-			if (model_ != nullptr)
-			{
-				for (int i = 0; i < cached_mesh_transforms_.size(); i++)
-				{
-					Mesh* mesh = cached_mesh_transforms_[i].first;
-					Mat44& transform = cached_mesh_transforms_[i].second;
-
-					if (!mesh->AreBuffersBuilt())
-					{
-						mesh->BuildBuffers();
-					}
-
-					Material* material = mesh->GetMaterial();
-					MaterialConstants mat_constants;
-
-					mat_constants.global_ambient = DirectX::XMFLOAT4(0.2f, 0.2f, 0.2f, 1.0f);
-					mat_constants.ambient_color = DirectX::XMFLOAT4(material->ambient_reflectance.x, material->ambient_reflectance.y, material->ambient_reflectance.z, 1.0f);
-					mat_constants.emissive_color = DirectX::XMFLOAT4(material->emissive.x, material->emissive.y, material->emissive.z, 1.0f);
-					mat_constants.diffuse_color = DirectX::XMFLOAT4(material->diffuse.x, material->diffuse.y, material->diffuse.z, 1.0f);
-					mat_constants.specular_color = DirectX::XMFLOAT4(material->specular.x, material->specular.y, material->specular.z, 1.0f);
-					mat_constants.reflectance = DirectX::XMFLOAT4(material->ambient_reflectance.x, material->ambient_reflectance.y, material->ambient_reflectance.z, 1.0f);
-					mat_constants.opacity = 1.0f;
-					mat_constants.specular_power = 5.0f;
-					mat_constants.index_of_refraction = 1.0f;
-					mat_constants.has_ambient_texture = false;
-					mat_constants.has_emissive_texture = false;
-					mat_constants.has_diffuse_texture = material->use_diffuse_map;
-					mat_constants.has_specular_texture = false;
-					mat_constants.has_specular_power_texture = false;
-					mat_constants.has_normal_texture = material->use_normal_map;
-					mat_constants.has_bump_texture = false;
-					mat_constants.has_opacity_texture = false;
-					mat_constants.bump_intensity = 1.0f;
-					mat_constants.specular_scale = 1.0f;
-					mat_constants.alpha_threshold = 0.05f;
-					mat_constants.padding[0] = mat_constants.padding[1] = 0.0f;
-
-					Get::Renderer()->GetMaterialConstantsBuffer().InsertDataByElement(mesh->GetMaterial()->renderer_material_cb_id, &mat_constants);
-
-					ObjectConstants constants;
-					constants.world = transform * GetNode()->GetWorldTransform();
-					constants.world_view = constants.world * camera->GetView();
-					constants.world_view_projection = constants.world * camera->GetViewProjection();
-
-					Get::Renderer()->GetObjectConstantsBuffer().InsertDataByElement(mesh->GetObjectConstantBufferID(this), &constants);
-
-					context.SetConstantBuffer(0, Get::Renderer()->GetObjectConstantsBuffer().GetAddressByElement(mesh->GetObjectConstantBufferID(this)));
-					context.SetConstantBuffer(2, Get::Renderer()->GetMaterialConstantsBuffer().GetAddressByElement(mesh->GetMaterial()->renderer_material_cb_id));
-
-					Material* mat = mesh->GetMaterial();
-					DescriptorHeap& srv_heap = Get::CbvSrvUavHeap();
-
-					if (mat != nullptr)
-					{
-						if (mat->use_ambient_map == true)
-						{
-							context.SetDescriptorTable(4, srv_heap.GetGPUDescriptorById(mat->ambient_map->GetSRV()));
-						}
-
-						if (mat->use_emissive_map == true)
-						{
-							context.SetDescriptorTable(5, srv_heap.GetGPUDescriptorById(mat->emissive_map->GetSRV()));
-						}
-
-						if (mat->use_diffuse_map == true)
-						{
-							context.SetDescriptorTable(6, srv_heap.GetGPUDescriptorById(mat->diffuse_map->GetSRV()));
-						}
-
-						if (mat->use_specular_map == true)
-						{
-							context.SetDescriptorTable(7, srv_heap.GetGPUDescriptorById(mat->specular_map->GetSRV()));
-						}
-
-						if (mat->use_shininess_map == true)
-						{
-							context.SetDescriptorTable(8, srv_heap.GetGPUDescriptorById(mat->shininess_map->GetSRV()));
-						}
-
-						if (mat->use_normal_map == true)
-						{
-							context.SetDescriptorTable(9, srv_heap.GetGPUDescriptorById(mat->normal_map->GetSRV()));
-						}
-					}
-
-					mesh->Draw(context);
-				}
-			}
-		}
+		return cached_mesh_transforms_[mesh_id].second * GetNode()->GetWorldTransform();
 	}
 
 	//------------------------------------------------------------------------------------------------------
-	void Renderable::Draw(GraphicsContext& context, OctreeObject* node, Camera* camera)
+	void Renderable::SetModel(Model* model)
 	{
-		if (active_)
+		if (model != model_)
 		{
-			Mesh* mesh = cached_mesh_transforms_[node->renderable_mesh_id].first;
-			Mat44& transform = cached_mesh_transforms_[node->renderable_mesh_id].second;
-
-			if (!mesh->AreBuffersBuilt())
-			{
-				mesh->BuildBuffers();
-			}
-
-			Material* material = mesh->GetMaterial();
-			MaterialConstants mat_constants;
-
-			mat_constants.global_ambient = DirectX::XMFLOAT4(0.2f, 0.2f, 0.2f, 1.0f);
-			mat_constants.ambient_color = DirectX::XMFLOAT4(material->ambient_reflectance.x, material->ambient_reflectance.y, material->ambient_reflectance.z, 1.0f);
-			mat_constants.emissive_color = DirectX::XMFLOAT4(material->emissive.x, material->emissive.y, material->emissive.z, 1.0f);
-			mat_constants.diffuse_color = DirectX::XMFLOAT4(material->diffuse.x, material->diffuse.y, material->diffuse.z, 1.0f);
-			mat_constants.specular_color = DirectX::XMFLOAT4(material->specular.x, material->specular.y, material->specular.z, 1.0f);
-			mat_constants.reflectance = DirectX::XMFLOAT4(material->ambient_reflectance.x, material->ambient_reflectance.y, material->ambient_reflectance.z, 1.0f);
-			mat_constants.opacity = 1.0f;
-			mat_constants.specular_power = 5.0f;
-			mat_constants.index_of_refraction = 1.0f;
-			mat_constants.has_ambient_texture = false;
-			mat_constants.has_emissive_texture = false;
-			mat_constants.has_diffuse_texture = material->use_diffuse_map;
-			mat_constants.has_specular_texture = false;
-			mat_constants.has_specular_power_texture = false;
-			mat_constants.has_normal_texture = material->use_normal_map;
-			mat_constants.has_bump_texture = false;
-			mat_constants.has_opacity_texture = false;
-			mat_constants.bump_intensity = 1.0f;
-			mat_constants.specular_scale = 1.0f;
-			mat_constants.alpha_threshold = 0.05f;
-			mat_constants.padding[0] = mat_constants.padding[1] = 0.0f;
-
-			Get::Renderer()->GetMaterialConstantsBuffer().InsertDataByElement(mesh->GetMaterial()->renderer_material_cb_id, &mat_constants);
-
-			ObjectConstants constants;
-			constants.world = transform * GetNode()->GetWorldTransform();
-			constants.world_view = constants.world * camera->GetView();
-			constants.world_view_projection = constants.world * camera->GetViewProjection();
-
-			Get::Renderer()->GetObjectConstantsBuffer().InsertDataByElement(mesh->GetObjectConstantBufferID(this), &constants);
-
-			context.SetConstantBuffer(0, Get::Renderer()->GetObjectConstantsBuffer().GetAddressByElement(mesh->GetObjectConstantBufferID(this)));
-			context.SetConstantBuffer(2, Get::Renderer()->GetMaterialConstantsBuffer().GetAddressByElement(mesh->GetMaterial()->renderer_material_cb_id));
-
-			Material* mat = mesh->GetMaterial();
-			DescriptorHeap& srv_heap = Get::CbvSrvUavHeap();
-
-			if (mat != nullptr)
-			{
-				if (mat->use_ambient_map == true)
-				{
-					context.SetDescriptorTable(4, srv_heap.GetGPUDescriptorById(mat->ambient_map->GetSRV()));
-				}
-
-				if (mat->use_emissive_map == true)
-				{
-					context.SetDescriptorTable(5, srv_heap.GetGPUDescriptorById(mat->emissive_map->GetSRV()));
-				}
-
-				if (mat->use_diffuse_map == true)
-				{
-					context.SetDescriptorTable(6, srv_heap.GetGPUDescriptorById(mat->diffuse_map->GetSRV()));
-				}
-
-				if (mat->use_specular_map == true)
-				{
-					context.SetDescriptorTable(7, srv_heap.GetGPUDescriptorById(mat->specular_map->GetSRV()));
-				}
-
-				if (mat->use_shininess_map == true)
-				{
-					context.SetDescriptorTable(8, srv_heap.GetGPUDescriptorById(mat->shininess_map->GetSRV()));
-				}
+			// cache the mesh/transforms to save a little bit of computational power
+			cached_mesh_transforms_ = model->GetMeshesWithTransforms();
 
-				if (mat->use_normal_map == true)
-				{
-					context.SetDescriptorTable(9, srv_heap.GetGPUDescriptorById(mat->normal_map->GetSRV()));
-				}
-			}
+			model_ = model;
 
-			mesh->Draw(context);
+			ComputeBounds();
 		}
 	}
 
 	//------------------------------------------------------------------------------------------------------
-	void Renderable::DrawBasic(GraphicsContext& context, const Mat44& view, const Mat44& projection)
+	void Renderable::ReloadModel(const Model& previous_model)
 	{
-		if (active_)
+		if (model_ == nullptr)
 		{
-			for (int i = 0; i < cached_mesh_transforms_.size(); i++)
-			{
-				Mesh* mesh = cached_mesh_transforms_[i].first;
-				Mat44& transform = cached_mesh_transforms_[i].second;
-
-				if (!mesh->AreBuffersBuilt())
-				{
-					mesh->BuildBuffers();
-				}
-
-				ObjectConstants constants;
-				constants.world = transform * GetNode()->GetWorldTransform();
-				constants.world_view = constants.world * view;
-				constants.world_view_projection = constants.world * view * projection;
-
-				Get::Renderer()->GetObjectConstantsBuffer().InsertDataByElement(mesh->GetObjectConstantBufferID(this), &constants);
-
-				context.SetConstantBuffer(0, Get::Renderer()->GetObjectConstantsBuffer().GetAddressByElement(mesh->GetObjectConstantBufferID(this)));
-
-				mesh->Draw(context);
-			}
+			return;
 		}
-	}
-
-	//------------------------------------------------------------------------------------------------------
-	void Renderable::DrawBasic(GraphicsContext& context, Camera* camera)
-	{
-		if (active_)
-		{
-			for (int i = 0; i < cached_mesh_transforms_.size(); i++)
-			{
-				Mesh* mesh = cached_mesh_transforms_[i].first;
-				Mat44& transform = cached_mesh_transforms_[i].second;
-
-				if (!mesh->AreBuffersBuilt())
-				{
-					mesh->BuildBuffers();
-				}
-
-				ObjectConstants constants;
-				constants.world = transform * GetNode()->GetWorldTransform();
-				constants.world_view = constants.world * camera->GetView();
-				constants.world_view_projection = constants.world * camera->GetViewProjection();
-
-				Get::Renderer()->GetObjectConstantsBuffer().InsertDataByElement(mesh->GetObjectConstantBufferID(this), &constants);
 
-				context.SetConstantBuffer(0, Get::Renderer()->GetObjectConstantsBuffer().GetAddressByElement(mesh->GetObjectConstantBufferID(this)));
+		cached_mesh_transforms_ = model_->GetMeshesWithTransforms();
 
-				mesh->Draw(context);
-			}
-		}
-	}
-
-	//------------------------------------------------------------------------------------------------------
-	void Renderable::DrawBasic(GraphicsContext& context, OctreeObject* node, Camera* camera)
-	{
-		if (active_)
+		// the mesh count may have changed, so throw away the old octree objects the same way Shutdown does
+		for (int i = 0; i < octree_nodes_.size(); i++)
 		{
-			Mesh* mesh = cached_mesh_transforms_[node->renderable_mesh_id].first;
-			Mat44& transform = cached_mesh_transforms_[node->renderable_mesh_id].second;
-
-			if (!mesh->AreBuffersBuilt())
-			{
-				mesh->BuildBuffers();
-			}
-
-			ObjectConstants constants;
-			constants.world = transform * GetNode()->GetWorldTransform();
-			constants.world_view = constants.world * camera->GetView();
-			constants.world_view_projection = constants.world * camera->GetViewProjection();
-
-			Get::Renderer()->GetObjectConstantsBuffer().InsertDataByElement(mesh->GetObjectConstantBufferID(this), &constants);
+			octree_nodes_[i]->alive = false;
+		}
 
-			context.SetConstantBuffer(0, Get::Renderer()->GetObjectConstantsBuffer().GetAddressByElement(mesh->GetObjectConstantBufferID(this)));
+		Get::Octree()->Update();
 
-			mesh->Draw(context);
+		for (int i = 0; i < octree_nodes_.size(); i++)
+		{
+			octree_node_allocator_->Delete(octree_nodes_[i]);
 		}
-	}
+		octree_nodes_.clear();
 
-	//------------------------------------------------------------------------------------------------------
-	void Renderable::SetModel(Model* model)
-	{
-		if (model != model_)
+		if (octree_node_allocator_ != nullptr)
 		{
-			// cache the mesh/transforms to save a little bit of computational power
-			cached_mesh_transforms_ = model->GetMeshesWithTransforms();
-
-			const std::vector<Mesh*>& meshes = model->GetMeshes();
-			for (int i = 0; i < model->GetMeshes().size(); i++)
-			{
-				meshes[i]->CreateObjectConstantBufferID(this);
-			}
-
-			model_ = model;
-
-			ComputeBounds();
+			Get::MemoryManager()->DeleteAllocator(octree_node_allocator_);
+			octree_node_allocator_ = nullptr;
 		}
+
+		ComputeBounds();
 	}
 
 	//------------------------------------------------------------------------------------------------------
@@ -389,10 +152,24 @@ namespace tremble
 		{
 			std::vector<DirectX::XMFLOAT3> verts;
 
-			const std::vector<Vertex>& mesh_verts = cached_mesh_transforms_[i].first->GetMeshData().vertices;
-			for (int j = 0; j < mesh_verts.size(); j++)
+			Mesh* mesh = cached_mesh_transforms_[i].first;
+			if (mesh->IsMeshDataReleased())
 			{
-				verts.push_back(cached_mesh_transforms_[i].second * Vector4(mesh_verts[j].position, Scalar(1.0f)));
+				// only the bounds survive releasing the mesh data, so fit around the transformed corners instead
+				DirectX::XMFLOAT3 corners[8];
+				mesh->GetBoundingBox().GetCorners(corners);
+				for (int j = 0; j < 8; j++)
+				{
+					verts.push_back(cached_mesh_transforms_[i].second * Vector4(corners[j], Scalar(1.0f)));
+				}
+			}
+			else
+			{
+				const std::vector<Vertex>& mesh_verts = mesh->GetMeshData().vertices;
+				for (int j = 0; j < mesh_verts.size(); j++)
+				{
+					verts.push_back(cached_mesh_transforms_[i].second * Vector4(mesh_verts[j].position, Scalar(1.0f)));
+				}
 			}
 
 			OctreeObject* octree_node = octree_node_allocator_->New<OctreeObject>();
@@ -425,4 +202,32 @@ namespace tremble
 			}
 		}
 	}
+
+	//------------------------------------------------------------------------------------------------------
+	float Renderable::ComputeScreenSize(const OctreeObject* node, Camera* camera)
+	{
+		float radius = DirectX::XMVectorGetX(DirectX::XMVector3Length(DirectX::XMLoadFloat3(&node->bounds.Extents)));
+		float depth = DirectX::XMVectorGetZ(DirectX::XMVector3TransformCoord(DirectX::XMLoadFloat3(&node->bounds.Center), camera->GetView()));
+
+		if (depth <= radius)
+		{
+			return 1.0f;
+		}
+
+		// the projection's [1][1] element is cot(fov / 2), which maps view space height onto half the screen height, so it's halved for the full height
+		return 0.5f * radius * DirectX::XMVectorGetY(camera->GetProjection().r[1]) / depth;
+	}
+
+	//------------------------------------------------------------------------------------------------------
+	int Renderable::SelectLOD(int mesh_id, Camera* camera)
+	{
+		Mesh* mesh = cached_mesh_transforms_[mesh_id].first;
+
+		if (mesh->GetLODCount() == 1 || mesh_id >= octree_nodes_.size() || !octree_nodes_[mesh_id]->alive)
+		{
+			return 0;
+		}
+
+		return mesh->SelectLOD(ComputeScreenSize(octree_nodes_[mesh_id], camera));
+	}
 }
\ No newline at end of file
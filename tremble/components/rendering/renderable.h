@@ -24,15 +24,24 @@ namespace tremble
 		void Update();
 		void Shutdown();
 
-		void Draw(GraphicsContext& context, Camera* camera);
-		void Draw(GraphicsContext& context, OctreeObject* node, Camera* camera);
-		void DrawBasic(GraphicsContext& context, const Mat44& view, const Mat44& projection);
-		void DrawBasic(GraphicsContext& context, Camera* camera);
-		void DrawBasic(GraphicsContext& context, OctreeObject* node, Camera* camera);
+		int GetNumMeshes() const { return static_cast<int>(cached_mesh_transforms_.size()); }
+		Mesh* GetMesh(int mesh_id) const { return cached_mesh_transforms_[mesh_id].first; }
+
+		/**
+		* @brief Computes the world transform of a single mesh
+		* @param[in] mesh_id The mesh id (relative to the cached mesh transforms)
+		*/
+		Mat44 GetMeshWorldTransform(int mesh_id);
 
 		void SetModel(Model* model);
 		Model* GetModel();
 
+		/**
+		* @brief Refreshes the cached meshes & bounds after the model's contents were swapped out by a hot reload
+		* @param[in] previous_model A model holding the contents from before the reload
+		*/
+		void ReloadModel(const Model& previous_model);
+
 		void SetActive(bool active) { active_ = active; }
 		const bool& GetActive() { return active_; }
 
@@ -40,6 +49,20 @@ namespace tremble
 
 		void ComputeBounds();
 		void UpdateBounds();
+
+		/**
+		* @brief Computes the projected size of an octree object's bounds, as a fraction of the screen height
+		* @param[in] node The octree object of which the projected size should be computed
+		* @param[in] camera The camera the object is viewed from
+		*/
+		static float ComputeScreenSize(const OctreeObject* node, Camera* camera);
+
+		/**
+		* @brief Selects the LOD of one of this renderable's meshes based on its projected size
+		* @param[in] mesh_id The mesh id (relative to the cached mesh transforms)
+		* @param[in] camera The camera the mesh is viewed from
+		*/
+		int SelectLOD(int mesh_id, Camera* camera);
 	private:
 		bool active_;
 		Model* model_;
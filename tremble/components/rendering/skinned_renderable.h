@@ -24,9 +24,23 @@ namespace tremble
 		void Update();
 		void Shutdown();
 
-		void Draw(GraphicsContext& context, Camera* camera);
-		void DrawBasic(GraphicsContext& context, const Mat44& view, const Mat44& projection);
-		void DrawBasic(GraphicsContext& context, Camera* camera);
+		int GetNumMeshes() const { return static_cast<int>(cached_mesh_transforms_.size()); }
+		Mesh* GetMesh(int mesh_id) const { return cached_mesh_transforms_[mesh_id].first; }
+
+		/**
+		* @brief Computes the world transform of a single mesh
+		* @param[in] mesh_id The mesh id (relative to the cached mesh transforms)
+		*/
+		Mat44 GetMeshWorldTransform(int mesh_id);
+
+		const std::vector<DirectX::XMFLOAT4X4>& GetBoneTransforms() const { return bone_transforms_; } //!< The bone transforms of the current animation frame
+
+		/**
+		* @brief Computes the world space bounds of the meshes in their bind pose, animations may move vertices outside of them
+		* @param[out] out_bounds The merged bounds of all meshes
+		* @return Whether there were any meshes to compute the bounds of
+		*/
+		bool ComputeWorldBounds(DirectX::BoundingBox& out_bounds);
 
 		void PlayAnimation(const std::string& name);
 		void PlayAnimation(const unsigned int& anim_index);
@@ -34,6 +48,12 @@ namespace tremble
 		void SetModel(Model* model);
 		Model* GetModel();
 
+		/**
+		* @brief Refreshes the cached meshes & animations after the model's contents were swapped out by a hot reload
+		* @param[in] previous_model A model holding the contents from before the reload, used to carry over the playing animation
+		*/
+		void ReloadModel(const Model& previous_model);
+
 		void SetActive(bool active) { active_ = active; }
 		const bool& GetActive() { return active_; }
 	private:
@@ -47,7 +67,6 @@ namespace tremble
 		float current_animation_time_normalized_;
 		float current_animation_time_in_ticks_;
 		std::unordered_map<std::string, int> name_to_animation_mapping_;
-		UploadBuffer bone_upload_buffer_;
-		StructuredBuffer bone_buffer_;
+		std::vector<DirectX::XMFLOAT4X4> bone_transforms_; //!< The bone transforms of the current animation frame, kept for when the animation stops
 	};
 }
\ No newline at end of file
@@ -9,6 +9,9 @@ namespace tremble {
 		width_ = 0;
 		height_ = 0;
 		measurements_valid_ = false;
+		glyph_texture_ = nullptr;
+		glyph_atlas_version_ = 0;
+		glyphs_valid_ = false;
 		text_ = "";
 		position_ = { 0, 0, 0 };
 		size_ = 32;
@@ -25,7 +28,10 @@ namespace tremble {
 	void TextComponent::SetFont(std::string name)
 	{
 		InterfaceFontRenderer* renderer = Get::Renderer()->GetFontRenderer();
-		std::vector<Font>& fonts = renderer->GetFontList();
+		std::deque<Font>& fonts = renderer->GetFontList();
+
+		measurements_valid_ = false;
+		glyphs_valid_ = false;
 
 		for (int i = 0; i < fonts.size(); i++)
 		{
@@ -87,7 +93,7 @@ namespace tremble {
 		float top = 0, bottom = 0, left = 0, right = 0;
 		float x = 0;
 
-		char c;
+		unsigned char c;
 		CharInfo info;
 
 
@@ -124,4 +130,73 @@ namespace tremble {
 
 		measurements_valid_ = true;
 	}
+
+	//------------------------------------------------------------------------------------------------------
+	bool TextComponent::UpdateGlyphs()
+	{
+		// the atlas version changes when another size of the font is packed, which moves every glyph
+		if (glyphs_valid_ == true && (font_ == nullptr || glyph_atlas_version_ == font_->atlas_version))
+		{
+			return false;
+		}
+
+		glyphs_.clear();
+		glyph_texture_ = nullptr;
+		glyphs_valid_ = true;
+
+		if (font_ == nullptr || text_.length() == 0)
+		{
+			return true;
+		}
+
+		// calculate component alignment, measuring first since it may generate the font level
+		float width = GetWidth();
+		float offset_x = -width * center_.GetX();
+		float offset_y = -GetHeight() * center_.GetY();
+
+		FontLevel& font = font_->FindLevel(size_);
+		float scale = size_ / font.size;
+
+		glyph_atlas_version_ = font_->atlas_version;
+		glyph_texture_ = font.char_map;
+
+		if (glyph_texture_ == nullptr)
+		{
+			return true;
+		}
+
+		float x, y;
+		x = 0;
+		y = lines_[0].height;
+
+		// add every line
+		for (int l = 0; l < lines_.size(); l++) {
+			// calculate line alignment
+			switch (alignment_)
+			{
+				case Left: { x = 0; break; }
+				case Middle: { x = (width - lines_[l].width) / 2.0f; break; }
+				case Right: { x = width - lines_[l].width; break; }
+			}
+
+			// add all characters
+			for (int s = 0; s < lines_[l].text.length(); s++) {
+				unsigned char c = lines_[l].text[s];
+				const CharInfo& info = font.char_info[c];
+
+				InterfaceFontData glyph;
+				glyph.transform = DirectX::XMMatrixScaling(info.width * scale, info.height * scale, 1) * DirectX::XMMatrixTranslation(position_.GetX().Get() + x + offset_x + info.offset_x * scale, position_.GetY().Get() + y + offset_y + info.offset_y * scale, 1 + layer_);
+				glyph.color = color_;
+				glyph.uv_min = { info.uv_x1, info.uv_y1 };
+				glyph.uv_max = { info.uv_x2, info.uv_y2 };
+				glyphs_.push_back(glyph);
+
+				x += info.advance * scale;
+			}
+
+			y += lines_[l].height + line_seperation_;
+		}
+
+		return true;
+	}
 }
\ No newline at end of file
@@ -1,6 +1,7 @@
 #pragma once
 #include "../../core/scene_graph/component.h"
 #include "../../core/math/math.h"
+#include "../../core/rendering/interface_buffers.h"
 
 namespace tremble
 {
@@ -42,22 +43,22 @@ namespace tremble
 		Font* GetFontPtr() { return font_; }
 
 		/// Assigns a string to the text
-		void SetText(std::string text) { text_ = text; measurements_valid_ = false;}
+		void SetText(std::string text) { text_ = text; measurements_valid_ = false; glyphs_valid_ = false; }
 		/// Returns the string assigned to the text
 		std::string GetText() { return text_; }
 
 		/// Assigns position to image
-		void SetPosition(Vector3 position) { position_ = position; }
+		void SetPosition(Vector3 position) { position_ = position; glyphs_valid_ = false; }
 		/// Returns position assigned to the text
 		Vector3 GetPosition() { return position_; }
 
 		/// Assigns size to the text
-		void SetSize(float size) { size_ = size; measurements_valid_ = false;}
+		void SetSize(float size) { size_ = size; measurements_valid_ = false; glyphs_valid_ = false; }
 		/// Returns size assigned to the text
 		float GetSize() { return size_; }
 
 		/// Assigns center point to the text
-		void SetCenter(Vector3 center) { center_ = center; }
+		void SetCenter(Vector3 center) { center_ = center; glyphs_valid_ = false; }
 		/// Returns center point assigned to the text
 		Vector3 GetCenter() { return center_; }
 
@@ -67,12 +68,12 @@ namespace tremble
 		DirectX::XMMATRIX GetMatrix() { return transform_; }
 
 		/// Assigns render the text
-		void SetLayer(int layer) { layer_ = layer; }
+		void SetLayer(int layer) { layer_ = layer; glyphs_valid_ = false; }
 		/// Returns render the text
 		float GetLayer() { return layer_; }
 
 		/// Assigns color to the text
-		void SetColor(Vector4 color) { color_ = color; }
+		void SetColor(Vector4 color) { color_ = color; glyphs_valid_ = false; }
 		/// Returns color assigned to the text
 		Vector4 GetColor() { return color_; }
 
@@ -82,24 +83,36 @@ namespace tremble
 		float GetHeight() { if (measurements_valid_ == false) { Measure(); } return height_; }
 
 		/// Sets text alignment
-		void SetAlignment(Alignment align) { alignment_ = align; }
+		void SetAlignment(Alignment align) { alignment_ = align; glyphs_valid_ = false; }
 		/// Returns text alignment
 		Alignment GetAlignment() { return alignment_; }
 
 		/// Sets line seperation distance in virtual pixels
-		void SetLineSeperation(float separation) { line_seperation_ = separation; }
+		void SetLineSeperation(float separation) { line_seperation_ = separation; measurements_valid_ = false; glyphs_valid_ = false; }
 		/// Returns line seperation distance in virtual pixels
 		float GetLineSeperation() { return line_seperation_; }
 
 		/// Returns lines found in assigned string with measurements
 		std::vector<TextLine>& GetLines() { return lines_; }
 
+		/// Rebuilds the cached glyph quads if the text changed since the last call, returns whether they were rebuilt
+		bool UpdateGlyphs();
+		/// Returns the cached glyph quads, as built by the last UpdateGlyphs call
+		const std::vector<InterfaceFontData>& GetGlyphs() { return glyphs_; }
+		/// Returns the atlas the cached glyph quads sample from
+		Texture* GetGlyphTexture() { return glyph_texture_; }
+
 	private:
 		void Measure();
 		float width_;
 		float height_;
 		bool measurements_valid_;
 
+		std::vector<InterfaceFontData> glyphs_;
+		Texture* glyph_texture_;
+		unsigned int glyph_atlas_version_;
+		bool glyphs_valid_;
+
 		Font* font_;
 
 		std::string text_;
@@ -1,15 +1,193 @@
 #include "audio_clip.h"
 #include "audio_manager.h"
+#include "../utilities/debug.h"
 #include "core/get.h"
 
 namespace tremble
 {
 	//------------------------------------------------------------------------------------------------------
-	AudioClip::AudioClip(const std::string& file_location)
+	AudioClip::AudioClip(const std::string& file_location) :
+		sound(nullptr),
+		name(file_location),
+		load_mode_(LoadMode::DECODED),
+		state_(State::UNLOADED),
+		file_size_(0),
+		decoded_size_(0),
+		length_(0.0f),
+		frequency_(0.0f),
+		min_distance_(1.0f),
+		max_distance_(10000.0f),
+		last_used_(0.0),
+		num_voices_(0)
 	{
-		Get::AudioManager()->ErrorCheck(Get::AudioManager()->GetSystem()->createSound(file_location.c_str(), FMOD_3D, 0, &sound));
-		name = file_location;
+		std::ifstream file(file_location, std::ios::in | std::ios::binary | std::ios::ate);
+		if (file.is_open())
+		{
+			file_size_ = static_cast<size_t>(file.tellg());
+		}
+
+		// short effects are decoded right away, anything larger is opened as a stream first to see how long it is
+		if (file_size_ < AUDIO_CLIP_PROBE_SIZE)
+		{
+			Open(FMOD_CREATESAMPLE, State::LOADING);
+		}
+		else
+		{
+			Open(FMOD_CREATESTREAM, State::PROBING);
+		}
+
 		Get::AudioManager()->AddAudioClip(this);
 	}
 
+	//------------------------------------------------------------------------------------------------------
+	AudioClip::~AudioClip()
+	{
+		Get::AudioManager()->RemoveAudioClip(this);
+
+		if (sound != nullptr)
+		{
+			sound->release();
+		}
+	}
+
+	//------------------------------------------------------------------------------------------------------
+	void AudioClip::Update()
+	{
+		if (state_ != State::PROBING && state_ != State::LOADING)
+		{
+			return;
+		}
+
+		FMOD_OPENSTATE open_state = FMOD_OPENSTATE_LOADING;
+		FMOD_RESULT result = sound->getOpenState(&open_state, nullptr, nullptr, nullptr);
+
+		if (result != FMOD_OK || open_state == FMOD_OPENSTATE_ERROR)
+		{
+			DLOG("audio clip " << name << " couldn't be opened");
+			sound->release();
+			sound = nullptr;
+			state_ = State::FAILED;
+			return;
+		}
+
+		if (open_state == FMOD_OPENSTATE_READY)
+		{
+			Finish();
+		}
+	}
+
+	//------------------------------------------------------------------------------------------------------
+	void AudioClip::Finish()
+	{
+		unsigned int length = 0;
+		unsigned int decoded_size = 0;
+		sound->getLength(&length, FMOD_TIMEUNIT_MS);
+		sound->getLength(&decoded_size, FMOD_TIMEUNIT_PCMBYTES);
+		length_ = static_cast<float>(length) / 1000.0f;
+		decoded_size_ = decoded_size;
+
+		if (state_ == State::PROBING)
+		{
+			// the probe is a stream already, so long clips keep it
+			if (length_ >= AUDIO_CLIP_STREAM_LENGTH)
+			{
+				load_mode_ = LoadMode::STREAMED;
+			}
+			else
+			{
+				load_mode_ = decoded_size_ <= AUDIO_CLIP_MAX_DECODED_SIZE ? LoadMode::DECODED : LoadMode::COMPRESSED;
+				sound->release();
+				sound = nullptr;
+				Open(load_mode_ == LoadMode::DECODED ? FMOD_CREATESAMPLE : FMOD_CREATECOMPRESSEDSAMPLE | FMOD_SOFTWARE, State::LOADING);
+				return;
+			}
+		}
+
+		float volume = 1.0f;
+		float pan = 0.0f;
+		int priority = 0;
+		sound->getDefaults(&frequency_, &volume, &pan, &priority);
+		sound->set3DMinMaxDistance(min_distance_, max_distance_);
+		state_ = State::READY;
+	}
+
+	//------------------------------------------------------------------------------------------------------
+	void AudioClip::Open(FMOD_MODE mode, State state)
+	{
+		FMOD_RESULT result = Get::AudioManager()->GetSystem()->createSound(name.c_str(), FMOD_3D | FMOD_NONBLOCKING | mode, 0, &sound);
+		if (result != FMOD_OK)
+		{
+			DLOG("audio clip " << name << " couldn't be opened: " << FMOD_ErrorString(result));
+			sound = nullptr;
+			state_ = State::FAILED;
+			return;
+		}
+
+		state_ = state;
+	}
+
+	//------------------------------------------------------------------------------------------------------
+	void AudioClip::Request(double time)
+	{
+		last_used_ = time;
+
+		if (state_ != State::UNLOADED)
+		{
+			return;
+		}
+
+		switch (load_mode_)
+		{
+		case LoadMode::DECODED:
+			Open(FMOD_CREATESAMPLE, State::LOADING);
+			break;
+		case LoadMode::COMPRESSED:
+			Open(FMOD_CREATECOMPRESSEDSAMPLE | FMOD_SOFTWARE, State::LOADING);
+			break;
+		case LoadMode::STREAMED:
+			Open(FMOD_CREATESTREAM, State::LOADING);
+			break;
+		}
+	}
+
+	//------------------------------------------------------------------------------------------------------
+	void AudioClip::Release()
+	{
+		ASSERT(num_voices_ == 0 && state_ == State::READY);
+
+		sound->release();
+		sound = nullptr;
+		state_ = State::UNLOADED;
+	}
+
+	//------------------------------------------------------------------------------------------------------
+	void AudioClip::Set3DMinMaxDistance(float min, float max)
+	{
+		min_distance_ = min;
+		max_distance_ = max;
+
+		if (state_ == State::READY)
+		{
+			Get::AudioManager()->ErrorCheck(sound->set3DMinMaxDistance(min, max));
+		}
+	}
+
+	//------------------------------------------------------------------------------------------------------
+	size_t AudioClip::GetMemory() const
+	{
+		if (sound == nullptr)
+		{
+			return 0;
+		}
+
+		switch (load_mode_)
+		{
+		case LoadMode::DECODED:
+			return state_ == State::READY ? decoded_size_ : 0;
+		case LoadMode::COMPRESSED:
+			return file_size_;
+		default:
+			return AUDIO_CLIP_STREAM_MEMORY;
+		}
+	}
 }
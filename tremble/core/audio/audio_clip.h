@@ -3,20 +3,93 @@
 #include "fmod.hpp"
 #include "fmod_errors.h"
 
+#define AUDIO_CLIP_PROBE_SIZE (128 * 1024) // files smaller than this many bytes are short effects, they're decoded without opening them first
+#define AUDIO_CLIP_MAX_DECODED_SIZE (2 * 1024 * 1024) // clips that would take more bytes than this decoded are kept compressed in memory
+#define AUDIO_CLIP_STREAM_LENGTH 30.0f // clips at least this many seconds long are streamed from disk
+#define AUDIO_CLIP_STREAM_MEMORY (64 * 1024) // the bytes an open stream is counted as, for its file handle & decode buffers
+
 namespace tremble
 {
 	/**
 	* @brief A class that contains the FMOD sound needed to play the associated clip
+	*
+	* Clips load in the background on FMOD's own thread, the sound is nullptr until the clip is ready. Larger files
+	* are opened as a stream first, the length decides whether they're decoded, kept compressed in memory or streamed.
+	* The audio clip cache releases the sounds of clips that weren't played for a while to stay within its budget,
+	* playing them again loads them again.
 	* @class tremble::AudioClip
 	* @author Max Blom
 	*/
 	class AudioClip
 	{
-	private:
-		
 	public:
+		/**
+		* @brief How the samples of a clip are kept
+		*/
+		enum class LoadMode
+		{
+			DECODED, //!< Decoded into memory when loading, for short effects
+			COMPRESSED, //!< Kept compressed in memory & decoded while playing
+			STREAMED //!< Read from disk & decoded while playing
+		};
+
+		/**
+		* @brief How far a clip is with loading
+		*/
+		enum class State
+		{
+			UNLOADED, //!< Not loaded or released by the cache
+			PROBING, //!< Opened as a stream to find out how long it is
+			LOADING, //!< Loading in the chosen mode
+			READY, //!< Ready to be played
+			FAILED //!< The file couldn't be opened
+		};
+
 		AudioClip(const std::string& file_location);
-		FMOD::Sound *sound;
+		~AudioClip(); //!< Stops the voices of the clip & releases its sound
+
+		FMOD::Sound *sound; //!< The loaded sound, nullptr while the clip isn't ready
 		std::string name;
+
+		void Update(); //!< Checks whether the background loading finished & continues with the next step
+		void Request(double time); //!< Marks the clip as used at a time, & starts loading it again if the cache released it
+		void Release(); //!< Releases the sound, only called by the cache for ready clips without voices
+
+		/**
+		* Sets the minimum and maximum distance of the clip for dropoff, kept when the clip is loaded again
+		* @param[in] min minimum distance
+		* @param[in] max maximum distance
+		*/
+		void Set3DMinMaxDistance(float min, float max);
+
+		void AddVoice() { num_voices_++; } //!< Called by the voice manager when a voice of the clip starts
+		void RemoveVoice() { num_voices_--; } //!< Called by the voice manager when a voice of the clip ends
+
+		bool IsReady() const { return state_ == State::READY; } //!< Whether the clip can be played
+		State GetState() const { return state_; } //!< How far the clip is with loading
+		LoadMode GetLoadMode() const { return load_mode_; } //!< How the samples are kept, only known once the clip was ready once
+		size_t GetMemory() const; //!< The bytes the loaded samples take, 0 if the clip isn't loaded
+		size_t GetFileSize() const { return file_size_; } //!< The size of the file in bytes
+		float GetLength() const { return length_; } //!< The length of the clip in seconds, 0 until it was opened
+		float GetFrequency() const { return frequency_; } //!< The frequency the clip plays at by default
+		float GetMinDistance() const { return min_distance_; } //!< The distance up to which the clip plays at full volume
+		float GetMaxDistance() const { return max_distance_; } //!< The distance beyond which the clip isn't heard
+		double GetLastUsed() const { return last_used_; } //!< The last time the clip was played
+		uint32_t GetNumVoices() const { return num_voices_; } //!< The number of voices that play the clip
+
+	private:
+		void Open(FMOD_MODE mode, State state); //!< Starts opening the file in the background
+		void Finish(); //!< Reads the properties of the opened sound & decides how to load it, if it was probed
+
+		LoadMode load_mode_; //!< How the samples are kept
+		State state_; //!< How far the clip is with loading
+		size_t file_size_; //!< The size of the file in bytes
+		size_t decoded_size_; //!< The bytes the decoded samples take
+		float length_; //!< The length in seconds
+		float frequency_; //!< The default frequency
+		float min_distance_; //!< The distance up to which the clip plays at full volume
+		float max_distance_; //!< The distance beyond which the clip isn't heard
+		double last_used_; //!< The last time the clip was played
+		uint32_t num_voices_; //!< The number of voices that play the clip
 	};
 }
\ No newline at end of file
@@ -0,0 +1,76 @@
+#include "audio_clip_cache.h"
+
+#include "audio_clip.h"
+#include "../utilities/debug.h"
+
+namespace tremble
+{
+	//------------------------------------------------------------------------------------------------------
+	AudioClipCache::AudioClipCache() :
+		budget_(0),
+		memory_(0),
+		peak_memory_(0),
+		num_releases_(0),
+		over_budget_(false)
+	{
+
+	}
+
+	//------------------------------------------------------------------------------------------------------
+	void AudioClipCache::Add(AudioClip* clip)
+	{
+		clips_.push_back(clip);
+	}
+
+	//------------------------------------------------------------------------------------------------------
+	void AudioClipCache::Remove(AudioClip* clip)
+	{
+		auto it = std::find(clips_.begin(), clips_.end(), clip);
+		if (it != clips_.end())
+		{
+			*it = clips_.back();
+			clips_.pop_back();
+		}
+	}
+
+	//------------------------------------------------------------------------------------------------------
+	void AudioClipCache::Update()
+	{
+		memory_ = 0;
+		for (size_t i = 0; i < clips_.size(); i++)
+		{
+			clips_[i]->Update();
+			memory_ += clips_[i]->GetMemory();
+		}
+
+		while (memory_ > budget_)
+		{
+			// clips with voices can't be released, even the virtual ones would have nothing to continue with
+			AudioClip* least_recent = nullptr;
+			for (size_t i = 0; i < clips_.size(); i++)
+			{
+				AudioClip* clip = clips_[i];
+				if (clip->IsReady() == true && clip->GetNumVoices() == 0 && (least_recent == nullptr || clip->GetLastUsed() < least_recent->GetLastUsed()))
+				{
+					least_recent = clip;
+				}
+			}
+
+			if (least_recent == nullptr)
+			{
+				if (over_budget_ == false)
+				{
+					DLOG("audio clip cache: the playing clips take " << memory_ << " bytes, more than the budget of " << budget_ << " bytes");
+				}
+				break;
+			}
+
+			memory_ -= least_recent->GetMemory();
+			least_recent->Release();
+			num_releases_++;
+		}
+
+		over_budget_ = memory_ > budget_;
+		peak_memory_ = std::max(peak_memory_, memory_);
+	}
+}
\ No newline at end of file
@@ -0,0 +1,39 @@
+#pragma once
+
+namespace tremble
+{
+	class AudioClip;
+
+	/**
+	* @class tremble::AudioClipCache
+	* @brief Keeps track of all audio clips & keeps the memory of their samples within a budget
+	*
+	* Every update the clips that are loading in the background are checked. If the loaded clips take more memory than
+	* the budget, the clips that weren't played for the longest time & have no voices are released until they fit
+	* again. Playing a released clip loads it again, its voices stay virtual until it's ready.
+	*/
+	class AudioClipCache
+	{
+	public:
+		AudioClipCache();
+
+		void SetBudget(size_t budget) { budget_ = budget; } //!< Sets the bytes the samples of the loaded clips may take
+		void Add(AudioClip* clip); //!< Starts keeping track of a clip
+		void Remove(AudioClip* clip); //!< Stops keeping track of a clip that is destroyed
+		void Update(); //!< Continues loading the clips & releases the least recently played ones while over the budget
+
+		const std::vector<AudioClip*>& GetClips() const { return clips_; } //!< All clips
+		size_t GetMemory() const { return memory_; } //!< The bytes the samples of the loaded clips took after the last update
+		size_t GetPeakMemory() const { return peak_memory_; } //!< The most bytes the samples of the loaded clips took after an update
+		size_t GetBudget() const { return budget_; } //!< The bytes the samples of the loaded clips may take
+		uint64_t GetNumReleases() const { return num_releases_; } //!< The number of times a clip was released to stay within the budget
+
+	private:
+		std::vector<AudioClip*> clips_; //!< All clips
+		size_t budget_; //!< The bytes the samples of the loaded clips may take
+		size_t memory_; //!< The bytes the samples of the loaded clips took after the last update
+		size_t peak_memory_; //!< The most bytes the samples of the loaded clips took after an update
+		uint64_t num_releases_; //!< The number of times a clip was released to stay within the budget
+		bool over_budget_; //!< Whether the clips that are playing took more than the budget in the last update, so that's only logged once
+	};
+}
\ No newline at end of file
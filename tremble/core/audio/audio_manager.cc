@@ -4,17 +4,27 @@
 #include "components/rendering/camera.h"
 #include "core/rendering/renderer.h"
 #include "core/scene_graph/scene_graph.h"
+#include "core/get.h"
 
 namespace tremble
 {
 	//------------------------------------------------------------------------------------------------------
-	AudioManager::AudioManager()
+	AudioManager::AudioManager() :
+		listener_node_(nullptr),
+		listener_position_(0.0f, 0.0f, 0.0f),
+		benchmark_pending_requests_(0.0f),
+		benchmark_num_requests_(0)
 	{
 		result_ = FMOD::System_Create(&system_);
 		ErrorCheck(result_);
 
-		result_ = system_->init(32, FMOD_INIT_NORMAL, 0);
+		// FMOD only gets as many channels as may play at once, the voice manager decides which voices get them
+		UINT max_voices = std::max(Get::Config().max_voices, 1u);
+		result_ = system_->init(max_voices, FMOD_INIT_NORMAL, 0);
 		ErrorCheck(result_);
+
+		voice_manager_.Init(system_, max_voices);
+		clip_cache_.SetBudget(static_cast<size_t>(Get::Config().audio_memory_budget_mb) * 1024 * 1024);
 	}
 
 	//------------------------------------------------------------------------------------------------------
@@ -31,27 +41,87 @@ namespace tremble
 	//------------------------------------------------------------------------------------------------------
 	void AudioManager::AddAudioClip(AudioClip* clip)
 	{
-		audio_clips_.push_back(clip);
+		clip_cache_.Add(clip);
+	}
+
+	//------------------------------------------------------------------------------------------------------
+	void AudioManager::RemoveAudioClip(AudioClip* clip)
+	{
+		voice_manager_.StopClip(clip);
+		clip_cache_.Remove(clip);
 	}
 
     //------------------------------------------------------------------------------------------------------
     void AudioManager::UpdateAudioSystem()
     {
+        Vector3 listener_position(0.0f, 0.0f, 0.0f);
         Camera* camera = Get::Renderer()->GetCamera();
         if (camera)
         {
             SGNode* camera_node = camera->GetNode();
+            listener_position = camera_node->GetPosition();
+
+            // switching cameras or teleporting isn't a movement, the doppler effect would make everything jump in pitch
+            Vector3 listener_velocity(0.0f, 0.0f, 0.0f);
+            if (camera_node == listener_node_ && Get::DeltaT() > 0.0f)
+            {
+                listener_velocity = (listener_position - listener_position_) / Get::DeltaT();
+                if (listener_velocity.Length() > VOICE_MAX_SPEED)
+                {
+                    listener_velocity = Vector3(0.0f, 0.0f, 0.0f);
+                }
+            }
+            listener_node_ = camera_node;
+            listener_position_ = listener_position;
 
-            FMOD_VECTOR listener_pos = Vector3toFMODVector(camera_node->GetPosition());
-            FMOD_VECTOR listener_vel = Vector3toFMODVector(Vector3(0));
+            FMOD_VECTOR listener_pos = Vector3toFMODVector(listener_position);
+            FMOD_VECTOR listener_vel = Vector3toFMODVector(listener_velocity);
             FMOD_VECTOR listener_forward = Vector3toFMODVector(camera_node->GetForwardVectorWorld());
             FMOD_VECTOR listener_up = Vector3toFMODVector(camera_node->GetUpVectorWorld());
 
             system_->set3DListenerAttributes(0, &listener_pos, &listener_vel, &listener_forward, &listener_up);
         }
+
+        if (Get::Config().audio_benchmark_requests > 0)
+        {
+            BenchmarkVoices(listener_position, Get::Config().audio_benchmark_requests);
+        }
+
+        clip_cache_.Update();
+        voice_manager_.Update(listener_position, Get::DeltaT());
         system_->update();
     }
 
+    //------------------------------------------------------------------------------------------------------
+    void AudioManager::BenchmarkVoices(const Vector3& listener_position, UINT requests_per_second)
+    {
+        const std::vector<AudioClip*>& clips = clip_cache_.GetClips();
+        if (clips.empty() == true)
+        {
+            return;
+        }
+
+        benchmark_pending_requests_ += requests_per_second * Get::DeltaT();
+
+        // the requests come from a few dozen spots, like the guns of a firefight, so the same clip is often requested from the same spot
+        while (benchmark_pending_requests_ >= 1.0f)
+        {
+            UINT i = benchmark_num_requests_++;
+            UINT spot = (i * 7) % 24;
+            float angle = spot * 2.3999632f;
+            float distance = 5.0f + 75.0f * fmodf(0.5f + spot * 0.6180340f, 1.0f);
+
+            VoiceRequest request;
+            request.clip = clips[i % clips.size()];
+            request.position = listener_position + Vector3(cosf(angle) * distance, 0.0f, sinf(angle) * distance);
+            request.priority = 64 + (i % 3) * 64;
+            request.volume = static_cast<float>(Get::Config().master_volume) / 100.0f;
+            voice_manager_.Play(request);
+
+            benchmark_pending_requests_ -= 1.0f;
+        }
+    }
+
     //------------------------------------------------------------------------------------------------------
 	AudioSource * AudioManager::GetAudioSource(int channel_ID)
 	{
@@ -66,4 +136,4 @@ namespace tremble
 		audio_sources_.push_back(audio_source);
 		return int(audio_sources_.size());
 	}
-}
+}
\ No newline at end of file
@@ -1,11 +1,15 @@
 #pragma once
 
 #include "audio_clip.h"
+#include "voice_manager.h"
+#include "audio_clip_cache.h"
 #include "core/math/dxmath/vector3.h"
 #include "components/audio/audio_source.h"
 
 namespace tremble
 {
+	class SGNode;
+
 	/**
 	* @brief A class that contains the audio system and all audio clips. It also manages all the audi channels
 	* @class tremble::AudioManager
@@ -25,6 +29,8 @@ namespace tremble
 		AudioManager();
 
 		FMOD::System* GetSystem() const { return system_; } //!<Returns the system used to execute FMOD commands
+		VoiceManager* GetVoiceManager() { return &voice_manager_; } //!<Returns the voice manager all sounds are played through
+		AudioClipCache* GetClipCache() { return &clip_cache_; } //!<Returns the cache that keeps the memory of the loaded clips within the budget
 		AudioSource* GetAudioSource(int channel_ID); //!< returns the channel that the sound is playing on
 
 		int AudioManager::AddAudioSource(AudioSource* audio_source);//!<Sets audio source to the vector
@@ -34,6 +40,12 @@ namespace tremble
 		* @param[in] audio_clip pointer to an audioclip created in the createSound function
 		*/
 		void AddAudioClip(AudioClip* audio_clip);
+
+		/**
+		* Stops the voices of an audio clip that is destroyed & removes it from the cache
+		* @param[in] audio_clip pointer to the audioclip that is destroyed
+		*/
+		void RemoveAudioClip(AudioClip* audio_clip);
 //-----------------------------------------------------------------------------------------------
 		FMOD_VECTOR Vector3toFMODVector(Vector3 vector)
 		{
@@ -56,9 +68,16 @@ namespace tremble
 
         void UpdateAudioSystem();
 
+		/**
+		* Plays the clips from spread out positions around the listener, to stress the voice manager
+		* @param[in] listener_position the position of the listener
+		* @param[in] requests_per_second the number of play requests issued every second
+		*/
+		void BenchmarkVoices(const Vector3& listener_position, UINT requests_per_second);
+
 		FMOD_RESULT result_;//!< FMOD Result that can be set to any variable that is part of the FMOD library in order to check for errors
 
-		std::vector<AudioClip*> audio_clips_;//!<Vector of pointers to audio clips
+		AudioClipCache clip_cache_;//!<All audio clips, keeps the memory of the loaded ones within the budget
 
 		std::vector<AudioSource*> audio_sources_;//!<Vector of all active channels
 
@@ -69,5 +88,12 @@ namespace tremble
 							  */
 		FMOD::System* system_;
 
+		VoiceManager voice_manager_;//!< Ranks the playing voices & gives the best ones a real channel
+
+		SGNode* listener_node_;//!< The camera node the listener was at in the last update, its velocity is only known while it stays the same
+		Vector3 listener_position_;//!< The position of the listener in the last update
+
+		float benchmark_pending_requests_;//!< The play requests the voice benchmark still has to issue, carried over between frames
+		UINT benchmark_num_requests_;//!< The number of play requests the voice benchmark issued
 	};
-}
+}
\ No newline at end of file
@@ -0,0 +1,473 @@
+#include "voice_manager.h"
+
+#include "audio_manager.h"
+#include "audio_clip.h"
+#include "components/audio/audio_source.h"
+#include "core/get.h"
+#include "core/scene_graph/scene_graph.h"
+#include "../utilities/stopwatch.h"
+
+namespace tremble
+{
+	//------------------------------------------------------------------------------------------------------
+	VoiceManager::VoiceManager() :
+		system_(nullptr),
+		max_real_voices_(0),
+		num_real_voices_(0),
+		last_handle_(0),
+		time_(0.0)
+	{
+
+	}
+
+	//------------------------------------------------------------------------------------------------------
+	VoiceManager::~VoiceManager()
+	{
+		for (size_t i = 0; i < voices_.size(); i++)
+		{
+			if (voices_[i].channel != nullptr)
+			{
+				voices_[i].channel->stop();
+			}
+		}
+	}
+
+	//------------------------------------------------------------------------------------------------------
+	void VoiceManager::Init(FMOD::System* system, uint32_t max_real_voices)
+	{
+		system_ = system;
+		max_real_voices_ = max_real_voices;
+	}
+
+	//------------------------------------------------------------------------------------------------------
+	VoiceHandle VoiceManager::Play(const VoiceRequest& request)
+	{
+		stats_.num_requests++;
+
+		if (request.clip == nullptr || request.clip->GetState() == AudioClip::State::FAILED)
+		{
+			return 0;
+		}
+
+		request.clip->Request(time_);
+
+		Vector3 position = request.owner != nullptr ? request.owner->GetNode()->GetPosition() : request.position;
+		bool looping = (request.mode & (FMOD_LOOP_NORMAL | FMOD_LOOP_BIDI)) != 0;
+
+		if (looping == false)
+		{
+			Voice* one_shot = FindCoalescable(request, position);
+			if (one_shot != nullptr)
+			{
+				// the merged one-shot plays as loud as the loudest of the requests
+				one_shot->request.volume = std::max(one_shot->request.volume, request.volume);
+				one_shot->request.priority = std::min(one_shot->request.priority, request.priority);
+				if (one_shot->channel != nullptr)
+				{
+					one_shot->channel->setVolume(one_shot->request.volume);
+				}
+				stats_.num_coalesced++;
+				return one_shot->handle;
+			}
+		}
+
+		Voice voice;
+		voice.handle = ++last_handle_;
+		voice.request = request;
+		voice.channel = nullptr;
+		voice.position = position;
+		voice.velocity = Vector3(0.0f, 0.0f, 0.0f);
+		voice.moved = true;
+		voice.follows_owner = request.owner != nullptr;
+		voice.looping = looping;
+		voice.paused = false;
+		voice.selected = false;
+		voice.time = 0.0f;
+		voice.audibility = 0.0f;
+		voice.start_time = time_;
+		request.clip->AddVoice();
+
+		voice_indices_[voice.handle] = voices_.size();
+		voices_.push_back(voice);
+
+		if (looping == false)
+		{
+			recent_one_shots_.push_back(voice.handle);
+		}
+
+		stats_.peak_voices = std::max(stats_.peak_voices, static_cast<uint32_t>(voices_.size()));
+		return voice.handle;
+	}
+
+	//------------------------------------------------------------------------------------------------------
+	void VoiceManager::Stop(VoiceHandle voice, const AudioSource* owner)
+	{
+		auto it = voice_indices_.find(voice);
+		if (it != voice_indices_.end() && (owner == nullptr || voices_[it->second].request.owner == owner))
+		{
+			Remove(it->second);
+		}
+	}
+
+	//------------------------------------------------------------------------------------------------------
+	void VoiceManager::Release(VoiceHandle voice, AudioSource* owner)
+	{
+		Voice* released = Find(voice);
+		if (released == nullptr || released->request.owner != owner)
+		{
+			return;
+		}
+
+		if (released->looping == true)
+		{
+			Stop(voice, owner);
+			return;
+		}
+
+		released->request.owner = nullptr;
+		released->request.position = released->position;
+		released->velocity = Vector3(0.0f, 0.0f, 0.0f);
+		released->moved = true;
+		released->follows_owner = false;
+	}
+
+	//------------------------------------------------------------------------------------------------------
+	void VoiceManager::SetPaused(VoiceHandle voice, bool paused)
+	{
+		Voice* paused_voice = Find(voice);
+		if (paused_voice == nullptr)
+		{
+			return;
+		}
+
+		paused_voice->paused = paused;
+		if (paused == true && paused_voice->channel != nullptr)
+		{
+			Demote(*paused_voice);
+		}
+	}
+
+	//------------------------------------------------------------------------------------------------------
+	void VoiceManager::SetTime(VoiceHandle voice, float time)
+	{
+		Voice* moved_voice = Find(voice);
+		if (moved_voice == nullptr)
+		{
+			return;
+		}
+
+		moved_voice->time = std::max(time, 0.0f);
+		if (moved_voice->channel != nullptr)
+		{
+			moved_voice->channel->setPosition(static_cast<unsigned int>(moved_voice->time * 1000.0f), FMOD_TIMEUNIT_MS);
+		}
+	}
+
+	//------------------------------------------------------------------------------------------------------
+	void VoiceManager::SetPosition(VoiceHandle voice, const Vector3& position)
+	{
+		Voice* placed_voice = Find(voice);
+		if (placed_voice == nullptr)
+		{
+			return;
+		}
+
+		placed_voice->request.position = position;
+		placed_voice->position = position;
+		placed_voice->velocity = Vector3(0.0f, 0.0f, 0.0f);
+		placed_voice->moved = true;
+		placed_voice->follows_owner = false;
+	}
+
+	//------------------------------------------------------------------------------------------------------
+	void VoiceManager::StopClip(const AudioClip* clip)
+	{
+		for (size_t i = 0; i < voices_.size();)
+		{
+			if (voices_[i].request.clip == clip)
+			{
+				Remove(i);
+				continue;
+			}
+			i++;
+		}
+	}
+
+	//------------------------------------------------------------------------------------------------------
+	bool VoiceManager::IsPlaying(VoiceHandle voice) const
+	{
+		return Find(voice) != nullptr;
+	}
+
+	//------------------------------------------------------------------------------------------------------
+	FMOD::Channel* VoiceManager::GetChannel(VoiceHandle voice) const
+	{
+		const Voice* found = Find(voice);
+		return found != nullptr ? found->channel : nullptr;
+	}
+
+	//------------------------------------------------------------------------------------------------------
+	void VoiceManager::Update(const Vector3& listener_position, float delta_time)
+	{
+		Stopwatch stopwatch;
+		time_ += delta_time;
+
+		recent_one_shots_.erase(std::remove_if(recent_one_shots_.begin(), recent_one_shots_.end(), [this](VoiceHandle handle)
+		{
+			const Voice* one_shot = Find(handle);
+			return one_shot == nullptr || time_ - one_shot->start_time > VOICE_COALESCE_WINDOW;
+		}), recent_one_shots_.end());
+
+		ranked_voices_.clear();
+
+		for (size_t i = 0; i < voices_.size();)
+		{
+			Voice& voice = voices_[i];
+			const AudioClip* clip = voice.request.clip;
+
+			// real voices end when FMOD is done with their sound, virtual ones when their time runs out
+			bool ended = voice.looping == false && clip->IsReady() == true && voice.time >= clip->GetLength();
+			if (voice.channel != nullptr)
+			{
+				bool playing = false;
+				ended = voice.channel->isPlaying(&playing) != FMOD_OK || playing == false;
+			}
+
+			if (ended == true)
+			{
+				Remove(i);
+				continue;
+			}
+
+			if (voice.follows_owner == true)
+			{
+				UpdatePosition(voice, delta_time);
+			}
+
+			// FMOD's inverse rolloff, except that voices beyond their maximum distance are culled instead of staying at the volume they have there
+			float distance = (voice.position - listener_position).Length();
+			float attenuation = distance <= clip->GetMinDistance() ? 1.0f : (distance <= clip->GetMaxDistance() ? clip->GetMinDistance() / distance : 0.0f);
+			voice.audibility = voice.request.volume * attenuation;
+			voice.selected = false;
+
+			if (voice.paused == false && clip->IsReady() == true && voice.audibility >= VOICE_MIN_AUDIBILITY)
+			{
+				ranked_voices_.push_back(&voice);
+			}
+
+			i++;
+		}
+
+		size_t num_selected = std::min(ranked_voices_.size(), static_cast<size_t>(max_real_voices_));
+		if (ranked_voices_.size() > num_selected)
+		{
+			std::nth_element(ranked_voices_.begin(), ranked_voices_.begin() + num_selected, ranked_voices_.end(), [](const Voice* a, const Voice* b)
+			{
+				if (a->request.priority != b->request.priority)
+				{
+					return a->request.priority < b->request.priority;
+				}
+
+				float a_score = a->audibility * (a->channel != nullptr ? VOICE_REAL_BIAS : 1.0f);
+				float b_score = b->audibility * (b->channel != nullptr ? VOICE_REAL_BIAS : 1.0f);
+				if (a_score != b_score)
+				{
+					return a_score > b_score;
+				}
+
+				return a->start_time > b->start_time;
+			});
+		}
+
+		for (size_t i = 0; i < num_selected; i++)
+		{
+			ranked_voices_[i]->selected = true;
+		}
+
+		// channels are taken away first, so the promoted voices find them free
+		for (size_t i = 0; i < voices_.size(); i++)
+		{
+			if (voices_[i].channel != nullptr && voices_[i].selected == false)
+			{
+				Demote(voices_[i]);
+			}
+		}
+
+		for (size_t i = 0; i < num_selected; i++)
+		{
+			if (ranked_voices_[i]->channel == nullptr)
+			{
+				Promote(*ranked_voices_[i]);
+			}
+		}
+
+		Apply3DAttributes();
+
+		for (size_t i = 0; i < voices_.size(); i++)
+		{
+			if (voices_[i].paused == false && voices_[i].request.clip->IsReady() == true)
+			{
+				voices_[i].time += delta_time * voices_[i].request.pitch;
+			}
+		}
+
+		stats_.peak_real_voices = std::max(stats_.peak_real_voices, num_real_voices_);
+		stats_.update_time += stopwatch.Output() * 1000.0f;
+		stats_.num_updates++;
+	}
+
+	//------------------------------------------------------------------------------------------------------
+	void VoiceManager::UpdatePosition(Voice& voice, float delta_time)
+	{
+		// the position is compared instead of checking SGNode::WasMoved, the moved flags are reset partway through the frame,
+		// so nodes that were moved before that, e.g. in UpdateBeforePhysics, would never be heard moving
+		Vector3 position = voice.request.owner->GetNode()->GetPosition();
+		if (position == voice.position)
+		{
+			// a node that stopped moving keeps its position, but its voice no longer has a velocity
+			if (voice.velocity != Vector3(0.0f, 0.0f, 0.0f))
+			{
+				voice.velocity = Vector3(0.0f, 0.0f, 0.0f);
+				voice.moved = true;
+			}
+			return;
+		}
+
+		Vector3 velocity = delta_time > 0.0f ? (position - voice.position) / delta_time : Vector3(0.0f, 0.0f, 0.0f);
+
+		voice.velocity = velocity.Length() <= VOICE_MAX_SPEED ? velocity : Vector3(0.0f, 0.0f, 0.0f);
+		voice.position = position;
+		voice.moved = true;
+		stats_.num_moved++;
+	}
+
+	//------------------------------------------------------------------------------------------------------
+	void VoiceManager::Apply3DAttributes()
+	{
+		AudioManager* audio_manager = Get::AudioManager();
+		for (size_t i = 0; i < voices_.size(); i++)
+		{
+			Voice& voice = voices_[i];
+			if (voice.channel == nullptr || voice.moved == false)
+			{
+				continue;
+			}
+
+			FMOD_VECTOR position = audio_manager->Vector3toFMODVector(voice.position);
+			FMOD_VECTOR velocity = audio_manager->Vector3toFMODVector(voice.velocity);
+			voice.channel->set3DAttributes(&position, &velocity);
+			voice.moved = false;
+			stats_.num_attribute_updates++;
+		}
+	}
+
+	//------------------------------------------------------------------------------------------------------
+	VoiceManager::Voice* VoiceManager::Find(VoiceHandle voice)
+	{
+		auto it = voice_indices_.find(voice);
+		return it != voice_indices_.end() ? &voices_[it->second] : nullptr;
+	}
+
+	//------------------------------------------------------------------------------------------------------
+	const VoiceManager::Voice* VoiceManager::Find(VoiceHandle voice) const
+	{
+		auto it = voice_indices_.find(voice);
+		return it != voice_indices_.end() ? &voices_[it->second] : nullptr;
+	}
+
+	//------------------------------------------------------------------------------------------------------
+	void VoiceManager::Remove(size_t index)
+	{
+		Voice& voice = voices_[index];
+		if (voice.channel != nullptr)
+		{
+			voice.channel->stop();
+			num_real_voices_--;
+		}
+
+		voice_indices_.erase(voice.handle);
+		voice.request.clip->RemoveVoice();
+
+		if (index + 1 < voices_.size())
+		{
+			voice = voices_.back();
+			voice_indices_[voice.handle] = index;
+		}
+		voices_.pop_back();
+	}
+
+	//------------------------------------------------------------------------------------------------------
+	VoiceManager::Voice* VoiceManager::FindCoalescable(const VoiceRequest& request, const Vector3& position)
+	{
+		for (size_t i = 0; i < recent_one_shots_.size(); i++)
+		{
+			Voice* one_shot = Find(recent_one_shots_[i]);
+			if (one_shot != nullptr &&
+				one_shot->request.clip == request.clip &&
+				time_ - one_shot->start_time <= VOICE_COALESCE_WINDOW &&
+				(one_shot->position - position).Length() <= VOICE_COALESCE_DISTANCE)
+			{
+				return one_shot;
+			}
+		}
+
+		return nullptr;
+	}
+
+	//------------------------------------------------------------------------------------------------------
+	bool VoiceManager::Promote(Voice& voice)
+	{
+		AudioClip* clip = voice.request.clip;
+
+		// a stream is read by a single channel, a second voice of it waits until the first one ends or loses its channel
+		if (clip->GetLoadMode() == AudioClip::LoadMode::STREAMED)
+		{
+			for (size_t i = 0; i < voices_.size(); i++)
+			{
+				if (voices_[i].request.clip == clip && voices_[i].channel != nullptr)
+				{
+					return false;
+				}
+			}
+		}
+
+		FMOD::Channel* channel = nullptr;
+		if (system_->playSound(FMOD_CHANNEL_FREE, clip->sound, true, &channel) != FMOD_OK || channel == nullptr)
+		{
+			return false;
+		}
+
+		FMOD_VECTOR position = Get::AudioManager()->Vector3toFMODVector(voice.position);
+		FMOD_VECTOR velocity = Get::AudioManager()->Vector3toFMODVector(voice.velocity);
+		channel->setVolume(voice.request.volume);
+		channel->setPan(voice.request.pan);
+		channel->setMode(voice.request.mode);
+		channel->setFrequency(clip->GetFrequency() * voice.request.pitch);
+		channel->setPriority(std::max(0, std::min(voice.request.priority, 256)));
+		channel->set3DAttributes(&position, &velocity);
+
+		// a voice that was virtual for a while continues where it would have been
+		if (voice.time > 0.0f)
+		{
+			float time = voice.looping == true && clip->GetLength() > 0.0f ? fmodf(voice.time, clip->GetLength()) : voice.time;
+			channel->setPosition(static_cast<unsigned int>(time * 1000.0f), FMOD_TIMEUNIT_MS);
+		}
+
+		channel->setPaused(false);
+
+		voice.channel = channel;
+		voice.moved = false;
+		num_real_voices_++;
+		stats_.num_promotions++;
+		return true;
+	}
+
+	//------------------------------------------------------------------------------------------------------
+	void VoiceManager::Demote(Voice& voice)
+	{
+		voice.channel->stop();
+		voice.channel = nullptr;
+		num_real_voices_--;
+		stats_.num_demotions++;
+	}
+}
\ No newline at end of file
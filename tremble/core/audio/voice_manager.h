@@ -0,0 +1,180 @@
+#pragma once
+
+#include "fmod.hpp"
+#include "core/math/dxmath/vector3.h"
+
+#define VOICE_DEFAULT_PRIORITY 128 // the priority of voices that don't set one, like FMOD lower values are more important
+#define VOICE_MIN_AUDIBILITY 0.01f // voices quieter than this after distance attenuation (-40 dB) are never given a real channel
+#define VOICE_REAL_BIAS 1.25f // real voices count as this much more audible when ranked, so voices of about the same audibility don't keep swapping
+#define VOICE_COALESCE_WINDOW 0.05f // identical one-shots started within this many seconds of each other are played as one voice
+#define VOICE_COALESCE_DISTANCE 2.0f // identical one-shots are only coalesced if they start at most this far apart
+#define VOICE_MAX_SPEED 100.0f // moves faster than this many units per second are teleports, they don't get a velocity so they don't cause a doppler spike
+
+namespace tremble
+{
+	class AudioSource;
+	class AudioClip;
+
+	typedef uint32_t VoiceHandle; //!< Identifies a voice, 0 is never a valid voice
+
+	/**
+	* @struct tremble::VoiceRequest
+	* @brief Everything a voice needs to start playing
+	*/
+	struct VoiceRequest
+	{
+		AudioClip* clip = nullptr; //!< The clip to play
+		AudioSource* owner = nullptr; //!< The source that plays the voice, the voice follows its node, nullptr for a voice at a fixed position
+		Vector3 position = Vector3(0.0f, 0.0f, 0.0f); //!< The position of the voice if it has no owner
+		int priority = VOICE_DEFAULT_PRIORITY; //!< The priority of the voice, lower values are more important
+		float volume = 1.0f; //!< The volume of the voice
+		float pitch = 1.0f; //!< The pitch of the voice, as a multiplier of the clip's frequency
+		float pan = 0.0f; //!< The pan of the voice
+		FMOD_MODE mode = FMOD_LOOP_OFF; //!< The mode of the voice's channel
+	};
+
+	/**
+	* @struct tremble::VoiceStats
+	* @brief What the voice manager did since it started
+	*/
+	struct VoiceStats
+	{
+		uint64_t num_requests = 0; //!< The number of voices that were requested
+		uint64_t num_coalesced = 0; //!< The number of requests that were merged into a voice that had just started
+		uint64_t num_promotions = 0; //!< The number of times a virtual voice was given a real channel
+		uint64_t num_demotions = 0; //!< The number of times a real voice lost its channel
+		uint64_t num_updates = 0; //!< The number of updates
+		uint64_t num_moved = 0; //!< The number of times a voice was moved because the node of its owner moved
+		uint64_t num_attribute_updates = 0; //!< The number of times the 3D attributes of a real channel were set
+		float update_time = 0.0f; //!< The time spent updating the voices, in milliseconds
+		uint32_t peak_voices = 0; //!< The most voices that played at once, real & virtual
+		uint32_t peak_real_voices = 0; //!< The most voices that had a real channel at once
+	};
+
+	/**
+	* @class tremble::VoiceManager
+	* @brief Decides which of the playing voices get one of the few real FMOD channels
+	*
+	* Sources don't play on channels of their own, they request voices. Every update the voices are ranked by priority,
+	* audibility (volume & distance attenuation from the listener) & age, the best ones get a real channel & the rest
+	* become virtual: they keep their place in the sound, but aren't decoded or mixed until they're audible & important
+	* enough again. Voices beyond the listener's hearing are culled this way too. Identical one-shots that start at
+	* nearly the same place & time, like the shots of a burst, are merged into one voice. Voices of clips that are
+	* still loading wait, without their time running, until the clip is ready.
+	*
+	* Voices that follow their owner get a velocity from the distance its node moved since the last update, for the
+	* doppler effect. Only the 3D attributes of the real voices that moved or stopped moving are set, in one pass at
+	* the end of the update, right before FMOD's own update.
+	*/
+	class VoiceManager
+	{
+	public:
+		VoiceManager();
+		~VoiceManager(); //!< Stops the real voices
+
+		/**
+		* @brief Sets the system the voices are played with
+		* @param[in] system The FMOD system, initialized with at least max_real_voices channels
+		* @param[in] max_real_voices The maximum number of voices that play at once
+		*/
+		void Init(FMOD::System* system, uint32_t max_real_voices);
+
+		/**
+		* @brief Starts a voice, it gets a real channel during the next update if it's important enough & its clip is ready
+		* @param[in] request The clip & settings of the voice
+		* @return The voice, or the one-shot it was merged with
+		*/
+		VoiceHandle Play(const VoiceRequest& request);
+
+		/**
+		* @brief Stops a voice
+		* @param[in] voice The voice, stopping voices that already ended does nothing
+		* @param[in] owner The source that stops the voice, a one-shot another source started keeps playing, nullptr stops any voice
+		*/
+		void Stop(VoiceHandle voice, const AudioSource* owner = nullptr);
+
+		/**
+		* @brief Stops a source's looping voice & lets its one-shot finish at the last position of the source
+		* @param[in] voice The voice of the source
+		* @param[in] owner The source that is going away
+		*/
+		void Release(VoiceHandle voice, AudioSource* owner);
+
+		void SetPaused(VoiceHandle voice, bool paused); //!< Pauses or resumes a voice, paused voices never hold a real channel
+		void SetTime(VoiceHandle voice, float time); //!< Moves a voice to a time in its clip, in seconds
+		void StopClip(const AudioClip* clip); //!< Stops all voices of a clip that is destroyed
+		void SetPosition(VoiceHandle voice, const Vector3& position); //!< Places a voice at a fixed position, it no longer follows its owner
+		bool IsPlaying(VoiceHandle voice) const; //!< Whether a voice is still playing, virtual & paused voices are playing too
+		FMOD::Channel* GetChannel(VoiceHandle voice) const; //!< The real channel of a voice, nullptr if it has none
+
+		/**
+		* @brief Ranks the voices, moves the real channels to the best ones & ends the voices that finished
+		* @param[in] listener_position The position the voices are heard from
+		* @param[in] delta_time The time since the last update, in seconds
+		*/
+		void Update(const Vector3& listener_position, float delta_time);
+
+		uint32_t GetNumVoices() const { return static_cast<uint32_t>(voices_.size()); } //!< The number of playing voices, real & virtual
+		uint32_t GetNumRealVoices() const { return num_real_voices_; } //!< The number of voices with a real channel
+		const VoiceStats& GetStats() const { return stats_; } //!< What the voice manager did since it started
+
+	private:
+		/**
+		* @struct tremble::VoiceManager::Voice
+		* @brief A playing sound & the channel it plays on, if it has one
+		*/
+		struct Voice
+		{
+			VoiceHandle handle; //!< The handle the voice is known by
+			VoiceRequest request; //!< The clip & settings the voice was started with
+			FMOD::Channel* channel; //!< The real channel of the voice, nullptr while it's virtual
+			Vector3 position; //!< The position of the voice in the last update
+			Vector3 velocity; //!< The velocity of the voice in the last update, in units per second
+			bool moved; //!< Whether the position or velocity changed since the 3D attributes of its channel were set
+			bool follows_owner; //!< Whether the voice moves with the node of its owner
+			bool looping; //!< Whether the sound loops
+			bool paused; //!< Whether the voice is paused
+			bool selected; //!< Whether the voice was ranked high enough for a real channel in the current update
+			float time; //!< The time the voice is at in its clip, in seconds
+			float audibility; //!< How loud the voice is at the listener, from 0 to its volume
+			double start_time; //!< The time the voice started
+		};
+
+		Voice* Find(VoiceHandle voice); //!< The voice with a handle, nullptr if it ended
+		const Voice* Find(VoiceHandle voice) const; //!< The voice with a handle, nullptr if it ended
+		void Remove(size_t index); //!< Ends a voice & moves the last voice in its place
+
+		/**
+		* @brief Finds a one-shot that was started just now with the same clip at about the same position
+		* @param[in] request The request of the new one-shot
+		* @param[in] position The position of the new one-shot
+		* @return The one-shot, nullptr if there is none
+		*/
+		Voice* FindCoalescable(const VoiceRequest& request, const Vector3& position);
+
+		/**
+		* @brief Reads the position of a voice that follows its owner again & marks it as moved if the owner's node moved
+		* @param[in] voice The voice
+		* @param[in] delta_time The time since the last update, in seconds
+		*/
+		void UpdatePosition(Voice& voice, float delta_time);
+
+		void Apply3DAttributes(); //!< Sets the 3D attributes of all real voices that moved at once
+
+		bool Promote(Voice& voice); //!< Gives a virtual voice a real channel, at the time it's at in its clip
+		void Demote(Voice& voice); //!< Takes the real channel away from a voice
+
+		FMOD::System* system_; //!< The system the voices are played with
+		uint32_t max_real_voices_; //!< The maximum number of voices with a real channel
+		uint32_t num_real_voices_; //!< The number of voices with a real channel
+		VoiceHandle last_handle_; //!< The last handle that was handed out
+		double time_; //!< The time since the voice manager started, in seconds
+
+		std::vector<Voice> voices_; //!< The playing voices
+		std::unordered_map<VoiceHandle, size_t> voice_indices_; //!< The index of every playing voice
+		std::vector<VoiceHandle> recent_one_shots_; //!< The one-shots that started within the coalesce window
+		std::vector<Voice*> ranked_voices_; //!< The audible voices of the current update, kept to not allocate every update
+
+		VoiceStats stats_; //!< What the voice manager did since it started
+	};
+}
\ No newline at end of file
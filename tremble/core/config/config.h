@@ -28,5 +28,59 @@ namespace tremble
 		std::string nickname = "Optic[S0_L3g1t]";
 		bool spawn_clients = false;
 		UINT num_clients = 0;
+		bool optimize_meshes = true;
+		bool mesh_optimization_report = false;
+		bool compressed_vertices = false;
+		bool release_mesh_data = false;
+		bool mesh_memory_report = false;
+		bool hot_reload = false;
+		UINT hot_reload_interval = 250;
+		bool instanced_rendering = true;
+		UINT shadow_cascades = 0;
+		bool render_thread = false;
+		bool null_render_backend = false;
+		UINT benchmark_frames = 0;
+		UINT query_benchmark_rays = 0;
+		UINT lag_compensation_ms = 200;
+		bool collision_cache = true;
+		bool merge_static_geometry = true;
+		std::string physics_stats_file = "";
+		UINT max_voices = 32;
+		UINT audio_benchmark_requests = 0;
+		UINT audio_memory_budget_mb = 64;
 	};
+
+	/**
+	* @def TREMBLE_CONFIG_STARTUP_FIELDS(FIELD)
+	* Calls FIELD for every config field that is only read while starting up. Changing them at runtime would leave the
+	* engine in a mixed state, so a reloaded config keeps their old values. New startup-only fields have to be added here.
+	*/
+#define TREMBLE_CONFIG_STARTUP_FIELDS(FIELD) \
+	FIELD(fullscreen) \
+	FIELD(adapter) \
+	FIELD(window_resolution) \
+	FIELD(render_resolution) \
+	FIELD(scene) \
+	FIELD(load_scene) \
+	FIELD(physics_base_plane) \
+	FIELD(d3d12_debug_layer) \
+	FIELD(wireframe_rendering) \
+	FIELD(light_demo) \
+	FIELD(num_lights) \
+	FIELD(host) \
+	FIELD(host_ip_address) \
+	FIELD(nickname) \
+	FIELD(spawn_clients) \
+	FIELD(num_clients) \
+	FIELD(compressed_vertices) \
+	FIELD(hot_reload) \
+	FIELD(hot_reload_interval) \
+	FIELD(render_thread) \
+	FIELD(null_render_backend) \
+	FIELD(benchmark_frames) \
+	FIELD(collision_cache) \
+	FIELD(merge_static_geometry) \
+	FIELD(physics_stats_file) \
+	FIELD(max_voices) \
+	FIELD(audio_memory_budget_mb)
 }
\ No newline at end of file
@@ -10,8 +10,26 @@ using namespace std::tr2::sys;
 namespace tremble
 {
 	//------------------------------------------------------------------------------------------------------
-	ConfigManager::ConfigManager()
+	ConfigManager::ConfigManager(UINT headless_frames) :
+		main_window_(nullptr),
+		setup_dialog_(nullptr),
+		running_(false)
 	{
+		if (headless_frames > 0)
+		{
+			// no dialog & no adapters, creating a device to test the adapters would need a GPU
+			FindAvailableWindowResolutions();
+			FindAvailableRenderResolutions();
+			FindAvailableScenes();
+
+			ConfigParser parser;
+			config_ = parser.Parse(TREMBLE_CONFIG_PATH);
+			config_.fullscreen = false;
+			config_.null_render_backend = true;
+			config_.benchmark_frames = headless_frames;
+			return;
+		}
+
 		int argc = 0;
 		QApplication QApp(argc, nullptr);
 
@@ -38,7 +56,7 @@ namespace tremble
 		FillSceneBox();
 
 		ConfigParser parser;
-		config_ = parser.Parse("../../config.cfg");
+		config_ = parser.Parse(TREMBLE_CONFIG_PATH);
 
 		setup_dialog_->is_fullscreen->setChecked(config_.fullscreen);
 		setup_dialog_->selection_gpu->setCurrentIndex(config_.adapter < available_adapters_.size() ? config_.adapter : 0);
@@ -113,6 +131,20 @@ namespace tremble
 		return config_;
 	}
 
+	//------------------------------------------------------------------------------------------------------
+	void ConfigManager::Reload()
+	{
+		ConfigParser parser;
+		Config reloaded = parser.Parse(TREMBLE_CONFIG_PATH);
+
+		// the startup-only fields keep the values the engine was started with
+#define KEEP_STARTUP_FIELD(field) reloaded.field = config_.field;
+		TREMBLE_CONFIG_STARTUP_FIELDS(KEEP_STARTUP_FIELD)
+#undef KEEP_STARTUP_FIELD
+
+		config_ = reloaded;
+	}
+
 	//------------------------------------------------------------------------------------------------------
 	void ConfigManager::Launch()
 	{
@@ -139,7 +171,7 @@ namespace tremble
 		config_.num_clients = static_cast<UINT>(setup_dialog_->num_clients->value());
 
 		ConfigParser parser;
-		parser.Serialize("../../config.cfg", config_);
+		parser.Serialize(TREMBLE_CONFIG_PATH, config_);
 
 		delete setup_dialog_;
 		delete main_window_;
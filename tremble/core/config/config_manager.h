@@ -4,13 +4,20 @@
 #include "design/config_design.h"
 #include "config.h"
 
+#define TREMBLE_CONFIG_PATH "../../config.cfg"
+
 namespace tremble
 {
 	class ConfigManager : public QObject
 	{
 		Q_OBJECT
 	public:
-		ConfigManager();
+		/**
+		* @brief Reads the config & lets the user change it in the setup dialog
+		* @param[in] headless_frames Skips the setup dialog & the adapter enumeration when non-zero, the config file is used as
+		* is, except that the engine renders through the null render backend in a window & stops after this many frames
+		*/
+		explicit ConfigManager(UINT headless_frames = 0);
 		~ConfigManager();
 
 		const std::vector<IDXGIAdapter1*>& GetAdapters() { return available_adapters_; }
@@ -20,6 +27,11 @@ namespace tremble
 
 		const Config& GetConfig();
 
+		/**
+		* @brief Re-reads the config file; settings that are baked in at startup (device, window, scene, networking, vertex format) keep their current value
+		*/
+		void Reload();
+
 	public slots:
 		void Launch();
 		void Shutdown();
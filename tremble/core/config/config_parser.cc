@@ -65,6 +65,26 @@ namespace tremble
 		ret.nickname			= obj.find("nickname")				!= obj.end() ? obj.at("nickname").get<std::string>()							: 0;
 		ret.spawn_clients		= obj.find("spawn_clients")			!= obj.end() ? obj.at("spawn_clients").get<bool>()								: false;
 		ret.num_clients			= obj.find("num_clients")			!= obj.end() ? static_cast<UINT>(obj.at("num_clients").get<int64_t>())			: 0;
+		ret.optimize_meshes		= obj.find("optimize_meshes")		!= obj.end() ? obj.at("optimize_meshes").get<bool>()							: true;
+		ret.mesh_optimization_report = obj.find("mesh_optimization_report") != obj.end() ? obj.at("mesh_optimization_report").get<bool>()		: false;
+		ret.compressed_vertices	= obj.find("compressed_vertices")	!= obj.end() ? obj.at("compressed_vertices").get<bool>()						: false;
+		ret.release_mesh_data	= obj.find("release_mesh_data")		!= obj.end() ? obj.at("release_mesh_data").get<bool>()							: false;
+		ret.mesh_memory_report	= obj.find("mesh_memory_report")	!= obj.end() ? obj.at("mesh_memory_report").get<bool>()							: false;
+		ret.hot_reload			= obj.find("hot_reload")			!= obj.end() ? obj.at("hot_reload").get<bool>()									: false;
+		ret.hot_reload_interval	= obj.find("hot_reload_interval")	!= obj.end() ? static_cast<UINT>(obj.at("hot_reload_interval").get<int64_t>())	: 250;
+		ret.instanced_rendering	= obj.find("instanced_rendering")	!= obj.end() ? obj.at("instanced_rendering").get<bool>()						: true;
+		ret.shadow_cascades		= obj.find("shadow_cascades")		!= obj.end() ? static_cast<UINT>(obj.at("shadow_cascades").get<int64_t>())		: 0;
+		ret.render_thread		= obj.find("render_thread")			!= obj.end() ? obj.at("render_thread").get<bool>()								: false;
+		ret.null_render_backend	= obj.find("null_render_backend")	!= obj.end() ? obj.at("null_render_backend").get<bool>()						: false;
+		ret.benchmark_frames	= obj.find("benchmark_frames")		!= obj.end() ? static_cast<UINT>(obj.at("benchmark_frames").get<int64_t>())		: 0;
+		ret.query_benchmark_rays = obj.find("query_benchmark_rays")	!= obj.end() ? static_cast<UINT>(obj.at("query_benchmark_rays").get<int64_t>())	: 0;
+		ret.lag_compensation_ms	= obj.find("lag_compensation_ms")	!= obj.end() ? static_cast<UINT>(obj.at("lag_compensation_ms").get<int64_t>())	: 200;
+		ret.collision_cache		= obj.find("collision_cache")		!= obj.end() ? obj.at("collision_cache").get<bool>()							: true;
+		ret.merge_static_geometry = obj.find("merge_static_geometry") != obj.end() ? obj.at("merge_static_geometry").get<bool>()				: true;
+		ret.physics_stats_file	= obj.find("physics_stats_file")	!= obj.end() ? obj.at("physics_stats_file").get<std::string>()					: "";
+		ret.max_voices			= obj.find("max_voices")			!= obj.end() ? static_cast<UINT>(obj.at("max_voices").get<int64_t>())			: 32;
+		ret.audio_benchmark_requests = obj.find("audio_benchmark_requests") != obj.end() ? static_cast<UINT>(obj.at("audio_benchmark_requests").get<int64_t>()) : 0;
+		ret.audio_memory_budget_mb = obj.find("audio_memory_budget_mb") != obj.end() ? static_cast<UINT>(obj.at("audio_memory_budget_mb").get<int64_t>()) : 64;
 
 		return ret;
 	}
@@ -94,7 +114,27 @@ namespace tremble
 			std::pair<std::string, picojson::value>("host_ip_address", picojson::value(config.host_ip_address)),
 			std::pair<std::string, picojson::value>("nickname", picojson::value(config.nickname)),
 			std::pair<std::string, picojson::value>("spawn_clients", picojson::value(config.spawn_clients)),
-			std::pair<std::string, picojson::value>("num_clients", picojson::value(static_cast<double>(config.num_clients)))
+			std::pair<std::string, picojson::value>("num_clients", picojson::value(static_cast<double>(config.num_clients))),
+			std::pair<std::string, picojson::value>("optimize_meshes", picojson::value(config.optimize_meshes)),
+			std::pair<std::string, picojson::value>("mesh_optimization_report", picojson::value(config.mesh_optimization_report)),
+			std::pair<std::string, picojson::value>("compressed_vertices", picojson::value(config.compressed_vertices)),
+			std::pair<std::string, picojson::value>("release_mesh_data", picojson::value(config.release_mesh_data)),
+			std::pair<std::string, picojson::value>("mesh_memory_report", picojson::value(config.mesh_memory_report)),
+			std::pair<std::string, picojson::value>("hot_reload", picojson::value(config.hot_reload)),
+			std::pair<std::string, picojson::value>("hot_reload_interval", picojson::value(static_cast<double>(config.hot_reload_interval))),
+			std::pair<std::string, picojson::value>("instanced_rendering", picojson::value(config.instanced_rendering)),
+			std::pair<std::string, picojson::value>("shadow_cascades", picojson::value(static_cast<double>(config.shadow_cascades))),
+			std::pair<std::string, picojson::value>("render_thread", picojson::value(config.render_thread)),
+			std::pair<std::string, picojson::value>("null_render_backend", picojson::value(config.null_render_backend)),
+			std::pair<std::string, picojson::value>("benchmark_frames", picojson::value(static_cast<double>(config.benchmark_frames))),
+			std::pair<std::string, picojson::value>("query_benchmark_rays", picojson::value(static_cast<double>(config.query_benchmark_rays))),
+			std::pair<std::string, picojson::value>("lag_compensation_ms", picojson::value(static_cast<double>(config.lag_compensation_ms))),
+			std::pair<std::string, picojson::value>("collision_cache", picojson::value(config.collision_cache)),
+			std::pair<std::string, picojson::value>("merge_static_geometry", picojson::value(config.merge_static_geometry)),
+			std::pair<std::string, picojson::value>("physics_stats_file", picojson::value(config.physics_stats_file)),
+			std::pair<std::string, picojson::value>("max_voices", picojson::value(static_cast<double>(config.max_voices))),
+			std::pair<std::string, picojson::value>("audio_benchmark_requests", picojson::value(static_cast<double>(config.audio_benchmark_requests))),
+			std::pair<std::string, picojson::value>("audio_memory_budget_mb", picojson::value(static_cast<double>(config.audio_memory_budget_mb)))
 		};
 
 		picojson::value v = picojson::value(picojson::object(list));
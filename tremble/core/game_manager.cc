@@ -3,6 +3,9 @@
 #include "win32/window.h"
 #include "input/input_manager.h"
 #include "rendering/renderer.h"
+#include "rendering/frame_extractor.h"
+#include "rendering/render_thread.h"
+#include "rendering/null_render_backend.h"
 #include "rendering/command_manager.h"
 #include "rendering/command_context_manager.h"
 #include "utilities/timer.h"
@@ -12,11 +15,13 @@
 #include "resources/resource_manager.h"
 #include "resources/fbx_loader.h"
 #include "physics/physics_manager.h"
+#include "physics/lag_compensation.h"
 #include "audio/audio_manager.h"
 #include "networking/network_manager.h"
 #include "networking/serialization_manager.h"
 #include "networking/packet_factory.h"
 #include "utilities/octree.h"
+#include "resources/hot_reload_manager.h"
 #include "get.h"
 
 #include "utilities\stopwatch.h"
@@ -48,7 +53,10 @@ namespace tremble
 		running_(true), 
 		memory_manager_(memory_manager), 
 		own_allocator_(own_allocator),
-		subsystem_allocator_(nullptr)
+		subsystem_allocator_(nullptr),
+		null_backend_(nullptr),
+		benchmark_extract_time_(0.0),
+		lag_compensation_(nullptr)
 	{
 		Get::Create(this);
 	}
@@ -60,29 +68,50 @@ namespace tremble
 	}
 
 	//------------------------------------------------------------------------------------------------------
-	void GameManager::Startup(const std::string& name, int width, int height)
+	void GameManager::Startup(const std::string& name, int width, int height, UINT headless_frames)
 	{
-		subsystem_allocator_		= memory_manager_->GetNewAllocator<StackAllocator>(40000);
+		subsystem_allocator_		= memory_manager_->GetNewAllocator<StackAllocator>(55000);
 
 		packet_factory_				= subsystem_allocator_->New<PacketFactory>(1000);
 		network_manager_			= subsystem_allocator_->New<NetworkManager>(1000000);
-		config_manager_				= subsystem_allocator_->New<ConfigManager>();
+		config_manager_				= subsystem_allocator_->New<ConfigManager>(headless_frames);
 		window_						= subsystem_allocator_->New<Window>(name, config_manager_->GetWindowResolutions()[config_manager_->GetConfig().window_resolution].width, config_manager_->GetWindowResolutions()[config_manager_->GetConfig().window_resolution].height, this);
 		input_manager_				= subsystem_allocator_->New<InputManager>(window_, this);
 		audio_manager_				= subsystem_allocator_->New<AudioManager>();
+		hot_reload_manager_			= subsystem_allocator_->New<HotReloadManager>();
 		resource_manager_			= subsystem_allocator_->New<ResourceManager>();
 		
 		renderer_					= subsystem_allocator_->New<Renderer>();
 		command_manager_			= subsystem_allocator_->New<CommandManager>();
 		command_context_manager_	= subsystem_allocator_->New<CommandContextManager>();
-		renderer_->Startup();
+
+		// the null backend runs the CPU side of rendering without drawing anything, e.g. to benchmark it headless, so the
+		// device, swap chain & other GPU resources aren't created & it also runs on machines without a GPU
+		if (config_manager_->GetConfig().null_render_backend == true)
+		{
+			null_backend_			= subsystem_allocator_->New<NullRenderBackend>();
+			null_backend_->SetDepthPrePass(config_manager_->GetConfig().depth_pre_pass);
+			null_backend_->SetInstancing(config_manager_->GetConfig().instanced_rendering);
+		}
+		else
+		{
+			renderer_->Startup();
+		}
+
+		frame_extractor_			= subsystem_allocator_->New<FrameExtractor>();
+
+		render_thread_				= subsystem_allocator_->New<RenderThread>();
+		render_thread_->Start(null_backend_ != nullptr ? static_cast<RenderBackend*>(null_backend_) : renderer_, config_manager_->GetConfig().render_thread);
 
 		timer_						= subsystem_allocator_->New<Timer>();
 		component_manager_			= subsystem_allocator_->New<ComponentManager>(100000000);
+		lag_compensation_			= subsystem_allocator_->New<LagCompensation>();
         octree_                     = subsystem_allocator_->New<Octree>(DirectX::BoundingBox(DirectX::XMFLOAT3(0.0f, 0.0f, 0.0f), DirectX::XMFLOAT3(17500.0f, 17500.0f, 17500.0f)));
 		scene_						= subsystem_allocator_->New<Scene>(1000000);
 		physics_manager_			= subsystem_allocator_->New<PhysicsManager>(10000000); // @TODO tell mr gavrilov to make the PhysicsManager subsystem allocation compliant
         scene_loader_               = subsystem_allocator_->New<SceneLoader>();
+
+		hot_reload_manager_->Watch(TREMBLE_CONFIG_PATH, HotReloadManager::AssetTypeConfig);
 	}
 
 	//------------------------------------------------------------------------------------------------------
@@ -94,6 +123,7 @@ namespace tremble
 		{
 			timer_->UpdateTimer();
 			window_->ProcessMessages();
+			hot_reload_manager_->Update(); // the previous frame is done, so assets can be swapped before anything references them this frame
             component_manager_->Start();
 			component_manager_->UpdateBeforePhysics();
             scene_->ResetMovedByPhysics_(); //Reset the object moved since last frame by physics tag
@@ -103,22 +133,116 @@ namespace tremble
             input_manager_->SendInput();
             scene_->ResetMovedByUser_(); //Reset the object moved since last frame by user tag
 			component_manager_->Update();
-            audio_manager_->UpdateAudioSystem();
+			physics_manager_->ExecuteQueries(); // the queries queued during the update, their results are read next frame
 			network_manager_->GetSerializationManager().Serialize();
             network_manager_->Listen(); //Network manager's listen is here, because 
             //1 - it can add new components, therefore it cannot be between start and update, because the components will start to
             //update before they start (can add an add queue to circumvent that)
             //2 - it canchange positions of objects, therefore it has to be between the resetting of the moved by user flag and octree
             //update, because otherwise the frustrum culling fucks up
+			if (network_manager_->IsHost() == true)
+			{
+				// after Listen, so the recorded poses of the remote players are the ones that were just sent to the clients
+				lag_compensation_->Record(timer_->GetTimeSinceStartup());
+			}
+			audio_manager_->UpdateAudioSystem(); // after everything that moves nodes this frame, including the remote players Listen moved, so the voices & their velocities are heard where the nodes are drawn
 			octree_->Update();
 			//octree_->Draw();
-			renderer_->Draw(timer_);
+			if (null_backend_ == nullptr && renderer_->GetSpriteRenderer()->IsAtlasDirty() == true)
+			{
+				// the interface textures drawn for the first time last frame are packed before this frame's sprites are extracted
+				render_thread_->WaitForIdle();
+				renderer_->GetSpriteRenderer()->UpdateAtlas();
+			}
+			FramePacket& packet = render_thread_->AcquirePacket(); // with the render thread enabled, the packet is rendered while the next frame is simulated
+			frame_extractor_->Extract(packet, renderer_->GetCamera(), timer_, renderer_->GetDebugVolumes(), renderer_->GetVirtualSizeX(), renderer_->GetVirtualSizeY());
+			render_thread_->Submit(packet);
+			UpdateBenchmark();
             component_manager_->ClearDeletionQueue_();
             SGNode::ClearDeletionQueue_();
             memory_manager_->ClearTemp_();
 		}
 	}
 
+	//------------------------------------------------------------------------------------------------------
+	void GameManager::UpdateBenchmark()
+	{
+		UINT num_frames = config_manager_->GetConfig().benchmark_frames;
+		if (num_frames == 0)
+		{
+			return;
+		}
+
+		benchmark_extract_time_ += frame_extractor_->GetExtractTime();
+
+		if (render_thread_->GetNumFrames() < num_frames)
+		{
+			return;
+		}
+
+		// the last packets may still be in flight on the render thread
+		render_thread_->WaitForIdle();
+
+		DLOG("render benchmark: " << num_frames << " frames, extraction " << benchmark_extract_time_ / num_frames << " ms per frame");
+
+		if (null_backend_ != nullptr)
+		{
+			const RenderCommandStats& stats = null_backend_->GetTotalStats();
+			double num_recorded = static_cast<double>(std::max<uint64_t>(null_backend_->GetNumFrames() - null_backend_->GetNumInvalidFrames(), 1));
+
+			DLOG("render benchmark: recording " << stats.record_time / num_recorded << " ms, "
+				<< stats.num_draws / num_recorded << " draws, "
+				<< stats.num_instances / num_recorded << " instances, "
+				<< stats.num_material_binds / num_recorded << " material binds, "
+				<< stats.num_mesh_binds / num_recorded << " mesh binds, "
+				<< stats.num_shadow_maps / num_recorded << " shadow maps & "
+				<< stats.num_upload_bytes / num_recorded << " upload bytes per frame");
+
+			if (null_backend_->GetNumInvalidFrames() > 0)
+			{
+				DLOG("render benchmark: " << null_backend_->GetNumInvalidFrames() << " invalid frames, the last one because " << null_backend_->GetLastError());
+			}
+		}
+
+		if (config_manager_->GetConfig().query_benchmark_rays > 0)
+		{
+			DLOG("query benchmark: " << config_manager_->GetConfig().query_benchmark_rays << " rays per frame, "
+				<< physics_manager_->GetBenchmarkSingleTime() / num_frames << " ms one at a time (" << physics_manager_->GetBenchmarkSingleHits() << " hits), "
+				<< physics_manager_->GetBenchmarkBatchedTime() / num_frames << " ms batched (" << physics_manager_->GetBenchmarkBatchedHits() << " hits) per frame");
+		}
+
+		const PhysicsStepStats& physics_stats = physics_manager_->GetTotalStats();
+		double num_steps = static_cast<double>(std::max<uint64_t>(physics_manager_->GetNumSteps(), 1));
+
+		DLOG("physics benchmark: " << physics_manager_->GetNumSteps() << " steps, simulate " << physics_stats.simulate_time / num_steps << " ms, fetch "
+			<< physics_stats.fetch_time / num_steps << " ms, callbacks " << physics_stats.callback_time / num_steps << " ms, syncing "
+			<< physics_stats.sync_time / num_steps << " ms, " << physics_stats.num_active_dynamic / num_steps << " active dynamic bodies, "
+			<< physics_stats.num_synced_bodies / num_steps << " synced rigidbodies, "
+			<< physics_stats.num_broadphase_new_pairs / num_steps << " new & " << physics_stats.num_broadphase_lost_pairs / num_steps << " lost broadphase pairs, "
+			<< physics_stats.num_narrowphase_pairs / num_steps << " narrowphase pairs, "
+			<< physics_stats.num_contact_pairs / num_steps << " contact pairs, " << physics_stats.num_contact_points / num_steps << " contact points & "
+			<< physics_stats.num_trigger_events / num_steps << " trigger events per step, PhysX peaked at " << physics_stats.px_memory_used << " bytes in "
+			<< physics_stats.px_allocations << " allocations");
+
+		if (config_manager_->GetConfig().audio_benchmark_requests > 0)
+		{
+			const VoiceStats& voice_stats = audio_manager_->GetVoiceManager()->GetStats();
+			double num_updates = static_cast<double>(std::max<uint64_t>(voice_stats.num_updates, 1));
+
+			DLOG("audio benchmark: " << voice_stats.num_requests << " play requests, " << voice_stats.num_coalesced << " coalesced, "
+				<< voice_stats.num_promotions << " promotions & " << voice_stats.num_demotions << " demotions, at most " << voice_stats.peak_voices
+				<< " voices of which " << voice_stats.peak_real_voices << " real, updating the voices took " << voice_stats.update_time / num_updates << " ms per frame");
+			DLOG("audio benchmark: voices were moved " << voice_stats.num_moved << " times, the 3D attributes of real channels were set "
+				<< voice_stats.num_attribute_updates << " times, " << voice_stats.num_attribute_updates / num_updates << " per frame");
+
+			const AudioClipCache* clip_cache = audio_manager_->GetClipCache();
+			DLOG("audio benchmark: the clips took at most " << clip_cache->GetPeakMemory() << " of " << clip_cache->GetBudget() << " bytes, "
+				<< clip_cache->GetNumReleases() << " clips were released to stay within the budget");
+		}
+
+		StopRunning();
+	}
+
 	//------------------------------------------------------------------------------------------------------
 	void GameManager::StopRunning()
 	{
@@ -128,16 +252,26 @@ namespace tremble
 	//------------------------------------------------------------------------------------------------------
 	void GameManager::ShutDown()
 	{
+		render_thread_->Stop(); // the last packet may still be rendering & referencing the scene's resources
+
         subsystem_allocator_->Delete(scene_loader_);
         subsystem_allocator_->Delete(physics_manager_);
 		subsystem_allocator_->Delete((Scene*)scene_);
         subsystem_allocator_->Delete(octree_);
+		subsystem_allocator_->Delete(lag_compensation_);
 		subsystem_allocator_->Delete(component_manager_);
 		subsystem_allocator_->Delete(timer_);
+		subsystem_allocator_->Delete(render_thread_);
+		if (null_backend_ != nullptr)
+		{
+			subsystem_allocator_->Delete(null_backend_);
+		}
+		subsystem_allocator_->Delete(frame_extractor_);
 		subsystem_allocator_->Delete(command_context_manager_);
 		subsystem_allocator_->Delete(command_manager_);
 		subsystem_allocator_->Delete(renderer_);
 		subsystem_allocator_->Delete(resource_manager_);
+		subsystem_allocator_->Delete(hot_reload_manager_);
 		subsystem_allocator_->Delete(audio_manager_);
 		subsystem_allocator_->Delete(input_manager_);
 		subsystem_allocator_->Delete(window_);
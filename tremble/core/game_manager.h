@@ -24,6 +24,11 @@ namespace tremble
 	class NetworkManager;
 	class PacketFactory;
 	class Octree;
+	class HotReloadManager;
+	class FrameExtractor;
+	class RenderThread;
+	class NullRenderBackend;
+	class LagCompensation;
 
 	/** 
 	* @class tremble::GameManager
@@ -60,7 +65,15 @@ namespace tremble
 		*/
 		static GameManager* Create(size_t memory_size);
 		
-		void Startup(const std::string& name, int width, int height);
+		/**
+		* @brief Creates all the subsystems of the engine
+		* @param[in] name The title of the window
+		* @param[in] width The width of the window
+		* @param[in] height The height of the window
+		* @param[in] headless_frames Starts without the setup dialog & without a device when non-zero, the frames are rendered
+		* through the null render backend & the engine stops after this many frames, see ConfigManager::ConfigManager
+		*/
+		void Startup(const std::string& name, int width, int height, UINT headless_frames = 0);
 		
 		void MainLoop(); //!< A general engine update loop
 
@@ -86,8 +99,18 @@ namespace tremble
 		NetworkManager* GetNetworkManager() { return network_manager_; } //!< Get the game network manager
 		PacketFactory* GetPacketFactory() { return packet_factory_; } //!< Get the packet factory singleton
 		Octree* GetOctree(); //!< Get the octree
+		HotReloadManager* GetHotReloadManager() { return hot_reload_manager_; } //!< Get the hot reload manager
+		FrameExtractor* GetFrameExtractor() { return frame_extractor_; } //!< Get the frame extractor that fills the frame packets
+		RenderThread* GetRenderThread() { return render_thread_; } //!< Get the render thread that consumes the frame packets
+		LagCompensation* GetLagCompensation() { return lag_compensation_; } //!< Get the hitbox history the host rewinds shots against
 
 	private:
+		/**
+		* @brief Accumulates the timings of the frame that was just submitted & reports them once the configured number of benchmark frames ran
+		* @see Config::benchmark_frames
+		*/
+		void UpdateBenchmark();
+
 		Timer* timer_; //!< Takes care of delta time
 		bool running_; //!< Is the game running? @see StopRunning()
 		FreeListAllocator* own_allocator_; //!< Allocator, that is used to allocate resources that are in use by the game manager itself
@@ -110,5 +133,11 @@ namespace tremble
 		CommandContextManager* command_context_manager_; //!< Manages all command contexts in the application
 		AudioManager* audio_manager_; //!< Contains audio system and manages all channels and clips
 		Octree* octree_; //!< Octree for per renderable nodes
+		HotReloadManager* hot_reload_manager_; //!< Reloads changed assets at the start of a frame
+		FrameExtractor* frame_extractor_; //!< Copies the scene into a frame packet at the end of a frame
+		RenderThread* render_thread_; //!< Renders the frame packets, on a thread of its own if the config enables it
+		NullRenderBackend* null_backend_; //!< Consumes the frame packets instead of the renderer if the config enables it, nullptr otherwise
+		double benchmark_extract_time_; //!< The total extraction time of all benchmarked frames, in milliseconds
+		LagCompensation* lag_compensation_; //!< Records the hitboxes every frame, created before the scene so hitboxes can remove themselves while it's deleted
 	};
-}
+}
\ No newline at end of file
@@ -180,4 +180,22 @@ namespace tremble
 	{
 		return game_manager_->GetOctree();
 	}
-}
+
+	//------------------------------------------------------------------------------------------------------
+	HotReloadManager* Get::HotReloadManager()
+	{
+		return game_manager_->GetHotReloadManager();
+	}
+
+	//------------------------------------------------------------------------------------------------------
+	RenderThread* Get::RenderThread()
+	{
+		return game_manager_->GetRenderThread();
+	}
+
+	//------------------------------------------------------------------------------------------------------
+	LagCompensation* Get::LagCompensation()
+	{
+		return game_manager_->GetLagCompensation();
+	}
+}
\ No newline at end of file
@@ -24,6 +24,9 @@ namespace tremble
 	class NetworkManager;
 	class PacketFactory;
 	class Octree;
+	class HotReloadManager;
+	class RenderThread;
+	class LagCompensation;
 
 	class Get
 	{
@@ -62,5 +65,8 @@ namespace tremble
 		static AudioManager* AudioManager();
         static SceneLoader* SceneLoader();
 		static Octree* Octree();
+		static HotReloadManager* HotReloadManager();
+		static RenderThread* RenderThread();
+		static LagCompensation* LagCompensation();
 	};
 }
\ No newline at end of file
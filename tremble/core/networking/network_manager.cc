@@ -172,6 +172,20 @@ void NetworkManager::SendPacket(Peer * recipient, PacketReliability reliability_
 	ASSERT(identifier != 0);
 }
 
+float NetworkManager::GetLatency(PeerID peer_id)
+{
+	Peer* peer = peer_factory_->FindPeer(peer_id);
+	if (peer == nullptr || peer->IsVirtual() == true || peer->GetGuid() == guid_)
+		return 0.0f;
+
+	// RakNet returns -1 until it measured the round trip at least once
+	int average_ping = client_->GetAveragePing(peer->GetGuid());
+	if (average_ping < 0)
+		return 0.0f;
+
+	return average_ping * 0.5f / 1000.0f;
+}
+
 bool NetworkManager::HasNetworkEventInterface()
 {
 	return network_event_interface_ != nullptr;
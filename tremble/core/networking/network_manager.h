@@ -98,6 +98,13 @@ namespace tremble
 		*/
 		void SendPacket(Peer* recipient, PacketReliability reliability_mode, RakNet::BitStream* packet_data);
 
+		/**
+		* @brief Get the time it takes packets of a peer to reach us.
+		* @param[in] peer_id The index of the peer.
+		* @return Half the average round trip time in seconds, 0 for ourselves, unknown peers and peers that aren't connected to us directly.
+		*/
+		float GetLatency(PeerID peer_id);
+
 		/**
 		 * @return The class in charge of handling incoming data.
 		 */
@@ -0,0 +1,342 @@
+#include "collision_cache.h"
+
+#include "physics_triangle_mesh_geometry.h"
+#include "../resources/mesh.h"
+#include "../utilities/stopwatch.h"
+
+#include <ppl.h>
+#include <unordered_set>
+
+namespace tremble
+{
+	using namespace physx;
+
+	//------------------------------------------------------------------------------------------------------
+	CollisionCache::CollisionCache(PxPhysics* px_physics, PxCooking* px_cooking, bool use_disk) :
+		px_physics_(px_physics),
+		px_cooking_(px_cooking),
+		use_disk_(use_disk)
+	{
+		// everything that changes the cooked data is hashed, so changing the parameters or PhysX never reads stale files
+		const PxCookingParams& params = px_cooking_->getParams();
+		uint32_t settings[] = {
+			COLLISION_CACHE_VERSION,
+			PX_PHYSICS_VERSION,
+			static_cast<uint32_t>(params.targetPlatform),
+			static_cast<uint32_t>(params.meshPreprocessParams),
+			params.buildTriangleAdjacencies == true ? 1u : 0u,
+			params.suppressTriangleMeshRemapTable == true ? 1u : 0u
+		};
+		float tolerances[] = { params.areaTestEpsilon, params.meshWeldTolerance, params.scale.length, params.scale.speed };
+
+		params_hash_ = Hash(14695981039346656037ull, settings, sizeof(settings));
+		params_hash_ = Hash(params_hash_, tolerances, sizeof(tolerances));
+
+		if (use_disk_ == true)
+		{
+			CreateDirectoryA(COLLISION_CACHE_DIRECTORY, nullptr);
+		}
+	}
+
+	//------------------------------------------------------------------------------------------------------
+	CollisionCache::~CollisionCache()
+	{
+		for (auto it = triangle_meshes_.begin(); it != triangle_meshes_.end(); ++it)
+		{
+			it->second->release();
+		}
+
+		for (auto it = convex_meshes_.begin(); it != convex_meshes_.end(); ++it)
+		{
+			it->second->release();
+		}
+	}
+
+	//------------------------------------------------------------------------------------------------------
+	PxTriangleMesh* CollisionCache::GetTriangleMesh(const std::vector<PxVec3>& vertices, const std::vector<PxU32>& indices)
+	{
+		Entry entry;
+		entry.type = TriangleMeshEntry;
+		entry.vertices = vertices;
+		entry.indices = indices;
+		ComputeKey(entry);
+
+		auto it = triangle_meshes_.find(entry.key);
+		if (it == triangle_meshes_.end())
+		{
+			Load(entry, use_disk_);
+			Create(entry);
+			it = triangle_meshes_.find(entry.key);
+		}
+
+		return it != triangle_meshes_.end() ? it->second : nullptr;
+	}
+
+	//------------------------------------------------------------------------------------------------------
+	PxConvexMesh* CollisionCache::GetConvexMesh(const std::vector<PxVec3>& vertices)
+	{
+		Entry entry;
+		entry.type = ConvexMeshEntry;
+		entry.vertices = vertices;
+		ComputeKey(entry);
+
+		auto it = convex_meshes_.find(entry.key);
+		if (it == convex_meshes_.end())
+		{
+			Load(entry, use_disk_);
+			Create(entry);
+			it = convex_meshes_.find(entry.key);
+		}
+
+		return it != convex_meshes_.end() ? it->second : nullptr;
+	}
+
+	//------------------------------------------------------------------------------------------------------
+	void CollisionCache::Prepare(const std::vector<Mesh*>& meshes, const std::vector<std::vector<PxVec3>>& convex_vertices)
+	{
+		size_t num_meshes = meshes.size();
+		std::vector<Entry> entries(num_meshes + convex_vertices.size());
+
+		concurrency::parallel_for(size_t(0), entries.size(), [&entries, &meshes, &convex_vertices, num_meshes](size_t i)
+		{
+			Entry& entry = entries[i];
+			if (i < num_meshes)
+			{
+				entry.type = TriangleMeshEntry;
+				if (meshes[i]->IsMeshDataReleased() == false)
+				{
+					entry.vertices = PhysicsTriangleMeshGeometry::GetVertices(meshes[i]);
+					entry.indices = PhysicsTriangleMeshGeometry::GetIndices(meshes[i]);
+				}
+			}
+			else
+			{
+				entry.type = ConvexMeshEntry;
+				entry.vertices = convex_vertices[i - num_meshes];
+			}
+		});
+
+		Prepare(entries);
+	}
+
+	//------------------------------------------------------------------------------------------------------
+	void CollisionCache::Prepare(const std::vector<std::vector<PxVec3>>& vertices, const std::vector<std::vector<PxU32>>& indices)
+	{
+		ASSERT(vertices.size() == indices.size());
+
+		std::vector<Entry> entries(vertices.size());
+		for (size_t i = 0; i < entries.size(); i++)
+		{
+			entries[i].type = TriangleMeshEntry;
+			entries[i].vertices = vertices[i];
+			entries[i].indices = indices[i];
+		}
+
+		Prepare(entries);
+	}
+
+	//------------------------------------------------------------------------------------------------------
+	void CollisionCache::Prepare(std::vector<Entry>& entries)
+	{
+		Stopwatch stopwatch;
+
+		concurrency::parallel_for(size_t(0), entries.size(), [this, &entries](size_t i)
+		{
+			ComputeKey(entries[i]);
+		});
+
+		// meshes that are used several times are only loaded once, & the ones that are cached already not at all
+		std::unordered_set<uint64_t> pending_keys;
+		std::vector<Entry*> pending;
+		for (size_t i = 0; i < entries.size(); i++)
+		{
+			Entry& entry = entries[i];
+			bool cached = entry.type == TriangleMeshEntry ? triangle_meshes_.count(entry.key) > 0 : convex_meshes_.count(entry.key) > 0;
+			if (entry.vertices.empty() == false && cached == false && pending_keys.insert(entry.key).second == true)
+			{
+				pending.push_back(&entry);
+			}
+		}
+
+		concurrency::parallel_for(size_t(0), pending.size(), [this, &pending](size_t i)
+		{
+			Load(*pending[i], use_disk_);
+		});
+		float load_time = stopwatch.OutputAndReset() * 1000.0f;
+
+		// PhysX meshes are created on the calling thread, creating them is cheap compared to cooking them
+		size_t num_from_disk = 0;
+		for (size_t i = 0; i < pending.size(); i++)
+		{
+			num_from_disk += pending[i]->from_disk == true ? 1 : 0;
+			Create(*pending[i]);
+		}
+		float create_time = stopwatch.Output() * 1000.0f;
+
+		DLOG("collision cache: prepared " << pending.size() << " of " << entries.size() << " meshes, " << num_from_disk << " read from disk & "
+			<< pending.size() - num_from_disk << " cooked in " << load_time << " ms, creating them took " << create_time << " ms");
+	}
+
+	//------------------------------------------------------------------------------------------------------
+	void CollisionCache::ComputeKey(Entry& entry) const
+	{
+		uint32_t header[] = {
+			static_cast<uint32_t>(entry.type),
+			static_cast<uint32_t>(entry.vertices.size()),
+			static_cast<uint32_t>(entry.indices.size())
+		};
+
+		entry.key = Hash(params_hash_, header, sizeof(header));
+		entry.key = Hash(entry.key, entry.vertices.data(), entry.vertices.size() * sizeof(PxVec3));
+		entry.key = Hash(entry.key, entry.indices.data(), entry.indices.size() * sizeof(PxU32));
+	}
+
+	//------------------------------------------------------------------------------------------------------
+	void CollisionCache::Load(Entry& entry, bool read_from_disk) const
+	{
+		entry.from_disk = false;
+
+		if (read_from_disk == true)
+		{
+			std::ifstream input(GetPath(entry), std::ios::in | std::ios::binary);
+			if (input.is_open())
+			{
+				uint32_t version = 0;
+				uint64_t key = 0;
+				uint32_t size = 0;
+				input.read(reinterpret_cast<char*>(&version), sizeof(version));
+				input.read(reinterpret_cast<char*>(&key), sizeof(key));
+				input.read(reinterpret_cast<char*>(&size), sizeof(size));
+
+				if (input.good() == true && version == COLLISION_CACHE_VERSION && key == entry.key && size > 0)
+				{
+					entry.data.resize(size);
+					input.read(reinterpret_cast<char*>(entry.data.data()), size);
+					entry.from_disk = input.gcount() == static_cast<std::streamsize>(size);
+				}
+			}
+		}
+
+		if (entry.from_disk == true || Cook(entry) == false || use_disk_ == false)
+		{
+			return;
+		}
+
+		// a partially written file fails the size check above, so nothing has to be done about two runs writing at once
+		std::ofstream output(GetPath(entry), std::ios::out | std::ios::binary | std::ios::trunc);
+		if (output.is_open())
+		{
+			uint32_t version = COLLISION_CACHE_VERSION;
+			uint32_t size = static_cast<uint32_t>(entry.data.size());
+			output.write(reinterpret_cast<const char*>(&version), sizeof(version));
+			output.write(reinterpret_cast<const char*>(&entry.key), sizeof(entry.key));
+			output.write(reinterpret_cast<const char*>(&size), sizeof(size));
+			output.write(reinterpret_cast<const char*>(entry.data.data()), size);
+		}
+	}
+
+	//------------------------------------------------------------------------------------------------------
+	bool CollisionCache::Cook(Entry& entry) const
+	{
+		entry.data.clear();
+
+		if (entry.vertices.empty() == true || (entry.type == TriangleMeshEntry && entry.indices.size() < 3))
+		{
+			return false;
+		}
+
+		PxDefaultMemoryOutputStream stream;
+		bool cooked = false;
+
+		if (entry.type == TriangleMeshEntry)
+		{
+			PxTriangleMeshDesc mesh_desc;
+			mesh_desc.points.count		= PxU32(entry.vertices.size());
+			mesh_desc.points.stride		= sizeof(PxVec3);
+			mesh_desc.points.data		= entry.vertices.data();
+			mesh_desc.triangles.count	= PxU32(entry.indices.size()) / 3;
+			mesh_desc.triangles.stride	= 3 * sizeof(PxU32);
+			mesh_desc.triangles.data	= entry.indices.data();
+
+			cooked = px_cooking_->cookTriangleMesh(mesh_desc, stream);
+		}
+		else
+		{
+			PxConvexMeshDesc convex_desc;
+			convex_desc.points.count	= PxU32(entry.vertices.size());
+			convex_desc.points.stride	= sizeof(PxVec3);
+			convex_desc.points.data		= entry.vertices.data();
+			convex_desc.flags			= PxConvexFlag::eCOMPUTE_CONVEX;
+
+			cooked = px_cooking_->cookConvexMesh(convex_desc, stream);
+		}
+
+		if (cooked == false)
+		{
+			return false;
+		}
+
+		entry.data.assign(stream.getData(), stream.getData() + stream.getSize());
+		return true;
+	}
+
+	//------------------------------------------------------------------------------------------------------
+	void CollisionCache::Create(Entry& entry)
+	{
+		// a file that passed the header check can still be unusable, e.g. when it was written by another PhysX build
+		if (CreateMesh(entry) == false && entry.from_disk == true)
+		{
+			DLOG("collision cache: " << GetPath(entry) << " couldn't be read, it's cooked again");
+			Load(entry, false);
+			CreateMesh(entry);
+		}
+	}
+
+	//------------------------------------------------------------------------------------------------------
+	bool CollisionCache::CreateMesh(Entry& entry)
+	{
+		if (entry.data.empty() == true)
+		{
+			return false;
+		}
+
+		PxDefaultMemoryInputData input(entry.data.data(), static_cast<PxU32>(entry.data.size()));
+
+		if (entry.type == TriangleMeshEntry)
+		{
+			PxTriangleMesh* px_triangle_mesh = px_physics_->createTriangleMesh(input);
+			if (px_triangle_mesh != nullptr)
+			{
+				triangle_meshes_[entry.key] = px_triangle_mesh;
+			}
+			return px_triangle_mesh != nullptr;
+		}
+
+		PxConvexMesh* px_convex_mesh = px_physics_->createConvexMesh(input);
+		if (px_convex_mesh != nullptr)
+		{
+			convex_meshes_[entry.key] = px_convex_mesh;
+		}
+		return px_convex_mesh != nullptr;
+	}
+
+	//------------------------------------------------------------------------------------------------------
+	std::string CollisionCache::GetPath(const Entry& entry)
+	{
+		std::stringstream path;
+		path << COLLISION_CACHE_DIRECTORY << std::hex << std::setw(16) << std::setfill('0') << entry.key << (entry.type == TriangleMeshEntry ? ".tri" : ".cvx");
+		return path.str();
+	}
+
+	//------------------------------------------------------------------------------------------------------
+	uint64_t CollisionCache::Hash(uint64_t hash, const void* data, size_t size)
+	{
+		const uint8_t* bytes = static_cast<const uint8_t*>(data);
+		for (size_t i = 0; i < size; i++)
+		{
+			hash ^= bytes[i];
+			hash *= 1099511628211ull;
+		}
+		return hash;
+	}
+}
\ No newline at end of file
@@ -0,0 +1,147 @@
+#pragma once
+
+#define COLLISION_CACHE_DIRECTORY "collision_cache/" // the directory cooked collision meshes are stored in, relative to the working directory
+#define COLLISION_CACHE_VERSION 1 // the version of the cache files, files of another version are cooked again
+
+namespace tremble
+{
+	class Mesh;
+
+	/**
+	* @class tremble::CollisionCache
+	* @brief Cooks triangle & convex meshes once & keeps them, both in memory & on disk
+	*
+	* Cooking is the most expensive part of loading a collision heavy level. Every cooked mesh is stored in a file
+	* named after a hash of its vertices, its indices & the cooking parameters, so later runs read the cooked data
+	* & only create the mesh from it. Identical meshes are cooked once & share the same PhysX mesh.
+	*
+	* The meshes of a level can be prepared up front, which loads & cooks them on worker threads. Meshes that
+	* weren't prepared are loaded or cooked on the calling thread when they are requested.
+	*/
+	class CollisionCache
+	{
+	public:
+		/**
+		* @param[in] px_physics The physics the meshes are created with
+		* @param[in] px_cooking The cooking the meshes are cooked with, its parameters are part of the hash
+		* @param[in] use_disk Whether cooked meshes are read from & written to COLLISION_CACHE_DIRECTORY
+		*/
+		CollisionCache(physx::PxPhysics* px_physics, physx::PxCooking* px_cooking, bool use_disk);
+		~CollisionCache(); //!< Releases the cache's references to the meshes, shapes that use them keep their own
+
+		/**
+		* @brief Gets the triangle mesh of a list of triangles, cooking it if it isn't cached yet
+		* @param[in] vertices The vertices of the mesh
+		* @param[in] indices Three indices for every triangle
+		* @return The triangle mesh, nullptr if it couldn't be cooked
+		*/
+		physx::PxTriangleMesh* GetTriangleMesh(const std::vector<physx::PxVec3>& vertices, const std::vector<physx::PxU32>& indices);
+
+		/**
+		* @brief Gets the convex hull of a point cloud, cooking it if it isn't cached yet
+		* @param[in] vertices The points to compute the convex hull of
+		* @return The convex mesh, nullptr if it couldn't be cooked
+		*/
+		physx::PxConvexMesh* GetConvexMesh(const std::vector<physx::PxVec3>& vertices);
+
+		/**
+		* @brief Loads or cooks all meshes that aren't cached yet on worker threads, so requesting them afterwards is a lookup
+		* @param[in] meshes The meshes of which the triangle meshes are prepared, meshes of which the data was released are skipped
+		* @param[in] convex_vertices The point clouds of which the convex meshes are prepared
+		*/
+		void Prepare(const std::vector<Mesh*>& meshes, const std::vector<std::vector<physx::PxVec3>>& convex_vertices);
+
+		/**
+		* @brief Loads or cooks triangle meshes that aren't cached yet on worker threads, so requesting them afterwards is a lookup
+		* @param[in] vertices The vertices of every triangle mesh
+		* @param[in] indices The indices of every triangle mesh, three for every triangle
+		*/
+		void Prepare(const std::vector<std::vector<physx::PxVec3>>& vertices, const std::vector<std::vector<physx::PxU32>>& indices);
+
+	private:
+		/**
+		* @brief The kind of cooked data
+		*/
+		enum EntryType
+		{
+			TriangleMeshEntry,
+			ConvexMeshEntry
+		};
+
+		/**
+		* @struct tremble::CollisionCache::Entry
+		* @brief A mesh on its way from vertices to a PhysX mesh
+		*/
+		struct Entry
+		{
+			EntryType type; //!< The kind of mesh
+			uint64_t key; //!< The hash the mesh is cached under
+			std::vector<physx::PxVec3> vertices; //!< The vertices of the mesh
+			std::vector<physx::PxU32> indices; //!< The indices of a triangle mesh, empty for convex meshes
+			std::vector<uint8_t> data; //!< The cooked data, empty if cooking failed
+			bool from_disk; //!< Whether the cooked data was read from the cache directory
+		};
+
+		/**
+		* @brief Computes the keys of entries & loads & creates the ones that aren't cached yet
+		* @param[in,out] entries The entries, of which only the type, vertices & indices have to be set
+		*/
+		void Prepare(std::vector<Entry>& entries);
+
+		/**
+		* @brief Computes the hash an entry is cached under from its type, vertices & indices & the cooking parameters
+		* @param[in,out] entry The entry, of which the key is set
+		*/
+		void ComputeKey(Entry& entry) const;
+
+		/**
+		* @brief Reads the cooked data of an entry from disk or cooks it, writing it to disk, safe to call from several threads
+		* @param[in,out] entry The entry, of which the data is set
+		* @param[in] read_from_disk Whether the cache directory is read, otherwise the entry is always cooked
+		*/
+		void Load(Entry& entry, bool read_from_disk) const;
+
+		/**
+		* @brief Cooks the data of an entry, safe to call from several threads
+		* @param[in,out] entry The entry, of which the data is set
+		* @return Whether cooking succeeded
+		*/
+		bool Cook(Entry& entry) const;
+
+		/**
+		* @brief Creates the PhysX mesh of a loaded entry & adds it to the cache, cooking it again if the data read from disk is unusable
+		* @param[in,out] entry The loaded entry
+		*/
+		void Create(Entry& entry);
+
+		/**
+		* @brief Creates the PhysX mesh of an entry from its cooked data & adds it to the cache
+		* @param[in] entry The entry
+		* @return Whether PhysX accepted the data
+		*/
+		bool CreateMesh(Entry& entry);
+
+		/**
+		* @brief Gets the path of the file an entry is cached in
+		* @param[in] entry The entry
+		*/
+		static std::string GetPath(const Entry& entry);
+
+		/**
+		* @brief Hashes data with 64 bit FNV-1a
+		* @param[in] hash The hash so far, to hash several pieces of data in a row
+		* @param[in] data The data to hash
+		* @param[in] size The size of the data in bytes
+		* @return The new hash
+		*/
+		static uint64_t Hash(uint64_t hash, const void* data, size_t size);
+
+		physx::PxPhysics* px_physics_; //!< The physics the meshes are created with
+		physx::PxCooking* px_cooking_; //!< The cooking the meshes are cooked with
+		bool use_disk_; //!< Whether cooked meshes are read from & written to disk
+		uint64_t params_hash_; //!< The hash of the cooking parameters, part of every key
+
+		std::unordered_map<uint64_t, physx::PxTriangleMesh*> triangle_meshes_; //!< The triangle meshes by key
+		std::unordered_map<uint64_t, physx::PxConvexMesh*> convex_meshes_; //!< The convex meshes by key
+	};
+}
\ No newline at end of file
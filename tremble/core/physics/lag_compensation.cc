@@ -0,0 +1,263 @@
+#include "lag_compensation.h"
+
+#include "../get.h"
+#include "../math/math.h"
+#include "../scene_graph/scene_graph.h"
+#include "../../components/physics/trigger_collider.h"
+
+namespace tremble
+{
+	using namespace physx;
+
+	//------------------------------------------------------------------------------------------------------
+	LagCompensation::LagCompensation() :
+		num_slots_(0),
+		num_ticks_(0)
+	{
+		for (uint32_t i = 0; i < LAG_COMPENSATION_MAX_HITBOXES; i++)
+		{
+			colliders_[i] = nullptr;
+			owners_[i] = 0;
+			half_extents_[i] = PxVec3(0.0f);
+			first_ticks_[i] = 0;
+		}
+
+		for (uint32_t i = 0; i < LAG_COMPENSATION_HISTORY_SIZE; i++)
+		{
+			tick_times_[i] = 0.0;
+		}
+
+		size_t num_poses = LAG_COMPENSATION_HISTORY_SIZE * LAG_COMPENSATION_MAX_HITBOXES;
+		position_x_.resize(num_poses, 0.0f);
+		position_y_.resize(num_poses, 0.0f);
+		position_z_.resize(num_poses, 0.0f);
+		rotation_x_.resize(num_poses, 0.0f);
+		rotation_y_.resize(num_poses, 0.0f);
+		rotation_z_.resize(num_poses, 0.0f);
+		rotation_w_.resize(num_poses, 1.0f);
+	}
+
+	//------------------------------------------------------------------------------------------------------
+	bool LagCompensation::AddHitbox(TriggerCollider* collider, QueryOwner owner)
+	{
+		ASSERT(owner != 0);
+
+		PxShape* px_shape;
+		PxBoxGeometry box;
+		if (collider->GetPxRigidbodyActor()->getShapes(&px_shape, 1) == 0 || px_shape->getBoxGeometry(box) == false)
+		{
+			DLOG("lag compensation only supports box hitboxes");
+			return false;
+		}
+
+		if (AddSlot(collider, box.halfExtents, owner) == LAG_COMPENSATION_MAX_HITBOXES)
+		{
+			DLOG("lag compensation is out of hitbox slots, a hitbox won't be rewound");
+			return false;
+		}
+
+		return true;
+	}
+
+	//------------------------------------------------------------------------------------------------------
+	void LagCompensation::RemoveHitbox(TriggerCollider* collider)
+	{
+		for (uint32_t i = 0; i < num_slots_; i++)
+		{
+			if (colliders_[i] == collider)
+			{
+				colliders_[i] = nullptr;
+				owners_[i] = 0;
+			}
+		}
+
+		while (num_slots_ > 0 && owners_[num_slots_ - 1] == 0)
+		{
+			num_slots_--;
+		}
+	}
+
+	//------------------------------------------------------------------------------------------------------
+	void LagCompensation::Record(double time)
+	{
+		uint32_t first = BeginTick(time);
+
+		for (uint32_t i = 0; i < num_slots_; i++)
+		{
+			if (colliders_[i] != nullptr)
+			{
+				SGNode* node = colliders_[i]->GetNode();
+				StorePose(first, i, PxTransform(node->GetPosition().ToPxVec3(), node->GetRotationQuaternion().ToPxQuat()));
+			}
+		}
+	}
+
+	//------------------------------------------------------------------------------------------------------
+	double LagCompensation::GetViewTime(float latency) const
+	{
+		if (num_ticks_ == 0)
+		{
+			return 0.0;
+		}
+
+		float max_rewind = Get::Config().lag_compensation_ms / 1000.0f;
+		return tick_times_[(num_ticks_ - 1) % LAG_COMPENSATION_HISTORY_SIZE] - std::min(std::max(latency, 0.0f), max_rewind);
+	}
+
+	//------------------------------------------------------------------------------------------------------
+	bool LagCompensation::Raycast(const Vector3& origin, const Vector3& direction, float max_distance, double view_time, QueryOwner ignored_owner, Hit& out_hit) const
+	{
+		if (num_ticks_ == 0)
+		{
+			return false;
+		}
+
+		// walk back from the newest tick to the first one at or before the view time
+		uint32_t newest = num_ticks_ - 1;
+		uint32_t oldest = num_ticks_ > LAG_COMPENSATION_HISTORY_SIZE ? num_ticks_ - LAG_COMPENSATION_HISTORY_SIZE : 0;
+
+		uint32_t older = newest;
+		while (older > oldest && tick_times_[older % LAG_COMPENSATION_HISTORY_SIZE] > view_time)
+		{
+			older--;
+		}
+
+		uint32_t newer = older;
+		float t = 0.0f;
+		if (older < newest && tick_times_[older % LAG_COMPENSATION_HISTORY_SIZE] <= view_time)
+		{
+			newer = older + 1;
+			double older_time = tick_times_[older % LAG_COMPENSATION_HISTORY_SIZE];
+			t = static_cast<float>((view_time - older_time) / (tick_times_[newer % LAG_COMPENSATION_HISTORY_SIZE] - older_time));
+		}
+
+		PxVec3 ray_origin = origin.ToPxVec3();
+		PxVec3 ray_direction = direction.ToPxVec3();
+
+		bool hit = false;
+		out_hit.distance = max_distance;
+
+		for (uint32_t i = 0; i < num_slots_; i++)
+		{
+			if (owners_[i] == 0 || owners_[i] == ignored_owner)
+			{
+				continue;
+			}
+
+			// a slot that was claimed later than the rewound ticks uses its first pose, the older ones belong to a previous hitbox
+			uint32_t slot_older = std::max(older, first_ticks_[i]);
+			uint32_t slot_newer = std::max(newer, first_ticks_[i]);
+			if (slot_older > newest)
+			{
+				continue;
+			}
+
+			PxTransform pose = GetPose(i, slot_older, slot_newer, t);
+
+			// the ray is moved into the space of the box, where the box is axis aligned around the origin
+			PxVec3 local_origin = pose.q.rotateInv(ray_origin - pose.p);
+			PxVec3 local_direction = pose.q.rotateInv(ray_direction);
+			const PxVec3& half_extents = half_extents_[i];
+
+			float enter = 0.0f;
+			float exit = out_hit.distance;
+			bool missed = false;
+
+			for (int axis = 0; axis < 3 && missed == false; axis++)
+			{
+				if (PxAbs(local_direction[axis]) < 1e-8f)
+				{
+					missed = PxAbs(local_origin[axis]) > half_extents[axis];
+					continue;
+				}
+
+				float inverse = 1.0f / local_direction[axis];
+				float near_plane = (-half_extents[axis] - local_origin[axis]) * inverse;
+				float far_plane = (half_extents[axis] - local_origin[axis]) * inverse;
+				if (near_plane > far_plane)
+				{
+					std::swap(near_plane, far_plane);
+				}
+
+				enter = std::max(enter, near_plane);
+				exit = std::min(exit, far_plane);
+				missed = enter > exit;
+			}
+
+			if (missed == false)
+			{
+				hit = true;
+				out_hit.collider = colliders_[i];
+				out_hit.owner = owners_[i];
+				out_hit.distance = enter;
+			}
+		}
+
+		return hit;
+	}
+
+	//------------------------------------------------------------------------------------------------------
+	uint32_t LagCompensation::AddSlot(TriggerCollider* collider, const PxVec3& half_extents, QueryOwner owner)
+	{
+		for (uint32_t i = 0; i < LAG_COMPENSATION_MAX_HITBOXES; i++)
+		{
+			if (owners_[i] != 0)
+			{
+				continue;
+			}
+
+			colliders_[i] = collider;
+			owners_[i] = owner;
+			half_extents_[i] = half_extents;
+			first_ticks_[i] = num_ticks_;
+			num_slots_ = std::max(num_slots_, i + 1);
+			return i;
+		}
+
+		return LAG_COMPENSATION_MAX_HITBOXES;
+	}
+
+	//------------------------------------------------------------------------------------------------------
+	uint32_t LagCompensation::BeginTick(double time)
+	{
+		uint32_t index = num_ticks_ % LAG_COMPENSATION_HISTORY_SIZE;
+		tick_times_[index] = time;
+		num_ticks_++;
+
+		return index * LAG_COMPENSATION_MAX_HITBOXES;
+	}
+
+	//------------------------------------------------------------------------------------------------------
+	void LagCompensation::StorePose(uint32_t first, uint32_t slot, const PxTransform& pose)
+	{
+		uint32_t index = first + slot;
+		position_x_[index] = pose.p.x;
+		position_y_[index] = pose.p.y;
+		position_z_[index] = pose.p.z;
+		rotation_x_[index] = pose.q.x;
+		rotation_y_[index] = pose.q.y;
+		rotation_z_[index] = pose.q.z;
+		rotation_w_[index] = pose.q.w;
+	}
+
+	//------------------------------------------------------------------------------------------------------
+	PxTransform LagCompensation::GetPose(uint32_t slot, uint32_t older, uint32_t newer, float t) const
+	{
+		uint32_t a = (older % LAG_COMPENSATION_HISTORY_SIZE) * LAG_COMPENSATION_MAX_HITBOXES + slot;
+		uint32_t b = (newer % LAG_COMPENSATION_HISTORY_SIZE) * LAG_COMPENSATION_MAX_HITBOXES + slot;
+
+		PxVec3 position_a(position_x_[a], position_y_[a], position_z_[a]);
+		PxVec3 position_b(position_x_[b], position_y_[b], position_z_[b]);
+		PxQuat rotation_a(rotation_x_[a], rotation_y_[a], rotation_z_[a], rotation_w_[a]);
+		PxQuat rotation_b(rotation_x_[b], rotation_y_[b], rotation_z_[b], rotation_w_[b]);
+
+		// the rotations are normalized after a linear blend, which is close enough for the few degrees between two ticks
+		if (rotation_a.dot(rotation_b) < 0.0f)
+		{
+			rotation_b = -rotation_b;
+		}
+
+		PxQuat rotation = rotation_a * (1.0f - t) + rotation_b * t;
+		return PxTransform(position_a + (position_b - position_a) * t, rotation.getNormalized());
+	}
+}
\ No newline at end of file
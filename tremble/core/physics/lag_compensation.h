@@ -0,0 +1,130 @@
+#pragma once
+
+#include "physics_layers.h"
+
+#define LAG_COMPENSATION_MAX_HITBOXES 64 // the number of hitboxes that can be recorded, two for each of 32 players
+#define LAG_COMPENSATION_HISTORY_SIZE 128 // the number of ticks that are kept, a second of history at up to 128 frames per second
+
+namespace tremble
+{
+	class Vector3;
+	class TriggerCollider;
+
+	/**
+	* @class tremble::LagCompensation
+	* @brief Records the poses of the players' hitboxes every tick, so the host can test shots against the world the shooter saw
+	*
+	* A client sees the other players as they were when their latest update left the host, so a hitscan shot tested
+	* against the host's present hitboxes misses targets the client aimed at. The host rewinds the hitboxes to the
+	* shooter's view time & tests the shot against those poses with analytic box tests instead.
+	*
+	* The history is a ring buffer of fixed capacity, stored as a structure of arrays where every tick holds the
+	* poses of all hitbox slots next to each other. Nothing is allocated after construction.
+	*/
+	class LagCompensation
+	{
+	public:
+		/**
+		* @struct tremble::LagCompensation::Hit
+		* @brief The closest hitbox a rewound ray hit
+		*/
+		struct Hit
+		{
+			TriggerCollider* collider; //!< The hitbox that was hit
+			QueryOwner owner; //!< The owner of the hitbox
+			float distance; //!< The distance along the ray, 0 if the ray started inside the hitbox
+		};
+
+		LagCompensation(); //!< Allocates the history
+
+		/**
+		* @brief Starts recording a box trigger collider
+		* @param[in] collider The hitbox, its shape has to be a box
+		* @param[in] owner The player the hitbox belongs to, shots of the same owner skip it
+		* @return Whether there was a free slot for the hitbox
+		*/
+		bool AddHitbox(TriggerCollider* collider, QueryOwner owner);
+
+		/**
+		* @brief Stops recording a hitbox, does nothing if it isn't recorded
+		* @param[in] collider The hitbox to remove
+		*/
+		void RemoveHitbox(TriggerCollider* collider);
+
+		/**
+		* @brief Records the current poses of all hitboxes as a new tick
+		* @param[in] time The time of the tick in seconds, has to increase every tick
+		*/
+		void Record(double time);
+
+		/**
+		* @brief Gets the time the world a shooter saw was recorded at
+		* @param[in] latency The time it takes the shooter's input to reach the host, in seconds
+		* @return The time of the newest tick minus the latency, which is limited to the configured maximum rewind
+		*/
+		double GetViewTime(float latency) const;
+
+		/**
+		* @brief Casts a ray against the hitboxes as they were at a point in time
+		* @param[in] origin The origin of the ray
+		* @param[in] direction The normalized direction of the ray
+		* @param[in] max_distance The length of the ray
+		* @param[in] view_time The time to rewind the hitboxes to, poses between two ticks are interpolated
+		* @param[in] ignored_owner The owner of which the hitboxes are skipped, 0 to skip none
+		* @param[out] out_hit The closest hitbox that was hit
+		* @return Whether a hitbox was hit
+		*/
+		bool Raycast(const Vector3& origin, const Vector3& direction, float max_distance, double view_time, QueryOwner ignored_owner, Hit& out_hit) const;
+
+		/**
+		* @brief Claims a free slot
+		* @param[in] collider The hitbox recorded in the slot, nullptr for hitboxes of which the poses are stored by hand
+		* @param[in] half_extents The half extents of the box
+		* @param[in] owner The player the hitbox belongs to
+		* @return The slot, or LAG_COMPENSATION_MAX_HITBOXES if none is free
+		*/
+		uint32_t AddSlot(TriggerCollider* collider, const physx::PxVec3& half_extents, QueryOwner owner);
+
+		/**
+		* @brief Starts a new tick, the poses of its slots have to be stored with StorePose
+		* @param[in] time The time of the tick in seconds
+		* @return The index of the first pose of the tick in the history arrays
+		*/
+		uint32_t BeginTick(double time);
+
+		/**
+		* @brief Stores the pose of a slot in a tick
+		* @param[in] first The index of the first pose of the tick, as returned by BeginTick
+		* @param[in] slot The slot of the hitbox
+		* @param[in] pose The pose of the hitbox
+		*/
+		void StorePose(uint32_t first, uint32_t slot, const physx::PxTransform& pose);
+
+	private:
+		/**
+		* @brief Gets the pose of a slot at a point in time, interpolated between the two ticks around it
+		* @param[in] slot The slot of the hitbox
+		* @param[in] older The tick at or before the time
+		* @param[in] newer The tick after the time, the same as older when the time is outside the history
+		* @param[in] t The interpolation factor between the two ticks
+		*/
+		physx::PxTransform GetPose(uint32_t slot, uint32_t older, uint32_t newer, float t) const;
+
+		uint32_t num_slots_; //!< One past the highest slot in use
+		TriggerCollider* colliders_[LAG_COMPENSATION_MAX_HITBOXES]; //!< The hitbox of every slot, nullptr for hitboxes stored by hand
+		QueryOwner owners_[LAG_COMPENSATION_MAX_HITBOXES]; //!< The owner of every slot, 0 for free slots
+		physx::PxVec3 half_extents_[LAG_COMPENSATION_MAX_HITBOXES]; //!< The half extents of every slot's box
+		uint32_t first_ticks_[LAG_COMPENSATION_MAX_HITBOXES]; //!< The first tick every slot was recorded in, older ticks hold the poses of a previous hitbox
+
+		uint32_t num_ticks_; //!< The number of ticks recorded since construction, the newest tick is num_ticks_ - 1
+		double tick_times_[LAG_COMPENSATION_HISTORY_SIZE]; //!< The time of every tick in the ring buffer
+
+		std::vector<float> position_x_; //!< The x positions of all slots for every tick in the ring buffer
+		std::vector<float> position_y_; //!< The y positions of all slots for every tick in the ring buffer
+		std::vector<float> position_z_; //!< The z positions of all slots for every tick in the ring buffer
+		std::vector<float> rotation_x_; //!< The x components of the rotations of all slots for every tick in the ring buffer
+		std::vector<float> rotation_y_; //!< The y components of the rotations of all slots for every tick in the ring buffer
+		std::vector<float> rotation_z_; //!< The z components of the rotations of all slots for every tick in the ring buffer
+		std::vector<float> rotation_w_; //!< The w components of the rotations of all slots for every tick in the ring buffer
+	};
+}
\ No newline at end of file
@@ -3,6 +3,7 @@
 #include "core/get.h"
 #include "core/memory/memory_manager.h"
 #include "core/physics/physics_manager.h"
+#include "core/physics/collision_cache.h"
 
 namespace tremble
 {
@@ -38,24 +39,14 @@ namespace tremble
     //------------------------------------------------------------------------------------------------------
     void ConvexMeshGeometry::CookConvexMesh(const std::vector<PxVec3>& verts)
     {
-        PxConvexMeshDesc convex_desc;
-        convex_desc.points.count    = PxU32(verts.size());
-        convex_desc.points.stride   = sizeof(PxVec3);
-        convex_desc.points.data     = &verts[0];
-        convex_desc.flags           = PxConvexFlag::eCOMPUTE_CONVEX;
-
-        PxDefaultMemoryOutputStream buf;
-        PxConvexMeshCookingResult::Enum result;
-        PxCooking* cooking = Get::PhysicsManager()->GetCooking();
-        if(!cooking->cookConvexMesh(convex_desc, buf, &result))
+        PxConvexMesh* px_convex_mesh = Get::PhysicsManager()->GetCollisionCache()->GetConvexMesh(verts);
+        if (px_convex_mesh == nullptr)
         {
             ASSERT(false && "Unable to cook convexMesh");
             return;
         }
 
-        PxPhysics* physics = Get::PhysicsManager()->GetPxPhysics();
-        PxDefaultMemoryInputData input(buf.getData(), buf.getSize());
-        px_convex_mesh_geometry_ = PxConvexMeshGeometry(physics->createConvexMesh(input));
+        px_convex_mesh_geometry_ = PxConvexMeshGeometry(px_convex_mesh);
     }
 }
 
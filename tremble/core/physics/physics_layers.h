@@ -0,0 +1,33 @@
+#pragma once
+
+namespace tremble
+{
+	/**
+	* @brief The collision layers a shape can be on, stored as a single bit in word0 of the shape's filter data
+	*
+	* Scene queries pass a mask of the layers they want to hit, PhysX rejects every shape whose layer isn't in
+	* the mask before the exact intersection test, without calling back into the engine.
+	*/
+	enum CollisionLayer
+	{
+		LAYER_DEFAULT = 1 << 0, //!< Shapes that don't belong to any other layer
+		LAYER_STATIC = 1 << 1, //!< Shapes of static rigidbodies & planes, the level geometry
+		LAYER_DYNAMIC = 1 << 2, //!< Shapes of dynamic rigidbodies
+		LAYER_CHARACTER = 1 << 3, //!< The capsules of character controllers
+		LAYER_TRIGGER = 1 << 4, //!< Trigger colliders that aren't hitboxes, e.g. jump pads
+		LAYER_HITBOX = 1 << 5 //!< Trigger colliders that register hits on a player
+	};
+
+	/**
+	* @brief Commonly used combinations of collision layers
+	*/
+	enum CollisionMask
+	{
+		MASK_NONE = 0, //!< Hits nothing
+		MASK_WORLD = LAYER_DEFAULT | LAYER_STATIC | LAYER_DYNAMIC, //!< The level & the objects in it
+		MASK_SOLID = MASK_WORLD | LAYER_CHARACTER, //!< Everything that blocks movement
+		MASK_ALL = 0xFFFFFFFF //!< Every layer
+	};
+
+	typedef uint32_t QueryOwner; //!< Identifies the shapes of a single object, stored in word1 of the shapes' query filter data, 0 for shapes without an owner
+}
\ No newline at end of file
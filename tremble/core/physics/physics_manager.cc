@@ -7,6 +7,11 @@
 #include "../math/math.h"
 #include "physics_material.h"
 #include "physics_geometry.h"
+#include "scene_query_batch.h"
+#include "collision_cache.h"
+#include "static_geometry_merger.h"
+#include "../utilities/stopwatch.h"
+#include "../../components/physics/rigidbody_dynamic.h"
 
 namespace tremble
 {
@@ -48,8 +53,77 @@ namespace tremble
 	//------------------------------------------------------------------------------------------------------
 	void PhysicsManager::Update()
 	{
+		PhysicsStepStats stats;
+		contact_callback_.stats = &stats;
+
+		// simulate only kicks off the step, the time PhysX' threads take to finish it is spent waiting in fetchResults
+		Stopwatch stopwatch;
 		px_scene_->simulate(Get::DeltaT());
+		stats.simulate_time = stopwatch.OutputAndReset() * 1000.0f;
 		px_scene_->fetchResults(true);
+		stats.fetch_time = stopwatch.OutputAndReset() * 1000.0f - stats.callback_time;
+
+		contact_callback_.stats = nullptr;
+
+		stats.num_synced_bodies = SyncActiveTransforms();
+		stats.sync_time = stopwatch.Output() * 1000.0f;
+		RecordStepStats(stats);
+	}
+
+	//------------------------------------------------------------------------------------------------------
+	uint32_t PhysicsManager::SyncActiveTransforms()
+	{
+		// only the actors PhysX moved during the step are listed, bodies that came to rest cost nothing
+		PxU32 num_active = 0;
+		const PxActiveTransform* active_transforms = px_scene_->getActiveTransforms(num_active);
+
+		uint32_t num_synced = 0;
+		for (PxU32 i = 0; i < num_active; i++)
+		{
+			// character controllers & other components with actors of their own move their nodes themselves
+			Component* component = static_cast<Component*>(active_transforms[i].userData);
+			if (component != nullptr && component->GetType() == typeid(RigidbodyDynamic))
+			{
+				static_cast<RigidbodyDynamic*>(component)->SetPoseFromPhysics_(active_transforms[i].actor2World);
+				num_synced++;
+			}
+		}
+
+		return num_synced;
+	}
+
+	//------------------------------------------------------------------------------------------------------
+	void PhysicsManager::RecordStepStats(PhysicsStepStats& stats)
+	{
+		PxSimulationStatistics px_stats;
+		px_scene_->getSimulationStatistics(px_stats);
+
+		stats.num_active_dynamic = px_stats.nbActiveDynamicBodies;
+		stats.num_active_kinematic = px_stats.nbActiveKinematicBodies;
+		stats.num_static = px_stats.nbStaticBodies;
+		stats.num_dynamic = px_stats.nbDynamicBodies;
+		stats.num_narrowphase_pairs = px_stats.nbDiscreteContactPairsTotal;
+
+		for (PxU32 i = 0; i < PxGeometryType::eGEOMETRY_COUNT; i++)
+		{
+			for (PxU32 j = 0; j < PxGeometryType::eGEOMETRY_COUNT; j++)
+			{
+				stats.num_broadphase_new_pairs += px_stats.nbNewPairs[i][j];
+				stats.num_broadphase_lost_pairs += px_stats.nbLostPairs[i][j];
+			}
+		}
+
+		stats.px_memory_used = px_allocator_->GetUsedMemory();
+		stats.px_allocations = px_allocator_->GetNumAllocations();
+
+		last_step_stats_ = stats;
+		total_stats_.Add(stats);
+
+		if (stats_file_.is_open() == true)
+		{
+			stats.WriteCsvRow(stats_file_, num_steps_);
+		}
+		num_steps_++;
 	}
 
 	//------------------------------------------------------------------------------------------------------
@@ -75,11 +149,178 @@ namespace tremble
 		return buffer->hasBlock;
 	}
 
+	//------------------------------------------------------------------------------------------------------
+	bool PhysicsManager::Raycast(PxRaycastBuffer* buffer, const Vector3& origin, const Vector3& direction, float max_distance, uint32_t layer_mask, QueryOwner ignored_owner)
+	{
+		PxQueryFilterData filter_data = GetQueryFilterData(layer_mask, ignored_owner);
+		px_scene_->raycast(origin.ToPxVec3(), direction.ToPxVec3(), max_distance, *buffer, PxHitFlag::eDEFAULT, filter_data, ignored_owner != 0 ? &owner_filter_callback_ : nullptr);
+		return buffer->hasBlock;
+	}
+
+	//------------------------------------------------------------------------------------------------------
+	bool PhysicsManager::Sweep(PxSweepBuffer* buffer, PhysicsGeometry* geometry, const Vector3& position, const Quaternion& rotation, const Vector3& direction, float max_distance, uint32_t layer_mask, QueryOwner ignored_owner)
+	{
+		PxQueryFilterData filter_data = GetQueryFilterData(layer_mask, ignored_owner);
+		px_scene_->sweep(*geometry->GetPxGeometry(), PxTransform(position.ToPxVec3(), rotation.ToPxQuat()), direction.ToPxVec3(), max_distance, *buffer, PxHitFlag::eDEFAULT, filter_data, ignored_owner != 0 ? &owner_filter_callback_ : nullptr);
+		return buffer->hasBlock;
+	}
+
+	//------------------------------------------------------------------------------------------------------
+	bool PhysicsManager::Overlap(PxOverlapBuffer* buffer, PhysicsGeometry* geometry, const Vector3& position, const Quaternion& rotation, uint32_t layer_mask, QueryOwner ignored_owner)
+	{
+		PxQueryFilterData filter_data = GetQueryFilterData(layer_mask, ignored_owner);
+
+		// overlaps have no closest hit, so either every shape is reported as touching or the query stops at the first one
+		filter_data.flags |= buffer->maxNbTouches > 0 ? PxQueryFlag::eNO_BLOCK : PxQueryFlag::eANY_HIT;
+
+		px_scene_->overlap(*geometry->GetPxGeometry(), PxTransform(position.ToPxVec3(), rotation.ToPxQuat()), *buffer, filter_data, ignored_owner != 0 ? &owner_filter_callback_ : nullptr);
+		return buffer->hasBlock == true || buffer->nbTouches > 0;
+	}
+
+	//------------------------------------------------------------------------------------------------------
+	void PhysicsManager::SetCollisionLayer(PxRigidActor* px_actor, CollisionLayer layer, QueryOwner owner)
+	{
+		PxShape* shapes[8];
+		PxU32 num_shapes = px_actor->getNbShapes();
+
+		for (PxU32 first = 0; first < num_shapes; first += 8)
+		{
+			PxU32 count = px_actor->getShapes(shapes, 8, first);
+			for (PxU32 i = 0; i < count; i++)
+			{
+				SetCollisionLayer(shapes[i], layer, owner);
+			}
+		}
+	}
+
+	//------------------------------------------------------------------------------------------------------
+	void PhysicsManager::SetCollisionLayer(PxShape* px_shape, CollisionLayer layer, QueryOwner owner)
+	{
+		// PhysX' own filtering passes a shape if any word of the query data ANDed with the same word of the shape data is
+		// non-zero, queries leave word1 zero, so the owner in it never lets a shape pass & only the layer in word0 decides
+		px_shape->setQueryFilterData(PxFilterData(layer, owner, 0, 0));
+		px_shape->setSimulationFilterData(PxFilterData(layer, 0, 0, 0));
+	}
+
+	//------------------------------------------------------------------------------------------------------
+	PxQueryFilterData PhysicsManager::GetQueryFilterData(uint32_t layer_mask, QueryOwner ignored_owner)
+	{
+		// the ignored owner goes in a word shapes leave zero, so it only reaches the prefilter
+		PxQueryFilterData filter_data(PxFilterData(layer_mask, 0, ignored_owner, 0), PxQueryFlag::eSTATIC | PxQueryFlag::eDYNAMIC);
+
+		if (ignored_owner != 0)
+		{
+			filter_data.flags |= PxQueryFlag::ePREFILTER;
+		}
+
+		return filter_data;
+	}
+
+	//------------------------------------------------------------------------------------------------------
+	void PhysicsManager::ExecuteQueries()
+	{
+		scene_queries_->Execute();
+
+		UINT num_benchmark_rays = Get::Config().query_benchmark_rays;
+		if (num_benchmark_rays > 0)
+		{
+			BenchmarkQueries(num_benchmark_rays);
+		}
+	}
+
+	//------------------------------------------------------------------------------------------------------
+	void PhysicsManager::BenchmarkQueries(UINT num_rays)
+	{
+		PxActorTypeFlags static_actors = PxActorTypeFlag::eRIGID_STATIC;
+		PxU32 num_actors = px_scene_->getNbActors(static_actors);
+		if (num_actors == 0)
+		{
+			return;
+		}
+
+		// the rays start all over the level geometry, so they test the scene the way gameplay queries would
+		PxBounds3 bounds = PxBounds3::empty();
+		PxActor* actors[32];
+		for (PxU32 first = 0; first < num_actors; first += 32)
+		{
+			PxU32 count = px_scene_->getActors(static_actors, actors, 32, first);
+			for (PxU32 i = 0; i < count; i++)
+			{
+				bounds.include(actors[i]->getWorldBounds());
+			}
+		}
+
+		PxVec3 extents = bounds.getDimensions();
+
+		// a low discrepancy sequence spreads the origins & directions evenly without a random number generator
+		auto ray_origin = [&bounds, &extents](UINT i)
+		{
+			return bounds.minimum + extents.multiply(PxVec3(fmodf(0.5f + i * 0.8191725f, 1.0f), fmodf(0.5f + i * 0.6710436f, 1.0f), fmodf(0.5f + i * 0.5497004f, 1.0f)));
+		};
+		auto ray_direction = [](UINT i)
+		{
+			float z = 1.0f - 2.0f * fmodf(0.5f + i * 0.6180340f, 1.0f);
+			float angle = i * 2.3999632f;
+			float radius = sqrtf(1.0f - z * z);
+			return PxVec3(cosf(angle) * radius, sinf(angle) * radius, z);
+		};
+
+		float max_distance = extents.magnitude();
+
+		Stopwatch stopwatch;
+		for (UINT i = 0; i < num_rays; i++)
+		{
+			PxRaycastBuffer buffer;
+			if (px_scene_->raycast(ray_origin(i), ray_direction(i), max_distance, buffer) == true)
+			{
+				benchmark_single_hits_++;
+			}
+		}
+		benchmark_single_time_ += stopwatch.OutputAndReset() * 1000.0f;
+
+		SceneQueryHandle first_handle = {};
+		for (UINT i = 0; i < num_rays; i++)
+		{
+			SceneQueryHandle handle = benchmark_queries_->QueueRaycast(Vector3(ray_origin(i)), Vector3(ray_direction(i)), max_distance, MASK_ALL);
+			if (i == 0)
+			{
+				first_handle = handle;
+			}
+		}
+		benchmark_queries_->Execute();
+		benchmark_batched_time_ += stopwatch.Output() * 1000.0f;
+
+		for (UINT i = 0; i < num_rays; i++)
+		{
+			SceneQueryHandle handle = { first_handle.batch, first_handle.index + i };
+			if (benchmark_queries_->GetResult(handle).hit == true)
+			{
+				benchmark_batched_hits_++;
+			}
+		}
+	}
+
 	//------------------------------------------------------------------------------------------------------
 	Component* PhysicsManager::GetComponentFromRaycast(physx::PxRaycastBuffer* buffer)
 	{
-		PxActor* actor = buffer->block.actor;
-		return GetComponentFromPxActor(actor);
+		return GetComponentFromHit(buffer->block.actor, buffer->block.shape, buffer->block.faceIndex);
+	}
+
+	//------------------------------------------------------------------------------------------------------
+	Component* PhysicsManager::GetComponentFromHit(const PxActor* px_actor, const PxShape* px_shape, PxU32 face_index)
+	{
+		if (px_actor->userData != nullptr)
+		{
+			return static_cast<Component*>(px_actor->userData);
+		}
+
+		// merged static geometry has no component of its own, its shape knows the component of every triangle
+		if (px_shape != nullptr && px_shape->userData != nullptr)
+		{
+			return static_cast<const StaticGeometryMerger::Chunk*>(px_shape->userData)->GetComponent(face_index);
+		}
+
+		return nullptr;
 	}
 
 	//------------------------------------------------------------------------------------------------------
@@ -116,15 +357,19 @@ namespace tremble
 	}
 
 	//------------------------------------------------------------------------------------------------------
-	physx::PxShape* PhysicsManager::CreatePxShape(PhysicsGeometry* geometry, PhysicsMaterial* material, bool is_exclusive)
+	physx::PxShape* PhysicsManager::CreatePxShape(PhysicsGeometry* geometry, PhysicsMaterial* material, bool is_exclusive, CollisionLayer layer)
 	{
-		return px_physics_->createShape(*geometry->GetPxGeometry(), *material->GetPxMaterial(), is_exclusive);
+		PxShape* px_shape = px_physics_->createShape(*geometry->GetPxGeometry(), *material->GetPxMaterial(), is_exclusive);
+		SetCollisionLayer(px_shape, layer);
+		return px_shape;
 	}
 
 	//------------------------------------------------------------------------------------------------------
 	physx::PxRigidStatic* PhysicsManager::CreatePxPlaneRigidStatic(const Vector3& angle, float offset, PhysicsMaterial* material)
 	{
-		return PxCreatePlane(*px_physics_, PxPlane(angle.ToPxVec3(), offset), *material->GetPxMaterial());
+		PxRigidStatic* px_plane = PxCreatePlane(*px_physics_, PxPlane(angle.ToPxVec3(), offset), *material->GetPxMaterial());
+		SetCollisionLayer(px_plane, LAYER_STATIC);
+		return px_plane;
 	}
 
 	//------------------------------------------------------------------------------------------------------
@@ -148,17 +393,46 @@ namespace tremble
 	}
 
     //------------------------------------------------------------------------------------------------------
-    PhysicsManager::PhysicsManager(size_t memory_size)
+    PhysicsManager::PhysicsManager(size_t memory_size) :
+        last_query_owner_(0),
+        benchmark_single_time_(0.0f),
+        benchmark_batched_time_(0.0f),
+        benchmark_single_hits_(0),
+        benchmark_batched_hits_(0),
+        num_steps_(0)
     {
         physics_allocator_ = Get::MemoryManager()->GetNewAllocator<FreeListAllocator>(memory_size);
         px_allocator_ = physics_allocator_->NewAllocator<FreeListAllocator>(memory_size * 0.9f);
         allocator_callback_ = physics_allocator_->New<AllocatorCallback>(px_allocator_);
         Startup();
+        scene_queries_ = physics_allocator_->New<SceneQueryBatch>(px_scene_, &owner_filter_callback_);
+        benchmark_queries_ = physics_allocator_->New<SceneQueryBatch>(px_scene_, &owner_filter_callback_);
+        collision_cache_ = physics_allocator_->New<CollisionCache>(px_physics_, px_cooking_, Get::Config().collision_cache);
+        static_geometry_merger_ = physics_allocator_->New<StaticGeometryMerger>(px_physics_, px_scene_, collision_cache_);
+        contact_callback_.stats = nullptr;
+
+        const std::string& stats_path = Get::Config().physics_stats_file;
+        if (stats_path.empty() == false)
+        {
+            stats_file_.open(stats_path, std::ios::out | std::ios::trunc);
+            if (stats_file_.is_open() == true)
+            {
+                PhysicsStepStats::WriteCsvHeader(stats_file_);
+            }
+            else
+            {
+                DLOG("physics stats: couldn't open " << stats_path << " for writing");
+            }
+        }
     }
 
     //------------------------------------------------------------------------------------------------------
     PhysicsManager::~PhysicsManager()
     {
+        physics_allocator_->Delete(static_geometry_merger_);
+        physics_allocator_->Delete(collision_cache_);
+        physics_allocator_->Delete(benchmark_queries_);
+        physics_allocator_->Delete(scene_queries_);
         Shutdown();
         physics_allocator_->Delete(allocator_callback_);
         physics_allocator_->DeleteAllocator(px_allocator_);
@@ -225,6 +499,7 @@ namespace tremble
 		px_scene_desc.gravity = PxVec3(0.0f, -9.81f, 0.0f);
 		px_scene_desc.cpuDispatcher = px_cpu_dispatcher_;
 		px_scene_desc.filterShader = PhysicsFilterShader;
+		px_scene_desc.flags |= PxSceneFlag::eENABLE_ACTIVETRANSFORMS;
 		px_scene_ = px_physics_->createScene(px_scene_desc);
 
 		px_controller_manager_ = PxCreateControllerManager(*px_scene_);
@@ -279,6 +554,8 @@ namespace tremble
     //------------------------------------------------------------------------------------------------------
     void PhysicsManager::ContactCallbackProcessing::onTrigger(physx::PxTriggerPair* pairs, physx::PxU32 count)
     {
+        Stopwatch stopwatch;
+
         for (physx::PxU32 i = 0; i < count; i++)
         {
             Component* trigger_component = static_cast<Component*>(pairs[i].triggerActor->userData);
@@ -297,6 +574,12 @@ namespace tremble
                 trigger_component->GetNode()->DoTriggerExitCallbacks(*other_component);
             }
         }
+
+        if (stats != nullptr)
+        {
+            stats->num_trigger_events += count;
+            stats->callback_time += stopwatch.Output() * 1000.0f;
+        }
     }
 
     //------------------------------------------------------------------------------------------------------
@@ -304,6 +587,8 @@ namespace tremble
 	{
 		//std::cout << "OnContact" << std::endl;
 		PX_UNUSED((pairHeader));
+		Stopwatch stopwatch;
+		PxU32 num_contact_points = 0;
 
 		Component* component0 = static_cast<Component*>(pairHeader.actors[0]->userData);
 		Component* component1 = static_cast<Component*>(pairHeader.actors[1]->userData);
@@ -320,6 +605,17 @@ namespace tremble
 				contactPoints.resize(contactCount);
 				contacts_data.resize(contactCount);
 				pairs[i].extractContacts(&contactPoints[0], contactCount);
+				num_contact_points += contactCount;
+
+				// a side without a component is merged static geometry, the triangle of the first contact tells which component it is
+				if (component0 == nullptr)
+				{
+					component0 = GetComponentFromHit(pairHeader.actors[0], pairs[i].shapes[0], contactPoints[0].internalFaceIndex0);
+				}
+				if (component1 == nullptr)
+				{
+					component1 = GetComponentFromHit(pairHeader.actors[1], pairs[i].shapes[1], contactPoints[0].internalFaceIndex1);
+				}
 
 				for (PxU32 j = 0; j<contactCount; j++)
 				{
@@ -353,6 +649,13 @@ namespace tremble
             impulse = impulse;
             component1->GetNode()->DoOnCollisionCallbacks(collision_data);
         }
+
+        if (stats != nullptr)
+        {
+            stats->num_contact_pairs += nbPairs;
+            stats->num_contact_points += num_contact_points;
+            stats->callback_time += stopwatch.Output() * 1000.0f;
+        }
 	}
 
     PxQueryHitType::Enum PhysicsManager::QueryFilterCallback::preFilter(const PxFilterData& filterData, const PxShape* shape, const PxRigidActor* actor, PxHitFlags& queryFlags)
@@ -363,4 +666,14 @@ namespace tremble
         }
         return PxQueryHitType::Enum::eNONE;
     }
+
+    //------------------------------------------------------------------------------------------------------
+    PxQueryHitType::Enum PhysicsManager::OwnerFilterCallback::preFilter(const PxFilterData& filterData, const PxShape* shape, const PxRigidActor* actor, PxHitFlags& queryFlags)
+    {
+        if (shape->getQueryFilterData().word1 == filterData.word2)
+        {
+            return PxQueryHitType::Enum::eNONE;
+        }
+        return PxQueryHitType::Enum::eBLOCK;
+    }
 }
\ No newline at end of file
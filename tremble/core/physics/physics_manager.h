@@ -1,13 +1,19 @@
 #pragma once
 #include <set>
+#include "physics_layers.h"
+#include "physics_stats.h"
 
 namespace tremble
 {
 	class FreeListAllocator;
 	class Vector3;
+	class Quaternion;
 	class Component;
 	class PhysicsMaterial;
 	class PhysicsGeometry;
+	class SceneQueryBatch;
+	class CollisionCache;
+	class StaticGeometryMerger;
 
 	class PhysicsManager
 	{
@@ -28,14 +34,104 @@ namespace tremble
 		void Update(); //!< Physics manager update function. Later to be changed to be called at fixed update
 		Vector3 GetGravity(); //!< Get current gravity of the world
 		bool Raycast(physx::PxRaycastBuffer* buffer, Vector3 origin, Vector3 direction, float max_distance, std::vector<Component*>* ignored_components = nullptr); //!< Cast a ray in the physics scene
+
+		/**
+		* @brief Casts a ray that only hits shapes on a set of collision layers, the layers are filtered inside PhysX
+		* @param[out] buffer The closest hit
+		* @param[in] origin The origin of the ray
+		* @param[in] direction The normalized direction of the ray
+		* @param[in] max_distance The length of the ray
+		* @param[in] layer_mask The collision layers the ray can hit
+		* @param[in] ignored_owner The owner of which the shapes are skipped, e.g. the player that fires the ray, 0 to skip none
+		* @return Whether anything was hit
+		*/
+		bool Raycast(physx::PxRaycastBuffer* buffer, const Vector3& origin, const Vector3& direction, float max_distance, uint32_t layer_mask, QueryOwner ignored_owner = 0);
+
+		/**
+		* @brief Sweeps a geometry through the scene, only hitting shapes on a set of collision layers
+		* @param[out] buffer The closest hit
+		* @param[in] geometry The geometry to sweep
+		* @param[in] position The position the sweep starts at
+		* @param[in] rotation The rotation of the geometry
+		* @param[in] direction The normalized direction of the sweep
+		* @param[in] max_distance The length of the sweep
+		* @param[in] layer_mask The collision layers the sweep can hit
+		* @param[in] ignored_owner The owner of which the shapes are skipped, 0 to skip none
+		* @return Whether anything was hit
+		*/
+		bool Sweep(physx::PxSweepBuffer* buffer, PhysicsGeometry* geometry, const Vector3& position, const Quaternion& rotation, const Vector3& direction, float max_distance, uint32_t layer_mask, QueryOwner ignored_owner = 0);
+
+		/**
+		* @brief Finds the shapes on a set of collision layers that overlap a geometry
+		* @param[out] buffer The overlapping shapes, a buffer without touch storage only receives the first shape found
+		* @param[in] geometry The geometry to test
+		* @param[in] position The position of the geometry
+		* @param[in] rotation The rotation of the geometry
+		* @param[in] layer_mask The collision layers that are tested
+		* @param[in] ignored_owner The owner of which the shapes are skipped, 0 to skip none
+		* @return Whether anything overlaps
+		*/
+		bool Overlap(physx::PxOverlapBuffer* buffer, PhysicsGeometry* geometry, const Vector3& position, const Quaternion& rotation, uint32_t layer_mask, QueryOwner ignored_owner = 0);
+
+		QueryOwner CreateQueryOwner() { return ++last_query_owner_; } //!< Creates a new owner id to mark the shapes of a single object with
+		SceneQueryBatch* GetSceneQueries() { return scene_queries_; } //!< The queries components queue during the update, executed at once after it
+
+		/**
+		* @brief Executes the queued scene queries, their results can be read until the queries queued after this are executed
+		*/
+		void ExecuteQueries();
+
+		float GetBenchmarkSingleTime() const { return benchmark_single_time_; } //!< The total time spent casting the benchmark rays one at a time, in milliseconds
+		float GetBenchmarkBatchedTime() const { return benchmark_batched_time_; } //!< The total time spent casting the benchmark rays as a batch, in milliseconds
+		UINT GetBenchmarkSingleHits() const { return benchmark_single_hits_; } //!< The number of benchmark rays that hit something when cast one at a time
+		UINT GetBenchmarkBatchedHits() const { return benchmark_batched_hits_; } //!< The number of benchmark rays that hit something when cast as a batch
+
+		const PhysicsStepStats& GetLastStepStats() const { return last_step_stats_; } //!< The timings & counts of the last physics step
+		const PhysicsStepStats& GetTotalStats() const { return total_stats_; } //!< The timings & counts of all physics steps added up
+		uint64_t GetNumSteps() const { return num_steps_; } //!< The number of physics steps that were taken
+
+		/**
+		* @brief Builds the filter data of a layered query
+		* @param[in] layer_mask The collision layers the query can hit
+		* @param[in] ignored_owner The owner of which the shapes are skipped, 0 to skip none
+		* @return The filter data, with the prefilter flag set when an owner is skipped
+		*/
+		static physx::PxQueryFilterData GetQueryFilterData(uint32_t layer_mask, QueryOwner ignored_owner);
+
+		/**
+		* @brief Puts all shapes of an actor on a collision layer
+		* @param[in] px_actor The actor of which the shapes are changed
+		* @param[in] layer The collision layer
+		* @param[in] owner The object the shapes belong to, 0 for none
+		*/
+		static void SetCollisionLayer(physx::PxRigidActor* px_actor, CollisionLayer layer, QueryOwner owner = 0);
+
+		/**
+		* @brief Puts a shape on a collision layer
+		* @param[in] px_shape The shape to change
+		* @param[in] layer The collision layer
+		* @param[in] owner The object the shape belongs to, 0 for none
+		*/
+		static void SetCollisionLayer(physx::PxShape* px_shape, CollisionLayer layer, QueryOwner owner = 0);
 		Component* GetComponentFromRaycast(physx::PxRaycastBuffer* buffer); //!< Get a component, that hit a ray, from the raycast buffer
 
+		/**
+		* @brief Gets the component a hit belongs to, resolving hits on merged static geometry to the component of the triangle that was hit
+		* @param[in] px_actor The actor that was hit
+		* @param[in] px_shape The shape that was hit
+		* @param[in] face_index The face index of the hit
+		* @return The component, nullptr for actors without one & for overlaps with merged static geometry
+		*/
+		static Component* GetComponentFromHit(const physx::PxActor* px_actor, const physx::PxShape* px_shape, physx::PxU32 face_index);
+
 		PhysicsMaterial* CreateMaterial(const std::string& name,float restitution = 0.6f, float dynamic_friction = 0.5f, float static_friction = 0.5f);
 		PhysicsMaterial* GetMaterial(std::string name); //!< Get material by name 
-		physx::PxShape* CreatePxShape(PhysicsGeometry* geometry, PhysicsMaterial* material, bool is_exclusive = true);
+		physx::PxShape* CreatePxShape(PhysicsGeometry* geometry, PhysicsMaterial* material, bool is_exclusive = true, CollisionLayer layer = LAYER_DEFAULT); //!< Create a shape on a collision layer
 		physx::PxRigidStatic* CreatePxPlaneRigidStatic(const Vector3& angle, float offset, PhysicsMaterial* material);
         physx::PxCooking* GetCooking() const { return px_cooking_; }
         physx::PxPhysics* GetPxPhysics() const { return px_physics_; }
+        CollisionCache* GetCollisionCache() const { return collision_cache_; } //!< The cooked triangle & convex meshes, shared by all geometries
+        StaticGeometryMerger* GetStaticGeometryMerger() const { return static_geometry_merger_; } //!< Merges static rigidbodies into a few large actors while a scene loads
 
 		void AddPxActor(physx::PxActor* px_actor, Component* component);
 		void RemovePxActor(physx::PxActor*);
@@ -56,6 +152,10 @@ namespace tremble
 
 		class ContactCallbackProcessing : public physx::PxSimulationEventCallback
 		{
+		public:
+			PhysicsStepStats* stats; //!< The stats of the current step, the callbacks add their counts & time to it
+
+		private:
 			void onConstraintBreak(physx::PxConstraintInfo* constraints, physx::PxU32 count) { PX_UNUSED(constraints); PX_UNUSED(count); }
 			void onWake(physx::PxActor** actors, physx::PxU32 count) { PX_UNUSED(actors); PX_UNUSED(count); }
 			void onSleep(physx::PxActor** actors, physx::PxU32 count) { PX_UNUSED(actors); PX_UNUSED(count); }
@@ -91,6 +191,19 @@ namespace tremble
             std::vector<Component*>* ignored_components;
         };
 
+        /**
+        * @brief Skips the shapes of the owner in word2 of the query's filter data, the layers are already filtered by PhysX before this is called
+        *
+        * The callback has no state, so queries on several threads can share it.
+        */
+        class OwnerFilterCallback : public physx::PxQueryFilterCallback
+        {
+        public:
+            virtual physx::PxQueryHitType::Enum preFilter(
+                const physx::PxFilterData& filterData, const physx::PxShape* shape, const physx::PxRigidActor* actor, physx::PxHitFlags& queryFlags);
+            virtual physx::PxQueryHitType::Enum postFilter(const physx::PxFilterData& filterData, const physx::PxQueryHit& hit) { return physx::PxQueryHitType::Enum::eBLOCK; }
+        };
+
 		static physx::PxFilterFlags PhysicsFilterShader(
 			physx::PxFilterObjectAttributes attributes0, physx::PxFilterData filterData0,
 			physx::PxFilterObjectAttributes attributes1, physx::PxFilterData filterData1,
@@ -113,9 +226,33 @@ namespace tremble
 		bool Startup(); //!< Startup physics
 		void Shutdown(); //!< Shutdown physics
 
+		/**
+		* @brief Casts rays from spread out origins against the scene, once one at a time & once as a batch, & adds up the times
+		* @param[in] num_rays The number of rays cast each way
+		*/
+		void BenchmarkQueries(UINT num_rays);
+
+		/**
+		* @brief Reads the step's counts from PhysX & the allocator, adds the step to the totals & writes it to the stats file
+		* @param[in] stats The stats of the step that was just taken, the timings & callback counts are filled in already
+		*/
+		void RecordStepStats(PhysicsStepStats& stats);
+
+		/**
+		* @brief Moves the nodes of the dynamic rigidbodies that moved during the last step, resting bodies aren't touched at all
+		* @return The number of rigidbodies that were moved
+		*/
+		uint32_t SyncActiveTransforms();
+
 		ContactCallbackProcessing contact_callback_;
 		AllocatorCallback* allocator_callback_;
         QueryFilterCallback query_filter_callback_;
+        OwnerFilterCallback owner_filter_callback_;
+        QueryOwner last_query_owner_; //!< The last owner id that was handed out
+        SceneQueryBatch* scene_queries_; //!< The queries queued by components
+        SceneQueryBatch* benchmark_queries_; //!< The batch the query benchmark queues its rays in, kept apart from the components' queries
+        CollisionCache* collision_cache_; //!< The cooked triangle & convex meshes
+        StaticGeometryMerger* static_geometry_merger_; //!< Merges static rigidbodies into a few large actors
 		ErrorCallback error_callback_;
 
 		physx::PxFoundation* px_foundation_;
@@ -131,6 +268,16 @@ namespace tremble
 		std::unordered_map<std::string, PhysicsMaterial> physics_materials_;
         FreeListAllocator* physics_allocator_; //!< Personal allocator for not PhysX object, but physics objects
         FreeListAllocator* px_allocator_; //!< Allocator, used by PhysX
+
+        float benchmark_single_time_; //!< The total time spent casting the benchmark rays one at a time, in milliseconds
+        float benchmark_batched_time_; //!< The total time spent casting the benchmark rays as a batch, in milliseconds
+        UINT benchmark_single_hits_; //!< The total number of benchmark rays that hit something when cast one at a time
+        UINT benchmark_batched_hits_; //!< The total number of benchmark rays that hit something when cast as a batch
+
+        PhysicsStepStats last_step_stats_; //!< The timings & counts of the last physics step
+        PhysicsStepStats total_stats_; //!< The timings & counts of all physics steps added up
+        uint64_t num_steps_; //!< The number of physics steps that were taken
+        std::ofstream stats_file_; //!< The file every step's stats are written to, not open if no file was configured
 	};
 
 
@@ -0,0 +1,44 @@
+#include "physics_stats.h"
+
+namespace tremble
+{
+	//------------------------------------------------------------------------------------------------------
+	void PhysicsStepStats::Add(const PhysicsStepStats& other)
+	{
+		simulate_time += other.simulate_time;
+		fetch_time += other.fetch_time;
+		callback_time += other.callback_time;
+		sync_time += other.sync_time;
+		num_active_dynamic += other.num_active_dynamic;
+		num_active_kinematic += other.num_active_kinematic;
+		num_static += other.num_static;
+		num_dynamic += other.num_dynamic;
+		num_synced_bodies += other.num_synced_bodies;
+		num_broadphase_new_pairs += other.num_broadphase_new_pairs;
+		num_broadphase_lost_pairs += other.num_broadphase_lost_pairs;
+		num_narrowphase_pairs += other.num_narrowphase_pairs;
+		num_contact_pairs += other.num_contact_pairs;
+		num_contact_points += other.num_contact_points;
+		num_trigger_events += other.num_trigger_events;
+		px_memory_used = std::max(px_memory_used, other.px_memory_used);
+		px_allocations = std::max(px_allocations, other.px_allocations);
+	}
+
+	//------------------------------------------------------------------------------------------------------
+	void PhysicsStepStats::WriteCsvHeader(std::ostream& stream)
+	{
+		stream << "step,simulate_ms,fetch_ms,callback_ms,sync_ms,active_dynamic,active_kinematic,static,dynamic,synced_bodies,"
+			<< "broadphase_new_pairs,broadphase_lost_pairs,narrowphase_pairs,contact_pairs,contact_points,trigger_events,"
+			<< "px_memory_used,px_allocations" << std::endl;
+	}
+
+	//------------------------------------------------------------------------------------------------------
+	void PhysicsStepStats::WriteCsvRow(std::ostream& stream, uint64_t step) const
+	{
+		stream << step << ',' << simulate_time << ',' << fetch_time << ',' << callback_time << ',' << sync_time << ','
+			<< num_active_dynamic << ',' << num_active_kinematic << ',' << num_static << ',' << num_dynamic << ',' << num_synced_bodies << ','
+			<< num_broadphase_new_pairs << ',' << num_broadphase_lost_pairs << ',' << num_narrowphase_pairs << ','
+			<< num_contact_pairs << ',' << num_contact_points << ',' << num_trigger_events << ','
+			<< px_memory_used << ',' << px_allocations << '\n';
+	}
+}
\ No newline at end of file
@@ -0,0 +1,51 @@
+#pragma once
+
+namespace tremble
+{
+	/**
+	* @struct tremble::PhysicsStepStats
+	* @brief What happened during one or more physics steps
+	*
+	* simulate only hands the step to PhysX' worker threads, waiting for them is part of the fetch time. The
+	* contact & trigger callbacks run inside fetchResults, their time is taken out of the fetch time.
+	*/
+	struct PhysicsStepStats
+	{
+		float simulate_time = 0.0f; //!< The time spent in simulate, in milliseconds
+		float fetch_time = 0.0f; //!< The time spent in fetchResults waiting for the step, without the callbacks, in milliseconds
+		float callback_time = 0.0f; //!< The time spent in the contact & trigger callbacks, in milliseconds
+		float sync_time = 0.0f; //!< The time spent moving the nodes of the bodies that moved, in milliseconds
+		uint64_t num_active_dynamic = 0; //!< The number of awake dynamic bodies
+		uint64_t num_active_kinematic = 0; //!< The number of awake kinematic bodies
+		uint64_t num_static = 0; //!< The number of static bodies
+		uint64_t num_dynamic = 0; //!< The number of dynamic bodies
+		uint64_t num_synced_bodies = 0; //!< The number of dynamic rigidbodies whose nodes were moved after the step
+		uint64_t num_broadphase_new_pairs = 0; //!< The number of pairs the broadphase found
+		uint64_t num_broadphase_lost_pairs = 0; //!< The number of pairs the broadphase lost
+		uint64_t num_narrowphase_pairs = 0; //!< The number of pairs the narrowphase tested
+		uint64_t num_contact_pairs = 0; //!< The number of contact pairs reported to onContact
+		uint64_t num_contact_points = 0; //!< The number of contact points in the reported pairs
+		uint64_t num_trigger_events = 0; //!< The number of trigger enter & exit events reported to onTrigger
+		uint64_t px_memory_used = 0; //!< The number of bytes PhysX has allocated after the step, the peak when stats are added
+		uint64_t px_allocations = 0; //!< The number of allocations PhysX holds after the step, the peak when stats are added
+
+		/**
+		* @brief Adds the stats of another step to these
+		* @param[in] other The stats to add
+		*/
+		void Add(const PhysicsStepStats& other);
+
+		/**
+		* @brief Writes the column names of WriteCsvRow
+		* @param[in] stream The stream to write to
+		*/
+		static void WriteCsvHeader(std::ostream& stream);
+
+		/**
+		* @brief Writes the stats as a line of comma separated values
+		* @param[in] stream The stream to write to
+		* @param[in] step The number of the step, written in the first column
+		*/
+		void WriteCsvRow(std::ostream& stream, uint64_t step) const;
+	};
+}
\ No newline at end of file
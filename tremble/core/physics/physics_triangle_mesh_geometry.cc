@@ -3,12 +3,19 @@
 #include "core/resources/model.h"
 #include "core/resources/mesh.h"
 #include "core/physics/physics_manager.h"
+#include "core/physics/collision_cache.h"
 #include "core/rendering/renderer.h"
 
 namespace tremble
 {
 	using namespace physx;
 
+    //------------------------------------------------------------------------------------------------------
+    PhysicsTriangleMeshGeometry::PhysicsTriangleMeshGeometry() :
+        PhysicsGeometry(TriangleMesh)
+    {
+    }
+
     //------------------------------------------------------------------------------------------------------
     PhysicsTriangleMeshGeometry::PhysicsTriangleMeshGeometry(tremble::Mesh* mesh) :
         PhysicsGeometry(TriangleMesh)
@@ -39,31 +46,14 @@ namespace tremble
     //------------------------------------------------------------------------------------------------------
     void PhysicsTriangleMeshGeometry::cookTriangleMeshGeometry(tremble::Mesh* mesh)
     {
-        std::vector<PxVec3> verts = GetVertices(mesh);
-        std::vector<PxU32> indices32 = GetIndices(mesh);
-
-        PxTriangleMeshDesc mesh_desc;        
-        mesh_desc.points.count          = PxU32(verts.size());
-        mesh_desc.points.stride         = sizeof(PxVec3);
-        mesh_desc.points.data           = &verts[0];
-
-        mesh_desc.triangles.count       = PxU32(indices32.size()) / 3;
-        mesh_desc.triangles.stride      = 3 * sizeof(PxU32);
-        mesh_desc.triangles.data        = &indices32[0];
-
-        PxDefaultMemoryOutputStream writeBuffer;
-        PxCooking* the_cooking = Get::PhysicsManager()->GetCooking();
-        bool status = the_cooking->cookTriangleMesh(mesh_desc, writeBuffer);
-        if (!status)
+        PxTriangleMesh* px_triangle_mesh = Get::PhysicsManager()->GetCollisionCache()->GetTriangleMesh(GetVertices(mesh), GetIndices(mesh));
+        if (px_triangle_mesh == nullptr)
         {
             ASSERT(false && "Failed to cook TriangleMesh");
             return;
         }
 
-        PxDefaultMemoryInputData readBuffer(writeBuffer.getData(), writeBuffer.getSize());
-
-        PxPhysics* the_physics = Get::PhysicsManager()->GetPxPhysics();
-        px_triangle_mesh_geometry_ = PxTriangleMeshGeometry(the_physics->createTriangleMesh(readBuffer));
+        px_triangle_mesh_geometry_ = PxTriangleMeshGeometry(px_triangle_mesh);
     }
 
     //------------------------------------------------------------------------------------------------------
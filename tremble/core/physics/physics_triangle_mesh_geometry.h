@@ -11,8 +11,16 @@ namespace tremble
     class PhysicsTriangleMeshGeometry : public PhysicsGeometry
 	{
 	public:
+        PhysicsTriangleMeshGeometry(); //!< Creates an empty geometry, which has to be cooked before it's used
         PhysicsTriangleMeshGeometry(tremble::Mesh* mesh);
 
+        /**
+        * @brief Gets the triangle mesh of a mesh from the physics manager's collision cache, cooking it if it isn't cached yet
+        * @param[in] mesh The mesh, its CPU-side vertices can't have been released
+        */
+        void cookTriangleMeshGeometry(tremble::Mesh* mesh);
+        bool IsCooked() const { return px_triangle_mesh_geometry_.triangleMesh != nullptr; } //!< Whether the geometry has a triangle mesh
+
 		physx::PxGeometry* GetPxGeometry() const override;
         void Scale(const Vector3& scale) override;
 
@@ -22,9 +30,6 @@ namespace tremble
         static std::vector<physx::PxU32> GetIndices(tremble::Mesh* mesh);
         static std::vector<physx::PxU32> CreateFakeIndices(int size);
 	private:
-
-        void cookTriangleMeshGeometry(tremble::Mesh* mesh);
-
 		physx::PxTriangleMeshGeometry px_triangle_mesh_geometry_;
 	};
 }
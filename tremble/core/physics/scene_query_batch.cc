@@ -0,0 +1,173 @@
+#include "scene_query_batch.h"
+
+#include "physics_manager.h"
+#include "physics_geometry.h"
+#include "../math/math.h"
+
+#include <ppl.h>
+
+namespace tremble
+{
+	using namespace physx;
+
+	//------------------------------------------------------------------------------------------------------
+	SceneQueryBatch::SceneQueryBatch(PxScene* px_scene, PxQueryFilterCallback* owner_filter) :
+		px_scene_(px_scene),
+		owner_filter_(owner_filter),
+		queued_batch_(1),
+		executed_batch_(0)
+	{
+
+	}
+
+	//------------------------------------------------------------------------------------------------------
+	SceneQueryHandle SceneQueryBatch::QueueRaycast(const Vector3& origin, const Vector3& direction, float max_distance, uint32_t layer_mask, QueryOwner ignored_owner)
+	{
+		Query query;
+		query.type = Raycast;
+		query.pose = PxTransform(origin.ToPxVec3());
+		query.direction = direction.ToPxVec3();
+		query.max_distance = max_distance;
+		query.layer_mask = layer_mask;
+		query.ignored_owner = ignored_owner;
+
+		return Queue(query);
+	}
+
+	//------------------------------------------------------------------------------------------------------
+	SceneQueryHandle SceneQueryBatch::QueueSweep(PhysicsGeometry* geometry, const Vector3& position, const Quaternion& rotation, const Vector3& direction, float max_distance, uint32_t layer_mask, QueryOwner ignored_owner)
+	{
+		Query query;
+		query.type = Sweep;
+		query.pose = PxTransform(position.ToPxVec3(), rotation.ToPxQuat());
+		query.direction = direction.ToPxVec3();
+		query.max_distance = max_distance;
+		query.geometry.storeAny(*geometry->GetPxGeometry());
+		query.layer_mask = layer_mask;
+		query.ignored_owner = ignored_owner;
+
+		return Queue(query);
+	}
+
+	//------------------------------------------------------------------------------------------------------
+	SceneQueryHandle SceneQueryBatch::QueueOverlap(PhysicsGeometry* geometry, const Vector3& position, const Quaternion& rotation, uint32_t layer_mask, QueryOwner ignored_owner)
+	{
+		Query query;
+		query.type = Overlap;
+		query.pose = PxTransform(position.ToPxVec3(), rotation.ToPxQuat());
+		query.direction = PxVec3(0.0f);
+		query.max_distance = 0.0f;
+		query.geometry.storeAny(*geometry->GetPxGeometry());
+		query.layer_mask = layer_mask;
+		query.ignored_owner = ignored_owner;
+
+		return Queue(query);
+	}
+
+	//------------------------------------------------------------------------------------------------------
+	void SceneQueryBatch::Execute()
+	{
+		uint32_t num_queries = static_cast<uint32_t>(queries_.size());
+		results_.resize(num_queries);
+
+		if (num_queries <= SCENE_QUERY_BLOCK_SIZE)
+		{
+			ExecuteRange(0, num_queries);
+		}
+		else
+		{
+			uint32_t num_blocks = (num_queries + SCENE_QUERY_BLOCK_SIZE - 1) / SCENE_QUERY_BLOCK_SIZE;
+			concurrency::parallel_for(0u, num_blocks, [this, num_queries](uint32_t block)
+			{
+				ExecuteRange(block * SCENE_QUERY_BLOCK_SIZE, std::min(num_queries, (block + 1) * SCENE_QUERY_BLOCK_SIZE));
+			});
+		}
+
+		queries_.clear();
+		executed_batch_ = queued_batch_++;
+	}
+
+	//------------------------------------------------------------------------------------------------------
+	const SceneQueryResult& SceneQueryBatch::GetResult(const SceneQueryHandle& handle) const
+	{
+		ASSERT(IsReady(handle) == true);
+		return results_[handle.index];
+	}
+
+	//------------------------------------------------------------------------------------------------------
+	SceneQueryHandle SceneQueryBatch::Queue(const Query& query)
+	{
+		SceneQueryHandle handle = { queued_batch_, static_cast<uint32_t>(queries_.size()) };
+		queries_.push_back(query);
+		return handle;
+	}
+
+	//------------------------------------------------------------------------------------------------------
+	void SceneQueryBatch::ExecuteRange(uint32_t begin, uint32_t end)
+	{
+		for (uint32_t i = begin; i < end; i++)
+		{
+			const Query& query = queries_[i];
+			SceneQueryResult& result = results_[i];
+
+			PxQueryFilterData filter_data = PhysicsManager::GetQueryFilterData(query.layer_mask, query.ignored_owner);
+			PxQueryFilterCallback* filter_callback = query.ignored_owner != 0 ? owner_filter_ : nullptr;
+
+			const PxActor* actor = nullptr;
+			const PxShape* shape = nullptr;
+			PxU32 face_index = PX_MAX_U32;
+			result.hit = false;
+			result.position = PxVec3(0.0f);
+			result.normal = PxVec3(0.0f);
+			result.distance = 0.0f;
+
+			switch (query.type)
+			{
+			case Raycast:
+			{
+				PxRaycastBuffer buffer;
+				if (px_scene_->raycast(query.pose.p, query.direction, query.max_distance, buffer, PxHitFlag::eDEFAULT, filter_data, filter_callback) == true && buffer.hasBlock == true)
+				{
+					result.hit = true;
+					result.position = buffer.block.position;
+					result.normal = buffer.block.normal;
+					result.distance = buffer.block.distance;
+					actor = buffer.block.actor;
+					shape = buffer.block.shape;
+					face_index = buffer.block.faceIndex;
+				}
+				break;
+			}
+			case Sweep:
+			{
+				PxSweepBuffer buffer;
+				if (px_scene_->sweep(query.geometry.any(), query.pose, query.direction, query.max_distance, buffer, PxHitFlag::eDEFAULT, filter_data, filter_callback) == true && buffer.hasBlock == true)
+				{
+					result.hit = true;
+					result.position = buffer.block.position;
+					result.normal = buffer.block.normal;
+					result.distance = buffer.block.distance;
+					actor = buffer.block.actor;
+					shape = buffer.block.shape;
+					face_index = buffer.block.faceIndex;
+				}
+				break;
+			}
+			case Overlap:
+			{
+				PxOverlapBuffer buffer;
+				filter_data.flags |= PxQueryFlag::eANY_HIT;
+				if (px_scene_->overlap(query.geometry.any(), query.pose, buffer, filter_data, filter_callback) == true && buffer.hasBlock == true)
+				{
+					result.hit = true;
+					actor = buffer.block.actor;
+					shape = buffer.block.shape;
+				}
+				break;
+			}
+			}
+
+			result.component = actor != nullptr ? PhysicsManager::GetComponentFromHit(actor, shape, face_index) : nullptr;
+		}
+	}
+}
\ No newline at end of file
@@ -0,0 +1,156 @@
+#pragma once
+
+#include "physics_layers.h"
+
+#define SCENE_QUERY_BLOCK_SIZE 64 // the number of queries a single worker executes at once, smaller batches are executed on the calling thread
+
+namespace tremble
+{
+	class Component;
+	class Vector3;
+	class Quaternion;
+	class PhysicsGeometry;
+
+	/**
+	* @struct tremble::SceneQueryHandle
+	* @brief Identifies a queued scene query, used to read its result once its batch was executed
+	*/
+	struct SceneQueryHandle
+	{
+		uint32_t batch; //!< The batch the query was queued in, 0 for a handle that doesn't refer to a query
+		uint32_t index; //!< The index of the query in its batch
+	};
+
+	/**
+	* @struct tremble::SceneQueryResult
+	* @brief The closest hit of a raycast or sweep, or the first shape found by an overlap
+	*/
+	struct SceneQueryResult
+	{
+		bool hit; //!< Whether anything was hit
+		physx::PxVec3 position; //!< The position of the hit, not set by overlaps
+		physx::PxVec3 normal; //!< The normal at the hit, not set by overlaps
+		float distance; //!< The distance along the ray or sweep, 0 for overlaps
+		Component* component; //!< The component that was hit, resolved per triangle on merged static geometry, nullptr if nothing was hit or the actor has none
+	};
+
+	/**
+	* @class tremble::SceneQueryBatch
+	* @brief Collects raycasts, sweeps & overlaps & executes them all at once
+	*
+	* Components queue their queries during the update & read the results through the returned handles after the
+	* batch was executed. Large batches are split into blocks that run on worker threads, which is safe as
+	* nothing writes to the scene while it's executed. Queries copy their geometry, so it doesn't have to outlive the call.
+	*/
+	class SceneQueryBatch
+	{
+	public:
+		/**
+		* @param[in] px_scene The scene the queries are executed against
+		* @param[in] owner_filter Skips the shapes of a query's ignored owner, it has to be safe to call from several threads
+		*/
+		SceneQueryBatch(physx::PxScene* px_scene, physx::PxQueryFilterCallback* owner_filter);
+
+		/**
+		* @brief Queues a raycast
+		* @param[in] origin The origin of the ray
+		* @param[in] direction The normalized direction of the ray
+		* @param[in] max_distance The length of the ray
+		* @param[in] layer_mask The collision layers the ray can hit
+		* @param[in] ignored_owner The owner of which the shapes are skipped, 0 to skip none
+		* @return The handle to read the result with
+		*/
+		SceneQueryHandle QueueRaycast(const Vector3& origin, const Vector3& direction, float max_distance, uint32_t layer_mask, QueryOwner ignored_owner = 0);
+
+		/**
+		* @brief Queues a sweep
+		* @param[in] geometry The geometry to sweep
+		* @param[in] position The position the sweep starts at
+		* @param[in] rotation The rotation of the geometry
+		* @param[in] direction The normalized direction of the sweep
+		* @param[in] max_distance The length of the sweep
+		* @param[in] layer_mask The collision layers the sweep can hit
+		* @param[in] ignored_owner The owner of which the shapes are skipped, 0 to skip none
+		* @return The handle to read the result with
+		*/
+		SceneQueryHandle QueueSweep(PhysicsGeometry* geometry, const Vector3& position, const Quaternion& rotation, const Vector3& direction, float max_distance, uint32_t layer_mask, QueryOwner ignored_owner = 0);
+
+		/**
+		* @brief Queues an overlap, which stops at the first shape it finds
+		* @param[in] geometry The geometry to test
+		* @param[in] position The position of the geometry
+		* @param[in] rotation The rotation of the geometry
+		* @param[in] layer_mask The collision layers that are tested
+		* @param[in] ignored_owner The owner of which the shapes are skipped, 0 to skip none
+		* @return The handle to read the result with
+		*/
+		SceneQueryHandle QueueOverlap(PhysicsGeometry* geometry, const Vector3& position, const Quaternion& rotation, uint32_t layer_mask, QueryOwner ignored_owner = 0);
+
+		/**
+		* @brief Executes all queued queries & clears the queue, the results of the previous batch are no longer available afterwards
+		*/
+		void Execute();
+
+		/**
+		* @brief Checks whether the result of a query is available, that is whether its batch was the last one executed
+		* @param[in] handle The handle of the query
+		*/
+		bool IsReady(const SceneQueryHandle& handle) const { return handle.batch != 0 && handle.batch == executed_batch_; }
+
+		/**
+		* @brief Gets the result of a query, only valid when the query IsReady
+		* @param[in] handle The handle of the query
+		*/
+		const SceneQueryResult& GetResult(const SceneQueryHandle& handle) const;
+
+		uint32_t GetNumQueued() const { return static_cast<uint32_t>(queries_.size()); } //!< The number of queries waiting for the next Execute
+
+	private:
+		/**
+		* @brief The kind of a queued query
+		*/
+		enum QueryType
+		{
+			Raycast,
+			Sweep,
+			Overlap
+		};
+
+		/**
+		* @struct tremble::SceneQueryBatch::Query
+		* @brief A queued query
+		*/
+		struct Query
+		{
+			QueryType type; //!< The kind of query
+			physx::PxTransform pose; //!< The origin of a raycast, or the pose of a sweep or overlap geometry
+			physx::PxVec3 direction; //!< The direction of a raycast or sweep
+			float max_distance; //!< The length of a raycast or sweep
+			physx::PxGeometryHolder geometry; //!< A copy of the geometry of a sweep or overlap
+			uint32_t layer_mask; //!< The collision layers the query can hit
+			QueryOwner ignored_owner; //!< The owner of which the shapes are skipped
+		};
+
+		/**
+		* @brief Adds a query to the queue
+		* @param[in] query The query to add
+		* @return The handle of the query
+		*/
+		SceneQueryHandle Queue(const Query& query);
+
+		/**
+		* @brief Executes a range of the queued queries
+		* @param[in] begin The first query of the range
+		* @param[in] end One past the last query of the range
+		*/
+		void ExecuteRange(uint32_t begin, uint32_t end);
+
+		physx::PxScene* px_scene_; //!< The scene the queries are executed against
+		physx::PxQueryFilterCallback* owner_filter_; //!< Skips the shapes of a query's ignored owner
+
+		std::vector<Query> queries_; //!< The queries waiting for the next Execute
+		std::vector<SceneQueryResult> results_; //!< The results of the last executed batch
+		uint32_t queued_batch_; //!< The batch the queued queries belong to
+		uint32_t executed_batch_; //!< The batch the results belong to, 0 before the first Execute
+	};
+}
\ No newline at end of file
@@ -0,0 +1,276 @@
+#include "static_geometry_merger.h"
+
+#include "physics_manager.h"
+#include "physics_material.h"
+#include "physics_triangle_mesh_geometry.h"
+#include "collision_cache.h"
+#include "../resources/mesh.h"
+#include "../utilities/stopwatch.h"
+
+namespace tremble
+{
+	using namespace physx;
+
+	//------------------------------------------------------------------------------------------------------
+	Component* StaticGeometryMerger::Chunk::GetComponent(PxU32 face_index) const
+	{
+		if (face_index >= num_triangles)
+		{
+			return nullptr;
+		}
+
+		return triangle_components[triangle_remap != nullptr ? triangle_remap[face_index] : face_index];
+	}
+
+	//------------------------------------------------------------------------------------------------------
+	StaticGeometryMerger::StaticGeometryMerger(PxPhysics* px_physics, PxScene* px_scene, CollisionCache* collision_cache) :
+		px_physics_(px_physics),
+		px_scene_(px_scene),
+		collision_cache_(collision_cache),
+		collecting_(false),
+		num_meshes_(0)
+	{
+
+	}
+
+	//------------------------------------------------------------------------------------------------------
+	StaticGeometryMerger::~StaticGeometryMerger()
+	{
+		for (size_t i = 0; i < chunks_.size(); i++)
+		{
+			chunks_[i].px_actor->release();
+		}
+	}
+
+	//------------------------------------------------------------------------------------------------------
+	void StaticGeometryMerger::Begin()
+	{
+		ASSERT(collecting_ == false);
+		collecting_ = true;
+	}
+
+	//------------------------------------------------------------------------------------------------------
+	void StaticGeometryMerger::End()
+	{
+		ASSERT(collecting_ == true);
+		collecting_ = false;
+
+		if (groups_.empty() == true)
+		{
+			return;
+		}
+
+		Stopwatch stopwatch;
+
+		std::vector<std::vector<PxVec3>> chunk_vertices;
+		std::vector<std::vector<PxU32>> chunk_indices;
+		std::vector<std::vector<Component*>> chunk_components;
+		std::vector<PhysicsMaterial*> chunk_materials;
+		size_t num_triangles = 0;
+
+		for (size_t i = 0; i < groups_.size(); i++)
+		{
+			const Group& group = groups_[i];
+			size_t group_triangles = group.indices.size() / 3;
+			num_triangles += group_triangles;
+
+			std::vector<PxVec3> centers(group_triangles);
+			std::vector<PxU32> triangles(group_triangles);
+			for (size_t t = 0; t < group_triangles; t++)
+			{
+				centers[t] = (group.vertices[group.indices[t * 3]] + group.vertices[group.indices[t * 3 + 1]] + group.vertices[group.indices[t * 3 + 2]]) / 3.0f;
+				triangles[t] = static_cast<PxU32>(t);
+			}
+
+			std::vector<std::pair<size_t, size_t>> ranges;
+			Split(centers, triangles, 0, group_triangles, ranges);
+
+			// every chunk only keeps the vertices its own triangles use
+			std::vector<PxU32> vertex_remap(group.vertices.size(), PX_MAX_U32);
+			std::vector<PxU32> used_vertices;
+
+			for (size_t r = 0; r < ranges.size(); r++)
+			{
+				chunk_vertices.emplace_back();
+				chunk_indices.emplace_back();
+				chunk_components.emplace_back();
+				chunk_materials.push_back(group.material);
+
+				std::vector<PxVec3>& vertices = chunk_vertices.back();
+				std::vector<PxU32>& indices = chunk_indices.back();
+				std::vector<Component*>& components = chunk_components.back();
+
+				for (size_t t = ranges[r].first; t < ranges[r].second; t++)
+				{
+					PxU32 triangle = triangles[t];
+					for (PxU32 corner = 0; corner < 3; corner++)
+					{
+						PxU32 vertex = group.indices[triangle * 3 + corner];
+						if (vertex_remap[vertex] == PX_MAX_U32)
+						{
+							vertex_remap[vertex] = static_cast<PxU32>(vertices.size());
+							vertices.push_back(group.vertices[vertex]);
+							used_vertices.push_back(vertex);
+						}
+						indices.push_back(vertex_remap[vertex]);
+					}
+					components.push_back(group.triangle_components[triangle]);
+				}
+
+				for (size_t v = 0; v < used_vertices.size(); v++)
+				{
+					vertex_remap[used_vertices[v]] = PX_MAX_U32;
+				}
+				used_vertices.clear();
+			}
+		}
+		float split_time = stopwatch.OutputAndReset() * 1000.0f;
+
+		collision_cache_->Prepare(chunk_vertices, chunk_indices);
+		float cook_time = stopwatch.OutputAndReset() * 1000.0f;
+
+		size_t num_chunks = 0;
+		for (size_t i = 0; i < chunk_vertices.size(); i++)
+		{
+			PxTriangleMesh* px_triangle_mesh = collision_cache_->GetTriangleMesh(chunk_vertices[i], chunk_indices[i]);
+			if (px_triangle_mesh == nullptr)
+			{
+				ASSERT(false && "Failed to cook a merged static chunk");
+				continue;
+			}
+
+			chunks_.emplace_back();
+			Chunk& chunk = chunks_.back();
+			chunk.px_actor = px_physics_->createRigidStatic(PxTransform(PxIdentity));
+			chunk.triangle_remap = px_triangle_mesh->getTrianglesRemap();
+			chunk.num_triangles = px_triangle_mesh->getNbTriangles();
+			chunk.triangle_components = std::move(chunk_components[i]);
+
+			for (size_t t = 0; t < chunk.triangle_components.size(); t++)
+			{
+				std::vector<Chunk*>& component_chunks = component_chunks_[chunk.triangle_components[t]];
+				if (component_chunks.empty() == true || component_chunks.back() != &chunk)
+				{
+					component_chunks.push_back(&chunk);
+				}
+			}
+
+			PxShape* px_shape = px_physics_->createShape(PxTriangleMeshGeometry(px_triangle_mesh), *chunk_materials[i]->GetPxMaterial(), true);
+			PhysicsManager::SetCollisionLayer(px_shape, LAYER_STATIC);
+			px_shape->userData = &chunk;
+			chunk.px_actor->attachShape(*px_shape);
+			px_shape->release();
+
+			// the actor has no component of its own, hits are resolved per triangle through the shape
+			chunk.px_actor->userData = nullptr;
+			px_scene_->addActor(*chunk.px_actor);
+			num_chunks++;
+		}
+		float insert_time = stopwatch.Output() * 1000.0f;
+
+		DLOG("static geometry merging: " << num_meshes_ << " meshes with " << num_triangles << " triangles merged into " << num_chunks << " actors, splitting took "
+			<< split_time << " ms, cooking " << cook_time << " ms & adding the actors " << insert_time << " ms");
+
+		groups_.clear();
+		num_meshes_ = 0;
+	}
+
+	//------------------------------------------------------------------------------------------------------
+	void StaticGeometryMerger::Add(Component* component, Mesh* mesh, const PxTransform& pose, const PxVec3& scale, PhysicsMaterial* material)
+	{
+		ASSERT(collecting_ == true);
+		ASSERT(mesh->IsMeshDataReleased() == false);
+
+		Group* group = nullptr;
+		for (size_t i = 0; i < groups_.size() && group == nullptr; i++)
+		{
+			if (groups_[i].material == material)
+			{
+				group = &groups_[i];
+			}
+		}
+
+		if (group == nullptr)
+		{
+			groups_.emplace_back();
+			group = &groups_.back();
+			group->material = material;
+		}
+
+		std::vector<PxVec3> vertices = PhysicsTriangleMeshGeometry::GetVertices(mesh);
+		std::vector<PxU32> indices = PhysicsTriangleMeshGeometry::GetIndices(mesh);
+		PxU32 first_vertex = static_cast<PxU32>(group->vertices.size());
+
+		for (size_t i = 0; i < vertices.size(); i++)
+		{
+			group->vertices.push_back(pose.transform(vertices[i].multiply(scale)));
+		}
+
+		// baking a mirroring scale into the vertices turns the triangles inside out, PhysX only corrects that for scales that are part of the geometry
+		bool mirrored = scale.x * scale.y * scale.z < 0.0f;
+		for (size_t i = 0; i + 2 < indices.size(); i += 3)
+		{
+			group->indices.push_back(first_vertex + indices[i]);
+			group->indices.push_back(first_vertex + indices[mirrored == true ? i + 2 : i + 1]);
+			group->indices.push_back(first_vertex + indices[mirrored == true ? i + 1 : i + 2]);
+		}
+
+		group->triangle_components.insert(group->triangle_components.end(), indices.size() / 3, component);
+		num_meshes_++;
+	}
+
+	//------------------------------------------------------------------------------------------------------
+	void StaticGeometryMerger::Remove(Component* component)
+	{
+		// the triangles stay in the merged actors, recooking a chunk isn't worth it for the few brushes that are destroyed
+		for (size_t i = 0; i < groups_.size(); i++)
+		{
+			std::replace(groups_[i].triangle_components.begin(), groups_[i].triangle_components.end(), component, static_cast<Component*>(nullptr));
+		}
+
+		auto it = component_chunks_.find(component);
+		if (it == component_chunks_.end())
+		{
+			return;
+		}
+
+		for (size_t i = 0; i < it->second.size(); i++)
+		{
+			std::vector<Component*>& triangle_components = it->second[i]->triangle_components;
+			std::replace(triangle_components.begin(), triangle_components.end(), component, static_cast<Component*>(nullptr));
+		}
+		component_chunks_.erase(it);
+	}
+
+	//------------------------------------------------------------------------------------------------------
+	void StaticGeometryMerger::Split(const std::vector<PxVec3>& centers, std::vector<PxU32>& triangles, size_t first, size_t last, std::vector<std::pair<size_t, size_t>>& out_ranges)
+	{
+		if (last - first <= STATIC_MERGE_MAX_TRIANGLES)
+		{
+			if (last > first)
+			{
+				out_ranges.push_back(std::make_pair(first, last));
+			}
+			return;
+		}
+
+		PxBounds3 bounds = PxBounds3::empty();
+		for (size_t i = first; i < last; i++)
+		{
+			bounds.include(centers[triangles[i]]);
+		}
+
+		PxVec3 extents = bounds.getExtents();
+		int axis = extents.x > extents.y ? (extents.x > extents.z ? 0 : 2) : (extents.y > extents.z ? 1 : 2);
+
+		// splitting at the median keeps the chunks equally large, however unevenly the triangles are spread
+		size_t middle = first + (last - first) / 2;
+		std::nth_element(triangles.begin() + first, triangles.begin() + middle, triangles.begin() + last, [&centers, axis](PxU32 a, PxU32 b)
+		{
+			return centers[a][axis] < centers[b][axis];
+		});
+
+		Split(centers, triangles, first, middle, out_ranges);
+		Split(centers, triangles, middle, last, out_ranges);
+	}
+}
\ No newline at end of file
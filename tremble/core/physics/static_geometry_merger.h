@@ -0,0 +1,112 @@
+#pragma once
+
+#include <deque>
+#include <unordered_map>
+
+#define STATIC_MERGE_MAX_TRIANGLES 8192 // chunks are split in half along their longest axis until they hold at most this many triangles
+
+namespace tremble
+{
+	class Component;
+	class Mesh;
+	class PhysicsMaterial;
+	class CollisionCache;
+
+	/**
+	* @class tremble::StaticGeometryMerger
+	* @brief Merges the triangle meshes of static rigidbodies into a few large actors while a scene loads
+	*
+	* Every brush of a level used to be a static actor of its own, so big levels put thousands of actors in the
+	* broadphase. While the merger collects, static rigidbodies made from a model hand their triangles to it instead
+	* of creating an actor. Ending the collection groups the triangles by physics material, splits every group into
+	* spatially compact chunks & creates a single triangle mesh actor per chunk.
+	*
+	* Merged actors have no component, their shape points to the chunk, which knows the component every triangle
+	* came from. PhysicsManager::GetComponentFromHit resolves hits through it.
+	*/
+	class StaticGeometryMerger
+	{
+	public:
+		/**
+		* @struct tremble::StaticGeometryMerger::Chunk
+		* @brief A merged actor & the components its triangles belong to
+		*/
+		struct Chunk
+		{
+			physx::PxRigidStatic* px_actor; //!< The merged actor
+			const physx::PxU32* triangle_remap; //!< Maps the triangles of the cooked mesh to the triangles it was cooked from, nullptr if PhysX kept their order
+			physx::PxU32 num_triangles; //!< The number of triangles of the cooked mesh
+			std::vector<Component*> triangle_components; //!< The component of every triangle the mesh was cooked from
+
+			/**
+			* @brief Gets the component a triangle of the cooked mesh came from
+			* @param[in] face_index The face index of a hit on the chunk's shape
+			* @return The component, nullptr if the face index isn't valid, e.g. for overlaps
+			*/
+			Component* GetComponent(physx::PxU32 face_index) const;
+		};
+
+		/**
+		* @param[in] px_physics The physics the actors are created with
+		* @param[in] px_scene The scene the actors are added to
+		* @param[in] collision_cache The cache the merged meshes are cooked with
+		*/
+		StaticGeometryMerger(physx::PxPhysics* px_physics, physx::PxScene* px_scene, CollisionCache* collision_cache);
+		~StaticGeometryMerger(); //!< Releases the merged actors
+
+		void Begin(); //!< Starts collecting the triangles of static rigidbodies
+		void End(); //!< Merges the collected triangles into chunks & adds their actors to the scene
+		bool IsCollecting() const { return collecting_; } //!< Whether static rigidbodies should hand their triangles to the merger
+
+		/**
+		* @brief Adds the triangles of a mesh, only valid while collecting
+		* @param[in] component The component hits on the triangles resolve to
+		* @param[in] mesh The mesh, its CPU-side vertices can't have been released
+		* @param[in] pose The pose of the mesh in the world
+		* @param[in] scale The scale of the mesh, applied before the pose
+		* @param[in] material The physics material of the mesh
+		*/
+		void Add(Component* component, Mesh* mesh, const physx::PxTransform& pose, const physx::PxVec3& scale, PhysicsMaterial* material);
+
+		/**
+		* @brief Forgets a component that is destroyed, hits on its triangles no longer resolve to it
+		* @param[in] component The component that handed its triangles to the merger
+		*/
+		void Remove(Component* component);
+
+		uint32_t GetNumChunks() const { return static_cast<uint32_t>(chunks_.size()); } //!< The number of merged actors
+
+	private:
+		/**
+		* @struct tremble::StaticGeometryMerger::Group
+		* @brief The collected triangles of a single physics material
+		*/
+		struct Group
+		{
+			PhysicsMaterial* material; //!< The physics material of the triangles
+			std::vector<physx::PxVec3> vertices; //!< The world space vertices of all triangles
+			std::vector<physx::PxU32> indices; //!< Three indices into the vertices for every triangle
+			std::vector<Component*> triangle_components; //!< The component of every triangle
+		};
+
+		/**
+		* @brief Splits a range of triangles in half along the longest axis of their centers until the halves are small enough
+		* @param[in] centers The center of every triangle of the group
+		* @param[in,out] triangles The triangles of the group, reordered so every chunk is a consecutive range
+		* @param[in] first The first triangle of the range
+		* @param[in] last One past the last triangle of the range
+		* @param[out] out_ranges The ranges of the chunks
+		*/
+		static void Split(const std::vector<physx::PxVec3>& centers, std::vector<physx::PxU32>& triangles, size_t first, size_t last, std::vector<std::pair<size_t, size_t>>& out_ranges);
+
+		physx::PxPhysics* px_physics_; //!< The physics the actors are created with
+		physx::PxScene* px_scene_; //!< The scene the actors are added to
+		CollisionCache* collision_cache_; //!< The cache the merged meshes are cooked with
+
+		bool collecting_; //!< Whether triangles are being collected
+		uint32_t num_meshes_; //!< The number of meshes that were collected
+		std::vector<Group> groups_; //!< The collected triangles by physics material
+		std::deque<Chunk> chunks_; //!< The merged actors, a deque so the shapes' pointers stay valid when more are added
+		std::unordered_map<Component*, std::vector<Chunk*>> component_chunks_; //!< The chunks every merged component has triangles in
+	};
+}
\ No newline at end of file
@@ -61,95 +61,14 @@ namespace tremble
 	//------------------------------------------------------------------------------------------------------
 	void CommandContext::InitializeTexture(GpuResource& dest_resource, UINT num_subresources, D3D12_SUBRESOURCE_DATA subresource_data[])
 	{
-		ID3D12Resource* upload_buffer = nullptr;
-
-		CommandContext& context = CommandContext::Begin();
-
-		UINT64 texture_upload_buffer_size;
-		Get::Device().Get()->GetCopyableFootprints(&dest_resource->GetDesc(), 0, 1, 0, nullptr, nullptr, nullptr, &texture_upload_buffer_size);
-
-		CHECKHR(
-			Get::Device().Get()->CreateCommittedResource(
-				&CD3DX12_HEAP_PROPERTIES(D3D12_HEAP_TYPE_UPLOAD),
-				D3D12_HEAP_FLAG_NONE,
-				&CD3DX12_RESOURCE_DESC::Buffer(texture_upload_buffer_size),
-				D3D12_RESOURCE_STATE_GENERIC_READ,
-				nullptr,
-				IID_PPV_ARGS(&upload_buffer)
-			)
-		);
-
-		// copy data to the intermediate upload heap and then schedule a copy from the upload heap to the default texture
-		UpdateSubresources(context.list_, dest_resource.Get(), upload_buffer, 0, 0, num_subresources, subresource_data);
-		context.TransitionResource(dest_resource, D3D12_RESOURCE_STATE_GENERIC_READ);
-
-		// Execute the command list and wait for it to finish so we can release the upload buffer
-		context.Finish(true);
-		
-		upload_buffer->Release();
+		// the copy is batched on the copy queue, the next submission of any context waits for it on the GPU
+		Get::Renderer()->GetUploadManager().CopyToTexture(dest_resource, 0, num_subresources, subresource_data);
 	}
 
 	//------------------------------------------------------------------------------------------------------
 	void CommandContext::InitializeBuffer(GpuResource& dest_resource, const void* data, UINT num_bytes, bool use_offset, UINT offset)
 	{
-		ID3D12Resource* upload_buffer;
-
-		CommandContext& context = CommandContext::Begin();
-
-		D3D12_HEAP_PROPERTIES heap_properties;
-		heap_properties.Type = D3D12_HEAP_TYPE_UPLOAD;
-		heap_properties.CPUPageProperty = D3D12_CPU_PAGE_PROPERTY_UNKNOWN;
-		heap_properties.MemoryPoolPreference = D3D12_MEMORY_POOL_UNKNOWN;
-		heap_properties.CreationNodeMask = 1;
-		heap_properties.VisibleNodeMask = 1;
-
-		D3D12_RESOURCE_DESC buffer_desc;
-		buffer_desc.Dimension = D3D12_RESOURCE_DIMENSION_BUFFER;
-		buffer_desc.Alignment = 0;
-		buffer_desc.Width = dest_resource->GetDesc().Width;
-		buffer_desc.Height = 1;
-		buffer_desc.DepthOrArraySize = 1;
-		buffer_desc.MipLevels = 1;
-		buffer_desc.Format = DXGI_FORMAT_UNKNOWN;
-		buffer_desc.SampleDesc.Count = 1;
-		buffer_desc.SampleDesc.Quality = 0;
-		buffer_desc.Layout = D3D12_TEXTURE_LAYOUT_ROW_MAJOR;
-		buffer_desc.Flags = D3D12_RESOURCE_FLAG_NONE;
-
-		CHECKHR(
-			Get::Device().Get()->CreateCommittedResource(
-				&heap_properties, 
-				D3D12_HEAP_FLAG_NONE, 
-				&buffer_desc, 
-				D3D12_RESOURCE_STATE_GENERIC_READ, 
-				nullptr, 
-				IID_PPV_ARGS(&upload_buffer)
-			)
-		);
-
-		// map, copy, unmap...
-		void* dest_address;
-		upload_buffer->Map(0, nullptr, &dest_address);
-		memcpy(dest_address, data, num_bytes);
-		upload_buffer->Unmap(0, nullptr);
-
-		// copy data to the intermediate upload heap and then schedule a copy from the upload heap to the default buffer
-		context.TransitionResource(dest_resource, D3D12_RESOURCE_STATE_COPY_DEST, true);
-		if (use_offset)
-		{
-			context.list_->CopyBufferRegion(dest_resource, offset, upload_buffer, 0, num_bytes);
-		}
-		else
-		{
-			context.list_->CopyResource(dest_resource, upload_buffer);
-		}
-
-		context.TransitionResource(dest_resource, D3D12_RESOURCE_STATE_GENERIC_READ, true);
-
-		// Execute the command list and wait for it to finish so we can release the upload buffer
-		context.Finish(true);
-
-		upload_buffer->Release();
+		Get::Renderer()->GetUploadManager().CopyToBuffer(dest_resource, data, num_bytes, use_offset ? offset : 0);
 	}
 
 	//------------------------------------------------------------------------------------------------------
@@ -219,7 +138,13 @@ namespace tremble
 	//------------------------------------------------------------------------------------------------------
 	void CommandContext::WriteBuffer(GpuResource& dest_resource, UINT dest_offset, const void* data, UINT num_bytes)
 	{
-		assert(false); // this function hasn't been implemented yet
+		// stage the data in this frame's upload memory, the copy is ordered with the rest of this context's work
+		UploadAllocation allocation = Get::Renderer()->GetFrameResource().Allocate(num_bytes, 16);
+		memcpy(allocation.cpu_address, data, num_bytes);
+
+		TransitionResource(dest_resource, D3D12_RESOURCE_STATE_COPY_DEST);
+		FlushResourceBarriers();
+		list_->CopyBufferRegion(dest_resource, dest_offset, allocation.buffer->Get(), allocation.offset, num_bytes);
 	}
 
 	//------------------------------------------------------------------------------------------------------
@@ -231,6 +156,8 @@ namespace tremble
 	//------------------------------------------------------------------------------------------------------
 	uint64_t CommandContext::Flush(bool wait_for_completion)
 	{
+		StallForUploads();
+
 		uint64_t fence_value = Get::CommandManager()->GetQueue(type_)->ExecuteCommandList(list_);
 		
 		if (wait_for_completion)
@@ -252,6 +179,8 @@ namespace tremble
 
 		auto queue = Get::CommandManager()->GetQueue(type_);
 
+		StallForUploads();
+
 		uint64_t fence_value = queue->ExecuteCommandList(list_);
 
 		queue->DiscardAllocator(fence_value, allocator_);
@@ -267,6 +196,19 @@ namespace tremble
 		return fence_value;
 	}
 
+	//------------------------------------------------------------------------------------------------------
+	void CommandContext::StallForUploads()
+	{
+		// resources initialized through the upload manager may be used by this list, so wait for their copies on the GPU
+		uint64_t upload_fence = Get::Renderer()->GetUploadManager().Flush();
+
+		if (upload_fence != 0 && Get::CommandManager()->IsFenceComplete(upload_fence) == false)
+		{
+			Get::CommandManager()->GetQueue(type_)->StallForFence(upload_fence);
+		}
+	}
+
+	//------------------------------------------------------------------------------------------------------
 	void CommandContext::TransitionResource(GpuResource& resource, const D3D12_RESOURCE_STATES& new_state, bool flush_immediate)
 	{
 		auto& old_state = resource.GetState();
@@ -91,6 +91,7 @@ namespace tremble
 
 	protected:
 		void BindDescriptorHeaps();
+		void StallForUploads(); //!< Submits the pending copies of the upload manager & makes this context's queue wait for them
 
 	protected:
 		std::wstring name_;
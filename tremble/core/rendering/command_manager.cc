@@ -7,7 +7,10 @@ namespace tremble
 {
 	//------------------------------------------------------------------------------------------------------
 	CommandManager::CommandManager() :
-		device_(nullptr)
+		device_(nullptr),
+		graphics_queue_(nullptr),
+		compute_queue_(nullptr),
+		copy_queue_(nullptr)
 	{
 		
 	}
@@ -107,6 +110,12 @@ namespace tremble
 	//------------------------------------------------------------------------------------------------------
 	void CommandManager::WaitForIdleGPU()
 	{
+		// without a device, e.g. with the null render backend, the queues were never created & nothing can be in flight
+		if (device_ == nullptr)
+		{
+			return;
+		}
+
 		graphics_queue_->WaitForIdle();
 		compute_queue_->WaitForIdle();
 		copy_queue_->WaitForIdle();
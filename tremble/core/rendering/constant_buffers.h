@@ -75,4 +75,15 @@ namespace tremble
 		int shadow_index;
 		int shadow_range;
 	};
+
+	struct ClusterConstants
+	{
+		uint32_t num_tiles_x;
+		uint32_t num_tiles_y;
+		uint32_t num_slices;
+		uint32_t num_global_lights;
+		DirectX::XMFLOAT2 tiles_per_pixel;
+		float depth_scale;
+		float depth_bias;
+	};
 }
\ No newline at end of file
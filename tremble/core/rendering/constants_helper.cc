@@ -1,68 +1,82 @@
 #include "constants_helper.h"
 
-#include "../../components/rendering/renderable.h"
-#include "../../components/rendering/camera.h"
-#include "../../components/rendering/light.h"
-#include "../scene_graph/scene_graph.h"
-#include "upload_buffer.h"
+#include "frame_packet.h"
+#include "frame_resource.h"
 #include "material.h"
 
 namespace tremble
 {
-	void ConstantsHelper::UpdatePassConstants(
-		UploadBuffer& buffer,
+	D3D12_GPU_VIRTUAL_ADDRESS ConstantsHelper::UpdatePassConstants(
+		FrameResource& frame,
 		const DirectX::XMFLOAT2& render_target_size,
-		Timer* timer,
-		Camera* camera
+		float delta_time,
+		float total_time,
+		const PacketView& view
 	)
 	{
 		PassConstants constants;
-		constants.delta_time = static_cast<float>(timer->GetDeltaT());
-		constants.total_time = static_cast<float>(timer->GetTimeSinceStartup());
-		constants.far_z = camera->GetFarZ();
-		constants.near_z = camera->GetNearZ();
+		constants.delta_time = delta_time;
+		constants.total_time = total_time;
+		constants.far_z = view.far_z;
+		constants.near_z = view.near_z;
 		constants.render_target_size = render_target_size;
 		constants.inv_render_target_size = DirectX::XMFLOAT2(1.0f / render_target_size.x, 1.0f / render_target_size.y);
-		constants.view = camera->GetView();
-		constants.inv_view = camera->GetInvView();
-		constants.projection = camera->GetProjection();
-		constants.inv_projection = camera->GetInvProjection();
-		constants.view_projection = camera->GetViewProjection();
-		constants.inv_view_projection = camera->GetInvViewProjection();
-		DirectX::XMStoreFloat3(&constants.eye_pos_world, camera->GetNode()->GetPosition());
+		constants.view = DirectX::XMLoadFloat4x4(&view.view);
+		constants.inv_view = DirectX::XMLoadFloat4x4(&view.inv_view);
+		constants.projection = DirectX::XMLoadFloat4x4(&view.projection);
+		constants.inv_projection = DirectX::XMLoadFloat4x4(&view.inv_projection);
+		constants.view_projection = DirectX::XMLoadFloat4x4(&view.view_projection);
+		constants.inv_view_projection = DirectX::XMLoadFloat4x4(&view.inv_view_projection);
+		constants.eye_pos_world = view.eye_position;
 
-		buffer.InsertDataByElement(0, &constants);
+		return frame.AllocateConstants(constants);
 	}
 	
 	//------------------------------------------------------------------------------------------------------
-	void ConstantsHelper::UpdateLightConstants(UploadBuffer& buffer, const std::vector<Light*>& lights, Camera* camera)
+	D3D12_GPU_VIRTUAL_ADDRESS ConstantsHelper::UpdateLightConstants(FrameResource& frame, const std::vector<const PacketLight*>& lights, const PacketView& view)
 	{
-		for (int i = 0; i < 64; i++)
+		// only the lights that exist are written, shaders find them through the cluster constants & light index list
+		UploadAllocation allocation = frame.Allocate(static_cast<UINT>(std::max<size_t>(lights.size(), 1) * sizeof(LightConstants)));
+		LightConstants* buffer = reinterpret_cast<LightConstants*>(allocation.cpu_address);
+
+		DirectX::XMMATRIX view_matrix = DirectX::XMLoadFloat4x4(&view.view);
+
+		for (int i = 0; i < lights.size(); i++)
 		{
 			LightConstants c;
-			if (i < lights.size())
-			{
-				Light& l = *(lights[i]);
-				c.position_world = Vector4(l.GetNode()->GetLocalPosition(), 1.0f);
-				c.direction_world = l.GetDirection();
-				DirectX::XMStoreFloat4(&c.position_view, DirectX::XMVector4Transform(Vector4(l.GetNode()->GetLocalPosition(), 1.0f), camera->GetView()));
-				DirectX::XMStoreFloat4(&c.direction_view, DirectX::XMVector4Transform(l.GetDirection().ToDxVec(), camera->GetView()));
-				c.color = l.GetColor();
-				c.spot_light_angle = 30.0f;
-				c.range = l.GetFalloffEnd();
-				c.intensity = 1.0f;
-				c.enabled = 1;
-				c.selected = 0;
-				c.type = l.GetLightType();
-				c.shadow_index = l.GetShadowIndex();
-				c.shadow_range = l.GetShadowRange();
-			}
-			else
-			{
-				c.enabled = 0;
-			}
+			const PacketLight& l = *(lights[i]);
+			c.position_world = DirectX::XMFLOAT4(l.position.x, l.position.y, l.position.z, 1.0f);
+			c.direction_world = DirectX::XMFLOAT4(l.direction.x, l.direction.y, l.direction.z, 0.0f);
+			DirectX::XMStoreFloat4(&c.position_view, DirectX::XMVector4Transform(DirectX::XMLoadFloat4(&c.position_world), view_matrix));
+			DirectX::XMStoreFloat4(&c.direction_view, DirectX::XMVector4Transform(DirectX::XMLoadFloat4(&c.direction_world), view_matrix));
+			c.color = l.color;
+			c.spot_light_angle = 30.0f;
+			c.range = l.falloff_end;
+			c.intensity = 1.0f;
+			c.enabled = 1;
+			c.selected = 0;
+			c.type = l.type;
+			c.shadow_index = l.shadow_index;
+			c.shadow_range = l.shadow_range;
 
-			buffer.InsertDataByElement(i, &c);
+			buffer[i] = c;
 		}
+
+		return allocation.gpu_address;
+	}
+
+	//------------------------------------------------------------------------------------------------------
+	D3D12_GPU_VIRTUAL_ADDRESS ConstantsHelper::UpdateClusterConstants(FrameResource& frame, const LightGrid& grid, UINT num_global_lights, const DirectX::XMFLOAT2& render_target_size)
+	{
+		ClusterConstants constants;
+		constants.num_tiles_x = grid.GetNumTilesX();
+		constants.num_tiles_y = grid.GetNumTilesY();
+		constants.num_slices = grid.GetNumSlices();
+		constants.num_global_lights = num_global_lights;
+		constants.tiles_per_pixel = DirectX::XMFLOAT2(grid.GetNumTilesX() / render_target_size.x, grid.GetNumTilesY() / render_target_size.y);
+		constants.depth_scale = grid.GetDepthScale();
+		constants.depth_bias = grid.GetDepthBias();
+
+		return frame.AllocateConstants(constants);
 	}
 }
\ No newline at end of file
@@ -1,31 +1,38 @@
 #pragma once
 
 #include "constant_buffers.h"
-#include "../utilities/timer.h"
-#include "upload_buffer.h"
+#include "frame_resource.h"
+#include "light_grid.h"
 
 namespace tremble
 {
-	class Camera;
 	struct Material;
 	class Renderable;
-	class Timer;
-	class Light;
+	struct PacketView;
+	struct PacketLight;
 
 	class ConstantsHelper
 	{
 	public:
-		static void UpdatePassConstants(
-			UploadBuffer& buffer,
+		static D3D12_GPU_VIRTUAL_ADDRESS UpdatePassConstants(
+			FrameResource& frame,
 			const DirectX::XMFLOAT2& render_target_size,
-			Timer* timer,
-			Camera* camera
+			float delta_time,
+			float total_time,
+			const PacketView& view
 		);
 
-		static void UpdateLightConstants(
-			UploadBuffer& buffer,
-			const std::vector<Light*>& lights,
-			Camera* camera
+		static D3D12_GPU_VIRTUAL_ADDRESS UpdateLightConstants(
+			FrameResource& frame,
+			const std::vector<const PacketLight*>& lights,
+			const PacketView& view
+		);
+
+		static D3D12_GPU_VIRTUAL_ADDRESS UpdateClusterConstants(
+			FrameResource& frame,
+			const LightGrid& grid,
+			UINT num_global_lights,
+			const DirectX::XMFLOAT2& render_target_size
 		);
 	};
 }
\ No newline at end of file
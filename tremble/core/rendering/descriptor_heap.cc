@@ -19,7 +19,7 @@ namespace tremble
 	//------------------------------------------------------------------------------------------------------
 	DescriptorHeap::~DescriptorHeap()
 	{
-		GUARANTEE_RELEASE(heap_);
+		SAFE_RELEASE(heap_); // the heaps of a renderer that never started, e.g. with the null render backend, were never created
 	}
 
 	//------------------------------------------------------------------------------------------------------
@@ -0,0 +1,129 @@
+#include "draw_list.h"
+
+namespace tremble
+{
+	//------------------------------------------------------------------------------------------------------
+	uint64_t DrawList::MakeKey(uint32_t pass, uint32_t pipeline, uint32_t material, uint32_t mesh, float depth)
+	{
+		const uint32_t depth_max = (1u << 20) - 1;
+		uint32_t quantized_depth = static_cast<uint32_t>(std::min(std::max(depth, 0.0f), 1.0f) * depth_max);
+
+		return (static_cast<uint64_t>(pass & 0xF) << 60) |
+			(static_cast<uint64_t>(pipeline & 0xFF) << 52) |
+			(static_cast<uint64_t>(material & 0xFFFF) << 36) |
+			(static_cast<uint64_t>(mesh & 0xFFFF) << 20) |
+			static_cast<uint64_t>(quantized_depth);
+	}
+
+	//------------------------------------------------------------------------------------------------------
+	uint32_t DrawList::HashPointer(const void* pointer, uint32_t bits)
+	{
+		// allocations are at least 16 byte aligned, so the low bits carry no information
+		uint64_t value = static_cast<uint64_t>(reinterpret_cast<uintptr_t>(pointer)) >> 4;
+		value ^= value >> 17;
+		value *= 0x9E3779B97F4A7C15ull;
+
+		return static_cast<uint32_t>(value >> (64 - bits));
+	}
+
+	//------------------------------------------------------------------------------------------------------
+	void DrawList::Clear()
+	{
+		items_.clear();
+	}
+
+	//------------------------------------------------------------------------------------------------------
+	void DrawList::Sort()
+	{
+		const size_t count = items_.size();
+		if (count < 2)
+		{
+			return;
+		}
+
+		// a single pass over the keys builds the histograms of all eight digits
+		uint32_t histograms[8][256] = {};
+		for (size_t i = 0; i < count; i++)
+		{
+			uint64_t key = items_[i].key;
+			for (int d = 0; d < 8; d++)
+			{
+				histograms[d][(key >> (d * 8)) & 0xFF]++;
+			}
+		}
+
+		scratch_.resize(count);
+
+		for (int d = 0; d < 8; d++)
+		{
+			uint32_t* histogram = histograms[d];
+
+			// every key shares this digit (e.g. unused key fields), so the pass wouldn't move anything
+			if (histogram[(items_[0].key >> (d * 8)) & 0xFF] == count)
+			{
+				continue;
+			}
+
+			uint32_t offset = 0;
+			for (int b = 0; b < 256; b++)
+			{
+				uint32_t bucket_count = histogram[b];
+				histogram[b] = offset;
+				offset += bucket_count;
+			}
+
+			for (size_t i = 0; i < count; i++)
+			{
+				scratch_[histogram[(items_[i].key >> (d * 8)) & 0xFF]++] = items_[i];
+			}
+
+			items_.swap(scratch_);
+		}
+	}
+
+	//------------------------------------------------------------------------------------------------------
+	bool DrawList::IsSorted() const
+	{
+		for (size_t i = 1; i < items_.size(); i++)
+		{
+			if (items_[i - 1].key > items_[i].key || (items_[i - 1].key == items_[i].key && items_[i - 1].payload > items_[i].payload))
+			{
+				return false;
+			}
+		}
+
+		return true;
+	}
+
+	//------------------------------------------------------------------------------------------------------
+	DrawStateCache::DrawStateCache()
+	{
+		Reset();
+	}
+
+	//------------------------------------------------------------------------------------------------------
+	void DrawStateCache::Reset()
+	{
+		for (int i = 0; i < SlotCount; i++)
+		{
+			bound_[i] = nullptr;
+		}
+
+		num_changes_ = 0;
+		num_skipped_ = 0;
+	}
+
+	//------------------------------------------------------------------------------------------------------
+	bool DrawStateCache::Apply(Slot slot, const void* state)
+	{
+		if (bound_[slot] == state && state != nullptr)
+		{
+			num_skipped_++;
+			return false;
+		}
+
+		bound_[slot] = state;
+		num_changes_++;
+		return true;
+	}
+}
\ No newline at end of file
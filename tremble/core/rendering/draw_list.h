@@ -0,0 +1,119 @@
+#pragma once
+
+namespace tremble
+{
+	/**
+	* @class tremble::DrawList
+	* @brief A list of draw records with 64-bit sort keys, sorted with a radix sort before submission
+	*
+	* A key packs, from most to least significant: the pass (4 bits), the pipeline state (8 bits), the material
+	* (16 bits), the mesh (16 bits) and the quantized view depth (20 bits). Sorting on the key groups draws that
+	* share state, so the submission stage can skip rebinding it. Every record carries a payload index that
+	* refers back into the caller's own array of draw data; the list itself never touches the GPU.
+	*/
+	class DrawList
+	{
+	public:
+		/**
+		* @brief The passes a draw record can belong to, in the order they are submitted
+		*/
+		enum Pass
+		{
+			PassDepth,
+			PassOpaque,
+			PassCount
+		};
+
+		/**
+		* @struct tremble::DrawList::DrawItem
+		* @brief A single draw record
+		*/
+		struct DrawItem
+		{
+			uint64_t key; //!< The sort key of the draw
+			uint32_t payload; //!< The index of the draw's data in the caller's array
+		};
+
+		/**
+		* @brief Packs the state of a draw into a sort key, ids that don't fit in their field are masked
+		* @param[in] pass The pass the draw belongs to
+		* @param[in] pipeline An id of the pipeline state the draw uses
+		* @param[in] material An id of the material the draw uses
+		* @param[in] mesh An id of the mesh the draw uses
+		* @param[in] depth The view depth of the draw, normalized to [0, 1], lower depths are drawn first
+		*/
+		static uint64_t MakeKey(uint32_t pass, uint32_t pipeline, uint32_t material, uint32_t mesh, float depth);
+
+		/**
+		* @brief Gets the pass a sort key belongs to
+		* @param[in] key The sort key
+		*/
+		static uint32_t GetPass(uint64_t key) { return static_cast<uint32_t>(key >> 60); }
+
+		/**
+		* @brief Folds a pointer into a small id for a key field, collisions only cost batching & never correctness
+		* @param[in] pointer The pointer to fold
+		* @param[in] bits The number of bits the id may use
+		*/
+		static uint32_t HashPointer(const void* pointer, uint32_t bits);
+
+		void Clear(); //!< Removes all draw records
+
+		/**
+		* @brief Adds a draw record
+		* @param[in] key The sort key of the draw
+		* @param[in] payload The index of the draw's data in the caller's array
+		*/
+		void Add(uint64_t key, uint32_t payload) { items_.push_back({ key, payload }); }
+
+		void Sort(); //!< Sorts the records on their keys with a stable LSD radix sort
+
+		const std::vector<DrawItem>& GetItems() const { return items_; }
+		size_t GetSize() const { return items_.size(); }
+
+		bool IsSorted() const; //!< Whether the keys are in order & records with equal keys kept the order of their payloads
+
+	private:
+		std::vector<DrawItem> items_; //!< The draw records
+		std::vector<DrawItem> scratch_; //!< Ping-pong storage for the radix sort, kept around to avoid reallocating every frame
+	};
+
+	/**
+	* @class tremble::DrawStateCache
+	* @brief Remembers the state bound by the previous draw, so sorted draws can skip redundant state changes
+	*/
+	class DrawStateCache
+	{
+	public:
+		/**
+		* @brief The kinds of state that are tracked
+		*/
+		enum Slot
+		{
+			SlotPipeline,
+			SlotMaterial,
+			SlotMesh,
+			SlotCount
+		};
+
+		DrawStateCache(); //!< Default constructor
+
+		void Reset(); //!< Forgets all bound state, should be called whenever the root signature is (re)bound
+
+		/**
+		* @brief Records the state a draw needs
+		* @param[in] slot The kind of state
+		* @param[in] state The state, compared by address
+		* @return Whether the state differs from what's bound & has to be bound by the caller
+		*/
+		bool Apply(Slot slot, const void* state);
+
+		unsigned int GetNumChanges() const { return num_changes_; }
+		unsigned int GetNumSkipped() const { return num_skipped_; }
+
+	private:
+		const void* bound_[SlotCount]; //!< The currently bound state per slot
+		unsigned int num_changes_; //!< The number of state changes since the last reset
+		unsigned int num_skipped_; //!< The number of redundant state changes skipped since the last reset
+	};
+}
\ No newline at end of file
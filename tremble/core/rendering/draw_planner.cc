@@ -0,0 +1,128 @@
+#include "draw_planner.h"
+
+#include "frame_packet.h"
+#include "material.h"
+#include "../resources/mesh.h"
+
+namespace tremble
+{
+	//------------------------------------------------------------------------------------------------------
+	DrawPlanner::DrawPlanner() :
+		packet_(nullptr),
+		instancing_(true),
+		pass_items_(),
+		pass_batches_()
+	{
+
+	}
+
+	//------------------------------------------------------------------------------------------------------
+	void DrawPlanner::Plan(const FramePacket& packet, bool depth_pass, bool instancing)
+	{
+		packet_ = &packet;
+		instancing_ = instancing;
+
+		draw_list_.Clear();
+		instance_batcher_.Clear();
+
+		for (uint32_t i = 0; i < packet.draws.size; i++)
+		{
+			AddDraw(i, depth_pass);
+		}
+
+		draw_list_.Sort();
+
+		// the pass is the most significant part of the keys, so every pass' records are adjacent
+		const std::vector<DrawList::DrawItem>& items = draw_list_.GetItems();
+		size_t first_item = 0;
+
+		for (int pass = 0; pass < DrawList::PassCount; pass++)
+		{
+			size_t end_item = first_item;
+			while (end_item < items.size() && DrawList::GetPass(items[end_item].key) == pass)
+			{
+				end_item++;
+			}
+
+			pass_items_[pass][0] = first_item;
+			pass_items_[pass][1] = end_item;
+			first_item = end_item;
+		}
+
+		if (instancing_ == true)
+		{
+			for (int pass = 0; pass < DrawList::PassCount; pass++)
+			{
+				BatchInstances(static_cast<DrawList::Pass>(pass));
+			}
+		}
+	}
+
+	//------------------------------------------------------------------------------------------------------
+	void DrawPlanner::WriteInstances(BYTE* destination) const
+	{
+		const std::vector<DrawList::DrawItem>& items = draw_list_.GetItems();
+
+		// the passes are batched in record order, so every record's instance slot is its index in the draw list
+		for (size_t i = 0; i < items.size(); i++)
+		{
+			ObjectConstants constants;
+			ComputeObjectConstants(packet_->view, packet_->draws[items[i].payload].world, constants);
+
+			memcpy(destination + i * sizeof(ObjectConstants), &constants, sizeof(ObjectConstants));
+		}
+	}
+
+	//------------------------------------------------------------------------------------------------------
+	size_t DrawPlanner::GetNumPassDraws(DrawList::Pass pass) const
+	{
+		if (instancing_ == true)
+		{
+			return pass_batches_[pass][1] - pass_batches_[pass][0];
+		}
+
+		return pass_items_[pass][1] - pass_items_[pass][0];
+	}
+
+	//------------------------------------------------------------------------------------------------------
+	void DrawPlanner::ComputeObjectConstants(const PacketView& view, const DirectX::XMFLOAT4X4& world, ObjectConstants& out_constants)
+	{
+		out_constants.world = DirectX::XMLoadFloat4x4(&world);
+		out_constants.world_view = DirectX::XMMatrixMultiply(out_constants.world, DirectX::XMLoadFloat4x4(&view.view));
+		out_constants.world_view_projection = DirectX::XMMatrixMultiply(out_constants.world, DirectX::XMLoadFloat4x4(&view.view_projection));
+	}
+
+	//------------------------------------------------------------------------------------------------------
+	void DrawPlanner::AddDraw(uint32_t index, bool depth_pass)
+	{
+		const PacketMeshDraw& draw = packet_->draws[index];
+
+		// the depth pass binds no material, so its draws only group by mesh; the LOD is part of the mesh field so instances of one LOD end up adjacent
+		uint32_t mesh_key = (DrawList::HashPointer(draw.mesh, 14) << 2) | static_cast<uint32_t>(std::min(draw.lod, 3));
+		if (depth_pass == true)
+		{
+			draw_list_.Add(DrawList::MakeKey(DrawList::PassDepth, 0, 0, mesh_key, draw.depth), index);
+		}
+
+		draw_list_.Add(DrawList::MakeKey(DrawList::PassOpaque, 0, DrawList::HashPointer(draw.mesh->GetMaterial(), 16), mesh_key, draw.depth), index);
+	}
+
+	//------------------------------------------------------------------------------------------------------
+	void DrawPlanner::BatchInstances(DrawList::Pass pass)
+	{
+		const std::vector<DrawList::DrawItem>& items = draw_list_.GetItems();
+
+		bool positions_only = pass == DrawList::PassDepth;
+
+		pass_batches_[pass][0] = instance_batcher_.GetBatches().size();
+		instance_batcher_.Break();
+
+		for (size_t i = pass_items_[pass][0]; i < pass_items_[pass][1]; i++)
+		{
+			const PacketMeshDraw& draw = packet_->draws[items[i].payload];
+			instance_batcher_.Add(draw.mesh, positions_only == true ? nullptr : draw.mesh->GetMaterial(), draw.lod, items[i].payload);
+		}
+
+		pass_batches_[pass][1] = instance_batcher_.GetBatches().size();
+	}
+}
\ No newline at end of file
@@ -0,0 +1,82 @@
+#pragma once
+
+#include "draw_list.h"
+#include "instance_batcher.h"
+#include "constant_buffers.h"
+
+namespace tremble
+{
+	struct FramePacket;
+	struct PacketView;
+
+	/**
+	* @class tremble::DrawPlanner
+	* @brief Turns a packet's mesh draws into sorted per-pass draw records & instanced batches
+	*
+	* This is the part of submitting the scene passes that doesn't need a device: building the sort keys, sorting
+	* them, finding every pass' range & grouping the draws into instanced batches. The renderer records its passes
+	* from the plan & the null backend replays the same plan, so a headless run measures the same CPU work.
+	*/
+	class DrawPlanner
+	{
+	public:
+		DrawPlanner(); //!< Default constructor
+
+		/**
+		* @brief Plans the mesh draws of a packet
+		* @param[in] packet The packet to plan, it has to stay alive while the plan is used
+		* @param[in] depth_pass Whether the draws are added to the depth pre-pass as well
+		* @param[in] instancing Whether the draws are grouped into instanced batches
+		*/
+		void Plan(const FramePacket& packet, bool depth_pass, bool instancing);
+
+		/**
+		* @brief Writes the object constants of every draw record into its instance slot, only used when instancing
+		* @param[out] destination The instance array, room for GetNumInstances object constants
+		*/
+		void WriteInstances(BYTE* destination) const;
+
+		/**
+		* @brief Gets the number of draws a pass records, the instanced batches when instancing & the draw records otherwise
+		* @param[in] pass The pass to get the number of draws of
+		*/
+		size_t GetNumPassDraws(DrawList::Pass pass) const;
+
+		/**
+		* @brief Computes the object constants of a world transform
+		* @param[in] view The view the constants are computed for
+		* @param[in] world The world transform
+		* @param[out] out_constants The computed constants
+		*/
+		static void ComputeObjectConstants(const PacketView& view, const DirectX::XMFLOAT4X4& world, ObjectConstants& out_constants);
+
+		const std::vector<DrawList::DrawItem>& GetItems() const { return draw_list_.GetItems(); } //!< The sorted draw records, their payloads index the packet's draws
+		const std::vector<InstanceBatcher::Batch>& GetBatches() const { return instance_batcher_.GetBatches(); } //!< The instanced batches of all passes
+		size_t GetFirstItem(DrawList::Pass pass) const { return pass_items_[pass][0]; } //!< The first draw record of a pass
+		size_t GetFirstBatch(DrawList::Pass pass) const { return pass_batches_[pass][0]; } //!< The first instanced batch of a pass
+		UINT GetNumInstances() const { return static_cast<UINT>(draw_list_.GetSize()); } //!< The number of instance slots, one per draw record
+		bool IsInstancing() const { return instancing_; } //!< Whether the draws are submitted as instanced draws
+
+	private:
+		/**
+		* @brief Adds the draw records of a single mesh to the draw list
+		* @param[in] index The index of the mesh in the packet's draws
+		* @param[in] depth_pass Whether the mesh is added to the depth pre-pass as well
+		*/
+		void AddDraw(uint32_t index, bool depth_pass);
+
+		/**
+		* @brief Groups a pass' draws into instanced batches
+		* @param[in] pass The pass of which the draws should be batched
+		*/
+		void BatchInstances(DrawList::Pass pass);
+
+		const FramePacket* packet_; //!< The packet that was planned
+		bool instancing_; //!< Whether the draws are submitted as instanced draws
+
+		DrawList draw_list_; //!< The sorted draw records, their payloads index the packet's draws
+		size_t pass_items_[DrawList::PassCount][2]; //!< The range of every pass' records in the sorted draw list
+		size_t pass_batches_[DrawList::PassCount][2]; //!< The range of every pass' instanced batches
+		InstanceBatcher instance_batcher_; //!< Groups the draws into instanced batches
+	};
+}
\ No newline at end of file
@@ -0,0 +1,684 @@
+#include "frame_extractor.h"
+
+#include "renderer.h"
+#include "texture.h"
+#include "shadow_renderer.h"
+#include "../resources/mesh.h"
+#include "../utilities/timer.h"
+#include "../utilities/stopwatch.h"
+#include "../scene_graph/scene_graph.h"
+#include "../scene_graph/component_manager.h"
+#include "../../components/rendering/camera.h"
+#include "../../components/rendering/renderable.h"
+#include "../../components/rendering/skinned_renderable.h"
+#include "../../components/rendering/light.h"
+#include "../../components/rendering/particle_system.h"
+#include "../../components/rendering/image_component.h"
+#include "../../components/rendering/button_component.h"
+#include "../../components/rendering/text_component.h"
+
+// needed for vector * float
+using namespace DirectX;
+
+namespace tremble
+{
+	//------------------------------------------------------------------------------------------------------
+	FrameExtractor::FrameExtractor() :
+		extract_time_(0.0f)
+	{
+		shadow_cache_.resize(SHADOW_MAX_MAPS);
+		InvalidateShadowCache();
+	}
+
+	//------------------------------------------------------------------------------------------------------
+	void FrameExtractor::Extract(FramePacket& packet, Camera* camera, Timer* timer, std::vector<DebugVolume>& debug_volumes, int virtual_width, int virtual_height)
+	{
+		Stopwatch stopwatch;
+
+		camera->Update();
+
+		packet.delta_time = static_cast<float>(timer->GetDeltaT());
+		packet.total_time = static_cast<float>(timer->GetTimeSinceStartup());
+		packet.virtual_width = virtual_width;
+		packet.virtual_height = virtual_height;
+
+		ExtractView(camera, packet.view);
+		ExtractDraws(camera);
+		ExtractSkinned();
+		ExtractLights();
+		ExtractShadows(camera);
+		ExtractParticles(camera);
+		ExtractInterface();
+
+		debug_meshes_.clear();
+		for (int i = 0; i < debug_volumes.size(); i++)
+		{
+			if (!debug_volumes[i].mesh->AreBuffersBuilt())
+			{
+				debug_volumes[i].mesh->BuildBuffers();
+			}
+
+			debug_meshes_.push_back(debug_volumes[i].mesh);
+		}
+
+		debug_volumes.clear();
+
+		packet.Copy(packet.draws, draws_);
+		packet.Copy(packet.skinned, skinned_);
+		packet.Copy(packet.skinned_meshes, skinned_meshes_);
+		packet.Copy(packet.bones, bones_);
+		packet.Copy(packet.lights, lights_);
+		packet.Copy(packet.shadow_lights, shadow_lights_);
+		packet.Copy(packet.shadow_maps, shadow_maps_);
+		packet.Copy(packet.shadow_casters, shadow_casters_);
+		packet.Copy(packet.shadow_skinned_casters, shadow_skinned_casters_);
+		packet.Copy(packet.particle_systems, particle_systems_);
+		packet.Copy(packet.particles, particles_);
+		packet.Copy(packet.sprites, sprites_);
+		packet.Copy(packet.texts, texts_);
+		packet.Copy(packet.glyphs, glyphs_);
+		packet.Copy(packet.debug_meshes, debug_meshes_);
+
+		extract_time_ = stopwatch.Output() * 1000.0f;
+	}
+
+	//------------------------------------------------------------------------------------------------------
+	void FrameExtractor::InvalidateShadowCache()
+	{
+		for (int i = 0; i < shadow_cache_.size(); i++)
+		{
+			shadow_cache_[i].light = nullptr;
+			shadow_cache_[i].caster_hash = 0;
+			shadow_cache_[i].valid = false;
+		}
+	}
+
+	//------------------------------------------------------------------------------------------------------
+	void FrameExtractor::ExtractView(Camera* camera, PacketView& out_view)
+	{
+		DirectX::XMStoreFloat4x4(&out_view.view, camera->GetView());
+		DirectX::XMStoreFloat4x4(&out_view.inv_view, camera->GetInvView());
+		DirectX::XMStoreFloat4x4(&out_view.projection, camera->GetProjection());
+		DirectX::XMStoreFloat4x4(&out_view.inv_projection, camera->GetInvProjection());
+		DirectX::XMStoreFloat4x4(&out_view.view_projection, camera->GetViewProjection());
+		DirectX::XMStoreFloat4x4(&out_view.inv_view_projection, camera->GetInvViewProjection());
+		DirectX::XMStoreFloat3(&out_view.eye_position, camera->GetNode()->GetPosition());
+		out_view.near_z = camera->GetNearZ();
+		out_view.far_z = camera->GetFarZ();
+	}
+
+	//------------------------------------------------------------------------------------------------------
+	void FrameExtractor::ExtractDraws(Camera* camera)
+	{
+		draws_.clear();
+
+		if (!Get::Config().frustum_culling)
+		{
+			const std::vector<Renderable*>& all_renderables = SGNode::FindAllComponents<Renderable>();
+
+			for (int i = 0; i < all_renderables.size(); i++)
+			{
+				if (!all_renderables[i]->GetActive() || all_renderables[i]->GetModel() == nullptr)
+				{
+					continue;
+				}
+
+				const std::vector<OctreeObject*>& nodes = all_renderables[i]->GetOctreeObjects();
+				for (int j = 0; j < all_renderables[i]->GetNumMeshes(); j++)
+				{
+					AddDraw(all_renderables[i], j, j < nodes.size() ? nodes[j] : nullptr, camera);
+				}
+			}
+
+			return;
+		}
+
+		visible_nodes_.clear();
+		Get::Octree()->GetContainedObjects(camera->GetFrustum(), visible_nodes_);
+
+		for (int i = 0; i < visible_nodes_.size(); i++)
+		{
+			if (visible_nodes_[i]->renderable->GetActive())
+			{
+				AddDraw(visible_nodes_[i]->renderable, visible_nodes_[i]->renderable_mesh_id, visible_nodes_[i], camera);
+			}
+		}
+	}
+
+	//------------------------------------------------------------------------------------------------------
+	void FrameExtractor::AddDraw(Renderable* renderable, int mesh_id, const OctreeObject* node, Camera* camera)
+	{
+		Mesh* mesh = renderable->GetMesh(mesh_id);
+
+		if (!mesh->AreBuffersBuilt())
+		{
+			mesh->BuildBuffers();
+		}
+
+		PacketMeshDraw draw;
+		draw.mesh = mesh;
+		draw.lod = 0;
+		draw.depth = 0.0f;
+
+		if (node != nullptr && node->alive)
+		{
+			draw.lod = mesh->GetLODCount() > 1 ? mesh->SelectLOD(Renderable::ComputeScreenSize(node, camera)) : 0;
+			draw.depth = DirectX::XMVectorGetZ(DirectX::XMVector3TransformCoord(DirectX::XMLoadFloat3(&node->bounds.Center), camera->GetView())) / camera->GetFarZ();
+		}
+
+		DirectX::XMStoreFloat4x4(&draw.world, static_cast<DirectX::XMMATRIX>(renderable->GetMeshWorldTransform(mesh_id)));
+
+		draws_.push_back(draw);
+	}
+
+	//------------------------------------------------------------------------------------------------------
+	void FrameExtractor::ExtractSkinned()
+	{
+		skinned_.clear();
+		skinned_meshes_.clear();
+		bones_.clear();
+		skinned_bounds_.clear();
+
+		const std::vector<SkinnedRenderable*>& all_skinned = SGNode::FindAllComponents<SkinnedRenderable>();
+
+		for (int i = 0; i < all_skinned.size(); i++)
+		{
+			// renderables that weren't started yet have no bones to draw with
+			DirectX::BoundingBox bounds;
+			if (!all_skinned[i]->GetActive() || all_skinned[i]->GetBoneTransforms().empty() || !all_skinned[i]->ComputeWorldBounds(bounds)) continue;
+
+			// skinned renderables have no octree objects, so their bounds are gathered once for all shadow maps
+			DirectX::XMStoreFloat3(&bounds.Extents, DirectX::XMVectorScale(DirectX::XMLoadFloat3(&bounds.Extents), SHADOW_SKINNED_BOUNDS_SCALE));
+
+			const std::vector<DirectX::XMFLOAT4X4>& bones = all_skinned[i]->GetBoneTransforms();
+
+			PacketSkinned skinned;
+			skinned.first_mesh = static_cast<uint32_t>(skinned_meshes_.size());
+			skinned.num_meshes = static_cast<uint32_t>(all_skinned[i]->GetNumMeshes());
+			skinned.first_bone = static_cast<uint32_t>(bones_.size());
+			skinned.num_bones = static_cast<uint32_t>(bones.size());
+
+			for (int j = 0; j < all_skinned[i]->GetNumMeshes(); j++)
+			{
+				Mesh* mesh = all_skinned[i]->GetMesh(j);
+
+				if (!mesh->AreBuffersBuilt())
+				{
+					mesh->BuildBuffers();
+				}
+
+				PacketSkinnedMesh skinned_mesh;
+				skinned_mesh.mesh = mesh;
+				DirectX::XMStoreFloat4x4(&skinned_mesh.world, static_cast<DirectX::XMMATRIX>(all_skinned[i]->GetMeshWorldTransform(j)));
+
+				skinned_meshes_.push_back(skinned_mesh);
+			}
+
+			bones_.insert(bones_.end(), bones.begin(), bones.end());
+			skinned_.push_back(skinned);
+			skinned_bounds_.push_back(bounds);
+		}
+	}
+
+	//------------------------------------------------------------------------------------------------------
+	void FrameExtractor::ExtractLights()
+	{
+		lights_.clear();
+
+		// every light is extracted, in the order FindAllComponents returns them, so ExtractShadows can index them
+		const std::vector<Light*>& lights = SGNode::FindAllComponents<Light>();
+
+		for (int i = 0; i < lights.size(); i++)
+		{
+			PacketLight light;
+			light.light = lights[i];
+			light.type = lights[i]->GetLightType();
+			light.position = lights[i]->GetNode()->GetLocalPosition();
+			light.direction = lights[i]->GetDirection();
+			light.color = lights[i]->GetColor();
+			light.falloff_end = lights[i]->GetFalloffEnd();
+			light.shadow_index = 0;
+			light.shadow_range = 0;
+
+			lights_.push_back(light);
+		}
+	}
+
+	//------------------------------------------------------------------------------------------------------
+	void FrameExtractor::ExtractShadows(Camera* camera)
+	{
+		DirectX::XMMATRIX view, projection;
+
+		shadow_lights_.clear();
+		shadow_maps_.clear();
+		shadow_casters_.clear();
+		shadow_skinned_casters_.clear();
+
+		int num_cascades = static_cast<int>(std::min(Get::Config().shadow_cascades, static_cast<UINT>(SHADOW_MAX_CASCADES)));
+
+		const std::vector<Light*>& lights = SGNode::FindAllComponents<Light>();
+		for (int i = 0; i < lights.size(); i++)
+		{
+			// not casting shadow
+			if (!lights[i]->GetShadowCasting()) continue;
+
+			// not compatible light
+			if (lights[i]->GetLightType() != LightTypeDirectional && lights[i]->GetLightType() != LightTypePoint) continue;
+
+			// map limit
+			bool cascaded = lights[i]->GetLightType() == LightTypeDirectional && num_cascades > 0 && camera != nullptr;
+			int num_maps = lights[i]->GetLightType() == LightTypePoint ? 6 : (cascaded ? num_cascades : 1);
+			if (static_cast<int>(shadow_maps_.size()) + num_maps > SHADOW_MAX_MAPS) continue;
+
+			Stopwatch stopwatch;
+			PacketShadowLight shadow_light = { lights[i], static_cast<uint32_t>(shadow_maps_.size()), 0, 0, 0, 0.0f };
+
+			switch (lights[i]->GetLightType())
+			{
+				case LightTypePoint:
+				{
+					const DirectX::XMVECTOR directions[6] = { { 1, 0, 0 }, { -1, 0, 0 }, { 0, 0, 1 }, { 0, 0, -1 }, { 0.001f, 1, 0 }, { 0.001f, -1, 0 } };
+					DirectX::XMVECTOR center = lights[i]->GetNode()->GetPosition();
+					float fov = 95 * 3.14f / 180.0f;
+
+					projection = DirectX::XMMatrixPerspectiveFovLH(fov, 1, 0.1f, 100.0f);
+
+					for (int f = 0; f < 6; f++)
+					{
+						view = DirectX::XMMatrixLookAtLH(center, center + directions[f], { 0, 1, 0 });
+						AddShadowMap(lights[i], view, projection, shadow_light);
+					}
+
+					break;
+				}
+
+				case LightTypeDirectional:
+				{
+					if (cascaded)
+					{
+						// the splits blend between uniform & logarithmic, so the near cascades don't get too thin
+						float near_z = camera->GetNearZ();
+						float far_z = std::min(camera->GetFarZ(), SHADOW_CASCADE_DISTANCE);
+						float split_near = near_z;
+
+						for (int c = 0; c < num_cascades; c++)
+						{
+							float t = (c + 1.0f) / num_cascades;
+							float uniform = near_z + (far_z - near_z) * t;
+							float logarithmic = near_z * std::pow(far_z / near_z, t);
+							float split_far = uniform + (logarithmic - uniform) * SHADOW_CASCADE_SPLIT_BLEND;
+
+							FitCascadeMap(lights[i], camera, split_near, split_far, view, projection);
+							AddShadowMap(lights[i], view, projection, shadow_light);
+
+							split_near = split_far;
+						}
+					}
+					else if (FitSceneMap(lights[i], view, projection))
+					{
+						AddShadowMap(lights[i], view, projection, shadow_light);
+					}
+
+					break;
+				}
+			}
+
+			if (shadow_light.num_maps > 0)
+			{
+				lights_[i].shadow_index = static_cast<int>(shadow_light.first_map);
+				lights_[i].shadow_range = static_cast<int>(shadow_light.num_maps);
+			}
+
+			shadow_light.cpu_time = stopwatch.Output() * 1000.0f;
+			shadow_lights_.push_back(shadow_light);
+		}
+	}
+
+	//------------------------------------------------------------------------------------------------------
+	void FrameExtractor::AddShadowMap(const Light* light, DirectX::XMMATRIX view, DirectX::XMMATRIX projection, PacketShadowLight& out_light)
+	{
+		size_t index = shadow_maps_.size();
+
+		DirectX::XMMATRIX view_projection = DirectX::XMMatrixMultiply(view, projection);
+		PlaneFrustum frustum = ComputeFrustum(view_projection);
+
+		casters_.clear();
+		Get::Octree()->GetContainedObjects(frustum, casters_);
+
+		skinned_casters_.clear();
+		for (int i = 0; i < skinned_bounds_.size(); i++)
+		{
+			if (skinned_bounds_[i].ContainedBy(frustum.near_plane, frustum.far_plane, frustum.right_plane, frustum.left_plane, frustum.top_plane, frustum.bottom_plane) != DirectX::ContainmentType::DISJOINT)
+			{
+				skinned_casters_.push_back(static_cast<uint32_t>(i));
+			}
+		}
+
+		// the sum of the scrambled pointers doesn't depend on the order the octree returns the casters in
+		uint64_t caster_hash = casters_.size();
+		bool caster_moved = false;
+
+		for (int i = 0; i < casters_.size(); i++)
+		{
+			uint64_t key = reinterpret_cast<uintptr_t>(casters_[i]) | (casters_[i]->renderable->GetActive() ? 1 : 0);
+			key *= 0x9E3779B97F4A7C15ull;
+			caster_hash += key ^ (key >> 29);
+
+			caster_moved = caster_moved || casters_[i]->updated;
+		}
+
+		PacketShadowMap map;
+		map.light = light;
+		DirectX::XMStoreFloat4x4(&map.view, view);
+		DirectX::XMStoreFloat4x4(&map.projection, projection);
+		map.render = false;
+		map.first_caster = static_cast<uint32_t>(shadow_casters_.size());
+		map.num_casters = 0;
+		map.first_skinned_caster = static_cast<uint32_t>(shadow_skinned_casters_.size());
+		map.num_skinned_casters = 0;
+
+		DirectX::XMFLOAT4X4 view_projection_data;
+		DirectX::XMStoreFloat4x4(&view_projection_data, view_projection);
+
+		out_light.num_maps++;
+
+		// a map is reused while it's seen from the same place & its casters didn't move, appear or disappear; animated casters always change
+		ShadowCacheEntry& entry = shadow_cache_[index];
+		if (entry.valid && entry.light == light && entry.caster_hash == caster_hash && !caster_moved && skinned_casters_.empty() &&
+			memcmp(&entry.view_projection, &view_projection_data, sizeof(DirectX::XMFLOAT4X4)) == 0)
+		{
+			shadow_maps_.push_back(map);
+			return;
+		}
+
+		// the packets are rendered in the order they're extracted in, so the map holds this result by the time the next packet is rendered
+		for (int i = 0; i < casters_.size(); i++)
+		{
+			if (!casters_[i]->alive || !casters_[i]->renderable->GetActive()) continue;
+
+			Mesh* mesh = casters_[i]->renderable->GetMesh(casters_[i]->renderable_mesh_id);
+
+			if (!mesh->AreBuffersBuilt())
+			{
+				mesh->BuildBuffers();
+			}
+
+			PacketShadowCaster caster;
+			caster.mesh = mesh;
+			DirectX::XMStoreFloat4x4(&caster.world, static_cast<DirectX::XMMATRIX>(casters_[i]->renderable->GetMeshWorldTransform(casters_[i]->renderable_mesh_id)));
+
+			shadow_casters_.push_back(caster);
+		}
+
+		shadow_skinned_casters_.insert(shadow_skinned_casters_.end(), skinned_casters_.begin(), skinned_casters_.end());
+
+		map.render = true;
+		map.num_casters = static_cast<uint32_t>(shadow_casters_.size()) - map.first_caster;
+		map.num_skinned_casters = static_cast<uint32_t>(skinned_casters_.size());
+
+		out_light.num_rendered_maps++;
+		out_light.num_casters += map.num_casters + map.num_skinned_casters;
+
+		entry.light = light;
+		entry.view_projection = view_projection_data;
+		entry.caster_hash = caster_hash;
+		entry.valid = true;
+
+		shadow_maps_.push_back(map);
+	}
+
+	//------------------------------------------------------------------------------------------------------
+	bool FrameExtractor::FitSceneMap(Light* light, DirectX::XMMATRIX& out_view, DirectX::XMMATRIX& out_projection)
+	{
+		const std::vector<Renderable*>& objects = SGNode::FindAllComponents<Renderable>();
+
+		// Create scene bounding box
+		DirectX::BoundingBox box;
+		bool has_bounds = false;
+
+		for (int o = 0; o < objects.size(); o++)
+		{
+			const std::vector<OctreeObject*>& octree_objects = objects[o]->GetOctreeObjects();
+			for (int b = 0; b < octree_objects.size(); b++)
+			{
+				if (!octree_objects[b]->alive) continue;
+
+				if (has_bounds)
+				{
+					DirectX::BoundingBox::CreateMerged(box, box, octree_objects[b]->bounds);
+				}
+				else
+				{
+					box = octree_objects[b]->bounds;
+					has_bounds = true;
+				}
+			}
+		}
+
+		if (!has_bounds)
+		{
+			return false;
+		}
+
+		DirectX::XMVECTOR boxCorners[8];
+		DirectX::XMVECTOR boxCenter = DirectX::XMLoadFloat3(&box.Center);
+
+		DirectX::XMFLOAT3 boxCornerFloats[8];
+		box.GetCorners(&boxCornerFloats[0]);
+		for (int bc = 0; bc < 8; bc++) {
+			boxCorners[bc] = DirectX::XMLoadFloat3(&boxCornerFloats[bc]);
+		}
+
+		// Transform scene bounds into shadow direction
+		DirectX::XMMATRIX cameraView = DirectX::XMMatrixLookAtLH({0, 0, 0}, light->GetDirection().Normalize(), { 0, 1, 0 });
+		for (int c = 0; c < 8; c++)
+		{
+			boxCorners[c] = DirectX::XMVector3Transform(boxCorners[c], cameraView);
+		}
+
+		// Get frustum dimensions
+		float xMin = DirectX::XMVectorGetX(boxCorners[0]), xMax = DirectX::XMVectorGetX(boxCorners[0]);
+		float yMin = DirectX::XMVectorGetY(boxCorners[0]), yMax = DirectX::XMVectorGetY(boxCorners[0]);
+		float zMin = DirectX::XMVectorGetZ(boxCorners[0]), zMax = DirectX::XMVectorGetZ(boxCorners[0]);
+		for (int c = 0; c < 8; c++)
+		{
+			xMin = std::min(xMin, DirectX::XMVectorGetX(boxCorners[c]));
+			xMax = std::max(xMax, DirectX::XMVectorGetX(boxCorners[c]));
+
+			yMin = std::min(yMin, DirectX::XMVectorGetY(boxCorners[c]));
+			yMax = std::max(yMax, DirectX::XMVectorGetY(boxCorners[c]));
+
+			zMin = std::min(zMin, DirectX::XMVectorGetZ(boxCorners[c]));
+			zMax = std::max(zMax, DirectX::XMVectorGetZ(boxCorners[c]));
+		}
+
+		DirectX::XMVECTOR direction = -light->GetDirection();
+
+		// Create view and projection
+		out_view = DirectX::XMMatrixLookAtLH(boxCenter + direction * -zMin, boxCenter, { 0, 1, 0 });
+		out_projection = DirectX::XMMatrixOrthographicLH(xMax - xMin, yMax - yMin, 0.01f, 1000);
+
+		return true;
+	}
+
+	//------------------------------------------------------------------------------------------------------
+	void FrameExtractor::FitCascadeMap(Light* light, Camera* camera, float near_z, float far_z, DirectX::XMMATRIX& out_view, DirectX::XMMATRIX& out_projection)
+	{
+		// the bounding sphere of the slice, its size doesn't change when the camera rotates
+		float tan_y = std::tan(camera->GetFOV() * 0.5f);
+		float tan_x = tan_y * camera->GetWidth() / camera->GetHeight();
+		float center_z = (near_z + far_z) * 0.5f;
+
+		float far_x = tan_x * far_z, far_y = tan_y * far_z;
+		float radius = std::sqrt(far_x * far_x + far_y * far_y + (far_z - center_z) * (far_z - center_z));
+		radius = std::ceil(radius * 16.0f) / 16.0f;
+
+		DirectX::XMMATRIX inv_view = camera->GetInvView();
+		DirectX::XMVECTOR center = DirectX::XMVector3Transform(DirectX::XMVectorSet(0.0f, 0.0f, center_z, 1.0f), inv_view);
+
+		DirectX::XMVECTOR direction = DirectX::XMVector3Normalize(light->GetDirection());
+		DirectX::XMVECTOR up = std::abs(DirectX::XMVectorGetY(direction)) > 0.99f ? DirectX::XMVectorSet(0.0f, 0.0f, 1.0f, 0.0f) : DirectX::XMVectorSet(0.0f, 1.0f, 0.0f, 0.0f);
+
+		// move the center in whole texels of the map, in light space
+		DirectX::XMMATRIX light_rotation = DirectX::XMMatrixLookToLH(DirectX::XMVectorZero(), direction, up);
+		DirectX::XMVECTOR light_center = DirectX::XMVector3Transform(center, light_rotation);
+
+		DirectX::XMVECTOR texel_size = DirectX::XMVectorReplicate(radius * 2.0f / SHADOW_MAP_SIZE);
+		light_center = DirectX::XMVectorMultiply(DirectX::XMVectorFloor(DirectX::XMVectorDivide(light_center, texel_size)), texel_size);
+		light_center = DirectX::XMVectorSetZ(light_center, DirectX::XMVectorGetZ(DirectX::XMVector3Transform(center, light_rotation)));
+
+		center = DirectX::XMVector3Transform(light_center, DirectX::XMMatrixTranspose(light_rotation));
+
+		// the map reaches back towards the light, so casters outside of the view still throw their shadows into it
+		float distance = radius + SHADOW_CASCADE_CASTER_DEPTH;
+
+		out_view = DirectX::XMMatrixLookToLH(center - direction * distance, direction, up);
+		out_projection = DirectX::XMMatrixOrthographicLH(radius * 2.0f, radius * 2.0f, 0.01f, distance + radius);
+	}
+
+	//------------------------------------------------------------------------------------------------------
+	PlaneFrustum FrameExtractor::ComputeFrustum(DirectX::FXMMATRIX view_projection)
+	{
+		// the columns of the matrix combine into the clip space planes, negated so they face outwards like DirectX::BoundingFrustum's
+		DirectX::XMMATRIX columns = DirectX::XMMatrixTranspose(view_projection);
+
+		PlaneFrustum frustum;
+		frustum.left_plane = DirectX::XMPlaneNormalize(DirectX::XMVectorNegate(DirectX::XMVectorAdd(columns.r[3], columns.r[0])));
+		frustum.right_plane = DirectX::XMPlaneNormalize(DirectX::XMVectorNegate(DirectX::XMVectorSubtract(columns.r[3], columns.r[0])));
+		frustum.bottom_plane = DirectX::XMPlaneNormalize(DirectX::XMVectorNegate(DirectX::XMVectorAdd(columns.r[3], columns.r[1])));
+		frustum.top_plane = DirectX::XMPlaneNormalize(DirectX::XMVectorNegate(DirectX::XMVectorSubtract(columns.r[3], columns.r[1])));
+		frustum.far_plane = DirectX::XMPlaneNormalize(DirectX::XMVectorNegate(DirectX::XMVectorSubtract(columns.r[3], columns.r[2])));
+
+		// depth clipping is disabled for the maps, casters in front of the near plane are flattened onto it rather than dropped
+		frustum.near_plane = frustum.far_plane;
+
+		return frustum;
+	}
+
+	//------------------------------------------------------------------------------------------------------
+	void FrameExtractor::ExtractParticles(Camera* camera)
+	{
+		particle_systems_.clear();
+		particles_.clear();
+
+		const std::vector<ParticleSystem*>& systems = Get::ComponentManager()->GetComponents<ParticleSystem>();
+
+		for (size_t i = 0; i < systems.size(); i++)
+		{
+			// Spawn and update particles
+			systems[i]->Update(camera);
+
+			// Skip if no alive particles
+			if (systems[i]->GetParticleCount() == 0) continue;
+
+			PacketParticleSystem system;
+			system.texture = systems[i]->GetTexture();
+			system.first_particle = static_cast<uint32_t>(particles_.size());
+			system.num_particles = static_cast<uint32_t>(systems[i]->GetParticleCount());
+
+			particles_.insert(particles_.end(), systems[i]->GetParticles(), systems[i]->GetParticles() + systems[i]->GetParticleCount());
+			particle_systems_.push_back(system);
+		}
+	}
+
+	//------------------------------------------------------------------------------------------------------
+	void FrameExtractor::ExtractInterface()
+	{
+		sprites_.clear();
+		texts_.clear();
+		glyphs_.clear();
+
+		const std::vector<ImageComponent*>& images = Get::ComponentManager()->GetComponents<ImageComponent>();
+		const std::vector<ButtonComponent*>& buttons = Get::ComponentManager()->GetComponents<ButtonComponent>();
+		const std::vector<TextComponent*>& texts = Get::ComponentManager()->GetComponents<TextComponent>();
+
+		// the atlas is packed on this thread, so sprites are remapped onto its pages here
+		InterfaceSpriteRenderer* sprite_renderer = Get::Renderer()->GetSpriteRenderer();
+		PacketSprite sprite;
+
+		// sprites
+		for (size_t i = 0; i < images.size(); i++)
+		{
+			Texture* texture = images[i]->GetTexture();
+			if (texture == nullptr)
+			{
+				continue;
+			}
+
+			if (images[i]->UsesCustomMatrix()) {
+				sprite.constants.transform = images[i]->GetMatrix();
+			}
+			else {
+				sprite.constants.transform = DirectX::XMMatrixTranslation(-images[i]->GetCenter().GetX(), -images[i]->GetCenter().GetY(), 0) * DirectX::XMMatrixScaling(images[i]->GetSize().GetX(), images[i]->GetSize().GetY(), 1) * DirectX::XMMatrixRotationRollPitchYaw(0, 0, (images[i]->GetRotation() * 3.24f) / 180.0f) * DirectX::XMMatrixTranslation(images[i]->GetPosition().GetX(), images[i]->GetPosition().GetY(), 1 + images[i]->GetLayer());
+			}
+			sprite.constants.color = images[i]->GetColor();
+			sprite.constants.uv_min = images[i]->GetUVMin();
+			sprite.constants.uv_max = images[i]->GetUVMax();
+
+			sprite.texture = sprite_renderer->ResolveTexture(texture, sprite.constants);
+			sprite.layer = images[i]->GetLayer();
+
+			BuildTexture(sprite.texture);
+			sprites_.push_back(sprite);
+		}
+
+		// buttons
+		for (size_t i = 0; i < buttons.size(); i++)
+		{
+			// Get texture, revert to normal state if possible
+			ButtonState used_state = buttons[i]->GetState();
+			Texture* texture = buttons[i]->GetTexture(used_state);
+			if (texture == nullptr) {
+				texture = buttons[i]->GetTexture(ButtonState::Normal);
+				used_state = ButtonState::Normal;
+			}
+
+			if (texture == nullptr)
+			{
+				continue;
+			}
+
+			sprite.constants.transform = buttons[i]->GetFinalTransform();
+			sprite.constants.uv_min = buttons[i]->GetUVMin(used_state);
+			sprite.constants.uv_max = buttons[i]->GetUVMax(used_state);
+			sprite.constants.color = buttons[i]->GetColor(buttons[i]->GetState());
+
+			sprite.texture = sprite_renderer->ResolveTexture(texture, sprite.constants);
+			sprite.layer = buttons[i]->GetLayer();
+
+			BuildTexture(sprite.texture);
+			sprites_.push_back(sprite);
+		}
+
+		// texts, only the glyphs of components whose text or font changed are rebuilt
+		for (size_t i = 0; i < texts.size(); i++)
+		{
+			PacketText text;
+			text.rebuilt = texts[i]->UpdateGlyphs();
+
+			const std::vector<InterfaceFontData>& glyphs = texts[i]->GetGlyphs();
+			if (glyphs.empty())
+			{
+				continue;
+			}
+
+			text.source = texts[i];
+			text.texture = texts[i]->GetGlyphTexture();
+			text.first_glyph = static_cast<uint32_t>(glyphs_.size());
+			text.num_glyphs = static_cast<uint32_t>(glyphs.size());
+
+			BuildTexture(text.texture);
+			glyphs_.insert(glyphs_.end(), glyphs.begin(), glyphs.end());
+			texts_.push_back(text);
+		}
+	}
+
+	//------------------------------------------------------------------------------------------------------
+	void FrameExtractor::BuildTexture(Texture* texture)
+	{
+		if (texture != nullptr && !texture->AreBuffersBuilt())
+		{
+			texture->BuildBuffers();
+		}
+	}
+}
\ No newline at end of file
@@ -0,0 +1,166 @@
+#pragma once
+
+#include "frame_packet.h"
+#include "debug_volume.h"
+#include "../utilities/octree.h"
+
+namespace tremble
+{
+	class Camera;
+	class Timer;
+	class Renderable;
+	class SkinnedRenderable;
+
+	/**
+	* @class tremble::FrameExtractor
+	* @brief Copies everything the renderer needs out of the scene into a frame packet, at the end of a simulation frame
+	*
+	* Extraction runs on the simulation thread & is the only part of rendering that reads components: it updates the
+	* camera, culls & selects the LODs of the meshes, gathers the lights, plans the shadow maps (fitting, caster culling
+	* & the cache decision), copies the bones, particles, interface sprites & glyphs and takes the queued debug volumes.
+	* Anything that is built lazily (mesh & texture buffers, world transforms) is built here, so the render side only
+	* reads the packet. Everything is gathered into scratch vectors that are kept across frames & copied into the
+	* packet's arena once at the end.
+	*/
+	class FrameExtractor
+	{
+	public:
+		FrameExtractor(); //!< Default constructor
+
+		/**
+		* @brief Extracts the current state of the scene
+		* @param[out] packet The packet to fill, it has to be reset already
+		* @param[in] camera The camera the frame is rendered from
+		* @param[in] timer The timer the game is running with
+		* @param[in] debug_volumes The debug volumes that were queued during the frame, the queue is emptied
+		* @param[in] virtual_width The width of the interface's virtual resolution
+		* @param[in] virtual_height The height of the interface's virtual resolution
+		*/
+		void Extract(FramePacket& packet, Camera* camera, Timer* timer, std::vector<DebugVolume>& debug_volumes, int virtual_width, int virtual_height);
+
+		void InvalidateShadowCache(); //!< Forces every shadow map to be rendered again in the next frame
+
+		float GetExtractTime() const { return extract_time_; } //!< The CPU time spent on the last extraction, in milliseconds
+
+	private:
+		/**
+		* @brief Copies the camera's matrices into the packet's view
+		* @param[in] camera The camera the frame is rendered from
+		* @param[out] out_view The view to fill
+		*/
+		static void ExtractView(Camera* camera, PacketView& out_view);
+
+		/**
+		* @brief Gathers the visible meshes of all renderables
+		* @param[in] camera The camera the frame is rendered from
+		*/
+		void ExtractDraws(Camera* camera);
+
+		/**
+		* @brief Adds a single visible mesh
+		* @param[in] renderable The renderable that owns the mesh
+		* @param[in] mesh_id The mesh id (relative to the renderable's cached mesh transforms)
+		* @param[in] node The octree object of the mesh, used for its LOD & depth, may be nullptr
+		* @param[in] camera The camera the frame is rendered from
+		*/
+		void AddDraw(Renderable* renderable, int mesh_id, const OctreeObject* node, Camera* camera);
+
+		void ExtractSkinned(); //!< Gathers the meshes, bones & (scaled up) bounds of all active skinned renderables
+		void ExtractLights(); //!< Gathers all lights, their shadow ranges are filled in by ExtractShadows
+
+		/**
+		* @brief Assigns shadow maps to the shadow casting lights & culls the casters of every map
+		* @param[in] camera The camera the frame is rendered from, the cascades are fitted to it
+		*/
+		void ExtractShadows(Camera* camera);
+
+		/**
+		* @brief Culls the casters of a map & decides whether its cached contents are still up to date
+		* @param[in] light The light the map belongs to
+		* @param[in] view The view matrix of the map
+		* @param[in] projection The projection matrix of the map
+		* @param[out] out_light The shadow light of the map, which is updated with the map
+		*/
+		void AddShadowMap(const Light* light, DirectX::XMMATRIX view, DirectX::XMMATRIX projection, PacketShadowLight& out_light);
+
+		/**
+		* @brief Fits a single map around all casters in the scene
+		* @param[in] light The directional light
+		* @param[out] out_view The view matrix of the map
+		* @param[out] out_projection The projection matrix of the map
+		* @return Whether there are any casters at all
+		*/
+		bool FitSceneMap(Light* light, DirectX::XMMATRIX& out_view, DirectX::XMMATRIX& out_projection);
+
+		/**
+		* @brief Fits a map around a slice of the camera frustum, snapped to whole texels so it doesn't shimmer while the camera moves
+		* @param[in] light The directional light
+		* @param[in] camera The camera the slice belongs to
+		* @param[in] near_z The distance to the near plane of the slice
+		* @param[in] far_z The distance to the far plane of the slice
+		* @param[out] out_view The view matrix of the map
+		* @param[out] out_projection The projection matrix of the map
+		*/
+		void FitCascadeMap(Light* light, Camera* camera, float near_z, float far_z, DirectX::XMMATRIX& out_view, DirectX::XMMATRIX& out_projection);
+
+		/**
+		* @brief Extracts the (outward facing) planes of the frustum a view projection matrix maps onto clip space
+		* @param[in] view_projection The view projection matrix, perspective or orthographic
+		*/
+		static PlaneFrustum ComputeFrustum(DirectX::FXMMATRIX view_projection);
+
+		/**
+		* @brief Updates the particle systems & gathers their living particles
+		* @param[in] camera The camera the particles are sorted for
+		*/
+		void ExtractParticles(Camera* camera);
+
+		void ExtractInterface(); //!< Gathers the interface sprites of all images & buttons and the glyphs of all texts
+
+		/**
+		* @brief Builds a texture's buffers if they aren't built yet & building is enabled
+		* @param[in] texture The texture to build, may be nullptr
+		*/
+		void BuildTexture(Texture* texture);
+
+		/**
+		* @struct tremble::FrameExtractor::ShadowCacheEntry
+		* @brief What a shadow map was last rendered with, so it can be reused while none of its casters change
+		*/
+		struct ShadowCacheEntry
+		{
+			const Light* light; //!< The light the map was rendered for
+			DirectX::XMFLOAT4X4 view_projection; //!< The view projection the map was rendered with
+			uint64_t caster_hash; //!< An order independent hash of the casters that were drawn into the map
+			bool valid; //!< Whether the map holds a rendered result at all
+		};
+
+		float extract_time_; //!< The CPU time spent on the last extraction, in milliseconds
+
+		std::vector<PacketMeshDraw> draws_; //!< Scratch storage for the packet's draws
+		std::vector<OctreeObject*> visible_nodes_; //!< Scratch storage for the octree query of the camera
+
+		std::vector<PacketSkinned> skinned_; //!< Scratch storage for the packet's skinned renderables
+		std::vector<PacketSkinnedMesh> skinned_meshes_; //!< Scratch storage for the packet's skinned meshes
+		std::vector<DirectX::XMFLOAT4X4> bones_; //!< Scratch storage for the packet's bone transforms
+		std::vector<DirectX::BoundingBox> skinned_bounds_; //!< The (scaled up) bounds of every extracted skinned renderable
+
+		std::vector<PacketLight> lights_; //!< Scratch storage for the packet's lights
+		std::vector<PacketShadowLight> shadow_lights_; //!< Scratch storage for the packet's shadow lights
+		std::vector<PacketShadowMap> shadow_maps_; //!< Scratch storage for the packet's shadow maps
+		std::vector<PacketShadowCaster> shadow_casters_; //!< Scratch storage for the packet's static shadow casters
+		std::vector<uint32_t> shadow_skinned_casters_; //!< Scratch storage for the packet's skinned shadow caster indices
+		std::vector<OctreeObject*> casters_; //!< Scratch storage for the octree query of a shadow map
+		std::vector<uint32_t> skinned_casters_; //!< Scratch storage for the skinned casters of a shadow map
+		std::vector<ShadowCacheEntry> shadow_cache_; //!< What every shadow map was last rendered with
+
+		std::vector<PacketParticleSystem> particle_systems_; //!< Scratch storage for the packet's particle systems
+		std::vector<ParticleRenderable> particles_; //!< Scratch storage for the packet's particles
+
+		std::vector<PacketSprite> sprites_; //!< Scratch storage for the packet's sprites
+		std::vector<PacketText> texts_; //!< Scratch storage for the packet's texts
+		std::vector<InterfaceFontData> glyphs_; //!< Scratch storage for the packet's glyphs
+
+		std::vector<Mesh*> debug_meshes_; //!< Scratch storage for the packet's debug volume meshes
+	};
+}
\ No newline at end of file
@@ -0,0 +1,113 @@
+#include "frame_packet.h"
+
+namespace tremble
+{
+	//------------------------------------------------------------------------------------------------------
+	FrameArena::FrameArena() :
+		current_page_(0),
+		offset_(0),
+		used_bytes_(0)
+	{
+
+	}
+
+	//------------------------------------------------------------------------------------------------------
+	FrameArena::~FrameArena()
+	{
+		for (int i = 0; i < pages_.size(); i++)
+		{
+			delete[] pages_[i].first;
+		}
+
+		pages_.clear();
+	}
+
+	//------------------------------------------------------------------------------------------------------
+	void* FrameArena::Allocate(size_t num_bytes, size_t alignment)
+	{
+		// the pages come from new[], which aligns them for any fundamental type, so offsets only need aligning
+		size_t aligned_offset = (offset_ + alignment - 1) & ~(alignment - 1);
+
+		// move on to the next page that fits the block, pages are reused in the same order every frame
+		while (current_page_ < pages_.size() && aligned_offset + num_bytes > pages_[current_page_].second)
+		{
+			current_page_++;
+			aligned_offset = 0;
+		}
+
+		if (current_page_ == pages_.size())
+		{
+			AddPage(std::max<size_t>(FRAME_ARENA_PAGE_SIZE, num_bytes));
+			aligned_offset = 0;
+		}
+
+		used_bytes_ += num_bytes;
+		offset_ = aligned_offset + num_bytes;
+
+		return pages_[current_page_].first + aligned_offset;
+	}
+
+	//------------------------------------------------------------------------------------------------------
+	void FrameArena::Reset()
+	{
+		current_page_ = 0;
+		offset_ = 0;
+		used_bytes_ = 0;
+	}
+
+	//------------------------------------------------------------------------------------------------------
+	size_t FrameArena::GetCapacity() const
+	{
+		size_t capacity = 0;
+
+		for (int i = 0; i < pages_.size(); i++)
+		{
+			capacity += pages_[i].second;
+		}
+
+		return capacity;
+	}
+
+	//------------------------------------------------------------------------------------------------------
+	void FrameArena::AddPage(size_t size)
+	{
+		pages_.push_back({ new BYTE[size], size });
+		current_page_ = pages_.size() - 1;
+		offset_ = 0;
+	}
+
+	//------------------------------------------------------------------------------------------------------
+	FramePacket::FramePacket()
+	{
+		Reset();
+	}
+
+	//------------------------------------------------------------------------------------------------------
+	void FramePacket::Reset()
+	{
+		frame = 0;
+		delta_time = 0.0f;
+		total_time = 0.0f;
+		virtual_width = 0;
+		virtual_height = 0;
+		memset(&view, 0, sizeof(PacketView));
+
+		draws = {};
+		skinned = {};
+		skinned_meshes = {};
+		bones = {};
+		lights = {};
+		shadow_lights = {};
+		shadow_maps = {};
+		shadow_casters = {};
+		shadow_skinned_casters = {};
+		particle_systems = {};
+		particles = {};
+		sprites = {};
+		texts = {};
+		glyphs = {};
+		debug_meshes = {};
+
+		arena.Reset();
+	}
+}
\ No newline at end of file
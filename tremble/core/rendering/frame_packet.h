@@ -0,0 +1,291 @@
+#pragma once
+
+#include "interface_buffers.h"
+#include "particle_renderer.h"
+#include "../../components/rendering/light.h"
+
+#define FRAME_ARENA_PAGE_SIZE (1024 * 1024) // the size of a single arena page, larger allocations get a page of their own
+
+namespace tremble
+{
+	class Mesh;
+	class Texture;
+
+	/**
+	* @class tremble::FrameArena
+	* @brief Linear memory for the contents of a single frame packet
+	*
+	* Allocations are bump-allocated from a list of pages & are all freed at once by Reset(). Pages are kept across
+	* resets, so after the first few frames nothing is allocated on the heap anymore. The arena is only ever used by
+	* one thread at a time: the simulation thread while it extracts a packet & the render thread while it renders it.
+	*/
+	class FrameArena
+	{
+	public:
+		FrameArena(); //!< Default constructor
+		~FrameArena(); //!< Destructor
+
+		FrameArena(const FrameArena&) = delete;
+		FrameArena& operator=(const FrameArena&) = delete;
+
+		/**
+		* @brief Allocates a block of memory that stays valid until the next reset
+		* @param[in] num_bytes The size of the block
+		* @param[in] alignment The alignment of the block, a power of two
+		*/
+		void* Allocate(size_t num_bytes, size_t alignment);
+
+		/**
+		* @brief Allocates an uninitialized array
+		* @param[in] count The number of elements of the array
+		* @return The array, nullptr if count is 0
+		*/
+		template<typename T>
+		T* AllocateArray(size_t count)
+		{
+			return count == 0 ? nullptr : static_cast<T*>(Allocate(count * sizeof(T), alignof(T)));
+		}
+
+		void Reset(); //!< Frees all allocations, the pages are kept
+
+		size_t GetUsedBytes() const { return used_bytes_; } //!< The number of bytes allocated since the last reset
+		size_t GetCapacity() const; //!< The total size of all pages
+
+	private:
+		/**
+		* @brief Adds a page to the end of the page list & makes it the current page
+		* @param[in] size The size of the page
+		*/
+		void AddPage(size_t size);
+
+		std::vector<std::pair<BYTE*, size_t>> pages_; //!< The memory & size of every page
+		size_t current_page_; //!< The page that is currently allocated from
+		size_t offset_; //!< The offset of the next allocation in the current page
+		size_t used_bytes_; //!< The number of bytes allocated since the last reset
+	};
+
+	/**
+	* @struct tremble::PacketArray
+	* @brief An array in a packet's arena, written once during extraction & only read afterwards
+	*/
+	template<typename T>
+	struct PacketArray
+	{
+		T* data = nullptr; //!< The elements, nullptr while the array is empty
+		uint32_t size = 0; //!< The number of elements
+
+		const T& operator[](size_t index) const { return data[index]; }
+		T& operator[](size_t index) { return data[index]; }
+		bool empty() const { return size == 0; }
+	};
+
+	/**
+	* @struct tremble::PacketView
+	* @brief The camera a frame is rendered from
+	*/
+	struct PacketView
+	{
+		DirectX::XMFLOAT4X4 view; //!< The view matrix
+		DirectX::XMFLOAT4X4 inv_view; //!< The inverse of the view matrix
+		DirectX::XMFLOAT4X4 projection; //!< The projection matrix
+		DirectX::XMFLOAT4X4 inv_projection; //!< The inverse of the projection matrix
+		DirectX::XMFLOAT4X4 view_projection; //!< The view projection matrix
+		DirectX::XMFLOAT4X4 inv_view_projection; //!< The inverse of the view projection matrix
+		DirectX::XMFLOAT3 eye_position; //!< The world space position of the camera
+		float near_z; //!< The distance to the near plane
+		float far_z; //!< The distance to the far plane
+	};
+
+	/**
+	* @struct tremble::PacketMeshDraw
+	* @brief A visible mesh of a renderable
+	*/
+	struct PacketMeshDraw
+	{
+		Mesh* mesh; //!< The mesh, its buffers are built already
+		int lod; //!< The LOD that should be drawn
+		float depth; //!< The view space depth of the mesh's bounds divided by the far plane, used to sort the draws
+		DirectX::XMFLOAT4X4 world; //!< The world transform of the mesh
+	};
+
+	/**
+	* @struct tremble::PacketSkinnedMesh
+	* @brief A mesh of a skinned renderable, drawn with its renderable's bones
+	*/
+	struct PacketSkinnedMesh
+	{
+		Mesh* mesh; //!< The mesh, its buffers are built already
+		DirectX::XMFLOAT4X4 world; //!< The world transform of the mesh
+	};
+
+	/**
+	* @struct tremble::PacketSkinned
+	* @brief A skinned renderable, its meshes & bones are ranges of the packet's skinned meshes & bones
+	*/
+	struct PacketSkinned
+	{
+		uint32_t first_mesh; //!< The first mesh of the renderable
+		uint32_t num_meshes; //!< The number of meshes of the renderable
+		uint32_t first_bone; //!< The first bone transform of the renderable
+		uint32_t num_bones; //!< The number of bone transforms of the renderable
+	};
+
+	/**
+	* @struct tremble::PacketLight
+	* @brief A light, with the range of shadow maps that was assigned to it during extraction
+	*/
+	struct PacketLight
+	{
+		const Light* light; //!< The component the light was extracted from, only used to identify it
+		LightType type; //!< The type of the light
+		DirectX::XMFLOAT3 position; //!< The world space position of the light
+		DirectX::XMFLOAT3 direction; //!< The world space direction of the light
+		DirectX::XMFLOAT4 color; //!< The color of the light
+		float falloff_end; //!< The distance at which the light's contribution reaches zero
+		int shadow_index; //!< The first shadow map of the light
+		int shadow_range; //!< The number of shadow maps of the light, 0 if it casts no shadows
+	};
+
+	/**
+	* @struct tremble::PacketShadowCaster
+	* @brief A static mesh that is drawn into a shadow map
+	*/
+	struct PacketShadowCaster
+	{
+		Mesh* mesh; //!< The mesh, its buffers are built already
+		DirectX::XMFLOAT4X4 world; //!< The world transform of the mesh
+	};
+
+	/**
+	* @struct tremble::PacketShadowMap
+	* @brief A shadow map, the maps are numbered by their position in the packet
+	*
+	* Only maps whose cached contents are out of date have casters; the others are still sampled, but not rendered.
+	*/
+	struct PacketShadowMap
+	{
+		const Light* light; //!< The light the map belongs to
+		DirectX::XMFLOAT4X4 view; //!< The view matrix of the map
+		DirectX::XMFLOAT4X4 projection; //!< The projection matrix of the map
+		bool render; //!< Whether the map has to be rendered again, otherwise its cached contents are still up to date
+		uint32_t first_caster; //!< The first static caster of the map
+		uint32_t num_casters; //!< The number of static casters of the map
+		uint32_t first_skinned_caster; //!< The first skinned caster index of the map
+		uint32_t num_skinned_casters; //!< The number of skinned caster indices of the map
+	};
+
+	/**
+	* @struct tremble::PacketShadowLight
+	* @brief The shadow maps of a single shadow casting light, with the cost of planning them
+	*/
+	struct PacketShadowLight
+	{
+		const Light* light; //!< The light
+		uint32_t first_map; //!< The first map of the light
+		uint32_t num_maps; //!< The number of maps of the light
+		uint32_t num_rendered_maps; //!< The number of maps that have to be rendered again
+		uint32_t num_casters; //!< The number of casters of the maps that have to be rendered again
+		float cpu_time; //!< The CPU time spent culling the light's casters during extraction, in milliseconds
+	};
+
+	/**
+	* @struct tremble::PacketParticleSystem
+	* @brief A particle system with living particles
+	*/
+	struct PacketParticleSystem
+	{
+		Texture* texture; //!< The texture of the particles, nullptr if they aren't textured
+		uint32_t first_particle; //!< The first particle of the system
+		uint32_t num_particles; //!< The number of particles of the system
+	};
+
+	/**
+	* @struct tremble::PacketSprite
+	* @brief An interface sprite, from an image or a button
+	*/
+	struct PacketSprite
+	{
+		InterfaceSpriteObjectConstants constants; //!< The transform, color & uvs of the sprite
+		Texture* texture; //!< The texture of the sprite, its buffers are built already
+		float layer; //!< The layer of the sprite, lower layers are drawn first
+	};
+
+	/**
+	* @struct tremble::PacketText
+	* @brief The glyphs of a single text component
+	*/
+	struct PacketText
+	{
+		const void* source; //!< The component the glyphs were extracted from, only used to skip uploads of unchanged text
+		Texture* texture; //!< The glyph atlas, its buffers are built already
+		uint32_t first_glyph; //!< The first glyph of the text
+		uint32_t num_glyphs; //!< The number of glyphs of the text
+		bool rebuilt; //!< Whether the glyphs changed since the previous frame
+	};
+
+	/**
+	* @struct tremble::FramePacket
+	* @brief Everything that is needed to render a single frame, extracted from the scene at the end of a simulation frame
+	*
+	* The render side only ever reads the packet, it never touches components or the scene graph. Resources (meshes,
+	* materials & textures) are referenced by pointer, as they're only swapped while the render thread is idle; the
+	* components that are referenced only serve as keys. All arrays live in the packet's arena & stay valid until the
+	* packet is reset for reuse.
+	*/
+	struct FramePacket
+	{
+		FramePacket(); //!< Default constructor
+
+		FramePacket(const FramePacket&) = delete;
+		FramePacket& operator=(const FramePacket&) = delete;
+
+		void Reset(); //!< Empties the packet & frees its arena, so it can be extracted into again
+
+		/**
+		* @brief Copies a vector into one of the packet's arrays
+		* @param[out] out_array The array to fill
+		* @param[in] source The elements to copy
+		*/
+		template<typename T>
+		void Copy(PacketArray<T>& out_array, const std::vector<T>& source)
+		{
+			out_array.size = static_cast<uint32_t>(source.size());
+			out_array.data = arena.AllocateArray<T>(source.size());
+
+			if (source.empty() == false)
+			{
+				memcpy(out_array.data, source.data(), source.size() * sizeof(T));
+			}
+		}
+
+		uint64_t frame; //!< The number of the frame, starting at 1
+		float delta_time; //!< The duration of the simulation frame in seconds
+		float total_time; //!< The time since startup in seconds
+		int virtual_width; //!< The width of the interface's virtual resolution
+		int virtual_height; //!< The height of the interface's virtual resolution
+
+		PacketView view; //!< The camera the frame is rendered from
+
+		PacketArray<PacketMeshDraw> draws; //!< The visible meshes of all renderables
+		PacketArray<PacketSkinned> skinned; //!< The active skinned renderables
+		PacketArray<PacketSkinnedMesh> skinned_meshes; //!< The meshes of the skinned renderables
+		PacketArray<DirectX::XMFLOAT4X4> bones; //!< The bone transforms of the skinned renderables
+
+		PacketArray<PacketLight> lights; //!< All lights
+		PacketArray<PacketShadowLight> shadow_lights; //!< The shadow casting lights that got maps
+		PacketArray<PacketShadowMap> shadow_maps; //!< The shadow maps of all lights, in the order they're numbered in
+		PacketArray<PacketShadowCaster> shadow_casters; //!< The static casters of the maps that have to be rendered again
+		PacketArray<uint32_t> shadow_skinned_casters; //!< Indices of the skinned renderables that are drawn into the maps
+
+		PacketArray<PacketParticleSystem> particle_systems; //!< The particle systems with living particles
+		PacketArray<ParticleRenderable> particles; //!< The particles of all systems
+
+		PacketArray<PacketSprite> sprites; //!< The interface sprites
+		PacketArray<PacketText> texts; //!< The interface texts
+		PacketArray<InterfaceFontData> glyphs; //!< The glyphs of all texts
+
+		PacketArray<Mesh*> debug_meshes; //!< The meshes of the debug volumes that were queued during the frame
+
+		FrameArena arena; //!< Holds all arrays of the packet
+	};
+}
\ No newline at end of file
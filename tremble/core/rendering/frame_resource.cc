@@ -1,35 +1,119 @@
 #include "frame_resource.h"
 
-#include "dynamic_upload_buffer.h"
-#include "upload_buffer.h"
-
 namespace tremble
 {
 	//------------------------------------------------------------------------------------------------------
-	FrameResource::FrameResource(ID3D12Device* device, UINT pass_count, UINT object_count)
+	FrameResource::FrameResource() :
+		page_size_(0),
+		current_page_(0),
+		offset_(0),
+		used_bytes_(0),
+		fence_(0)
 	{
-		CHECKHR(device->CreateCommandAllocator(D3D12_COMMAND_LIST_TYPE_DIRECT, IID_PPV_ARGS(&command_allocator_)));
 
-		pass_constants_.Create(L"Pass Constants Buffer", pass_count, (sizeof(PassConstants) + 255) & ~255);
+	}
 
-		object_constants_ = new DynamicUploadBuffer<ObjectConstants>(device, object_count, true);
-		object_constants_->GetBuffers()[0].buffer->SetName(L"Object Constants Buffer");
+	//------------------------------------------------------------------------------------------------------
+	FrameResource::~FrameResource()
+	{
+		Destroy();
+	}
 
-		debug_constants_ = new DynamicUploadBuffer<DebugConstants>(device, 10, true);
-		debug_constants_->GetBuffers()[0].buffer->SetName(L"Debug Constants Buffer");
+	//------------------------------------------------------------------------------------------------------
+	void FrameResource::Create(const std::wstring& name, UINT page_size)
+	{
+		name_ = name;
+		page_size_ = (page_size + D3D12_CONSTANT_BUFFER_DATA_PLACEMENT_ALIGNMENT - 1) & ~(D3D12_CONSTANT_BUFFER_DATA_PLACEMENT_ALIGNMENT - 1);
 
-		material_constants_ = new DynamicUploadBuffer<MaterialConstants>(device, 10, true);
-		material_constants_->GetBuffers()[0].buffer->SetName(L"Material Constants Buffer");
+		AddPage(page_size_);
+		Reset();
 	}
 
 	//------------------------------------------------------------------------------------------------------
-	FrameResource::~FrameResource()
+	void FrameResource::Destroy()
+	{
+		Reset();
+
+		for (int i = 0; i < pages_.size(); i++)
+		{
+			pages_[i]->Destroy();
+			delete pages_[i];
+		}
+
+		pages_.clear();
+	}
+
+	//------------------------------------------------------------------------------------------------------
+	void FrameResource::Reset()
+	{
+		for (int i = 0; i < deferred_releases_.size(); i++)
+		{
+			deferred_releases_[i]->Release();
+		}
+
+		deferred_releases_.clear();
+
+		current_page_ = 0;
+		offset_ = 0;
+		used_bytes_ = 0;
+	}
+
+	//------------------------------------------------------------------------------------------------------
+	UploadAllocation FrameResource::Allocate(UINT num_bytes, UINT alignment)
+	{
+		std::lock_guard<std::mutex> lock(mutex_);
+
+		UINT aligned_offset = (offset_ + alignment - 1) & ~(alignment - 1);
+
+		// move on to the next page that fits the block, pages are reused in the same order every frame
+		while (current_page_ < pages_.size() && aligned_offset + num_bytes > pages_[current_page_]->GetBufferSize())
+		{
+			current_page_++;
+			aligned_offset = 0;
+		}
+
+		if (current_page_ == pages_.size())
+		{
+			AddPage(std::max(page_size_, (num_bytes + D3D12_CONSTANT_BUFFER_DATA_PLACEMENT_ALIGNMENT - 1) & ~(D3D12_CONSTANT_BUFFER_DATA_PLACEMENT_ALIGNMENT - 1)));
+			aligned_offset = 0;
+		}
+
+		UploadBuffer* page = pages_[current_page_];
+
+		UploadAllocation allocation;
+		allocation.cpu_address = page->GetMappedData() + aligned_offset;
+		allocation.gpu_address = page->GetRootCBV() + aligned_offset;
+		allocation.buffer = page;
+		allocation.offset = aligned_offset;
+
+		used_bytes_ += num_bytes;
+		offset_ = aligned_offset + num_bytes;
+
+		return allocation;
+	}
+
+	//------------------------------------------------------------------------------------------------------
+	void FrameResource::DeferRelease(ID3D12Resource* resource)
+	{
+		if (resource == nullptr)
+		{
+			return;
+		}
+
+		std::lock_guard<std::mutex> lock(mutex_);
+
+		resource->AddRef();
+		deferred_releases_.push_back(resource);
+	}
+
+	//------------------------------------------------------------------------------------------------------
+	void FrameResource::AddPage(UINT size)
 	{
-		delete pass_constants_;
-		delete object_constants_;
-		delete debug_constants_;
-		delete material_constants_;
+		UploadBuffer* page = new UploadBuffer();
+		page->Create(name_ + L"Page" + std::to_wstring(pages_.size()), size / D3D12_CONSTANT_BUFFER_DATA_PLACEMENT_ALIGNMENT, D3D12_CONSTANT_BUFFER_DATA_PLACEMENT_ALIGNMENT);
 
-		SAFE_RELEASE(command_allocator_);
+		pages_.push_back(page);
+		current_page_ = pages_.size() - 1;
+		offset_ = 0;
 	}
 }
\ No newline at end of file
@@ -1,35 +1,96 @@
 #pragma once
 
-#include "constant_buffers.h"
 #include "upload_buffer.h"
 
+#include <mutex>
+
 namespace tremble
 {
-	template<typename T>
-	class DynamicUploadBuffer;
+	/**
+	* @struct tremble::UploadAllocation
+	* @brief A block of upload memory that belongs to a single frame
+	*/
+	struct UploadAllocation
+	{
+		BYTE* cpu_address; //!< The address the CPU writes the data to
+		D3D12_GPU_VIRTUAL_ADDRESS gpu_address; //!< The address the GPU reads the data from, e.g. for root constant buffer & shader resource views
+		UploadBuffer* buffer; //!< The upload page the block lives in, used as the source of copy commands
+		UINT offset; //!< The offset of the block in its upload page
+	};
 
+	/**
+	* @class tremble::FrameResource
+	* @brief Linear upload memory for a single frame in flight
+	*
+	* All data the CPU writes for the GPU during a frame (object, material & pass constants, instance data, ...) is
+	* bump-allocated from a list of persistently mapped upload pages. The frame is fenced when it is submitted and may
+	* only be reset once the GPU passed that fence, so the CPU never overwrites memory the GPU is still reading. Pages
+	* are kept across resets, so after the first few frames no resources are created anymore. Allocations may be made
+	* from several threads at once, e.g. by command lists that are recorded in parallel.
+	*/
 	class FrameResource
 	{
 	public:
-		FrameResource(ID3D12Device* device, UINT passCount, UINT objectCount);
-		~FrameResource();
+		FrameResource(); //!< Default constructor
+		~FrameResource(); //!< Destructor
+
+		/**
+		* @brief Creates the first upload page
+		* @param[in] name The name of the upload pages, used to identify them in graphics debuggers
+		* @param[in] page_size The size of a single upload page in bytes, allocations that are larger get a page of their own
+		*/
+		void Create(const std::wstring& name, UINT page_size);
+
+		void Destroy(); //!< Releases all upload pages & deferred resources, the GPU must be idle
+
+		void Reset(); //!< Rewinds all allocations & releases the deferred resources, the GPU must have passed the frame's fence
 
-		DynamicUploadBuffer<ObjectConstants>* GetObjectConstants() { return object_constants_; }
-		DynamicUploadBuffer<DebugConstants>* GetDebugConstants() { return debug_constants_; }
-		DynamicUploadBuffer<MaterialConstants>* GetMaterialConstants() { return material_constants_; }
-		UploadBuffer& GetPassConstants() { return pass_constants_; }
+		/**
+		* @brief Allocates a block of upload memory that stays valid until the frame is reset
+		* @param[in] num_bytes The size of the block
+		* @param[in] alignment The alignment of the block, defaults to the alignment constant buffer views require
+		*/
+		UploadAllocation Allocate(UINT num_bytes, UINT alignment = D3D12_CONSTANT_BUFFER_DATA_PLACEMENT_ALIGNMENT);
 
-		void SetFenceValue(UINT64 fence) { fence_ = fence; }
-		UINT64 GetFenceValue() { return fence_; }
+		/**
+		* @brief Copies a constant buffer into a new block of upload memory
+		* @param[in] data The constants to copy
+		* @return The GPU address of the copy, to be bound as a root constant buffer view
+		*/
+		template<typename T>
+		D3D12_GPU_VIRTUAL_ADDRESS AllocateConstants(const T& data)
+		{
+			UploadAllocation allocation = Allocate(sizeof(T));
+			memcpy(allocation.cpu_address, &data, sizeof(T));
+
+			return allocation.gpu_address;
+		}
+
+		/**
+		* @brief Keeps a resource alive until the GPU passed this frame's fence
+		* @param[in] resource The resource to release, the caller may release its own reference right away
+		*/
+		void DeferRelease(ID3D12Resource* resource);
+
+		void SetFenceValue(uint64_t fence) { fence_ = fence; }
+		uint64_t GetFenceValue() const { return fence_; }
+
+		UINT GetUsedBytes() const { return used_bytes_; } //!< The number of bytes allocated since the last reset
+		size_t GetNumPages() const { return pages_.size(); }
 
-		ID3D12CommandAllocator* GetCommandAllocator() { return command_allocator_; }
 	private:
-		DynamicUploadBuffer<ObjectConstants>* object_constants_;
-		DynamicUploadBuffer<DebugConstants>* debug_constants_;
-		DynamicUploadBuffer<MaterialConstants>* material_constants_;
-		UploadBuffer pass_constants_;
+		void AddPage(UINT size); //!< Creates a new upload page & makes it the current page
+
+		std::wstring name_; //!< The name of the upload pages
+		UINT page_size_; //!< The default size of an upload page
+		std::vector<UploadBuffer*> pages_; //!< All upload pages, persistently mapped
+		size_t current_page_; //!< The page that is being allocated from
+		UINT offset_; //!< The first free byte in the current page
+		UINT used_bytes_; //!< The number of bytes allocated since the last reset
+
+		std::vector<ID3D12Resource*> deferred_releases_; //!< Resources that are released when the frame is reset
+		uint64_t fence_; //!< The fence value of the last submission that used this frame's memory
 
-		ID3D12CommandAllocator* command_allocator_;
-		UINT64 fence_ = 0;
+		std::mutex mutex_; //!< Guards the allocation state & the deferred releases
 	};
 }
\ No newline at end of file
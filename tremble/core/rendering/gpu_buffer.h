@@ -17,6 +17,7 @@ namespace tremble
 		const UINT& GetSRV() const { return srv_id_; }
 		const D3D12_GPU_VIRTUAL_ADDRESS& GetRootCBV() const { return gpu_virtual_address_; }
 		D3D12_GPU_VIRTUAL_ADDRESS GetRootCBV() { return gpu_virtual_address_; }
+		UINT GetBufferSize() const { return buffer_size_; }
 
 		D3D12_VERTEX_BUFFER_VIEW GetVertexBufferView(UINT offset, UINT size, UINT stride) const;
 		D3D12_VERTEX_BUFFER_VIEW GetVertexBufferView(UINT base_vertex_index = 0) const;
@@ -7,6 +7,7 @@ namespace tremble
 	class GpuResource
 	{
 		friend class CommandContext;
+		friend class UploadManager;
 	public:
 		GpuResource();
 		GpuResource(ID3D12Resource* resource, D3D12_RESOURCE_STATES current_state);
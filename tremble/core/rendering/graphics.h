@@ -230,7 +230,7 @@ namespace tremble
 			alpha_blend.RenderTarget[0].SrcBlend = D3D12_BLEND_SRC_ALPHA;
 			blend_state_traditional_additive = alpha_blend;
 
-			root_signature_default.Create(16, 6);
+			root_signature_default.Create(20, 6);
 			root_signature_default[0].InitAsConstantBuffer(0);
 			root_signature_default[1].InitAsConstantBuffer(1);
 			root_signature_default[2].InitAsConstantBuffer(2);
@@ -247,6 +247,10 @@ namespace tremble
 			root_signature_default[13].InitAsBufferSRV(10); // shadow data
 			root_signature_default[14].InitAsConstantBuffer(3); // shadow info
 			root_signature_default[15].InitAsBufferSRV(11); // bone data
+			root_signature_default[16].InitAsBufferSRV(12); // instance data
+			root_signature_default[17].InitAsBufferSRV(13); // cluster light ranges
+			root_signature_default[18].InitAsBufferSRV(14); // cluster light indices
+			root_signature_default[19].InitAsConstantBuffer(4); // cluster info
 			root_signature_default.InitStaticSampler(0, sampler_point_wrap);
 			root_signature_default.InitStaticSampler(1, sampler_point_clamp);
 			root_signature_default.InitStaticSampler(2, sampler_linear_wrap);
@@ -255,9 +259,10 @@ namespace tremble
 			root_signature_default.InitStaticSampler(5, sampler_anisotropic_clamp);
 			root_signature_default.Finalize(L"RootSignatureDefault", D3D12_ROOT_SIGNATURE_FLAG_ALLOW_INPUT_ASSEMBLER_INPUT_LAYOUT);
 
-			root_signature_depth_pre_pass.Create(2, 0);
+			root_signature_depth_pre_pass.Create(3, 0);
 			root_signature_depth_pre_pass[0].InitAsConstantBuffer(0);
 			root_signature_depth_pre_pass[1].InitAsBufferSRV(0);
+			root_signature_depth_pre_pass[2].InitAsBufferSRV(12); // instance data
 			root_signature_depth_pre_pass.Finalize(L"RootSignatureZPrePass", D3D12_ROOT_SIGNATURE_FLAG_ALLOW_INPUT_ASSEMBLER_INPUT_LAYOUT);
 		}
 	}
@@ -237,6 +237,12 @@ namespace tremble
 		list_->SetGraphicsRootShaderResourceView(root_index, srv->GetGPUVirtualAddress() + offset);
 	}
 
+	//------------------------------------------------------------------------------------------------------
+	void GraphicsContext::SetBufferSRV(UINT root_index, D3D12_GPU_VIRTUAL_ADDRESS srv)
+	{
+		list_->SetGraphicsRootShaderResourceView(root_index, srv);
+	}
+
 	//------------------------------------------------------------------------------------------------------
 	void GraphicsContext::SetBufferUAV(UINT root_index, GpuBuffer& uav, UINT offset)
 	{
@@ -47,6 +47,7 @@ namespace tremble
 		void SetConstants(UINT root_index, Param32Bit x, Param32Bit y, Param32Bit z, Param32Bit w);
 		void SetConstantBuffer(UINT root_index, D3D12_GPU_VIRTUAL_ADDRESS cbv);
 		void SetBufferSRV(UINT root_index, GpuBuffer& srv, UINT offset = 0);
+		void SetBufferSRV(UINT root_index, D3D12_GPU_VIRTUAL_ADDRESS srv);
 		void SetBufferUAV(UINT root_index, GpuBuffer& uav, UINT offset = 0);
 		void SetDescriptorTable(UINT root_index, D3D12_GPU_DESCRIPTOR_HANDLE first_handle);
 
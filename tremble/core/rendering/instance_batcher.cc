@@ -0,0 +1,44 @@
+#include "instance_batcher.h"
+
+namespace tremble
+{
+	//------------------------------------------------------------------------------------------------------
+	InstanceBatcher::InstanceBatcher()
+	{
+		Clear();
+	}
+
+	//------------------------------------------------------------------------------------------------------
+	void InstanceBatcher::Clear()
+	{
+		batches_.clear();
+		num_instances_ = 0;
+		Break();
+	}
+
+	//------------------------------------------------------------------------------------------------------
+	void InstanceBatcher::Break()
+	{
+		mesh_ = nullptr;
+		material_ = nullptr;
+		lod_ = -1;
+		open_ = false;
+	}
+
+	//------------------------------------------------------------------------------------------------------
+	uint32_t InstanceBatcher::Add(const void* mesh, const void* material, int lod, uint32_t payload)
+	{
+		if (open_ == false || mesh != mesh_ || material != material_ || lod != lod_)
+		{
+			batches_.push_back({ payload, num_instances_, 0 });
+
+			mesh_ = mesh;
+			material_ = material;
+			lod_ = lod;
+			open_ = true;
+		}
+
+		batches_.back().num_instances++;
+		return num_instances_++;
+	}
+}
\ No newline at end of file
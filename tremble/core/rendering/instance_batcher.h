@@ -0,0 +1,56 @@
+#pragma once
+
+namespace tremble
+{
+	/**
+	* @class tremble::InstanceBatcher
+	* @brief Merges consecutive draws of the same mesh, material & LOD into instanced batches
+	*
+	* Draws are expected in draw list order, which already places draws that share state next to each other.
+	* Every added draw gets a slot in one contiguous instance array; the caller writes the draw's per-instance
+	* data into that slot, so every batch's instances can be bound as a single range. The batcher only deals
+	* with indices & never touches the GPU.
+	*/
+	class InstanceBatcher
+	{
+	public:
+		/**
+		* @struct tremble::InstanceBatcher::Batch
+		* @brief A range of instances that can be drawn with a single instanced draw call
+		*/
+		struct Batch
+		{
+			uint32_t payload; //!< The payload of the first draw in the batch, every draw in the batch shares its state
+			uint32_t first_instance; //!< The slot of the batch's first instance
+			uint32_t num_instances; //!< The number of instances in the batch
+		};
+
+		InstanceBatcher(); //!< Default constructor
+
+		void Clear(); //!< Removes all batches & instances
+
+		void Break(); //!< Makes sure the next draw starts a new batch, e.g. at the start of a new pass
+
+		/**
+		* @brief Adds a draw, merging it into the previous batch if they share the same state
+		* @param[in] mesh The mesh the draw uses, compared by address
+		* @param[in] material The material the draw uses, compared by address, may be nullptr for passes without materials
+		* @param[in] lod The LOD the draw uses
+		* @param[in] payload The index of the draw's data in the caller's array
+		* @return The instance slot the caller should write the draw's per-instance data to
+		*/
+		uint32_t Add(const void* mesh, const void* material, int lod, uint32_t payload);
+
+		const std::vector<Batch>& GetBatches() const { return batches_; }
+		uint32_t GetNumInstances() const { return num_instances_; }
+
+	private:
+		const void* mesh_; //!< The mesh of the current batch
+		const void* material_; //!< The material of the current batch
+		int lod_; //!< The LOD of the current batch
+		bool open_; //!< Whether the next draw may still be merged into the last batch
+
+		std::vector<Batch> batches_; //!< All batches in submission order
+		uint32_t num_instances_; //!< The total number of instance slots handed out
+	};
+}
\ No newline at end of file
@@ -8,10 +8,11 @@
 #include "texture.h"
 #include "descriptor_heap.h"
 #include "renderer.h"
-#include "../scene_graph/component_manager.h"
+#include "frame_packet.h"
 #include "../resources/resource_manager.h"
-#include "../../components/rendering/text_component.h"
 
+#define STB_RECT_PACK_IMPLEMENTATION
+#include <stb_rect_pack.h>
 #define STB_TRUETYPE_IMPLEMENTATION
 #include <stb_truetype.h>
 
@@ -24,9 +25,6 @@ namespace tremble
 		geometry_shader_ = Get::ResourceManager()->GetShader("interface_font_gs.cso");
 		vertex_shader_ = Get::ResourceManager()->GetShader("interface_font_vs.cso");
 
-		// create constant buffers
-		pass_constants_.Create(L"FontPassConstants", 1U, (sizeof(InterfaceSpritePassConstants) + 255) & ~255);
-
 		CreateRenderResources();
 
 		CreateRootSignature();
@@ -41,11 +39,9 @@ namespace tremble
 	}
 
 	//------------------------------------------------------------------------------------------------------
-	void InterfaceFontRenderer::Draw(GraphicsContext& context)
+	void InterfaceFontRenderer::Draw(GraphicsContext& context, const FramePacket& packet)
 	{
-		std::vector<TextComponent*> components_ = Get::ComponentManager()->GetComponents<TextComponent>();
-
-		if (components_.size() == 0 && components_.size() == 0)
+		if (packet.texts.empty() && uploaded_slots_.size() == 0)
 		{
 			return;
 		}
@@ -55,101 +51,62 @@ namespace tremble
 		context.SetPipelineState(GraphicsPSO::Get("interface_font_draw"));
 
 		int render_id = 0;
+		int slot_id = 0;
+		bool upload = false;
 
-		std::vector<CharBatch> batches;
+		batches_.clear();
 
-		// draw all components
-		for (int i = 0; i < components_.size(); i++) 
+		// the glyphs of all components were gathered during extraction, only the ones that changed are copied
+		for (uint32_t i = 0; i < packet.texts.size; i++) 
 		{
 			if (render_id == char_limit_)
 			{
 				break;
 			}
 
-			if (components_[i]->GetText() == std::string("") || components_[i]->GetFont() == std::string(""))
-			{
-				continue;
-			}
-
-			// create batch
-			batches.push_back({});
-			CharBatch& batch = batches[batches.size() - 1];
-			batch.offset = render_id;
-
-			// get text and font
-			std::string string = components_[i]->GetText();
-
-			float wanted_size = components_[i]->GetSize();
-
-			FontLevel& font = components_[i]->GetFontPtr()->FindLevel(wanted_size);
-
-			float scale = wanted_size / font.size;
-
-			batch.texture = font.char_map;
-
-			// calculate component alignment
-			float offset_x = -components_[i]->GetWidth() * components_[i]->GetCenter().GetX();
-			float offset_y = -components_[i]->GetHeight() * components_[i]->GetCenter().GetY();
+			const PacketText& text = packet.texts[i];
+			int count = std::min(static_cast<int>(text.num_glyphs), char_limit_ - render_id);
 
-			std::vector<TextLine> lines = components_[i]->GetLines();
-
-			float x, y;
-			x = 0;
-			y = lines[0].height;
+			if (text.rebuilt || slot_id >= uploaded_slots_.size() || uploaded_slots_[slot_id].source != text.source || uploaded_slots_[slot_id].offset != render_id || uploaded_slots_[slot_id].count != count)
+			{
+				memcpy(render_data_ + render_id, &packet.glyphs[text.first_glyph], count * sizeof(InterfaceFontData));
 
-			// draw every line
-			for (int l = 0; l < lines.size(); l++) {
-				if (render_id == char_limit_)
-				{
-					break;
-				}
-				
-				// calculate line alignment
-				switch (components_[i]->GetAlignment())
+				if (slot_id >= uploaded_slots_.size())
 				{
-					case Left: { x = 0; break; }
-					case Middle: { x = (components_[i]->GetWidth() - lines[l].width) / 2.0f; break; }
-					case Right: { x = components_[i]->GetWidth() - lines[l].width; break; }
+					uploaded_slots_.push_back({});
 				}
 
-				// add all characters
-				for (int s = 0; s < lines[l].text.length(); s++) {
-					unsigned char c = lines[l].text[s];
-
-					render_data_[render_id].transform = DirectX::XMMatrixScaling(font.char_info[c].width * scale, font.char_info[c].height * scale, 1) * DirectX::XMMatrixTranslation(components_[i]->GetPosition().GetX().Get() + x + offset_x + font.char_info[c].offset_x * scale, components_[i]->GetPosition().GetY().Get() + y + offset_y + font.char_info[c].offset_y * scale, 1 + components_[i]->GetLayer());
-					render_data_[render_id].color = components_[i]->GetColor();
-					render_data_[render_id].uv_min = { font.char_info[c].uv_x1, font.char_info[c].uv_y1 };
-					render_data_[render_id].uv_max = { font.char_info[c].uv_x2, font.char_info[c].uv_y2 };
-
-					x += font.char_info[c].advance * scale;
-
-					render_id++;
+				uploaded_slots_[slot_id] = { text.source, render_id, count };
+				upload = true;
+			}
 
-					if (render_id == char_limit_) 
-					{
-						break;
-					}
-				}
+			// create batch
+			batches_.push_back({ render_id, count, text.texture });
 
-				batch.count = render_id - batch.offset;
-				y += lines[l].height + components_[i]->GetLineSeperation();
-			}
+			render_id += count;
+			slot_id++;
+		}
 
-			
+		if (slot_id != uploaded_slots_.size())
+		{
+			uploaded_slots_.resize(slot_id);
+			upload = true;
 		}
 
 		if (render_id != 0)
 		{
-			// Upload buffer and render batches
-			CommandContext::InitializeBuffer(char_buffer_, render_data_, render_id * sizeof(InterfaceFontData), false, 0);
-			for (int i = 0; i < batches.size(); i++)
+			// Upload buffer, static text keeps the previous upload; the copy is ordered after the previous frame's reads
+			if (upload == true)
 			{
-				if (!batches[i].texture->AreBuffersBuilt())
-				{
-					batches[i].texture->BuildBuffers();
-				}
-				context.SetDescriptorTable(2, Get::CbvSrvUavHeap().GetGPUDescriptorById(batches[i].texture->GetSRV()));
-				RenderBatch(context, batches[i].offset, batches[i].count);
+				context.WriteBuffer(char_buffer_, 0, render_data_, render_id * sizeof(InterfaceFontData));
+				context.TransitionResource(char_buffer_, D3D12_RESOURCE_STATE_GENERIC_READ);
+			}
+
+			// Render batches
+			for (int i = 0; i < batches_.size(); i++)
+			{
+				context.SetDescriptorTable(2, Get::CbvSrvUavHeap().GetGPUDescriptorById(batches_[i].texture->GetSRV()));
+				RenderBatch(context, packet, batches_[i].offset, batches_[i].count);
 			}
 		}
 	}
@@ -157,10 +114,14 @@ namespace tremble
 	//------------------------------------------------------------------------------------------------------
 	void InterfaceFontRenderer::Destroy()
 	{
+		for (int i = 0; i < fonts_.size(); i++)
+		{
+			fonts_[i].Release();
+		}
+
 		delete pixel_shader_;
 		delete geometry_shader_;
 		delete vertex_shader_;
-		delete pass_constants_;
 	}
 
 	//------------------------------------------------------------------------------------------------------
@@ -266,17 +227,16 @@ namespace tremble
 	}
 
 	//------------------------------------------------------------------------------------------------------
-	void InterfaceFontRenderer::RenderBatch(GraphicsContext& context, int offset, int count)
+	void InterfaceFontRenderer::RenderBatch(GraphicsContext& context, const FramePacket& packet, int offset, int count)
 	{
 		InterfaceSpritePassConstants pass_data;
 
 		context.SetBufferSRV(1, char_buffer_, offset * sizeof(InterfaceFontData));
 
-		pass_data.view_projection = DirectX::XMMatrixOrthographicLH(Get::Renderer()->GetVirtualSizeX(), Get::Renderer()->GetVirtualSizeY(), 0.01f, 1000.0f);
+		pass_data.view_projection = DirectX::XMMatrixOrthographicLH(static_cast<float>(packet.virtual_width), static_cast<float>(packet.virtual_height), 0.01f, 1000.0f);
 		pass_data.view_view = DirectX::XMMatrixScaling(1, -1, 1) * DirectX::XMMatrixTranslation(-1.0f, 1.0f, 0);
-		pass_constants_.InsertDataByElement(0, &pass_data);
 
-		context.SetConstantBuffer(0, pass_constants_.GetAddressByElement(0));
+		context.SetConstantBuffer(0, Get::Renderer()->GetFrameResource().AllocateConstants(pass_data));
 
 		// render
 		context.SetPrimitiveTopology(D3D_PRIMITIVE_TOPOLOGY_POINTLIST);
@@ -288,7 +248,7 @@ namespace tremble
 	void InterfaceFontRenderer::AddFont(std::string file)
 	{
 		fonts_.push_back({});
-		Font& newFont = fonts_[fonts_.size() - 1];
+		Font& newFont = fonts_.back();
 		newFont.name = file;
 	}
 
@@ -312,84 +272,156 @@ namespace tremble
 	void Font::GenerateLevel(int size)
 	{
 		levels.push_back({});
-		FontLevel& newLevel = levels[levels.size() - 1];
+		FontLevel& newLevel = levels.back();
+		newLevel.size = size;
+		newLevel.char_map = nullptr;
+
+		if (!LoadFile() || !BuildAtlas())
+		{
+			DLOG(("Font not loaded correctly: " + name).c_str());
+		}
+
+		//TODO sort levels
+	}
+
+	//------------------------------------------------------------------------------------------------------
+	bool Font::LoadFile()
+	{
+		if (!file_data.empty())
+		{
+			return true;
+		}
 
 		// read file
 		FILE* read_file;
-		fopen_s(&read_file, name.c_str(), "rb");
+		if (fopen_s(&read_file, name.c_str(), "rb") != 0)
+		{
+			return false;
+		}
 
 		fseek(read_file, 0, SEEK_END);
 		long file_size = ftell(read_file);
 		rewind(read_file);
 
-		unsigned char* file_data = (unsigned char*)malloc(sizeof(char)*file_size);
-		fread(file_data, sizeof(char), file_size, read_file);
+		file_data.resize(file_size);
+		fread(file_data.data(), sizeof(char), file_size, read_file);
 		fclose(read_file);
 
-		// laod font data
-		stbtt_fontinfo font;
-		stbtt_InitFont(&font, file_data, 0);
-
-		int width = 12 * size, height = 12 * size;
-		unsigned char* bitmap = (unsigned char*)malloc(width*height);
+		return file_size > 0;
+	}
 
-		stbtt_bakedchar baked_chars[255];
+	//------------------------------------------------------------------------------------------------------
+	bool Font::BuildAtlas()
+	{
+		const int max_atlas_size = 4096;
 
-		// create bitmap
-		int created_height = stbtt_BakeFontBitmap(file_data, 0, size, bitmap, width, height, 0, 255, &baked_chars[0]);
+		int width = 512, height = 512;
+		std::vector<unsigned char> bitmap;
+		std::vector<stbtt_packedchar> packed_chars(levels.size() * 255);
 
-		if (created_height <= 0)
+		// pack every level, grow the atlas until they all fit
+		while (true)
 		{
-			DLOG(("Font not loaded correctly: " + name).c_str());
-			return;
+			bitmap.assign(width * height, 0);
+
+			stbtt_pack_context context;
+			bool packed = stbtt_PackBegin(&context, bitmap.data(), width, height, 0, 1, nullptr) != 0;
+
+			for (int i = 0; i < levels.size() && packed == true; i++)
+			{
+				packed = stbtt_PackFontRange(&context, file_data.data(), 0, static_cast<float>(levels[i].size), 0, 255, &packed_chars[i * 255]) != 0;
+			}
+
+			stbtt_PackEnd(&context);
+
+			if (packed == true)
+			{
+				break;
+			}
+
+			if (width == max_atlas_size && height == max_atlas_size)
+			{
+				return false;
+			}
+
+			if (height < width)
+			{
+				height *= 2;
+			}
+			else {
+				width *= 2;
+			}
 		}
 
 		// assign char info
-		for (int i = 0; i < 255; i++)
+		for (int l = 0; l < levels.size(); l++)
 		{
-			newLevel.char_info[i].width = baked_chars[i].x1 - baked_chars[i].x0;
-			newLevel.char_info[i].height = baked_chars[i].y1 - baked_chars[i].y0;
-			newLevel.char_info[i].advance = baked_chars[i].xadvance;
-			newLevel.char_info[i].offset_x = baked_chars[i].xoff;
-			newLevel.char_info[i].offset_y = baked_chars[i].yoff;
-			newLevel.char_info[i].uv_x1 = (float)baked_chars[i].x0 / width;
-			newLevel.char_info[i].uv_x2 = (float)baked_chars[i].x1 / width;
-			newLevel.char_info[i].uv_y1 = (float)baked_chars[i].y0 / created_height;
-			newLevel.char_info[i].uv_y2 = (float)baked_chars[i].y1 / created_height;
+			for (int i = 0; i < 255; i++)
+			{
+				const stbtt_packedchar& packed_char = packed_chars[l * 255 + i];
+				CharInfo& info = levels[l].char_info[i];
+
+				info.width = packed_char.x1 - packed_char.x0;
+				info.height = packed_char.y1 - packed_char.y0;
+				info.advance = packed_char.xadvance;
+				info.offset_x = packed_char.xoff;
+				info.offset_y = packed_char.yoff;
+				info.uv_x1 = (float)packed_char.x0 / width;
+				info.uv_x2 = (float)packed_char.x1 / width;
+				info.uv_y1 = (float)packed_char.y0 / height;
+				info.uv_y2 = (float)packed_char.y1 / height;
+			}
 		}
 
 		// convert texture to rgba
-		unsigned char* image = (unsigned char*)malloc(width * created_height * 4);
-		for (int y = 0; y < created_height; y++)
+		std::vector<unsigned char> image(width * height * 4);
+		for (int i = 0; i < width * height; i++)
 		{
-			for (int x = 0; x < width; x++)
-			{
-				image[(y*height + x) * 4] = 255;
-				image[(y*height + x) * 4 + 1] = 255;
-				image[(y*height + x) * 4 + 2] = 255;
-				image[(y*height + x) * 4 + 3] = bitmap[y*height + x];
-			}
+			image[i * 4] = 255;
+			image[i * 4 + 1] = 255;
+			image[i * 4 + 2] = 255;
+			image[i * 4 + 3] = bitmap[i];
 		}
 
 		// create texture from data
 		WICLoadedData image_data;
 		image_data.image_width = width;
-		image_data.image_height = created_height;
-		image_data.image_data = image;
-		image_data.image_data_byte_size = width * created_height * 4;
+		image_data.image_height = height;
+		image_data.image_data = image.data();
+		image_data.image_data_byte_size = width * height * 4;
 		image_data.bytes_per_row = width * 4;
 		image_data.dxgi_format = DXGI_FORMAT_R8G8B8A8_UNORM;
 		image_data.success = true;
 
-		newLevel.char_map = new Texture(image_data);
-		newLevel.char_map->BuildBuffers();
-		newLevel.size = size;
+		if (atlas != nullptr)
+		{
+			retired_atlases.push_back(atlas);
+		}
 
-		delete file_data;
-		delete bitmap;
-		delete image;
+		atlas = new Texture(image_data);
+		atlas->BuildBuffers();
+		atlas_version++;
 
-		//TODO sort levels
+		for (int l = 0; l < levels.size(); l++)
+		{
+			levels[l].char_map = atlas;
+		}
+
+		return true;
+	}
+
+	//------------------------------------------------------------------------------------------------------
+	void Font::Release()
+	{
+		for (int i = 0; i < retired_atlases.size(); i++)
+		{
+			delete retired_atlases[i];
+		}
+
+		retired_atlases.clear();
+
+		delete atlas;
+		atlas = nullptr;
 	}
 
 }
\ No newline at end of file
@@ -5,10 +5,13 @@
 #include "../math/math.h"
 #include "upload_buffer.h"
 
+#include <deque>
+
 namespace tremble
 {
 	class Shader;
 	class Texture;
+	struct FramePacket;
 
 	/// Holds information about a character in a font
 	struct CharInfo
@@ -23,6 +26,7 @@ namespace tremble
 	struct FontLevel {
 		int size;
 		CharInfo char_info[255];
+		/// Atlas the characters are packed in, shared by every level of the font
 		Texture* char_map;
 	};
 
@@ -31,10 +35,24 @@ namespace tremble
 	{
 		std::string name;
 		std::vector<FontLevel> levels;
+		/// Contents of the font file, read once when the first level is generated
+		std::vector<unsigned char> file_data;
+		/// Atlas that holds the characters of every level
+		Texture* atlas = nullptr;
+		/// Incremented every time the atlas is rebuilt, cached glyphs with an older version have stale uvs
+		unsigned int atlas_version = 0;
+		/// Previous atlases, kept alive because frames in flight may still sample from them
+		std::vector<Texture*> retired_atlases;
 		/// Returns font level that should be used for specified size
 		FontLevel& FindLevel(float);
 		/// Generates font level with specified size
 		void GenerateLevel(int);
+		/// Reads the font file, returns false if it couldn't be read
+		bool LoadFile();
+		/// Packs all levels into a new atlas, growing it until everything fits
+		bool BuildAtlas();
+		/// Frees all atlases
+		void Release();
 	};
 
 	/**
@@ -48,14 +66,14 @@ namespace tremble
 		/// Initializes interface renderer
 		void Startup();
 
-		/// Render interface components to specified context
-		void Draw(GraphicsContext&);
+		/// Render the texts of a frame packet to specified context
+		void Draw(GraphicsContext&, const FramePacket&);
 
 		/// Frees up memory used by interface renderer
 		void Destroy();
 
 		/// Returns list of currently present fonts
-		std::vector<Font>& GetFontList() { return fonts_; };
+		std::deque<Font>& GetFontList() { return fonts_; };
 
 		/// Adds font for rendering
 		void AddFont(std::string);
@@ -66,9 +84,7 @@ namespace tremble
 		void CreateRootSignature();
 		void CreateGeometry();
 
-		void RenderBatch(GraphicsContext&, int, int);
-
-		UploadBuffer pass_constants_;
+		void RenderBatch(GraphicsContext&, const FramePacket&, int, int);
 
 		Shader* pixel_shader_;
 		Shader* geometry_shader_;
@@ -84,7 +100,8 @@ namespace tremble
 		D3D12_VERTEX_BUFFER_VIEW index_buffer_view_;
 		StructuredBuffer index_buffer_;
 
-		std::vector<Font> fonts_;
+		/// Deque so the Font pointers held by text components stay valid when fonts are added
+		std::deque<Font> fonts_;
 
 		StructuredBuffer char_buffer_;
 
@@ -99,6 +116,17 @@ namespace tremble
 			int count;
 			Texture* texture;
 		};
+
+		/// Stores which component's glyphs are in which part of the uploaded char buffer
+		struct CharSlot {
+			const void* source;
+			int offset;
+			int count;
+		};
+
+		std::vector<CharBatch> batches_;
+		/// Slots of the char buffer as it was last uploaded, the upload is skipped while none of them change
+		std::vector<CharSlot> uploaded_slots_;
 	};
 	
 }
\ No newline at end of file
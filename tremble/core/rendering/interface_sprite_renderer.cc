@@ -7,10 +7,8 @@
 #include "root_signature.h"
 #include "graphics_context.h"
 #include "texture.h"
-#include "../scene_graph/component_manager.h"
+#include "frame_packet.h"
 #include "../resources/resource_manager.h"
-#include "../../components/rendering/image_component.h"
-#include "../../components/rendering/button_component.h"
 
 namespace tremble
 {
@@ -21,10 +19,6 @@ namespace tremble
 		pixel_shader_ = Get::ResourceManager()->GetShader("interface_sprite_ps.cso");
 		vertex_shader_ = Get::ResourceManager()->GetShader("interface_sprite_vs.cso");
 
-		// create constant buffers
-		pass_constants_.Create(L"SpritePassConstants", 1U, (sizeof(InterfaceSpritePassConstants) + 255) & ~255);
-		object_constants_.Create(L"SpriteObjectConstants", 1024U, (sizeof(InterfaceSpriteObjectConstants) + 255) & ~255);
-		
 		CreateRenderResources();
 
 		CreateRootSignature();
@@ -35,111 +29,80 @@ namespace tremble
 	}
 
 	//------------------------------------------------------------------------------------------------------
-	void InterfaceSpriteRenderer::Draw(GraphicsContext& context)
+	void InterfaceSpriteRenderer::Draw(GraphicsContext& context, const FramePacket& packet)
 	{
-		std::vector<ImageComponent*> images_ = Get::ComponentManager()->GetComponents<ImageComponent>();
-		std::vector<ButtonComponent*> buttons_ = Get::ComponentManager()->GetComponents<ButtonComponent>();
+		// the sprites were gathered & remapped onto the atlas during extraction
+		if (packet.sprites.empty())
+		{
+			return;
+		}
+
+		batcher_.Clear();
+
+		for (uint32_t i = 0; i < packet.sprites.size; i++)
+		{
+			batcher_.Add(packet.sprites[i].constants, packet.sprites[i].texture, packet.sprites[i].layer);
+		}
+
+		batcher_.Build();
 
-		if (images_.size() == 0 && buttons_.size() == 0) 
+		const std::vector<InterfaceSpriteObjectConstants>& instances = batcher_.GetInstances();
+		const std::vector<SpriteBatcher::Batch>& batches = batcher_.GetBatches();
+
+		if (instances.empty() == true)
 		{
 			return;
 		}
 
+		// the instances are read straight from this frame's upload memory
+		UploadAllocation instance_data = Get::Renderer()->GetFrameResource().Allocate(static_cast<UINT>(instances.size() * sizeof(InterfaceSpriteObjectConstants)), 16);
+		memcpy(instance_data.cpu_address, instances.data(), instances.size() * sizeof(InterfaceSpriteObjectConstants));
+
 		// activate shader
 		context.SetRootSignature(root_signature_);
 		context.SetPipelineState(GraphicsPSO::Get("interface_sprite_draw"));
 
+		// prepare constant buffers
 		InterfaceSpritePassConstants pass_data;
-		InterfaceSpriteObjectConstants object_data;
-		Texture* texture_;
-
-		int render_id = 0;
-
-		// sprites
-		for (size_t i = 0; (i < images_.size() && i < 1024); i++) {
-
-			// prepare constant buffers
-			pass_data.view_projection = DirectX::XMMatrixOrthographicLH(Get::Renderer()->GetVirtualSizeX(), Get::Renderer()->GetVirtualSizeY(), 0.01f, 1000.0f);
-			pass_data.view_view = DirectX::XMMatrixScaling(1, -1, 1) * DirectX::XMMatrixTranslation(-1.0f, 1.0f, 0);
-			pass_constants_.InsertDataByElement(0, &pass_data);
-
-			if (images_[i]->UsesCustomMatrix()) {
-				object_data.transform = images_[i]->GetMatrix();
-			}
-			else {
-				object_data.transform = DirectX::XMMatrixTranslation(-images_[i]->GetCenter().GetX(), -images_[i]->GetCenter().GetY(), 0) * DirectX::XMMatrixScaling(images_[i]->GetSize().GetX(), images_[i]->GetSize().GetY(), 1) * DirectX::XMMatrixRotationRollPitchYaw(0, 0, (images_[i]->GetRotation() * 3.24f) / 180.0f) * DirectX::XMMatrixTranslation(images_[i]->GetPosition().GetX(), images_[i]->GetPosition().GetY(), 1 + images_[i]->GetLayer());
-			}
-			object_data.color = images_[i]->GetColor();
-			object_data.uv_min = images_[i]->GetUVMin();
-			object_data.uv_max = images_[i]->GetUVMax();
-			object_constants_.InsertDataByElement(render_id, &object_data);
-
-			texture_ = images_[i]->GetTexture();
-			if (texture_ == nullptr) 
-			{
-				continue;
-			}
-
-			//upload buffers and texture
-			context.SetConstantBuffer(0, pass_constants_.GetAddressByElement(0));
-			context.SetConstantBuffer(1, object_constants_.GetAddressByElement(render_id));
-			if (!texture_->AreBuffersBuilt())
-			{
-				texture_->BuildBuffers();
-			}
-			context.SetDescriptorTable(2, Get::CbvSrvUavHeap().GetGPUDescriptorById(texture_->GetSRV()));
-
-			// render
-			context.SetPrimitiveTopology(D3D_PRIMITIVE_TOPOLOGY_TRIANGLELIST);
-			context.SetVertexBuffer(0, vertex_buffer_view_);
-			context.DrawInstanced(static_cast<UINT>(vertices_.size()), 1);
-
-			render_id++;
+		pass_data.view_projection = DirectX::XMMatrixOrthographicLH(static_cast<float>(packet.virtual_width), static_cast<float>(packet.virtual_height), 0.01f, 1000.0f);
+		pass_data.view_view = DirectX::XMMatrixScaling(1, -1, 1) * DirectX::XMMatrixTranslation(-1.0f, 1.0f, 0);
+
+		context.SetConstantBuffer(0, Get::Renderer()->GetFrameResource().AllocateConstants(pass_data));
+		context.SetPrimitiveTopology(D3D_PRIMITIVE_TOPOLOGY_TRIANGLELIST);
+		context.SetVertexBuffer(0, vertex_buffer_view_);
+
+		// one instanced draw per texture / atlas page
+		for (int i = 0; i < batches.size(); i++)
+		{
+			context.SetBufferSRV(1, instance_data.gpu_address + batches[i].offset * sizeof(InterfaceSpriteObjectConstants));
+			context.SetDescriptorTable(2, Get::CbvSrvUavHeap().GetGPUDescriptorById(batches[i].texture->GetSRV()));
+			context.DrawInstanced(static_cast<UINT>(vertices_.size()), static_cast<UINT>(batches[i].count));
 		}
+	}
 
-		// buttons
-		for (size_t i = 0; (i < buttons_.size() && i < 1024); i++) {
-
-			// prepare constant buffers
-			pass_data.view_projection = DirectX::XMMatrixOrthographicLH(Get::Renderer()->GetVirtualSizeX(), Get::Renderer()->GetVirtualSizeY(), 0.01f, 1000.0f);
-			pass_data.view_view = DirectX::XMMatrixScaling(1, -1, 1) * DirectX::XMMatrixTranslation(-1.0f, 1.0f, 0);
-			pass_constants_.InsertDataByElement(0, &pass_data);
-
-			// Get texture, revert to normal state if possible
-			ButtonState used_state = buttons_[i]->GetState();
-			texture_ = buttons_[i]->GetTexture(used_state);
-			if (texture_ == nullptr) {
-				texture_ = buttons_[i]->GetTexture(ButtonState::Normal);
-				used_state = ButtonState::Normal;
-			}
-
-			if (texture_ == nullptr)
-			{
-				continue;
-			}
-
-			object_data.transform = buttons_[i]->GetFinalTransform();
-			object_data.uv_min = buttons_[i]->GetUVMin(used_state);
-			object_data.uv_max = buttons_[i]->GetUVMax(used_state);
-			object_data.color = buttons_[i]->GetColor(buttons_[i]->GetState());
-			object_constants_.InsertDataByElement(render_id, &object_data);
-
-			//upload buffers and texture
-			context.SetConstantBuffer(0, pass_constants_.GetAddressByElement(0));
-			context.SetConstantBuffer(1, object_constants_.GetAddressByElement(render_id));
-			if (!texture_->AreBuffersBuilt())
-			{
-				texture_->BuildBuffers();
-			}
-			context.SetDescriptorTable(2, Get::CbvSrvUavHeap().GetGPUDescriptorById(texture_->GetSRV()));
-
-			// render
-			context.SetPrimitiveTopology(D3D_PRIMITIVE_TOPOLOGY_TRIANGLELIST);
-			context.SetVertexBuffer(0, vertex_buffer_view_);
-			context.DrawInstanced(static_cast<UINT>(vertices_.size()), 1);
-
-			render_id++;
+	//------------------------------------------------------------------------------------------------------
+	Texture* InterfaceSpriteRenderer::ResolveTexture(Texture* texture, InterfaceSpriteObjectConstants& object_data)
+	{
+		SpriteAtlas::Region region;
+
+		// wrapping uvs can't be expressed inside of an atlas page, so those sprites keep their own texture
+		if (object_data.uv_min.x < 0.0f || object_data.uv_min.y < 0.0f || object_data.uv_max.x > 1.0f || object_data.uv_max.y > 1.0f)
+		{
+			return texture;
+		}
+
+		// a texture that's drawn for the first time is drawn on its own until the atlas was updated
+		if (!atlas_.Find(texture, region))
+		{
+			atlas_dirty_ = atlas_.Add(texture) || atlas_dirty_;
+			return texture;
 		}
+
+		DirectX::XMFLOAT2 region_size = { region.uv_max.x - region.uv_min.x, region.uv_max.y - region.uv_min.y };
+		object_data.uv_min = { region.uv_min.x + object_data.uv_min.x * region_size.x, region.uv_min.y + object_data.uv_min.y * region_size.y };
+		object_data.uv_max = { region.uv_min.x + object_data.uv_max.x * region_size.x, region.uv_min.y + object_data.uv_max.y * region_size.y };
+
+		return region.page;
 	}
 
 	//------------------------------------------------------------------------------------------------------
@@ -147,8 +110,6 @@ namespace tremble
 	{
 		delete pixel_shader_;
 		delete vertex_shader_;
-		delete pass_constants_;
-		delete object_constants_;
 	}
 
 	//------------------------------------------------------------------------------------------------------
@@ -233,8 +194,8 @@ namespace tremble
 	{
 		root_signature_.Create(3, 1);
 		root_signature_[0].InitAsConstantBuffer(0); // pass
-		root_signature_[1].InitAsConstantBuffer(1); // object
-		root_signature_[2].InitAsDescriptorRange(D3D12_DESCRIPTOR_RANGE_TYPE_SRV, 1, 0);  // texture
+		root_signature_[1].InitAsBufferSRV(0); // sprite instances
+		root_signature_[2].InitAsDescriptorRange(D3D12_DESCRIPTOR_RANGE_TYPE_SRV, 1, 1);  // texture
 		root_signature_.InitStaticSampler(0, sampler_state_);
 		root_signature_.Finalize(L"RootSignatureInterfaceSprite", D3D12_ROOT_SIGNATURE_FLAG_ALLOW_INPUT_ASSEMBLER_INPUT_LAYOUT);
 	}
@@ -259,4 +220,16 @@ namespace tremble
 		vertex_buffer_view_.SizeInBytes = static_cast<UINT>(vertices_.size() * sizeof(SpriteVertex));
 		vertex_buffer_view_.BufferLocation = vertex_buffer_->GetGPUVirtualAddress();
 	}
+
+	//------------------------------------------------------------------------------------------------------
+	void InterfaceSpriteRenderer::UpdateAtlas()
+	{
+		if (atlas_dirty_ == false)
+		{
+			return;
+		}
+
+		atlas_.Build();
+		atlas_dirty_ = false;
+	}
 }
\ No newline at end of file
@@ -3,12 +3,15 @@
 #include "root_signature.h"
 #include "graphics_context.h"
 #include "upload_buffer.h"
+#include "sprite_atlas.h"
+#include "sprite_batcher.h"
 #include "../math/math.h"
 
 namespace tremble
 {
 	class Shader;
 	class Texture;
+	struct FramePacket;
 
 	/**
 	* @class tremble::InterfaceSpriteRenderer
@@ -21,21 +24,30 @@ namespace tremble
 		/// Initializes interface renderer
 		void Startup();
 
-		/// Render interface components to specified context
-		void Draw(GraphicsContext&);
+		/// Render the sprites of a frame packet to specified context
+		void Draw(GraphicsContext&, const FramePacket&);
 
 		/// Frees up memory used by interface renderer
 		void Destroy();
 
+		/// Returns the atlas interface textures can be packed into, sprites using packed textures share draw calls
+		SpriteAtlas& GetAtlas() { return atlas_; }
+
+		/// Remaps a sprite to its atlas page if its texture was packed, returns the texture the sprite should be drawn with. Textures that weren't seen before are registered for the next atlas update
+		Texture* ResolveTexture(Texture*, InterfaceSpriteObjectConstants&);
+
+		/// Returns whether textures were registered since the atlas was last built
+		bool IsAtlasDirty() const { return atlas_dirty_; }
+
+		/// Packs the registered textures into the atlas again, the packets in flight must be rendered first as the old pages are freed
+		void UpdateAtlas();
+
 	private:
 		void CreateRenderResources();
 		void CreatePSO();
 		void CreateRootSignature();
 		void CreateGeometry();
 
-		UploadBuffer pass_constants_;
-		UploadBuffer object_constants_;
-
 		Shader* pixel_shader_;
 		Shader* vertex_shader_;
 
@@ -48,5 +60,9 @@ namespace tremble
 		std::vector<SpriteVertex> vertices_;
 		D3D12_VERTEX_BUFFER_VIEW vertex_buffer_view_;
 		StructuredBuffer vertex_buffer_;
+
+		SpriteAtlas atlas_;
+		bool atlas_dirty_ = false;
+		SpriteBatcher batcher_;
 	};
 }
\ No newline at end of file
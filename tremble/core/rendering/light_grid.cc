@@ -0,0 +1,252 @@
+#include "light_grid.h"
+
+#include <ppl.h>
+
+namespace tremble
+{
+	//------------------------------------------------------------------------------------------------------
+	LightGrid::LightGrid() :
+		tiles_x_(0),
+		tiles_y_(0),
+		slices_(0),
+		tile_groups_(0),
+		near_z_(0.0f),
+		far_z_(0.0f),
+		depth_scale_(0.0f),
+		depth_bias_(0.0f),
+		num_dropped_(0)
+	{
+		DirectX::XMStoreFloat4x4(&projection_, DirectX::XMMatrixIdentity());
+	}
+
+	//------------------------------------------------------------------------------------------------------
+	void LightGrid::Configure(uint32_t tiles_x, uint32_t tiles_y, uint32_t slices, const DirectX::XMFLOAT4X4& projection, float near_z, float far_z)
+	{
+		if (tiles_x == tiles_x_ && tiles_y == tiles_y_ && slices == slices_ &&
+			projection._11 == projection_._11 && projection._22 == projection_._22 &&
+			near_z == near_z_ && far_z == far_z_)
+		{
+			return;
+		}
+
+		tiles_x_ = tiles_x;
+		tiles_y_ = tiles_y;
+		slices_ = slices;
+		projection_ = projection;
+		near_z_ = near_z;
+		far_z_ = far_z;
+
+		const float log_range = std::log(far_z_ / near_z_);
+		depth_scale_ = slices_ / log_range;
+		depth_bias_ = slices_ * std::log(near_z_) / log_range;
+
+		const uint32_t num_clusters = GetNumClusters();
+		slice_lights_.resize(slices_);
+		slice_dropped_.resize(slices_);
+		cluster_counts_.resize(num_clusters);
+		cluster_lights_.resize(num_clusters * LIGHT_GRID_MAX_LIGHTS_PER_CLUSTER);
+		ranges_.assign(num_clusters, { 0, 0 });
+
+		BuildBounds();
+	}
+
+	//------------------------------------------------------------------------------------------------------
+	void LightGrid::Build(const std::vector<ClusterLight>& lights)
+	{
+		for (uint32_t s = 0; s < slices_; s++)
+		{
+			slice_lights_[s].clear();
+		}
+
+		// sort the lights into the slices their depth range overlaps
+		for (uint32_t i = 0; i < lights.size(); i++)
+		{
+			const ClusterLight& light = lights[i];
+			float min_depth = light.position_view.z - light.range;
+			float max_depth = light.position_view.z + light.range;
+
+			if (max_depth < near_z_ || min_depth > far_z_)
+			{
+				continue;
+			}
+
+			uint32_t last_slice = GetSlice(max_depth);
+			for (uint32_t s = GetSlice(min_depth); s <= last_slice; s++)
+			{
+				slice_lights_[s].push_back(i);
+			}
+		}
+
+		std::fill(cluster_counts_.begin(), cluster_counts_.end(), 0);
+
+		if (lights.size() >= LIGHT_GRID_PARALLEL_THRESHOLD)
+		{
+			concurrency::parallel_for(0u, slices_, [this, &lights](uint32_t s)
+			{
+				BinSlice(s, lights);
+			});
+		}
+		else
+		{
+			for (uint32_t s = 0; s < slices_; s++)
+			{
+				BinSlice(s, lights);
+			}
+		}
+
+		// compact the fixed size cluster slots into one index list
+		indices_.clear();
+		num_dropped_ = 0;
+
+		for (uint32_t c = 0; c < ranges_.size(); c++)
+		{
+			const uint32_t* slots = &cluster_lights_[c * LIGHT_GRID_MAX_LIGHTS_PER_CLUSTER];
+
+			ranges_[c].offset = static_cast<uint32_t>(indices_.size());
+			ranges_[c].count = cluster_counts_[c];
+			indices_.insert(indices_.end(), slots, slots + cluster_counts_[c]);
+		}
+
+		for (uint32_t s = 0; s < slices_; s++)
+		{
+			num_dropped_ += slice_dropped_[s];
+		}
+	}
+
+	//------------------------------------------------------------------------------------------------------
+	uint32_t LightGrid::GetSlice(float depth) const
+	{
+		if (depth <= near_z_)
+		{
+			return 0;
+		}
+
+		int slice = static_cast<int>(std::floor(std::log(depth) * depth_scale_ - depth_bias_));
+		return static_cast<uint32_t>(std::min(std::max(slice, 0), static_cast<int>(slices_) - 1));
+	}
+
+	//------------------------------------------------------------------------------------------------------
+	void LightGrid::BinSlice(uint32_t slice, const std::vector<ClusterLight>& lights)
+	{
+		const uint32_t tiles_per_slice = tiles_x_ * tiles_y_;
+		const DirectX::XMFLOAT4A* bounds = &bounds_[slice * tile_groups_ * 4];
+		uint32_t* counts = &cluster_counts_[slice * tiles_per_slice];
+		uint32_t* slots = &cluster_lights_[slice * tiles_per_slice * LIGHT_GRID_MAX_LIGHTS_PER_CLUSTER];
+
+		const float slice_near = slice_depths_[slice];
+		const float slice_far = slice_depths_[slice + 1];
+
+		uint32_t dropped = 0;
+		const std::vector<uint32_t>& slice_lights = slice_lights_[slice];
+
+		for (size_t i = 0; i < slice_lights.size(); i++)
+		{
+			const ClusterLight& light = lights[slice_lights[i]];
+
+			// every cluster in the slice has the same depth range, so the depth distance is shared by all of them
+			float dz = light.position_view.z - std::min(std::max(light.position_view.z, slice_near), slice_far);
+			float remaining = light.range * light.range - dz * dz;
+			if (remaining < 0.0f)
+			{
+				continue;
+			}
+
+			DirectX::XMVECTOR center_x = DirectX::XMVectorReplicate(light.position_view.x);
+			DirectX::XMVECTOR center_y = DirectX::XMVectorReplicate(light.position_view.y);
+			DirectX::XMVECTOR radius_sq = DirectX::XMVectorReplicate(remaining);
+
+			for (uint32_t g = 0; g < tile_groups_; g++)
+			{
+				DirectX::XMVECTOR min_x = DirectX::XMLoadFloat4A(&bounds[g * 4 + 0]);
+				DirectX::XMVECTOR max_x = DirectX::XMLoadFloat4A(&bounds[g * 4 + 1]);
+				DirectX::XMVECTOR min_y = DirectX::XMLoadFloat4A(&bounds[g * 4 + 2]);
+				DirectX::XMVECTOR max_y = DirectX::XMLoadFloat4A(&bounds[g * 4 + 3]);
+
+				// distance from the sphere center to the closest point of four boxes at once
+				DirectX::XMVECTOR dx = DirectX::XMVectorSubtract(center_x, DirectX::XMVectorMin(DirectX::XMVectorMax(center_x, min_x), max_x));
+				DirectX::XMVECTOR dy = DirectX::XMVectorSubtract(center_y, DirectX::XMVectorMin(DirectX::XMVectorMax(center_y, min_y), max_y));
+				DirectX::XMVECTOR distance_sq = DirectX::XMVectorMultiplyAdd(dx, dx, DirectX::XMVectorMultiply(dy, dy));
+				DirectX::XMVECTOR overlaps = DirectX::XMVectorLessOrEqual(distance_sq, radius_sq);
+
+				if (DirectX::XMVector4EqualInt(overlaps, DirectX::XMVectorFalseInt()))
+				{
+					continue;
+				}
+
+				uint32_t mask[4];
+				DirectX::XMStoreInt4(mask, overlaps);
+
+				for (uint32_t lane = 0; lane < 4; lane++)
+				{
+					if (mask[lane] == 0)
+					{
+						continue;
+					}
+
+					uint32_t tile = g * 4 + lane;
+					if (counts[tile] < LIGHT_GRID_MAX_LIGHTS_PER_CLUSTER)
+					{
+						slots[tile * LIGHT_GRID_MAX_LIGHTS_PER_CLUSTER + counts[tile]++] = slice_lights[i];
+					}
+					else
+					{
+						dropped++;
+					}
+				}
+			}
+		}
+
+		slice_dropped_[slice] = dropped;
+	}
+
+	//------------------------------------------------------------------------------------------------------
+	void LightGrid::BuildBounds()
+	{
+		const uint32_t tiles_per_slice = tiles_x_ * tiles_y_;
+		tile_groups_ = (tiles_per_slice + 3) / 4;
+
+		slice_depths_.resize(slices_ + 1);
+		for (uint32_t s = 0; s <= slices_; s++)
+		{
+			slice_depths_[s] = near_z_ * std::pow(far_z_ / near_z_, static_cast<float>(s) / slices_);
+		}
+
+		// padding tiles get inverted bounds, which no sphere can ever overlap
+		const float empty = 1e30f;
+		bounds_.assign(slices_ * tile_groups_ * 4, DirectX::XMFLOAT4A(empty, empty, empty, empty));
+
+		for (uint32_t s = 0; s < slices_; s++)
+		{
+			const float d0 = slice_depths_[s];
+			const float d1 = slice_depths_[s + 1];
+
+			for (uint32_t t = 0; t < tiles_per_slice; t++)
+			{
+				uint32_t x = t % tiles_x_;
+				uint32_t y = t / tiles_x_;
+
+				// normalized device coordinates of the tile, the first row is at the top of the screen
+				float ndc_x0 = -1.0f + 2.0f * x / tiles_x_;
+				float ndc_x1 = -1.0f + 2.0f * (x + 1) / tiles_x_;
+				float ndc_y0 = 1.0f - 2.0f * (y + 1) / tiles_y_;
+				float ndc_y1 = 1.0f - 2.0f * y / tiles_y_;
+
+				// view space position = ndc * depth / projection scale, the extremes lie on the slice's near or far plane
+				float* group = reinterpret_cast<float*>(&bounds_[(s * tile_groups_ + t / 4) * 4]);
+				uint32_t lane = t % 4;
+
+				group[0 * 4 + lane] = std::min(ndc_x0 * d0, ndc_x0 * d1) / projection_._11;
+				group[1 * 4 + lane] = std::max(ndc_x1 * d0, ndc_x1 * d1) / projection_._11;
+				group[2 * 4 + lane] = std::min(ndc_y0 * d0, ndc_y0 * d1) / projection_._22;
+				group[3 * 4 + lane] = std::max(ndc_y1 * d0, ndc_y1 * d1) / projection_._22;
+			}
+
+			for (uint32_t t = tiles_per_slice; t < tile_groups_ * 4; t++)
+			{
+				float* group = reinterpret_cast<float*>(&bounds_[(s * tile_groups_ + t / 4) * 4]);
+				group[1 * 4 + t % 4] = -empty;
+				group[3 * 4 + t % 4] = -empty;
+			}
+		}
+	}
+}
\ No newline at end of file
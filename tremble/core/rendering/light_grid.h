@@ -0,0 +1,119 @@
+#pragma once
+
+#define LIGHT_GRID_TILES_X 16
+#define LIGHT_GRID_TILES_Y 9
+#define LIGHT_GRID_SLICES 24
+#define LIGHT_GRID_MAX_LIGHTS_PER_CLUSTER 128
+#define LIGHT_GRID_PARALLEL_THRESHOLD 64 // below this many lights the slices are binned on the calling thread
+
+namespace tremble
+{
+	/**
+	* @struct tremble::ClusterLight
+	* @brief The bounding sphere of a light that is binned into the light grid
+	*/
+	struct ClusterLight
+	{
+		DirectX::XMFLOAT3 position_view; //!< The position of the light in view space
+		float range; //!< The distance at which the light's contribution reaches zero
+	};
+
+	/**
+	* @class tremble::LightGrid
+	* @brief Bins lights into a froxel grid built from the camera frustum, for clustered light culling
+	*
+	* The view frustum is split into screen space tiles and exponentially distributed depth slices. Every light's
+	* bounding sphere is tested against the view space bounding boxes of the clusters it may touch, four clusters at
+	* a time, and every cluster gets a compact range in a shared light index list. Lights are first sorted into the
+	* depth slices they overlap, after which the slices are binned in parallel; slices never share clusters, so the
+	* workers don't need to synchronize. The grid only deals with plain data & never touches the GPU.
+	*/
+	class LightGrid
+	{
+	public:
+		/**
+		* @struct tremble::LightGrid::Range
+		* @brief The lights of a single cluster, laid out as a uint2 in shaders
+		*/
+		struct Range
+		{
+			uint32_t offset; //!< The index of the cluster's first light in the light index list
+			uint32_t count; //!< The number of lights in the cluster
+		};
+
+		LightGrid(); //!< Default constructor
+
+		/**
+		* @brief Sets up the grid & rebuilds the cluster bounds if any of the parameters changed
+		* @param[in] tiles_x The number of tiles along the width of the screen
+		* @param[in] tiles_y The number of tiles along the height of the screen
+		* @param[in] slices The number of depth slices
+		* @param[in] projection The (symmetric, left handed) projection matrix of the camera
+		* @param[in] near_z The distance to the near plane of the camera
+		* @param[in] far_z The distance to the far plane of the camera
+		*/
+		void Configure(uint32_t tiles_x, uint32_t tiles_y, uint32_t slices, const DirectX::XMFLOAT4X4& projection, float near_z, float far_z);
+
+		/**
+		* @brief Bins lights into the clusters, replacing the previous result
+		* @param[in] lights The lights to bin, the light index list refers to indices in this vector
+		*/
+		void Build(const std::vector<ClusterLight>& lights);
+
+		/**
+		* @brief Finds the depth slice a view space depth falls in, the same way shaders do
+		* @param[in] depth The view space depth
+		*/
+		uint32_t GetSlice(float depth) const;
+
+		uint32_t GetClusterIndex(uint32_t x, uint32_t y, uint32_t z) const { return (z * tiles_y_ + y) * tiles_x_ + x; }
+
+		const std::vector<Range>& GetRanges() const { return ranges_; } //!< The light range of every cluster, ordered by slice, row & column
+		const std::vector<uint32_t>& GetIndices() const { return indices_; } //!< The light indices of all clusters
+
+		uint32_t GetNumTilesX() const { return tiles_x_; }
+		uint32_t GetNumTilesY() const { return tiles_y_; }
+		uint32_t GetNumSlices() const { return slices_; }
+		uint32_t GetNumClusters() const { return tiles_x_ * tiles_y_ * slices_; }
+
+		float GetDepthScale() const { return depth_scale_; } //!< slice = log(depth) * scale - bias
+		float GetDepthBias() const { return depth_bias_; } //!< slice = log(depth) * scale - bias
+
+		float GetSliceDepth(uint32_t slice) const { return slice_depths_[slice]; } //!< The view space depth at which a slice starts, the slice count gives the far plane
+		const DirectX::XMFLOAT4X4& GetProjection() const { return projection_; } //!< The projection the cluster bounds were built for
+
+		uint32_t GetNumDroppedLights() const { return num_dropped_; } //!< The number of cluster entries that didn't fit in the last build
+
+	private:
+		/**
+		* @brief Bins all lights that overlap a depth slice into the clusters of that slice
+		* @param[in] slice The depth slice
+		* @param[in] lights The lights that are being binned
+		*/
+		void BinSlice(uint32_t slice, const std::vector<ClusterLight>& lights);
+
+		void BuildBounds(); //!< Computes the view space bounding boxes of all clusters
+
+		uint32_t tiles_x_; //!< The number of tiles along the width of the screen
+		uint32_t tiles_y_; //!< The number of tiles along the height of the screen
+		uint32_t slices_; //!< The number of depth slices
+		uint32_t tile_groups_; //!< The number of groups of four tiles in a slice
+		DirectX::XMFLOAT4X4 projection_; //!< The projection the bounds were built for
+		float near_z_; //!< The near plane the bounds were built for
+		float far_z_; //!< The far plane the bounds were built for
+		float depth_scale_; //!< Scales the log of a depth to a slice
+		float depth_bias_; //!< Offsets the scaled log of a depth to a slice
+
+		std::vector<DirectX::XMFLOAT4A> bounds_; //!< Per slice & group of four tiles: min x, max x, min y & max y of the four tiles
+		std::vector<float> slice_depths_; //!< The view space depth at which every slice starts, plus the far plane
+
+		std::vector<std::vector<uint32_t>> slice_lights_; //!< The lights that overlap every slice
+		std::vector<uint32_t> cluster_lights_; //!< LIGHT_GRID_MAX_LIGHTS_PER_CLUSTER light slots for every cluster
+		std::vector<uint32_t> cluster_counts_; //!< The number of used light slots of every cluster
+		std::vector<uint32_t> slice_dropped_; //!< The number of lights that didn't fit in the clusters of every slice
+		uint32_t num_dropped_; //!< The number of cluster entries that didn't fit in the last build
+
+		std::vector<Range> ranges_; //!< The light range of every cluster
+		std::vector<uint32_t> indices_; //!< The light indices of all clusters
+	};
+}
\ No newline at end of file
@@ -29,8 +29,5 @@ namespace tremble
 		bool use_ambient_map = false;
 		DirectX::XMFLOAT3 ambient_reflectance = DirectX::XMFLOAT3(0.1f, 0.1f, 0.1f);
 		Texture* ambient_map = nullptr;
-
-		UINT renderer_material_cb_id = 0;
-		UINT renderer_material_descriptor_id = 0;
 	};
 }
\ No newline at end of file
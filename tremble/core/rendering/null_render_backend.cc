@@ -0,0 +1,435 @@
+#include "null_render_backend.h"
+
+#include "frame_packet.h"
+#include "constant_buffers.h"
+#include "../resources/mesh.h"
+#include "../utilities/stopwatch.h"
+
+namespace tremble
+{
+	namespace
+	{
+		//------------------------------------------------------------------------------------------------------
+		bool IsFinite(const DirectX::XMFLOAT4X4& matrix)
+		{
+			for (int i = 0; i < 16; i++)
+			{
+				if (!std::isfinite(reinterpret_cast<const float*>(&matrix)[i]))
+				{
+					return false;
+				}
+			}
+
+			return true;
+		}
+
+		//------------------------------------------------------------------------------------------------------
+		bool IsInRange(uint32_t first, uint32_t count, uint32_t size)
+		{
+			return first <= size && count <= size - first;
+		}
+
+		//------------------------------------------------------------------------------------------------------
+		bool Fail(std::string& out_error, const std::string& error)
+		{
+			out_error = error;
+			return false;
+		}
+	}
+
+	//------------------------------------------------------------------------------------------------------
+	void RenderCommandStats::Add(const RenderCommandStats& other)
+	{
+		num_draws += other.num_draws;
+		num_instances += other.num_instances;
+		num_material_binds += other.num_material_binds;
+		num_mesh_binds += other.num_mesh_binds;
+		num_shadow_maps += other.num_shadow_maps;
+		num_upload_bytes += other.num_upload_bytes;
+		record_time += other.record_time;
+	}
+
+	//------------------------------------------------------------------------------------------------------
+	NullRenderBackend::NullRenderBackend() :
+		last_frame_(0),
+		num_frames_(0),
+		num_invalid_frames_(0),
+		num_draws_(0),
+		depth_pass_(true),
+		instancing_(true)
+	{
+
+	}
+
+	//------------------------------------------------------------------------------------------------------
+	void NullRenderBackend::Render(const FramePacket& packet)
+	{
+		std::string error;
+
+		if (packet.frame <= last_frame_)
+		{
+			error = "frame " + std::to_string(packet.frame) + " was rendered after frame " + std::to_string(last_frame_);
+		}
+		else
+		{
+			Validate(packet, error);
+		}
+
+		if (error.empty() == false)
+		{
+			last_error_ = error;
+			num_invalid_frames_++;
+		}
+		else
+		{
+			// an invalid packet could index out of its arrays, so only valid ones are recorded
+			Record(packet);
+		}
+
+		last_frame_ = packet.frame;
+		num_frames_++;
+		num_draws_ += packet.draws.size;
+	}
+
+	//------------------------------------------------------------------------------------------------------
+	bool NullRenderBackend::Validate(const FramePacket& packet, std::string& out_error)
+	{
+		const PacketView& view = packet.view;
+
+		if (!IsFinite(view.view) || !IsFinite(view.projection) || !IsFinite(view.view_projection) || !(view.near_z > 0.0f && view.near_z < view.far_z))
+		{
+			return Fail(out_error, "the view is degenerate");
+		}
+
+		for (uint32_t i = 0; i < packet.draws.size; i++)
+		{
+			const PacketMeshDraw& draw = packet.draws[i];
+
+			if (draw.mesh == nullptr)
+			{
+				return Fail(out_error, "draw " + std::to_string(i) + " has no mesh");
+			}
+
+			if (draw.lod < 0 || draw.lod >= draw.mesh->GetLODCount() || !IsFinite(draw.world))
+			{
+				return Fail(out_error, "draw " + std::to_string(i) + " has an invalid LOD or transform");
+			}
+		}
+
+		for (uint32_t i = 0; i < packet.skinned.size; i++)
+		{
+			const PacketSkinned& skinned = packet.skinned[i];
+
+			if (!IsInRange(skinned.first_mesh, skinned.num_meshes, packet.skinned_meshes.size) || !IsInRange(skinned.first_bone, skinned.num_bones, packet.bones.size))
+			{
+				return Fail(out_error, "skinned renderable " + std::to_string(i) + " is out of range");
+			}
+		}
+
+		for (uint32_t i = 0; i < packet.skinned_meshes.size; i++)
+		{
+			if (packet.skinned_meshes[i].mesh == nullptr || !IsFinite(packet.skinned_meshes[i].world))
+			{
+				return Fail(out_error, "skinned mesh " + std::to_string(i) + " is invalid");
+			}
+		}
+
+		for (uint32_t i = 0; i < packet.lights.size; i++)
+		{
+			const PacketLight& light = packet.lights[i];
+
+			if (light.type < LightTypeDirectional || light.type > LightTypeDualConeSpot)
+			{
+				return Fail(out_error, "light " + std::to_string(i) + " has an unknown type");
+			}
+
+			if (light.shadow_range != 0 && (light.shadow_index < 0 || light.shadow_range < 0 || !IsInRange(light.shadow_index, light.shadow_range, packet.shadow_maps.size)))
+			{
+				return Fail(out_error, "light " + std::to_string(i) + " refers to shadow maps that don't exist");
+			}
+		}
+
+		for (uint32_t i = 0; i < packet.shadow_lights.size; i++)
+		{
+			if (!IsInRange(packet.shadow_lights[i].first_map, packet.shadow_lights[i].num_maps, packet.shadow_maps.size))
+			{
+				return Fail(out_error, "shadow light " + std::to_string(i) + " is out of range");
+			}
+		}
+
+		for (uint32_t i = 0; i < packet.shadow_maps.size; i++)
+		{
+			const PacketShadowMap& map = packet.shadow_maps[i];
+
+			if (!IsFinite(map.view) || !IsFinite(map.projection))
+			{
+				return Fail(out_error, "shadow map " + std::to_string(i) + " has an invalid transform");
+			}
+
+			if (!IsInRange(map.first_caster, map.num_casters, packet.shadow_casters.size) || !IsInRange(map.first_skinned_caster, map.num_skinned_casters, packet.shadow_skinned_casters.size))
+			{
+				return Fail(out_error, "the casters of shadow map " + std::to_string(i) + " are out of range");
+			}
+
+			if (map.render == false && (map.num_casters != 0 || map.num_skinned_casters != 0))
+			{
+				return Fail(out_error, "cached shadow map " + std::to_string(i) + " has casters");
+			}
+		}
+
+		for (uint32_t i = 0; i < packet.shadow_casters.size; i++)
+		{
+			if (packet.shadow_casters[i].mesh == nullptr || !IsFinite(packet.shadow_casters[i].world))
+			{
+				return Fail(out_error, "shadow caster " + std::to_string(i) + " is invalid");
+			}
+		}
+
+		for (uint32_t i = 0; i < packet.shadow_skinned_casters.size; i++)
+		{
+			if (packet.shadow_skinned_casters[i] >= packet.skinned.size)
+			{
+				return Fail(out_error, "skinned shadow caster " + std::to_string(i) + " is out of range");
+			}
+		}
+
+		for (uint32_t i = 0; i < packet.particle_systems.size; i++)
+		{
+			if (!IsInRange(packet.particle_systems[i].first_particle, packet.particle_systems[i].num_particles, packet.particles.size))
+			{
+				return Fail(out_error, "particle system " + std::to_string(i) + " is out of range");
+			}
+		}
+
+		for (uint32_t i = 0; i < packet.sprites.size; i++)
+		{
+			if (packet.sprites[i].texture == nullptr)
+			{
+				return Fail(out_error, "sprite " + std::to_string(i) + " has no texture");
+			}
+		}
+
+		for (uint32_t i = 0; i < packet.texts.size; i++)
+		{
+			if (packet.texts[i].texture == nullptr || !IsInRange(packet.texts[i].first_glyph, packet.texts[i].num_glyphs, packet.glyphs.size))
+			{
+				return Fail(out_error, "text " + std::to_string(i) + " has no texture or is out of range");
+			}
+		}
+
+		for (uint32_t i = 0; i < packet.debug_meshes.size; i++)
+		{
+			if (packet.debug_meshes[i] == nullptr)
+			{
+				return Fail(out_error, "debug volume " + std::to_string(i) + " has no mesh");
+			}
+		}
+
+		return true;
+	}
+
+	//------------------------------------------------------------------------------------------------------
+	void NullRenderBackend::Record(const FramePacket& packet)
+	{
+		Stopwatch stopwatch;
+
+		frame_stats_ = RenderCommandStats();
+		upload_.clear();
+
+		// the same order the renderer records in: bones, shadow maps, scene passes & the overlay
+		for (uint32_t i = 0; i < packet.skinned.size; i++)
+		{
+			size_t num_bytes = packet.skinned[i].num_bones * sizeof(DirectX::XMFLOAT4X4);
+			memcpy(Upload(num_bytes), &packet.bones[packet.skinned[i].first_bone], num_bytes);
+		}
+
+		for (uint32_t i = 0; i < packet.shadow_maps.size; i++)
+		{
+			const PacketShadowMap& map = packet.shadow_maps[i];
+
+			if (map.render == false)
+			{
+				continue;
+			}
+
+			PacketView map_view;
+			map_view.view = map.view;
+			DirectX::XMStoreFloat4x4(&map_view.view_projection, DirectX::XMMatrixMultiply(DirectX::XMLoadFloat4x4(&map.view), DirectX::XMLoadFloat4x4(&map.projection)));
+
+			for (uint32_t j = map.first_caster; j < map.first_caster + map.num_casters; j++)
+			{
+				RecordObject(map_view, packet.shadow_casters[j].world);
+				frame_stats_.num_mesh_binds++;
+			}
+
+			for (uint32_t j = map.first_skinned_caster; j < map.first_skinned_caster + map.num_skinned_casters; j++)
+			{
+				const PacketSkinned& skinned = packet.skinned[packet.shadow_skinned_casters[j]];
+
+				for (uint32_t k = skinned.first_mesh; k < skinned.first_mesh + skinned.num_meshes; k++)
+				{
+					RecordObject(map_view, packet.skinned_meshes[k].world);
+					frame_stats_.num_mesh_binds++;
+				}
+			}
+
+			frame_stats_.num_shadow_maps++;
+		}
+
+		planner_.Plan(packet, depth_pass_, instancing_);
+
+		if (planner_.IsInstancing() == true)
+		{
+			planner_.WriteInstances(Upload(planner_.GetNumInstances() * sizeof(ObjectConstants)));
+		}
+
+		for (int pass = 0; pass < DrawList::PassCount; pass++)
+		{
+			RecordPass(packet, static_cast<DrawList::Pass>(pass));
+		}
+
+		// skinned meshes always bind their own material & buffers, once for the depth pre-pass & once for the lit pass
+		for (uint32_t i = 0; i < packet.skinned_meshes.size; i++)
+		{
+			if (depth_pass_ == true)
+			{
+				RecordObject(packet.view, packet.skinned_meshes[i].world);
+				frame_stats_.num_mesh_binds++;
+			}
+
+			RecordObject(packet.view, packet.skinned_meshes[i].world);
+			Upload(sizeof(MaterialConstants));
+			frame_stats_.num_material_binds++;
+			frame_stats_.num_mesh_binds++;
+		}
+
+		for (uint32_t i = 0; i < packet.debug_meshes.size; i++)
+		{
+			frame_stats_.num_draws++;
+			frame_stats_.num_instances++;
+			frame_stats_.num_mesh_binds++;
+		}
+
+		if (packet.particles.empty() == false)
+		{
+			memcpy(Upload(packet.particles.size * sizeof(ParticleRenderable)), packet.particles.data, packet.particles.size * sizeof(ParticleRenderable));
+		}
+
+		for (uint32_t i = 0; i < packet.particle_systems.size; i++)
+		{
+			frame_stats_.num_draws++;
+			frame_stats_.num_instances += packet.particle_systems[i].num_particles;
+		}
+
+		sprite_batcher_.Clear();
+
+		for (uint32_t i = 0; i < packet.sprites.size; i++)
+		{
+			sprite_batcher_.Add(packet.sprites[i].constants, packet.sprites[i].texture, packet.sprites[i].layer);
+		}
+
+		sprite_batcher_.Build();
+
+		const std::vector<InterfaceSpriteObjectConstants>& sprite_instances = sprite_batcher_.GetInstances();
+		if (sprite_instances.empty() == false)
+		{
+			memcpy(Upload(sprite_instances.size() * sizeof(InterfaceSpriteObjectConstants)), sprite_instances.data(), sprite_instances.size() * sizeof(InterfaceSpriteObjectConstants));
+		}
+
+		for (size_t i = 0; i < sprite_batcher_.GetBatches().size(); i++)
+		{
+			frame_stats_.num_draws++;
+			frame_stats_.num_instances += sprite_batcher_.GetBatches()[i].count;
+		}
+
+		// the font renderer only copies the glyphs of texts that changed, this counts them as if all of them did
+		if (packet.glyphs.empty() == false)
+		{
+			memcpy(Upload(packet.glyphs.size * sizeof(InterfaceFontData)), packet.glyphs.data, packet.glyphs.size * sizeof(InterfaceFontData));
+		}
+
+		frame_stats_.num_draws += packet.texts.size;
+		frame_stats_.num_instances += packet.texts.size;
+
+		frame_stats_.record_time = stopwatch.Output() * 1000.0f;
+		total_stats_.Add(frame_stats_);
+	}
+
+	//------------------------------------------------------------------------------------------------------
+	void NullRenderBackend::RecordPass(const FramePacket& packet, DrawList::Pass pass)
+	{
+		DrawStateCache state_cache;
+
+		bool positions_only = pass == DrawList::PassDepth;
+		size_t num_draws = planner_.GetNumPassDraws(pass);
+
+		if (planner_.IsInstancing() == true)
+		{
+			const std::vector<InstanceBatcher::Batch>& batches = planner_.GetBatches();
+
+			for (size_t i = planner_.GetFirstBatch(pass); i < planner_.GetFirstBatch(pass) + num_draws; i++)
+			{
+				RecordMesh(packet.draws[batches[i].payload], positions_only, state_cache);
+
+				frame_stats_.num_draws++;
+				frame_stats_.num_instances += batches[i].num_instances;
+			}
+
+			return;
+		}
+
+		const std::vector<DrawList::DrawItem>& items = planner_.GetItems();
+
+		for (size_t i = planner_.GetFirstItem(pass); i < planner_.GetFirstItem(pass) + num_draws; i++)
+		{
+			const PacketMeshDraw& draw = packet.draws[items[i].payload];
+
+			ObjectConstants constants;
+			DrawPlanner::ComputeObjectConstants(packet.view, draw.world, constants);
+			memcpy(Upload(sizeof(ObjectConstants)), &constants, sizeof(ObjectConstants));
+
+			RecordMesh(draw, positions_only, state_cache);
+
+			frame_stats_.num_draws++;
+			frame_stats_.num_instances++;
+		}
+	}
+
+	//------------------------------------------------------------------------------------------------------
+	void NullRenderBackend::RecordMesh(const PacketMeshDraw& draw, bool positions_only, DrawStateCache& state_cache)
+	{
+		Material* material = draw.mesh->GetMaterial();
+		if (positions_only == false && state_cache.Apply(DrawStateCache::SlotMaterial, material))
+		{
+			Upload(sizeof(MaterialConstants));
+			frame_stats_.num_material_binds++;
+		}
+
+		if (state_cache.Apply(DrawStateCache::SlotMesh, draw.mesh))
+		{
+			frame_stats_.num_mesh_binds++;
+		}
+	}
+
+	//------------------------------------------------------------------------------------------------------
+	void NullRenderBackend::RecordObject(const PacketView& view, const DirectX::XMFLOAT4X4& world)
+	{
+		ObjectConstants constants;
+		DrawPlanner::ComputeObjectConstants(view, world, constants);
+		memcpy(Upload(sizeof(ObjectConstants)), &constants, sizeof(ObjectConstants));
+
+		frame_stats_.num_draws++;
+		frame_stats_.num_instances++;
+	}
+
+	//------------------------------------------------------------------------------------------------------
+	BYTE* NullRenderBackend::Upload(size_t num_bytes)
+	{
+		size_t offset = upload_.size();
+		upload_.resize(offset + num_bytes);
+
+		frame_stats_.num_upload_bytes += num_bytes;
+
+		return upload_.data() + offset;
+	}
+}
\ No newline at end of file
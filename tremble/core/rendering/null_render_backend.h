@@ -0,0 +1,121 @@
+#pragma once
+
+#include "render_backend.h"
+#include "draw_planner.h"
+#include "sprite_batcher.h"
+
+namespace tremble
+{
+	/**
+	* @struct tremble::RenderCommandStats
+	* @brief What the null backend would have recorded for one or more frames
+	*/
+	struct RenderCommandStats
+	{
+		uint64_t num_draws = 0; //!< The number of draw calls, an instanced batch counts as one
+		uint64_t num_instances = 0; //!< The number of instances drawn by all draw calls
+		uint64_t num_material_binds = 0; //!< The number of times a material was bound
+		uint64_t num_mesh_binds = 0; //!< The number of times a mesh's buffers were bound
+		uint64_t num_shadow_maps = 0; //!< The number of shadow maps that were rendered, cached maps aren't counted
+		uint64_t num_upload_bytes = 0; //!< The number of bytes written to per-frame upload memory
+		float record_time = 0.0f; //!< The CPU time spent recording, in milliseconds
+
+		/**
+		* @brief Adds the stats of another frame to these
+		* @param[in] other The stats to add
+		*/
+		void Add(const RenderCommandStats& other);
+	};
+
+	/**
+	* @class tremble::NullRenderBackend
+	* @brief Consumes frame packets without a device, checks that they're well formed & replays their CPU work
+	*
+	* Meant for running the simulation & extraction headless: every packet is validated (array ranges, non-null
+	* resources, LODs, finite transforms, shadow map assignments & frame order). The last problem that was found is
+	* kept, so a failing frame can be reported. Valid packets are then recorded the way the renderer records them,
+	* minus the device: the draws are planned with the same DrawPlanner, object, material & instance constants, bones,
+	* particles, sprites & glyphs are packed into CPU memory instead of upload memory and the interface sprites are
+	* batched. Every draw call & state change that would have been recorded is counted instead, so the CPU cost &
+	* the command counts of the render path can be measured on a machine without a GPU.
+	*
+	* The counts assume every pass is recorded as a single chunk, the renderer may rebind some state at the start of
+	* every chunk it records on another thread.
+	*/
+	class NullRenderBackend : public RenderBackend
+	{
+	public:
+		NullRenderBackend(); //!< Default constructor
+
+		void Render(const FramePacket& packet) override; //!< Validates a packet & counts it
+
+		/**
+		* @brief Checks that a packet is well formed
+		* @param[in] packet The packet to check
+		* @param[out] out_error A description of the first problem that was found
+		* @return Whether the packet is well formed
+		*/
+		static bool Validate(const FramePacket& packet, std::string& out_error);
+
+		uint64_t GetNumFrames() const { return num_frames_; } //!< The number of packets that were consumed
+		uint64_t GetNumInvalidFrames() const { return num_invalid_frames_; } //!< The number of packets that weren't well formed
+		uint64_t GetNumDraws() const { return num_draws_; } //!< The total number of mesh draws in all consumed packets
+		const std::string& GetLastError() const { return last_error_; } //!< The last problem that was found, empty if there never was one
+
+		void SetDepthPrePass(bool depth_pass) { depth_pass_ = depth_pass; } //!< Sets whether the depth pre-pass is recorded, like Config::depth_pre_pass
+		void SetInstancing(bool instancing) { instancing_ = instancing; } //!< Sets whether draws are recorded as instanced batches, like Config::instanced_rendering
+
+		const RenderCommandStats& GetFrameStats() const { return frame_stats_; } //!< What was recorded for the last valid packet
+		const RenderCommandStats& GetTotalStats() const { return total_stats_; } //!< What was recorded for all valid packets
+
+	private:
+		/**
+		* @brief Records a valid packet into the frame stats
+		* @param[in] packet The packet to record
+		*/
+		void Record(const FramePacket& packet);
+
+		/**
+		* @brief Records the draws of a single pass in sorted order
+		* @param[in] packet The packet that is recorded
+		* @param[in] pass The pass of which the draws should be recorded
+		*/
+		void RecordPass(const FramePacket& packet, DrawList::Pass pass);
+
+		/**
+		* @brief Records the bindings of a single mesh draw, only counting the state that differs from the previous draw
+		* @param[in] draw The draw to record
+		* @param[in] positions_only Whether only the positions are bound, without a material
+		* @param[in] state_cache The state bound by the previous draws of the pass
+		*/
+		void RecordMesh(const PacketMeshDraw& draw, bool positions_only, DrawStateCache& state_cache);
+
+		/**
+		* @brief Records a non-instanced draw of a mesh with its own object constants
+		* @param[in] view The view the constants are computed for
+		* @param[in] world The world transform of the mesh
+		*/
+		void RecordObject(const PacketView& view, const DirectX::XMFLOAT4X4& world);
+
+		/**
+		* @brief Allocates a block of the CPU memory that stands in for upload memory & counts its bytes
+		* @param[in] num_bytes The size of the block
+		* @return The block, valid until the next allocation
+		*/
+		BYTE* Upload(size_t num_bytes);
+
+		bool depth_pass_; //!< Whether the depth pre-pass is recorded
+		bool instancing_; //!< Whether draws are recorded as instanced batches
+		DrawPlanner planner_; //!< Plans the mesh draws of the recorded packet
+		SpriteBatcher sprite_batcher_; //!< Batches the interface sprites of the recorded packet
+		std::vector<BYTE> upload_; //!< Stands in for the per-frame upload memory, kept across frames
+		RenderCommandStats frame_stats_; //!< What was recorded for the last valid packet
+		RenderCommandStats total_stats_; //!< What was recorded for all valid packets
+
+		uint64_t last_frame_; //!< The number of the last consumed packet
+		uint64_t num_frames_; //!< The number of packets that were consumed
+		uint64_t num_invalid_frames_; //!< The number of packets that weren't well formed
+		uint64_t num_draws_; //!< The total number of mesh draws in all consumed packets
+		std::string last_error_; //!< The last problem that was found
+	};
+}
\ No newline at end of file
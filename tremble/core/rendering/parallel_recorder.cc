@@ -0,0 +1,73 @@
+#include "parallel_recorder.h"
+
+#include "graphics_context.h"
+
+#include <ppl.h>
+#include <thread>
+
+namespace tremble
+{
+	//------------------------------------------------------------------------------------------------------
+	ParallelRecorder::ParallelRecorder() :
+		max_chunks_per_pass_(std::max(std::thread::hardware_concurrency(), 1u))
+	{
+
+	}
+
+	//------------------------------------------------------------------------------------------------------
+	void ParallelRecorder::AddPass(const std::wstring& name, size_t num_draws, const SetupFunction& setup, const RecordFunction& record, bool allow_split)
+	{
+		size_t num_chunks = 1;
+		if (allow_split == true)
+		{
+			num_chunks = std::min(std::max<size_t>(num_draws / PARALLEL_RECORDER_MIN_DRAWS_PER_CHUNK, 1), max_chunks_per_pass_);
+		}
+
+		passes_.push_back({ setup, record });
+
+		// spread the draws evenly, the first chunks get one draw more when they don't divide
+		size_t begin = 0;
+		for (size_t i = 0; i < num_chunks; i++)
+		{
+			size_t end = begin + num_draws / num_chunks + (i < num_draws % num_chunks ? 1 : 0);
+
+			Chunk chunk;
+			chunk.context = &GraphicsContext::Begin(name);
+			chunk.pass = passes_.size() - 1;
+			chunk.begin = begin;
+			chunk.end = end;
+			chunks_.push_back(chunk);
+
+			begin = end;
+		}
+	}
+
+	//------------------------------------------------------------------------------------------------------
+	void ParallelRecorder::Record()
+	{
+		concurrency::parallel_for(size_t(0), chunks_.size(), [this](size_t i)
+		{
+			const Chunk& chunk = chunks_[i];
+			const Pass& pass = passes_[chunk.pass];
+
+			pass.setup(*chunk.context);
+			pass.record(*chunk.context, chunk.begin, chunk.end);
+		});
+	}
+
+	//------------------------------------------------------------------------------------------------------
+	uint64_t ParallelRecorder::Submit()
+	{
+		uint64_t fence = 0;
+
+		for (size_t i = 0; i < chunks_.size(); i++)
+		{
+			fence = chunks_[i].context->Finish();
+		}
+
+		chunks_.clear();
+		passes_.clear();
+
+		return fence;
+	}
+}
\ No newline at end of file
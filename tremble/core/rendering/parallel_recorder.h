@@ -0,0 +1,76 @@
+#pragma once
+
+#define PARALLEL_RECORDER_MIN_DRAWS_PER_CHUNK 64 // passes are only split up into chunks of at least this many draws
+
+namespace tremble
+{
+	class GraphicsContext;
+
+	/**
+	* @class tremble::ParallelRecorder
+	* @brief Splits passes into chunks of draws that are recorded into separate command lists on worker threads
+	*
+	* Every chunk gets a context of its own from the CommandContextManager, which brings its own allocator from the
+	* queue's CommandAllocatorPool. Contexts are requested when a pass is added & submitted by Submit() in the order
+	* their passes & chunks were added, both on the calling thread; only the recording itself runs on the workers.
+	* The setup function of a pass binds the state every chunk needs (heaps, targets, root signature & pipeline state)
+	* on every chunk's context, as command lists don't inherit state from each other. Recording must not transition
+	* resources that other chunks use or touch anything that isn't safe to share between threads; barriers belong in
+	* a context that is submitted before the chunks.
+	*/
+	class ParallelRecorder
+	{
+	public:
+		typedef std::function<void(GraphicsContext& context)> SetupFunction;
+		typedef std::function<void(GraphicsContext& context, size_t begin, size_t end)> RecordFunction;
+
+		ParallelRecorder(); //!< Default constructor
+
+		/**
+		* @brief Adds a pass & requests the contexts of its chunks
+		* @param[in] name The name of the pass' contexts
+		* @param[in] num_draws The number of draws in the pass
+		* @param[in] setup Binds the state the pass needs, called on every chunk's context before its draws
+		* @param[in] record Records the draws [begin, end) of the pass
+		* @param[in] allow_split Whether the pass may be split up at all, a pass that isn't is recorded as a single chunk
+		*/
+		void AddPass(const std::wstring& name, size_t num_draws, const SetupFunction& setup, const RecordFunction& record, bool allow_split = true);
+
+		void Record(); //!< Records all chunks of all added passes on worker threads, returns once they're all done
+
+		/**
+		* @brief Submits all recorded chunks in order & forgets the added passes
+		* @return The fence value of the last submission, 0 if there was nothing to submit
+		*/
+		uint64_t Submit();
+
+		size_t GetNumChunks() const { return chunks_.size(); } //!< The number of chunks of the added passes
+
+	private:
+		/**
+		* @struct tremble::ParallelRecorder::Pass
+		* @brief The functions of an added pass
+		*/
+		struct Pass
+		{
+			SetupFunction setup; //!< Binds the state the pass needs
+			RecordFunction record; //!< Records a range of the pass' draws
+		};
+
+		/**
+		* @struct tremble::ParallelRecorder::Chunk
+		* @brief A range of a pass' draws with a context of its own
+		*/
+		struct Chunk
+		{
+			GraphicsContext* context; //!< The context the chunk is recorded into
+			size_t pass; //!< The index of the pass the chunk belongs to
+			size_t begin; //!< The first draw of the chunk
+			size_t end; //!< One past the last draw of the chunk
+		};
+
+		std::vector<Pass> passes_; //!< The added passes
+		std::vector<Chunk> chunks_; //!< The chunks of all added passes, in submission order
+		size_t max_chunks_per_pass_; //!< The number of worker threads, more chunks per pass wouldn't be recorded any faster
+	};
+}
\ No newline at end of file
@@ -0,0 +1,266 @@
+#include "particle_pool.h"
+
+#include <ppl.h>
+#include <atomic>
+
+namespace tremble
+{
+	//------------------------------------------------------------------------------------------------------
+	ParticleRandom::ParticleRandom(uint32_t seed) :
+		state(seed != 0 ? seed : 0x9E3779B9u)
+	{
+
+	}
+
+	//------------------------------------------------------------------------------------------------------
+	float ParticleRandom::Next()
+	{
+		state ^= state << 13;
+		state ^= state >> 17;
+		state ^= state << 5;
+
+		// the top 24 bits fill a float's mantissa exactly, so the result never rounds up to 1
+		return (state >> 8) * (1.0f / 16777216.0f);
+	}
+
+	//------------------------------------------------------------------------------------------------------
+	ParticlePool::ParticlePool() :
+		count_(0)
+	{
+
+	}
+
+	//------------------------------------------------------------------------------------------------------
+	void ParticlePool::Spawn(const DirectX::XMFLOAT3& position, const DirectX::XMFLOAT3& velocity, float lifetime, const DirectX::XMFLOAT4& color, const DirectX::XMFLOAT4& color_end, float size, float size_end)
+	{
+		Reserve(count_ + 1);
+
+		position_x_[count_] = position.x;
+		position_y_[count_] = position.y;
+		position_z_[count_] = position.z;
+		velocity_x_[count_] = velocity.x;
+		velocity_y_[count_] = velocity.y;
+		velocity_z_[count_] = velocity.z;
+		age_[count_] = 0.0f;
+		lifetime_[count_] = lifetime < 0.0f ? std::numeric_limits<float>::max() : lifetime;
+		color_[count_] = color;
+		color_end_[count_] = color_end;
+		size_[count_] = size;
+		size_end_[count_] = size_end;
+
+		count_++;
+	}
+
+	//------------------------------------------------------------------------------------------------------
+	void ParticlePool::Simulate(float delta_time)
+	{
+		// particles that expire during this step are removed first, so only the survivors are integrated
+		for (uint32_t i = 0; i < count_;)
+		{
+			if (age_[i] + delta_time > lifetime_[i])
+			{
+				Remove(i);
+				continue;
+			}
+
+			i++;
+		}
+
+		if (count_ <= PARTICLE_BLOCK_SIZE)
+		{
+			Integrate(0, count_, delta_time);
+			return;
+		}
+
+		uint32_t num_blocks = (count_ + PARTICLE_BLOCK_SIZE - 1) / PARTICLE_BLOCK_SIZE;
+		concurrency::parallel_for(0u, num_blocks, [this, delta_time](uint32_t block)
+		{
+			Integrate(block * PARTICLE_BLOCK_SIZE, std::min(count_, (block + 1) * PARTICLE_BLOCK_SIZE), delta_time);
+		});
+	}
+
+	//------------------------------------------------------------------------------------------------------
+	bool ParticlePool::WriteRenderables(const DirectX::XMFLOAT3& offset)
+	{
+		renderables_.resize(count_);
+
+		if (count_ <= PARTICLE_BLOCK_SIZE)
+		{
+			return WriteRange(0, count_, offset);
+		}
+
+		uint32_t num_blocks = (count_ + PARTICLE_BLOCK_SIZE - 1) / PARTICLE_BLOCK_SIZE;
+		std::atomic<bool> transparent(false);
+
+		concurrency::parallel_for(0u, num_blocks, [this, &offset, &transparent](uint32_t block)
+		{
+			if (WriteRange(block * PARTICLE_BLOCK_SIZE, std::min(count_, (block + 1) * PARTICLE_BLOCK_SIZE), offset))
+			{
+				transparent = true;
+			}
+		});
+
+		return transparent;
+	}
+
+	//------------------------------------------------------------------------------------------------------
+	void ParticlePool::SortRenderables(DirectX::FXMMATRIX view_projection, bool solids_first)
+	{
+		if (count_ < 2)
+		{
+			return;
+		}
+
+		sort_keys_.resize(count_);
+		sort_scratch_.resize(count_);
+
+		for (uint32_t i = 0; i < count_; i++)
+		{
+			const ParticleRenderable& renderable = renderables_[i];
+
+			uint32_t key = 0;
+			if (solids_first == false || renderable.Color.w != 1.0f)
+			{
+				DirectX::XMVECTOR clip = DirectX::XMVector3Transform(DirectX::XMLoadFloat3(&renderable.Position), view_projection);
+				float depth = DirectX::XMVectorGetZ(clip) / DirectX::XMVectorGetW(clip);
+
+				// flipping the sign bit (or all bits of negative depths) makes the float's bits sort like the float,
+				// the result is inverted so the farthest particles get the lowest keys
+				uint32_t bits;
+				memcpy(&bits, &depth, sizeof(bits));
+				key = ~((bits & 0x80000000u) != 0 ? ~bits : (bits | 0x80000000u));
+			}
+
+			sort_keys_[i] = (static_cast<uint64_t>(key) << 32) | i;
+		}
+
+		// the indices in the low half are unique & already in order, so only the four digits of the depth are sorted
+		uint32_t histograms[4][256] = {};
+		for (uint32_t i = 0; i < count_; i++)
+		{
+			uint64_t key = sort_keys_[i];
+			for (int d = 0; d < 4; d++)
+			{
+				histograms[d][(key >> (32 + d * 8)) & 0xFF]++;
+			}
+		}
+
+		for (int d = 0; d < 4; d++)
+		{
+			uint32_t* histogram = histograms[d];
+
+			if (histogram[(sort_keys_[0] >> (32 + d * 8)) & 0xFF] == count_)
+			{
+				continue;
+			}
+
+			uint32_t offset = 0;
+			for (int b = 0; b < 256; b++)
+			{
+				uint32_t bucket_count = histogram[b];
+				histogram[b] = offset;
+				offset += bucket_count;
+			}
+
+			for (uint32_t i = 0; i < count_; i++)
+			{
+				sort_scratch_[histogram[(sort_keys_[i] >> (32 + d * 8)) & 0xFF]++] = sort_keys_[i];
+			}
+
+			sort_keys_.swap(sort_scratch_);
+		}
+
+		sorted_.resize(count_);
+		for (uint32_t i = 0; i < count_; i++)
+		{
+			sorted_[i] = renderables_[static_cast<uint32_t>(sort_keys_[i])];
+		}
+
+		renderables_.swap(sorted_);
+	}
+
+	//------------------------------------------------------------------------------------------------------
+	void ParticlePool::Reserve(uint32_t count)
+	{
+		if (count <= age_.size())
+		{
+			return;
+		}
+
+		// the padding past count_ is integrated along with the last living particles, but never read
+		size_t padded = (static_cast<size_t>(count) + 3) & ~static_cast<size_t>(3);
+
+		position_x_.resize(padded, 0.0f);
+		position_y_.resize(padded, 0.0f);
+		position_z_.resize(padded, 0.0f);
+		velocity_x_.resize(padded, 0.0f);
+		velocity_y_.resize(padded, 0.0f);
+		velocity_z_.resize(padded, 0.0f);
+		age_.resize(padded, 0.0f);
+		lifetime_.resize(padded, 0.0f);
+		color_.resize(padded);
+		color_end_.resize(padded);
+		size_.resize(padded, 0.0f);
+		size_end_.resize(padded, 0.0f);
+	}
+
+	//------------------------------------------------------------------------------------------------------
+	void ParticlePool::Remove(uint32_t index)
+	{
+		uint32_t last = --count_;
+
+		position_x_[index] = position_x_[last];
+		position_y_[index] = position_y_[last];
+		position_z_[index] = position_z_[last];
+		velocity_x_[index] = velocity_x_[last];
+		velocity_y_[index] = velocity_y_[last];
+		velocity_z_[index] = velocity_z_[last];
+		age_[index] = age_[last];
+		lifetime_[index] = lifetime_[last];
+		color_[index] = color_[last];
+		color_end_[index] = color_end_[last];
+		size_[index] = size_[last];
+		size_end_[index] = size_end_[last];
+	}
+
+	//------------------------------------------------------------------------------------------------------
+	void ParticlePool::Integrate(uint32_t begin, uint32_t end, float delta_time)
+	{
+		DirectX::XMVECTOR dt = DirectX::XMVectorReplicate(delta_time);
+
+		// the arrays are padded to a multiple of four, so the last group may safely run past end
+		for (uint32_t i = begin; i < end; i += 4)
+		{
+			DirectX::XMFLOAT4* age = reinterpret_cast<DirectX::XMFLOAT4*>(&age_[i]);
+			DirectX::XMStoreFloat4(age, DirectX::XMVectorAdd(DirectX::XMLoadFloat4(age), dt));
+
+			DirectX::XMFLOAT4* x = reinterpret_cast<DirectX::XMFLOAT4*>(&position_x_[i]);
+			DirectX::XMFLOAT4* y = reinterpret_cast<DirectX::XMFLOAT4*>(&position_y_[i]);
+			DirectX::XMFLOAT4* z = reinterpret_cast<DirectX::XMFLOAT4*>(&position_z_[i]);
+
+			DirectX::XMStoreFloat4(x, DirectX::XMVectorMultiplyAdd(DirectX::XMLoadFloat4(reinterpret_cast<const DirectX::XMFLOAT4*>(&velocity_x_[i])), dt, DirectX::XMLoadFloat4(x)));
+			DirectX::XMStoreFloat4(y, DirectX::XMVectorMultiplyAdd(DirectX::XMLoadFloat4(reinterpret_cast<const DirectX::XMFLOAT4*>(&velocity_y_[i])), dt, DirectX::XMLoadFloat4(y)));
+			DirectX::XMStoreFloat4(z, DirectX::XMVectorMultiplyAdd(DirectX::XMLoadFloat4(reinterpret_cast<const DirectX::XMFLOAT4*>(&velocity_z_[i])), dt, DirectX::XMLoadFloat4(z)));
+		}
+	}
+
+	//------------------------------------------------------------------------------------------------------
+	bool ParticlePool::WriteRange(uint32_t begin, uint32_t end, const DirectX::XMFLOAT3& offset)
+	{
+		bool transparent = false;
+
+		for (uint32_t i = begin; i < end; i++)
+		{
+			float t = age_[i] / lifetime_[i];
+
+			ParticleRenderable& renderable = renderables_[i];
+			renderable.Position = DirectX::XMFLOAT3(position_x_[i] + offset.x, position_y_[i] + offset.y, position_z_[i] + offset.z);
+			DirectX::XMStoreFloat4(&renderable.Color, DirectX::XMVectorLerp(DirectX::XMLoadFloat4(&color_[i]), DirectX::XMLoadFloat4(&color_end_[i]), t));
+			renderable.Size = size_[i] + (size_end_[i] - size_[i]) * t;
+
+			transparent |= renderable.Color.w != 1.0f && renderable.Color.w != 0.0f;
+		}
+
+		return transparent;
+	}
+}
\ No newline at end of file
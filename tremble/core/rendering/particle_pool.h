@@ -0,0 +1,127 @@
+#pragma once
+
+#include "particle_renderer.h"
+
+#define PARTICLE_BLOCK_SIZE 4096 // the number of particles a single worker simulates at once, smaller pools are simulated on the calling thread
+
+namespace tremble
+{
+	/**
+	* @struct tremble::ParticleRandom
+	* @brief A xorshift random number generator, cheap enough to draw every attribute of every spawned particle from
+	*
+	* Every emitter owns its own generator, so emitters don't share (or contend on) the state of rand().
+	*/
+	struct ParticleRandom
+	{
+		/**
+		* @brief Seeds the generator
+		* @param[in] seed The seed, zero is replaced as xorshift would only ever return zero
+		*/
+		explicit ParticleRandom(uint32_t seed = 0x9E3779B9u);
+
+		float Next(); //!< Draws a uniformly distributed number in [0, 1)
+
+		uint32_t state; //!< The state of the generator, never zero
+	};
+
+	/**
+	* @class tremble::ParticlePool
+	* @brief Stores & simulates the particles of a single particle system as a structure of arrays
+	*
+	* Every attribute lives in its own array, padded to a multiple of four so positions & ages are integrated four
+	* particles at a time with SIMD. Expired particles are swap-removed, so removing any number of them is linear.
+	* Pools larger than PARTICLE_BLOCK_SIZE are integrated & written out in blocks on worker threads. The renderables
+	* are rebuilt from the arrays every frame & depth sorted with a radix sort when any of them is transparent.
+	*/
+	class ParticlePool
+	{
+	public:
+		ParticlePool(); //!< Default constructor
+
+		/**
+		* @brief Adds a particle
+		* @param[in] position The position of the particle
+		* @param[in] velocity The velocity of the particle, in units per second
+		* @param[in] lifetime The lifetime of the particle in seconds, negative for particles that never expire
+		* @param[in] color The color of the particle when it spawns
+		* @param[in] color_end The color of the particle when it expires
+		* @param[in] size The size of the particle when it spawns
+		* @param[in] size_end The size of the particle when it expires
+		*/
+		void Spawn(const DirectX::XMFLOAT3& position, const DirectX::XMFLOAT3& velocity, float lifetime, const DirectX::XMFLOAT4& color, const DirectX::XMFLOAT4& color_end, float size, float size_end);
+
+		/**
+		* @brief Ages & moves all particles and removes the ones that expired
+		* @param[in] delta_time The time since the last simulation in seconds
+		*/
+		void Simulate(float delta_time);
+
+		/**
+		* @brief Rebuilds the renderable of every particle, interpolating its color & size over its lifetime
+		* @param[in] offset Added to every particle's position, e.g. the position of a system that simulates in its own space
+		* @return Whether any particle is partially transparent & the renderables should be depth sorted
+		*/
+		bool WriteRenderables(const DirectX::XMFLOAT3& offset);
+
+		/**
+		* @brief Sorts the renderables back to front on their depth
+		* @param[in] view_projection The view projection matrix the depth is computed with
+		* @param[in] solids_first Whether fully opaque particles go before all others regardless of their depth, for untextured particles
+		*/
+		void SortRenderables(DirectX::FXMMATRIX view_projection, bool solids_first);
+
+		uint32_t GetCount() const { return count_; } //!< The number of living particles
+		ParticleRenderable* GetRenderables() { return renderables_.data(); } //!< The renderables of the living particles, valid after WriteRenderables
+
+	private:
+		/**
+		* @brief Grows the attribute arrays so they hold at least a number of particles, padded to a multiple of four
+		* @param[in] count The number of particles the arrays have to hold
+		*/
+		void Reserve(uint32_t count);
+
+		/**
+		* @brief Removes a particle by moving the last particle into its place
+		* @param[in] index The index of the particle to remove
+		*/
+		void Remove(uint32_t index);
+
+		/**
+		* @brief Integrates the ages & positions of a range of particles
+		* @param[in] begin The first particle of the range, a multiple of four
+		* @param[in] end One past the last particle of the range
+		* @param[in] delta_time The time since the last simulation in seconds
+		*/
+		void Integrate(uint32_t begin, uint32_t end, float delta_time);
+
+		/**
+		* @brief Rebuilds the renderables of a range of particles
+		* @param[in] begin The first particle of the range
+		* @param[in] end One past the last particle of the range
+		* @param[in] offset Added to every particle's position
+		* @return Whether any particle in the range is partially transparent
+		*/
+		bool WriteRange(uint32_t begin, uint32_t end, const DirectX::XMFLOAT3& offset);
+
+		uint32_t count_; //!< The number of living particles
+
+		std::vector<float> position_x_; //!< The x positions of the particles
+		std::vector<float> position_y_; //!< The y positions of the particles
+		std::vector<float> position_z_; //!< The z positions of the particles
+		std::vector<float> velocity_x_; //!< The x velocities of the particles
+		std::vector<float> velocity_y_; //!< The y velocities of the particles
+		std::vector<float> velocity_z_; //!< The z velocities of the particles
+		std::vector<float> age_; //!< The time the particles are alive for
+		std::vector<float> lifetime_; //!< The lifetimes of the particles, the largest float for particles that never expire
+		std::vector<DirectX::XMFLOAT4> color_; //!< The spawn colors of the particles
+		std::vector<DirectX::XMFLOAT4> color_end_; //!< The expiry colors of the particles
+		std::vector<float> size_; //!< The spawn sizes of the particles
+		std::vector<float> size_end_; //!< The expiry sizes of the particles
+
+		std::vector<ParticleRenderable> renderables_; //!< The renderables of the living particles
+		std::vector<ParticleRenderable> sorted_; //!< Scratch storage for the sorted renderables, kept to avoid reallocating every frame
+		std::vector<uint64_t> sort_keys_; //!< The depth keys of the renderables in the high bits & their indices in the low bits
+		std::vector<uint64_t> sort_scratch_; //!< Ping-pong storage for the radix sort
+	};
+}
\ No newline at end of file
@@ -8,10 +8,8 @@
 #include "texture.h"
 #include "descriptor_heap.h"
 #include "renderer.h"
-#include "../scene_graph/component_manager.h"
+#include "frame_packet.h"
 #include "../resources/resource_manager.h"
-#include "../../components/rendering/camera.h"
-#include "../../components/rendering/particle_system.h"
 
 namespace tremble
 {
@@ -22,8 +20,6 @@ namespace tremble
 		geometry_shader_ = Get::ResourceManager()->GetShader("particle_gs.cso");
 		vertex_shader_ = Get::ResourceManager()->GetShader("particle_vs.cso");
 
-		pass_constants_.Create(L"ParticlePassData", 24U, (sizeof(ParticlePassData) + 255) & ~255);
-
 		CreateRenderResources();
 
 		CreateRootSignature();
@@ -32,47 +28,38 @@ namespace tremble
 	}
 
 	//------------------------------------------------------------------------------------------------------
-	void ParticleRenderer::Draw(GraphicsContext& context, Camera* camera)
+	void ParticleRenderer::Draw(GraphicsContext& context, const FramePacket& packet)
 	{
-		// Get all particle systems
-		std::vector<ParticleSystem*> components_ = Get::ComponentManager()->GetComponents<ParticleSystem>();
-
-		if (components_.size() == 0) return;
+		// the systems were updated & their living particles copied during extraction
+		if (packet.particle_systems.empty()) return;
 
 		context.SetRootSignature(root_signature_);
 		context.SetPipelineState(GraphicsPSO::Get("particle_draw"));
 
-		int rendered = 0;
-
-		for (size_t i = 0; i < components_.size(); i++) {
-			// Spawn and update particles
-			components_[i]->Update(camera);
-
-			// Skip if no alive particles
-			if (components_[i]->GetParticleCount() == 0) continue;
+		for (uint32_t i = 0; i < packet.particle_systems.size; i++) {
+			const PacketParticleSystem& system = packet.particle_systems[i];
 
 			// Upload scene data
 			ParticlePassData pass_data;
-			pass_data.projection = camera->GetProjection();
-			pass_data.view = camera->GetView();
+			pass_data.projection = DirectX::XMLoadFloat4x4(&packet.view.projection);
+			pass_data.view = DirectX::XMLoadFloat4x4(&packet.view.view);
 			pass_data.aspect_ratio = (float)Get::SwapChain().GetBackBuffer().GetWidth() / Get::SwapChain().GetBackBuffer().GetHeight();
-			pass_data.textured = components_[i]->GetTexture() != nullptr;
-			pass_constants_.InsertDataByElement(rendered, &pass_data);
+			pass_data.textured = system.texture != nullptr;
 
-			// Upload particles
-			CommandContext::InitializeBuffer(components_[i]->GetBuffer(), components_[i]->GetParticles(), components_[i]->GetParticleCount() * sizeof(ParticleRenderable), false, 0);
+			// Upload particles, they're read straight from this frame's upload memory
+			UINT particle_bytes = system.num_particles * sizeof(ParticleRenderable);
+			UploadAllocation particle_data = Get::Renderer()->GetFrameResource().Allocate(particle_bytes, 16);
+			memcpy(particle_data.cpu_address, &packet.particles[system.first_particle], particle_bytes);
 
 			// Set buffers and texture
-			context.SetConstantBuffer(0, pass_constants_.GetAddressByElement(rendered));
-			context.SetBufferSRV(1, components_[i]->GetBuffer(), 0);
-			if(pass_data.textured) context.SetDescriptorTable(2, Get::CbvSrvUavHeap().GetGPUDescriptorById(components_[i]->GetTexture()->GetSRV()));
+			context.SetConstantBuffer(0, Get::Renderer()->GetFrameResource().AllocateConstants(pass_data));
+			context.SetBufferSRV(1, particle_data.gpu_address);
+			if(pass_data.textured) context.SetDescriptorTable(2, Get::CbvSrvUavHeap().GetGPUDescriptorById(system.texture->GetSRV()));
 
 			// Render
 			context.SetPrimitiveTopology(D3D_PRIMITIVE_TOPOLOGY_POINTLIST);
 			context.SetVertexBuffers(0, 0, nullptr);
-			context.Draw(components_[i]->GetParticleCount());
-
-			rendered++;
+			context.Draw(system.num_particles);
 		}
 	}
 
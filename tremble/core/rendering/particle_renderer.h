@@ -9,7 +9,7 @@ namespace tremble
 {
 	class Shader;
 	class Texture;
-	class Camera;
+	struct FramePacket;
 
 	struct ParticlePassData{
 		DirectX::XMMATRIX projection;
@@ -35,8 +35,8 @@ namespace tremble
 		/// Initializes particle renderer
 		void Startup();
 		
-		/// Render particle system components to specified context
-		void Draw(GraphicsContext&, Camera*);
+		/// Render the particle systems of a frame packet to specified context
+		void Draw(GraphicsContext&, const FramePacket&);
 
 		/// Frees up memory used by particle renderer
 		void Destroy();
@@ -55,7 +55,5 @@ namespace tremble
 		D3D12_BLEND_DESC blend_state_;
 		D3D12_DEPTH_STENCIL_DESC depth_stencil_state_;
 		D3D12_RASTERIZER_DESC rasterizer_state_;
-
-		UploadBuffer pass_constants_;
 	};
 }
\ No newline at end of file
@@ -37,6 +37,38 @@ namespace tremble
 		return psos_[name];
 	}
 
+	//------------------------------------------------------------------------------------------------------
+	int GraphicsPSO::ReplaceShader(const D3D12_SHADER_BYTECODE& previous, const D3D12_SHADER_BYTECODE& replacement)
+	{
+		int num_replaced = 0;
+
+		for (auto it = psos_.begin(); it != psos_.end(); it++)
+		{
+			GraphicsPSO& pso = it->second;
+			D3D12_SHADER_BYTECODE* stages[] = { &pso.pso_desc_.VS, &pso.pso_desc_.PS, &pso.pso_desc_.GS, &pso.pso_desc_.HS, &pso.pso_desc_.DS };
+
+			bool uses_shader = false;
+			for (int i = 0; i < _countof(stages); i++)
+			{
+				if (stages[i]->pShaderBytecode != nullptr && stages[i]->pShaderBytecode == previous.pShaderBytecode)
+				{
+					*stages[i] = replacement;
+					uses_shader = true;
+				}
+			}
+
+			// the caller is responsible for making sure the GPU is no longer using the old PSO
+			if (uses_shader && pso.pso_ != nullptr)
+			{
+				pso.Destroy();
+				pso.Finalize();
+				num_replaced++;
+			}
+		}
+
+		return num_replaced;
+	}
+
 	//------------------------------------------------------------------------------------------------------
 	void GraphicsPSO::SetBlendState(const D3D12_BLEND_DESC& blend_desc)
 	{
@@ -130,6 +162,31 @@ namespace tremble
 
 		return psos_[name];
 	}
+
+	//------------------------------------------------------------------------------------------------------
+	int ComputePSO::ReplaceShader(const D3D12_SHADER_BYTECODE& previous, const D3D12_SHADER_BYTECODE& replacement)
+	{
+		int num_replaced = 0;
+
+		for (auto it = psos_.begin(); it != psos_.end(); it++)
+		{
+			ComputePSO& pso = it->second;
+
+			if (pso.pso_desc_.CS.pShaderBytecode != nullptr && pso.pso_desc_.CS.pShaderBytecode == previous.pShaderBytecode)
+			{
+				pso.pso_desc_.CS = replacement;
+
+				if (pso.pso_ != nullptr)
+				{
+					pso.Destroy();
+					pso.Finalize();
+					num_replaced++;
+				}
+			}
+		}
+
+		return num_replaced;
+	}
 	
 	//------------------------------------------------------------------------------------------------------
 	void ComputePSO::Finalize()
@@ -37,6 +37,7 @@ namespace tremble
 		}
 	public:
 		static GraphicsPSO& Get(const std::string& name);
+		static int ReplaceShader(const D3D12_SHADER_BYTECODE& previous, const D3D12_SHADER_BYTECODE& replacement); //!< Recreates every PSO that uses the previous byte code, returns the number of recreated PSOs
 
 		void SetBlendState(const D3D12_BLEND_DESC& blend_desc);
 		void SetRasterizerState(const D3D12_RASTERIZER_DESC& rasterizer_desc);
@@ -69,6 +70,7 @@ namespace tremble
 
 	public:
 		static ComputePSO& Get(const std::string& name);
+		static int ReplaceShader(const D3D12_SHADER_BYTECODE& previous, const D3D12_SHADER_BYTECODE& replacement); //!< Recreates every PSO that uses the previous byte code, returns the number of recreated PSOs
 
 		void SetComputeShader(const void* binary, size_t size) { pso_desc_.CS = CD3DX12_SHADER_BYTECODE(binary, size); }
 		void SetComputeShader(const D3D12_SHADER_BYTECODE& binary) { pso_desc_.CS = binary; }
@@ -0,0 +1,25 @@
+#pragma once
+
+namespace tremble
+{
+	struct FramePacket;
+
+	/**
+	* @class tremble::RenderBackend
+	* @brief Consumes extracted frame packets, the renderer draws them with Direct3D 12
+	*
+	* A backend only reads the packets it is given & never touches the scene, so it may run on another thread than
+	* the simulation. Packets are handed over in the order they were extracted in.
+	*/
+	class RenderBackend
+	{
+	public:
+		virtual ~RenderBackend() {} //!< Virtual destructor
+
+		/**
+		* @brief Renders a single frame
+		* @param[in] packet The frame to render, it stays untouched until this returns
+		*/
+		virtual void Render(const FramePacket& packet) = 0;
+	};
+}
\ No newline at end of file
@@ -0,0 +1,145 @@
+#include "render_thread.h"
+
+#include "render_backend.h"
+#include "../utilities/stopwatch.h"
+
+namespace tremble
+{
+	//------------------------------------------------------------------------------------------------------
+	RenderThread::RenderThread() :
+		backend_(nullptr),
+		num_frames_(0),
+		wait_time_(0.0f),
+		running_(false),
+		queued_(nullptr),
+		rendering_(nullptr)
+	{
+
+	}
+
+	//------------------------------------------------------------------------------------------------------
+	RenderThread::~RenderThread()
+	{
+		Stop();
+	}
+
+	//------------------------------------------------------------------------------------------------------
+	void RenderThread::Start(RenderBackend* backend, bool threaded)
+	{
+		Stop();
+
+		backend_ = backend;
+
+		if (threaded == true)
+		{
+			running_ = true;
+			thread_ = std::thread(&RenderThread::Run, this);
+		}
+	}
+
+	//------------------------------------------------------------------------------------------------------
+	void RenderThread::Stop()
+	{
+		if (!running_)
+		{
+			return;
+		}
+
+		WaitForIdle();
+
+		{
+			std::lock_guard<std::mutex> lock(mutex_);
+			running_ = false;
+		}
+
+		condition_.notify_all();
+
+		if (thread_.joinable())
+		{
+			thread_.join();
+		}
+	}
+
+	//------------------------------------------------------------------------------------------------------
+	FramePacket& RenderThread::AcquirePacket()
+	{
+		FramePacket* packet = &packets_[num_frames_ % FRAME_PACKET_COUNT];
+
+		if (running_)
+		{
+			Stopwatch stopwatch;
+
+			std::unique_lock<std::mutex> lock(mutex_);
+			condition_.wait(lock, [this, packet]() { return queued_ != packet && rendering_ != packet; });
+
+			wait_time_ = stopwatch.Output() * 1000.0f;
+		}
+
+		packet->Reset();
+		packet->frame = ++num_frames_;
+
+		return *packet;
+	}
+
+	//------------------------------------------------------------------------------------------------------
+	void RenderThread::Submit(FramePacket& packet)
+	{
+		if (!running_)
+		{
+			backend_->Render(packet);
+			return;
+		}
+
+		{
+			// the packet from two frames ago was waited for in AcquirePacket, so at most one packet is queued at a time
+			std::unique_lock<std::mutex> lock(mutex_);
+			condition_.wait(lock, [this]() { return queued_ == nullptr; });
+			queued_ = &packet;
+		}
+
+		condition_.notify_all();
+	}
+
+	//------------------------------------------------------------------------------------------------------
+	void RenderThread::WaitForIdle()
+	{
+		if (!running_)
+		{
+			return;
+		}
+
+		std::unique_lock<std::mutex> lock(mutex_);
+		condition_.wait(lock, [this]() { return queued_ == nullptr && rendering_ == nullptr; });
+	}
+
+	//------------------------------------------------------------------------------------------------------
+	void RenderThread::Run()
+	{
+		while (true)
+		{
+			{
+				std::unique_lock<std::mutex> lock(mutex_);
+				condition_.wait(lock, [this]() { return queued_ != nullptr || !running_; });
+
+				if (queued_ == nullptr)
+				{
+					return;
+				}
+
+				rendering_ = queued_;
+				queued_ = nullptr;
+			}
+
+			condition_.notify_all();
+
+			backend_->Render(*rendering_);
+
+			{
+				std::lock_guard<std::mutex> lock(mutex_);
+				rendering_ = nullptr;
+			}
+
+			condition_.notify_all();
+		}
+	}
+}
\ No newline at end of file
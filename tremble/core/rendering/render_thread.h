@@ -0,0 +1,75 @@
+#pragma once
+
+#include "frame_packet.h"
+
+#include <thread>
+#include <mutex>
+#include <atomic>
+#include <condition_variable>
+
+#define FRAME_PACKET_COUNT 2 // the simulation extracts one packet while the render thread renders the other
+
+namespace tremble
+{
+	class RenderBackend;
+
+	/**
+	* @class tremble::RenderThread
+	* @brief Hands extracted frame packets over to a render backend, on a thread of its own or inline
+	*
+	* The simulation acquires a packet, extracts the frame into it & submits it. When threaded, the render thread
+	* renders the packet while the simulation already runs the next frame, so rendering lags at most one frame
+	* behind; acquiring a packet blocks until the render thread is done with it. Anything that swaps resources the
+	* packets reference (e.g. hot reloading) has to wait for the thread to become idle first. Without a thread the
+	* packets are rendered by Submit() itself, which keeps the old single threaded behaviour.
+	*/
+	class RenderThread
+	{
+	public:
+		RenderThread(); //!< Default constructor
+		~RenderThread(); //!< Destructor, stops the render thread
+
+		/**
+		* @brief Starts rendering packets with a backend
+		* @param[in] backend The backend that renders the packets
+		* @param[in] threaded Whether the packets are rendered on a thread of their own, or by Submit()
+		*/
+		void Start(RenderBackend* backend, bool threaded);
+
+		void Stop(); //!< Renders the packet that is still queued & stops the render thread
+
+		/**
+		* @brief Gets the next packet to extract into, blocking until the render thread is done with it
+		* @return The packet, reset & numbered already
+		*/
+		FramePacket& AcquirePacket();
+
+		/**
+		* @brief Queues an extracted packet for rendering, or renders it right away when not threaded
+		* @param[in] packet The packet that was acquired last
+		*/
+		void Submit(FramePacket& packet);
+
+		void WaitForIdle(); //!< Blocks until every submitted packet has been rendered
+
+		bool IsThreaded() const { return running_; } //!< Whether the packets are rendered on a thread of their own
+		uint64_t GetNumFrames() const { return num_frames_; } //!< The number of packets that were acquired
+		float GetWaitTime() const { return wait_time_; } //!< The time the simulation waited for the render thread in the last frame, in milliseconds
+
+	private:
+		void Run(); //!< The render thread's main loop
+
+		RenderBackend* backend_; //!< Renders the packets
+		FramePacket packets_[FRAME_PACKET_COUNT]; //!< The packets, used round robin
+		uint64_t num_frames_; //!< The number of packets that were acquired
+		float wait_time_; //!< The time the simulation waited for the render thread in the last frame, in milliseconds
+
+		std::thread thread_; //!< The render thread
+		std::atomic<bool> running_; //!< Whether the render thread should keep running
+
+		std::mutex mutex_; //!< Guards the members below
+		std::condition_variable condition_; //!< Signaled whenever a packet is queued or finished
+		FramePacket* queued_; //!< The packet that was submitted but isn't being rendered yet
+		FramePacket* rendering_; //!< The packet that is being rendered
+	};
+}
\ No newline at end of file
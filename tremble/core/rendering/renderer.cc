@@ -24,8 +24,6 @@
 #include "../input/input_manager.h"
 #include "../get.h"
 #include "../scene_graph/scene_graph.h"
-#include "../../components/rendering/renderable.h"
-#include "../../components/rendering/skinned_renderable.h"
 #include "../../components/rendering/camera.h"
 #include "../../components/rendering/light.h"
 
@@ -35,9 +33,9 @@ namespace tremble
 {
 	//------------------------------------------------------------------------------------------------------
 	Renderer::Renderer() :
-		num_object_cbs_(0),
-		num_material_cbs_(0),
-		camera_(nullptr)
+		frame_index_(0),
+		camera_(nullptr),
+		packet_(nullptr)
 	{
 		depthpass_ = Get::Config().depth_pre_pass;
 	}
@@ -45,6 +43,7 @@ namespace tremble
 	//------------------------------------------------------------------------------------------------------
 	Renderer::~Renderer()
 	{
+		upload_manager_.Shutdown();
 		FlushCommandQueue();
 	}
 
@@ -116,18 +115,30 @@ namespace tremble
 	//------------------------------------------------------------------------------------------------------
 	void Renderer::CreateBaseResources()
 	{
+		upload_manager_.Startup(32U * 1024U * 1024U);
+
 		depth_buffer_.Create(L"SceneDepthBuffer", swap_chain_.GetBufferWidth(), swap_chain_.GetBufferHeight(), DXGI_FORMAT_D32_FLOAT);
-		pass_constants_.Create(L"PassConstantsBuffer", 1U, (sizeof(PassConstants) + 255) & ~255);
-		object_constants_.Create(L"ObjectConstantsBuffer", 1024U, (sizeof(ObjectConstants) + 255) & ~255);
-		material_constants_.Create(L"MaterialConstantsBuffer", 1024U, (sizeof(MaterialConstants) + 255) & ~255);
 		debug_constants_.Create(L"DebugConstantsBuffer", 1024U, (sizeof(DebugConstants) + 255) & ~255);
-		light_upload_buffer_.Create(L"LightUploadBuffer", 64U, sizeof(LightConstants));
-		light_buffer_.Create(L"LightBuffer", 64U, sizeof(LightConstants));
+
+		for (int i = 0; i < FRAMES_IN_FLIGHT; i++)
+		{
+			frame_resources_[i].Create(L"FrameUpload" + std::to_wstring(i), 1024U * 1024U);
+		}
 	}
 
 	//------------------------------------------------------------------------------------------------------
 	void Renderer::CreatePSOs()
 	{
+		// model meshes are all built in the configured vertex format, debug volumes always use the full one
+		bool compressed = Get::Config().compressed_vertices;
+		const D3D12_INPUT_ELEMENT_DESC* mesh_input_layout = compressed ? input_element_compressed_vertex_desc : input_element_vertex_desc;
+		UINT mesh_input_layout_count = compressed ? _countof(input_element_compressed_vertex_desc) : _countof(input_element_vertex_desc);
+
+		const std::string default_vs = compressed ? "default_compressed_vs.cso" : "default_vs.cso";
+		const std::string default_skinned_vs = compressed ? "default_skinned_compressed_vs.cso" : "default_skinned_vs.cso";
+		const std::string shadow_skinned_vs = compressed ? "shadow_skinned_compressed_vs.cso" : "shadow_skinned_vs.cso";
+		const std::string default_instanced_vs = compressed ? "default_instanced_compressed_vs.cso" : "default_instanced_vs.cso";
+
 		D3D12_DEPTH_STENCIL_DESC desc = Graphics::depth_state_default;
 		desc.DepthWriteMask = D3D12_DEPTH_WRITE_MASK_ALL;
 
@@ -138,19 +149,31 @@ namespace tremble
 		depth_pre_pass.SetDepthStencilState(desc);
 		depth_pre_pass.SetRasterizerState(Graphics::rasterizer_default_cw);
 		depth_pre_pass.SetPrimitiveTopologyType(D3D12_PRIMITIVE_TOPOLOGY_TYPE_TRIANGLE);
-		depth_pre_pass.SetInputLayout(_countof(input_element_vertex_desc), input_element_vertex_desc);
+		depth_pre_pass.SetInputLayout(_countof(input_element_position_desc), input_element_position_desc);
 		depth_pre_pass.SetSampleMask(0xFFFFFFFF);
 		depth_pre_pass.SetRenderTargetFormats(0, nullptr, depth_buffer_.GetFormat());
 		depth_pre_pass.Finalize();
 
+		GraphicsPSO& depth_pre_pass_instanced = GraphicsPSO::Get("depth_pre_pass_instanced");
+		depth_pre_pass_instanced.SetRootSignature(Graphics::root_signature_depth_pre_pass);
+		depth_pre_pass_instanced.SetVertexShader(Get::ResourceManager()->GetShader("shadow_instanced_vs.cso")->GetShaderByteCode());
+		depth_pre_pass_instanced.SetBlendState(Graphics::blend_state_traditional);
+		depth_pre_pass_instanced.SetDepthStencilState(desc);
+		depth_pre_pass_instanced.SetRasterizerState(Graphics::rasterizer_default_cw);
+		depth_pre_pass_instanced.SetPrimitiveTopologyType(D3D12_PRIMITIVE_TOPOLOGY_TYPE_TRIANGLE);
+		depth_pre_pass_instanced.SetInputLayout(_countof(input_element_position_desc), input_element_position_desc);
+		depth_pre_pass_instanced.SetSampleMask(0xFFFFFFFF);
+		depth_pre_pass_instanced.SetRenderTargetFormats(0, nullptr, depth_buffer_.GetFormat());
+		depth_pre_pass_instanced.Finalize();
+
 		GraphicsPSO& depth_pre_pass_skinned = GraphicsPSO::Get("depth_pre_pass_skinned");
 		depth_pre_pass_skinned.SetRootSignature(Graphics::root_signature_depth_pre_pass);
-		depth_pre_pass_skinned.SetVertexShader(Get::ResourceManager()->GetShader("shadow_skinned_vs.cso")->GetShaderByteCode());
+		depth_pre_pass_skinned.SetVertexShader(Get::ResourceManager()->GetShader(shadow_skinned_vs)->GetShaderByteCode());
 		depth_pre_pass_skinned.SetBlendState(Graphics::blend_state_traditional);
 		depth_pre_pass_skinned.SetDepthStencilState(desc);
 		depth_pre_pass_skinned.SetRasterizerState(Graphics::rasterizer_default_cw);
 		depth_pre_pass_skinned.SetPrimitiveTopologyType(D3D12_PRIMITIVE_TOPOLOGY_TYPE_TRIANGLE);
-		depth_pre_pass_skinned.SetInputLayout(_countof(input_element_vertex_desc), input_element_vertex_desc);
+		depth_pre_pass_skinned.SetInputLayout(mesh_input_layout_count, mesh_input_layout);
 		depth_pre_pass_skinned.SetSampleMask(0xFFFFFFFF);
 		depth_pre_pass_skinned.SetRenderTargetFormats(0, nullptr, depth_buffer_.GetFormat());
 		depth_pre_pass_skinned.Finalize();
@@ -162,52 +185,78 @@ namespace tremble
 
 		GraphicsPSO& render_lit_prepass = GraphicsPSO::Get("render_lit_prepass");
 		render_lit_prepass.SetRootSignature(Graphics::root_signature_default);
-		render_lit_prepass.SetVertexShader(Get::ResourceManager()->GetShader("default_vs.cso")->GetShaderByteCode());
+		render_lit_prepass.SetVertexShader(Get::ResourceManager()->GetShader(default_vs)->GetShaderByteCode());
 		render_lit_prepass.SetPixelShader(Get::ResourceManager()->GetShader("default_ps.cso")->GetShaderByteCode());
 		render_lit_prepass.SetBlendState(Graphics::blend_state_traditional);
 		render_lit_prepass.SetDepthStencilState(desc);
 		render_lit_prepass.SetRasterizerState(Get::Config().wireframe_rendering ? Graphics::rasterizer_no_culling_wireframe : Graphics::rasterizer_default_cw);
 		render_lit_prepass.SetPrimitiveTopologyType(D3D12_PRIMITIVE_TOPOLOGY_TYPE_TRIANGLE);
-		render_lit_prepass.SetInputLayout(_countof(input_element_vertex_desc), input_element_vertex_desc);
+		render_lit_prepass.SetInputLayout(mesh_input_layout_count, mesh_input_layout);
 		render_lit_prepass.SetSampleMask(0xFFFFFFFF);
 		render_lit_prepass.SetRenderTargetFormat(swap_chain_.GetBackBuffer().GetFormat(), depth_buffer_.GetFormat());
 		render_lit_prepass.Finalize();
 
+		GraphicsPSO& render_lit_prepass_instanced = GraphicsPSO::Get("render_lit_prepass_instanced");
+		render_lit_prepass_instanced.SetRootSignature(Graphics::root_signature_default);
+		render_lit_prepass_instanced.SetVertexShader(Get::ResourceManager()->GetShader(default_instanced_vs)->GetShaderByteCode());
+		render_lit_prepass_instanced.SetPixelShader(Get::ResourceManager()->GetShader("default_ps.cso")->GetShaderByteCode());
+		render_lit_prepass_instanced.SetBlendState(Graphics::blend_state_traditional);
+		render_lit_prepass_instanced.SetDepthStencilState(desc);
+		render_lit_prepass_instanced.SetRasterizerState(Get::Config().wireframe_rendering ? Graphics::rasterizer_no_culling_wireframe : Graphics::rasterizer_default_cw);
+		render_lit_prepass_instanced.SetPrimitiveTopologyType(D3D12_PRIMITIVE_TOPOLOGY_TYPE_TRIANGLE);
+		render_lit_prepass_instanced.SetInputLayout(mesh_input_layout_count, mesh_input_layout);
+		render_lit_prepass_instanced.SetSampleMask(0xFFFFFFFF);
+		render_lit_prepass_instanced.SetRenderTargetFormat(swap_chain_.GetBackBuffer().GetFormat(), depth_buffer_.GetFormat());
+		render_lit_prepass_instanced.Finalize();
+
 		GraphicsPSO& render_lit_prepass_skinned = GraphicsPSO::Get("render_lit_prepass_skinned");
 		render_lit_prepass_skinned.SetRootSignature(Graphics::root_signature_default);
-		render_lit_prepass_skinned.SetVertexShader(Get::ResourceManager()->GetShader("default_skinned_vs.cso")->GetShaderByteCode());
+		render_lit_prepass_skinned.SetVertexShader(Get::ResourceManager()->GetShader(default_skinned_vs)->GetShaderByteCode());
 		render_lit_prepass_skinned.SetPixelShader(Get::ResourceManager()->GetShader("default_ps.cso")->GetShaderByteCode());
 		render_lit_prepass_skinned.SetBlendState(Graphics::blend_state_traditional);
 		render_lit_prepass_skinned.SetDepthStencilState(desc);
 		render_lit_prepass_skinned.SetRasterizerState(Get::Config().wireframe_rendering ? Graphics::rasterizer_no_culling_wireframe : Graphics::rasterizer_default_cw);
 		render_lit_prepass_skinned.SetPrimitiveTopologyType(D3D12_PRIMITIVE_TOPOLOGY_TYPE_TRIANGLE);
-		render_lit_prepass_skinned.SetInputLayout(_countof(input_element_vertex_desc), input_element_vertex_desc);
+		render_lit_prepass_skinned.SetInputLayout(mesh_input_layout_count, mesh_input_layout);
 		render_lit_prepass_skinned.SetSampleMask(0xFFFFFFFF);
 		render_lit_prepass_skinned.SetRenderTargetFormat(swap_chain_.GetBackBuffer().GetFormat(), depth_buffer_.GetFormat());
 		render_lit_prepass_skinned.Finalize();
 
 		GraphicsPSO& render_lit = GraphicsPSO::Get("render_lit");
 		render_lit.SetRootSignature(Graphics::root_signature_default);
-		render_lit.SetVertexShader(Get::ResourceManager()->GetShader("default_vs.cso")->GetShaderByteCode());
+		render_lit.SetVertexShader(Get::ResourceManager()->GetShader(default_vs)->GetShaderByteCode());
 		render_lit.SetPixelShader(Get::ResourceManager()->GetShader("default_ps.cso")->GetShaderByteCode());
 		render_lit.SetBlendState(Graphics::blend_state_traditional);
 		render_lit.SetDepthStencilState(Graphics::depth_state_default);
 		render_lit.SetRasterizerState(Get::Config().wireframe_rendering ? Graphics::rasterizer_no_culling_wireframe : Graphics::rasterizer_default_cw);
 		render_lit.SetPrimitiveTopologyType(D3D12_PRIMITIVE_TOPOLOGY_TYPE_TRIANGLE);
-		render_lit.SetInputLayout(_countof(input_element_vertex_desc), input_element_vertex_desc);
+		render_lit.SetInputLayout(mesh_input_layout_count, mesh_input_layout);
 		render_lit.SetSampleMask(0xFFFFFFFF);
 		render_lit.SetRenderTargetFormat(swap_chain_.GetBackBuffer().GetFormat(), depth_buffer_.GetFormat());
 		render_lit.Finalize();
 
+		GraphicsPSO& render_lit_instanced = GraphicsPSO::Get("render_lit_instanced");
+		render_lit_instanced.SetRootSignature(Graphics::root_signature_default);
+		render_lit_instanced.SetVertexShader(Get::ResourceManager()->GetShader(default_instanced_vs)->GetShaderByteCode());
+		render_lit_instanced.SetPixelShader(Get::ResourceManager()->GetShader("default_ps.cso")->GetShaderByteCode());
+		render_lit_instanced.SetBlendState(Graphics::blend_state_traditional);
+		render_lit_instanced.SetDepthStencilState(Graphics::depth_state_default);
+		render_lit_instanced.SetRasterizerState(Get::Config().wireframe_rendering ? Graphics::rasterizer_no_culling_wireframe : Graphics::rasterizer_default_cw);
+		render_lit_instanced.SetPrimitiveTopologyType(D3D12_PRIMITIVE_TOPOLOGY_TYPE_TRIANGLE);
+		render_lit_instanced.SetInputLayout(mesh_input_layout_count, mesh_input_layout);
+		render_lit_instanced.SetSampleMask(0xFFFFFFFF);
+		render_lit_instanced.SetRenderTargetFormat(swap_chain_.GetBackBuffer().GetFormat(), depth_buffer_.GetFormat());
+		render_lit_instanced.Finalize();
+
 		GraphicsPSO& render_lit_skinned = GraphicsPSO::Get("render_lit_skinned");
 		render_lit_skinned.SetRootSignature(Graphics::root_signature_default);
-		render_lit_skinned.SetVertexShader(Get::ResourceManager()->GetShader("default_skinned_vs.cso")->GetShaderByteCode());
+		render_lit_skinned.SetVertexShader(Get::ResourceManager()->GetShader(default_skinned_vs)->GetShaderByteCode());
 		render_lit_skinned.SetPixelShader(Get::ResourceManager()->GetShader("default_ps.cso")->GetShaderByteCode());
 		render_lit_skinned.SetBlendState(Graphics::blend_state_traditional);
 		render_lit_skinned.SetDepthStencilState(Graphics::depth_state_default);
 		render_lit_skinned.SetRasterizerState(Get::Config().wireframe_rendering ? Graphics::rasterizer_no_culling_wireframe : Graphics::rasterizer_default_cw);
 		render_lit_skinned.SetPrimitiveTopologyType(D3D12_PRIMITIVE_TOPOLOGY_TYPE_TRIANGLE);
-		render_lit_skinned.SetInputLayout(_countof(input_element_vertex_desc), input_element_vertex_desc);
+		render_lit_skinned.SetInputLayout(mesh_input_layout_count, mesh_input_layout);
 		render_lit_skinned.SetSampleMask(0xFFFFFFFF);
 		render_lit_skinned.SetRenderTargetFormat(swap_chain_.GetBackBuffer().GetFormat(), depth_buffer_.GetFormat());
 		render_lit_skinned.Finalize();
@@ -227,175 +276,465 @@ namespace tremble
 	}
 
 	//------------------------------------------------------------------------------------------------------
-	void Renderer::Draw(Timer* timer)
+	void Renderer::Render(const FramePacket& packet)
 	{
-		camera_->Update();
+		packet_ = &packet;
+
+		upload_manager_.Update();
+
+		// the shadow maps draw the skinned casters as well, so the bones are uploaded first
+		UploadBones();
+
+		shadow_renderer_.Draw(packet, bone_data_);
+
+		GatherDraws();
 
-		shadow_renderer_.Draw();
+		D3D12_GPU_VIRTUAL_ADDRESS pass_constants = ConstantsHelper::UpdatePassConstants(GetFrameResource(), DirectX::XMFLOAT2((float)swap_chain_.GetBufferWidth(), (float)swap_chain_.GetBufferHeight()), packet.delta_time, packet.total_time, packet.view);
+		UpdateLights();
 
+		// the transitions & clears go first, the chunks of the passes never change the state of a resource
 		GraphicsContext& context = GraphicsContext::Begin(L"SceneRender");
-		
-		ID3D12DescriptorHeap* heaps[2] = { cbv_srv_uav_heap_.Get(), sampler_heap_.Get() };
-		D3D12_DESCRIPTOR_HEAP_TYPE heap_types[2] = { D3D12_DESCRIPTOR_HEAP_TYPE_CBV_SRV_UAV, D3D12_DESCRIPTOR_HEAP_TYPE_SAMPLER };
-		
-		context.SetDescriptorHeaps(2, heap_types, heaps);
+
+		BindSceneTargets(context, false);
 		context.TransitionResource(swap_chain_.GetBackBuffer(), D3D12_RESOURCE_STATE_RENDER_TARGET);
-		
+		context.TransitionResource(depth_buffer_, D3D12_RESOURCE_STATE_DEPTH_WRITE);
+		context.FlushResourceBarriers();
+		context.ClearColor(swap_chain_.GetBackBuffer());
+		context.ClearDepth(depth_buffer_);
+		context.Finish();
+
+		// the pipeline states are looked up here, the lookup may insert into the shared pipeline state map
+		const GraphicsPSO* depth_pso = &GraphicsPSO::Get(planner_.IsInstancing() == true ? "depth_pre_pass_instanced" : "depth_pre_pass");
+		const GraphicsPSO* depth_skinned_pso = &GraphicsPSO::Get("depth_pre_pass_skinned");
+		const GraphicsPSO* lit_pso;
+		const GraphicsPSO* lit_skinned_pso;
+
+		if (depthpass_ == true)
+		{
+			lit_pso = &GraphicsPSO::Get(planner_.IsInstancing() == true ? "render_lit_prepass_instanced" : "render_lit_prepass");
+			lit_skinned_pso = &GraphicsPSO::Get("render_lit_prepass_skinned");
+		}
+		else
+		{
+			lit_pso = &GraphicsPSO::Get(planner_.IsInstancing() == true ? "render_lit_instanced" : "render_lit");
+			lit_skinned_pso = &GraphicsPSO::Get("render_lit_skinned");
+		}
+
+		// every chunk binds the state of its pass again, as command lists don't inherit any state from each other
 		if (depthpass_ == true)
 		{
-			context.FlushResourceBarriers();
-			context.SetPipelineState(GraphicsPSO::Get("depth_pre_pass"));
-			context.SetRootSignature(Graphics::root_signature_depth_pre_pass);
-			context.SetRenderTargets(0, nullptr, depth_buffer_.GetDSV());
-			context.ClearDepth(depth_buffer_);
-			context.SetViewportAndScissor(0, 0, swap_chain_.GetBufferWidth(), swap_chain_.GetBufferHeight());
-
-			if (!Get::Config().frustum_culling)
+			recorder_.AddPass(L"DepthPrePass", planner_.GetNumPassDraws(DrawList::PassDepth), [this, depth_pso](GraphicsContext& chunk)
+			{
+				BindSceneTargets(chunk, false);
+				chunk.SetPipelineState(*depth_pso);
+				chunk.SetRootSignature(Graphics::root_signature_depth_pre_pass);
+			},
+			[this](GraphicsContext& chunk, size_t begin, size_t end)
 			{
-				const std::vector<Renderable*>& all_renderables = SGNode::FindAllComponents<Renderable>();
+				RecordDraws(chunk, DrawList::PassDepth, begin, end);
+			});
 
-				for (int i = 0; i < all_renderables.size(); i++)
+			recorder_.AddPass(L"DepthPrePassSkinned", packet.skinned.size, [this, depth_skinned_pso](GraphicsContext& chunk)
+			{
+				BindSceneTargets(chunk, false);
+				chunk.SetPipelineState(*depth_skinned_pso);
+				chunk.SetRootSignature(Graphics::root_signature_depth_pre_pass);
+			},
+			[this](GraphicsContext& chunk, size_t begin, size_t end)
+			{
+				for (size_t i = begin; i < end; i++)
 				{
-					all_renderables[i]->DrawBasic(context, camera_);
+					DrawSkinned(chunk, static_cast<uint32_t>(i), true);
 				}
+			});
+		}
+
+		recorder_.AddPass(L"LitPass", planner_.GetNumPassDraws(DrawList::PassOpaque), [this, lit_pso, pass_constants](GraphicsContext& chunk)
+		{
+			BindSceneTargets(chunk, true);
+			chunk.SetRootSignature(Graphics::root_signature_default);
+			chunk.SetPipelineState(*lit_pso);
+			chunk.SetConstantBuffer(1, pass_constants);
+			BindLights(chunk);
+
+			shadow_renderer_.UploadData(chunk);
+		},
+		[this](GraphicsContext& chunk, size_t begin, size_t end)
+		{
+			RecordDraws(chunk, DrawList::PassOpaque, begin, end);
+		});
+
+		recorder_.AddPass(L"LitPassSkinned", packet.skinned.size, [this, lit_skinned_pso, pass_constants](GraphicsContext& chunk)
+		{
+			BindSceneTargets(chunk, true);
+			chunk.SetRootSignature(Graphics::root_signature_default);
+			chunk.SetPipelineState(*lit_skinned_pso);
+			chunk.SetConstantBuffer(1, pass_constants);
+			BindLights(chunk);
+
+			shadow_renderer_.UploadData(chunk);
+		},
+		[this](GraphicsContext& chunk, size_t begin, size_t end)
+		{
+			for (size_t i = begin; i < end; i++)
+			{
+				DrawSkinned(chunk, static_cast<uint32_t>(i), false);
 			}
-			else
+		});
+
+		recorder_.Record();
+		recorder_.Submit();
+
+		GraphicsContext& overlay = GraphicsContext::Begin(L"SceneOverlay");
+
+		BindSceneTargets(overlay, true);
+		overlay.SetRootSignature(Graphics::root_signature_default);
+		overlay.SetConstantBuffer(1, pass_constants);
+
+		DrawDebugVolumes(overlay);
+		
+		particle_renderer_.Draw(overlay, packet);
+		sprite_renderer_.Draw(overlay, packet);
+		font_renderer_.Draw(overlay, packet);
+		
+		overlay.TransitionResource(swap_chain_.GetBackBuffer(), D3D12_RESOURCE_STATE_PRESENT);
+		
+		CheckDeviceRemoved();
+		
+		// the frame's upload memory stays untouched until its fence passes, so the CPU can move on to the next frame right away
+		uint64_t fence = overlay.Finish();
+
+		swap_chain_.Present(false);
+
+		AdvanceFrame(fence);
+	}
+
+	//------------------------------------------------------------------------------------------------------
+	void Renderer::FlushCommandQueue()
+	{
+		Get::CommandManager()->WaitForIdleGPU();
+	}
+
+	//------------------------------------------------------------------------------------------------------
+	void Renderer::AdvanceFrame(uint64_t fence)
+	{
+		frame_resources_[frame_index_].SetFenceValue(fence);
+
+		frame_index_ = (frame_index_ + 1) % FRAMES_IN_FLIGHT;
+
+		// the GPU may still be reading the upload memory of the frame that is about to be reused
+		Get::CommandManager()->WaitForFence(frame_resources_[frame_index_].GetFenceValue());
+		frame_resources_[frame_index_].Reset();
+	}
+
+	//------------------------------------------------------------------------------------------------------
+	void Renderer::DrawDebugVolumes(GraphicsContext& context)
+	{
+		context.SetRootSignature(Graphics::root_signature_default);
+		context.SetPipelineState(GraphicsPSO::Get("default_debug"));
+		
+		for (uint32_t i = 0; i < packet_->debug_meshes.size; i++)
+		{
+			packet_->debug_meshes[i]->Draw(context);
+		}
+	}
+
+	//------------------------------------------------------------------------------------------------------
+	void Renderer::UpdateLights()
+	{
+		FrameResource& frame = GetFrameResource();
+		const PacketView& view = packet_->view;
+		const PacketArray<PacketLight>& lights = packet_->lights;
+
+		DirectX::XMMATRIX view_matrix = DirectX::XMLoadFloat4x4(&view.view);
+
+		frame_lights_.clear();
+		cluster_lights_.clear();
+
+		// directional lights reach every pixel, so they're kept out of the grid & applied everywhere
+		for (uint32_t i = 0; i < lights.size; i++)
+		{
+			if (lights[i].type == LightTypeDirectional)
 			{
-				std::vector<OctreeObject*> all_nodes;
-				Get::Octree()->GetContainedObjects(camera_->GetFrustum(), all_nodes);
+				frame_lights_.push_back(&lights[i]);
+			}
+		}
 
-				for (int i = 0; i < all_nodes.size(); i++)
-				{
-					all_nodes[i]->renderable->DrawBasic(context, all_nodes[i], camera_);
-				}
+		UINT num_global_lights = static_cast<UINT>(frame_lights_.size());
+
+		for (uint32_t i = 0; i < lights.size; i++)
+		{
+			if (lights[i].type == LightTypeDirectional)
+			{
+				continue;
 			}
 
-			context.SetPipelineState(GraphicsPSO::Get("depth_pre_pass_skinned"));
-			context.SetRootSignature(Graphics::root_signature_depth_pre_pass);
-			context.SetViewportAndScissor(0, 0, swap_chain_.GetBufferWidth(), swap_chain_.GetBufferHeight());
+			ClusterLight cluster_light;
+			DirectX::XMStoreFloat3(&cluster_light.position_view, DirectX::XMVector4Transform(DirectX::XMVectorSet(lights[i].position.x, lights[i].position.y, lights[i].position.z, 1.0f), view_matrix));
+			cluster_light.range = lights[i].falloff_end;
+
+			frame_lights_.push_back(&lights[i]);
+			cluster_lights_.push_back(cluster_light);
+		}
+
+		light_grid_.Configure(LIGHT_GRID_TILES_X, LIGHT_GRID_TILES_Y, LIGHT_GRID_SLICES, view.projection, view.near_z, view.far_z);
+		light_grid_.Build(cluster_lights_);
+
+		const std::vector<LightGrid::Range>& ranges = light_grid_.GetRanges();
+		const std::vector<uint32_t>& indices = light_grid_.GetIndices();
 
-			auto& skinned_renderables = SGNode::FindAllComponents<SkinnedRenderable>();
-			for (int i = 0; i < skinned_renderables.size(); i++)
+		UploadAllocation range_data = frame.Allocate(static_cast<UINT>(ranges.size() * sizeof(LightGrid::Range)));
+		memcpy(range_data.cpu_address, ranges.data(), ranges.size() * sizeof(LightGrid::Range));
+
+		UploadAllocation index_data = frame.Allocate(static_cast<UINT>(std::max<size_t>(indices.size(), 1) * sizeof(uint32_t)));
+		memcpy(index_data.cpu_address, indices.data(), indices.size() * sizeof(uint32_t));
+
+		light_constants_ = ConstantsHelper::UpdateLightConstants(frame, frame_lights_, view);
+		cluster_ranges_ = range_data.gpu_address;
+		cluster_indices_ = index_data.gpu_address;
+		cluster_constants_ = ConstantsHelper::UpdateClusterConstants(frame, light_grid_, num_global_lights, DirectX::XMFLOAT2((float)swap_chain_.GetBufferWidth(), (float)swap_chain_.GetBufferHeight()));
+	}
+
+	//------------------------------------------------------------------------------------------------------
+	void Renderer::BindLights(GraphicsContext& context)
+	{
+		context.SetBufferSRV(3, light_constants_);
+		context.SetBufferSRV(17, cluster_ranges_);
+		context.SetBufferSRV(18, cluster_indices_);
+		context.SetConstantBuffer(19, cluster_constants_);
+	}
+
+	//------------------------------------------------------------------------------------------------------
+	void Renderer::GatherDraws()
+	{
+		planner_.Plan(*packet_, depthpass_, Get::Config().instanced_rendering);
+
+		// every draw record takes at most one instance slot
+		if (planner_.IsInstancing() == true)
+		{
+			instance_data_ = GetFrameResource().Allocate(std::max<UINT>(planner_.GetNumInstances(), 1) * sizeof(ObjectConstants));
+			planner_.WriteInstances(instance_data_.cpu_address);
+		}
+	}
+
+	//------------------------------------------------------------------------------------------------------
+	void Renderer::RecordDraws(GraphicsContext& context, DrawList::Pass pass, size_t begin, size_t end)
+	{
+		// every range starts on a fresh context, so its state cache starts out empty as well
+		DrawStateCache state_cache;
+
+		if (planner_.IsInstancing() == true)
+		{
+			const std::vector<InstanceBatcher::Batch>& batches = planner_.GetBatches();
+
+			bool positions_only = pass == DrawList::PassDepth;
+			UINT instance_root_index = positions_only == true ? 2 : 16;
+
+			for (size_t i = planner_.GetFirstBatch(pass) + begin; i < planner_.GetFirstBatch(pass) + end; i++)
 			{
-				skinned_renderables[i]->DrawBasic(context, camera_);
+				context.SetBufferSRV(instance_root_index, instance_data_.gpu_address + batches[i].first_instance * sizeof(ObjectConstants));
+				DrawInstances(context, packet_->draws[batches[i].payload], batches[i].num_instances, positions_only, state_cache);
 			}
+
+			return;
 		}
 
-		ConstantsHelper::UpdatePassConstants(pass_constants_, DirectX::XMFLOAT2((float)swap_chain_.GetBufferWidth(), (float)swap_chain_.GetBufferHeight()), timer, camera_);
-		ConstantsHelper::UpdateLightConstants(light_upload_buffer_, SGNode::FindAllComponents<Light>(), camera_);
+		const std::vector<DrawList::DrawItem>& items = planner_.GetItems();
 
-		context.CopyBuffer(light_buffer_, light_upload_buffer_);
-		context.TransitionResource(light_buffer_, D3D12_RESOURCE_STATE_GENERIC_READ);
-		
-		context.SetRenderTarget(swap_chain_.GetBackBuffer().GetRTV(), depth_buffer_.GetDSV());
-		context.ClearColor(swap_chain_.GetBackBuffer());
-		if (depthpass_ != true)
+		for (size_t i = planner_.GetFirstItem(pass) + begin; i < planner_.GetFirstItem(pass) + end; i++)
 		{
-			context.TransitionResource(depth_buffer_, D3D12_RESOURCE_STATE_DEPTH_WRITE, true);
-			context.ClearDepth(depth_buffer_);
+			DrawMesh(context, packet_->draws[items[i].payload], pass == DrawList::PassDepth, state_cache);
 		}
-		context.SetViewportAndScissor(0, 0, swap_chain_.GetBufferWidth(), swap_chain_.GetBufferHeight());
-		
-		context.FlushResourceBarriers();
+	}
+
+	//------------------------------------------------------------------------------------------------------
+	void Renderer::DrawMesh(GraphicsContext& context, const PacketMeshDraw& draw, bool positions_only, DrawStateCache& state_cache)
+	{
+		ObjectConstants constants;
+		DrawPlanner::ComputeObjectConstants(packet_->view, draw.world, constants);
 
+		context.SetConstantBuffer(0, GetFrameResource().AllocateConstants(constants));
+
+		// consecutive draws in a sorted draw list mostly share their material & mesh
+		Material* material = draw.mesh->GetMaterial();
+		if (positions_only == false && state_cache.Apply(DrawStateCache::SlotMaterial, material))
+		{
+			BindMaterial(context, material);
+		}
+
+		if (state_cache.Apply(DrawStateCache::SlotMesh, draw.mesh))
 		{
-			context.SetRootSignature(Graphics::root_signature_default);
-			if (depthpass_ == true)
+			if (positions_only == true)
 			{
-				context.SetPipelineState(GraphicsPSO::Get("render_lit_prepass"));
+				draw.mesh->SetPositions(context);
 			}
 			else
 			{
-				context.SetPipelineState(GraphicsPSO::Get("render_lit"));
+				draw.mesh->Set(context);
 			}
-			context.SetConstantBuffer(1, pass_constants_.GetRootCBV());
-			context.SetBufferSRV(3, light_buffer_);
+		}
 
-			shadow_renderer_.UploadData(context);
+		draw.mesh->DrawRange(context, draw.lod);
+	}
 
-			if (!Get::Config().frustum_culling)
-			{
-				std::vector<Renderable*> all_renderables = SGNode::FindAllComponents<Renderable>();
+	//------------------------------------------------------------------------------------------------------
+	void Renderer::DrawInstances(GraphicsContext& context, const PacketMeshDraw& draw, UINT num_instances, bool positions_only, DrawStateCache& state_cache)
+	{
+		Material* material = draw.mesh->GetMaterial();
+		if (positions_only == false && state_cache.Apply(DrawStateCache::SlotMaterial, material))
+		{
+			BindMaterial(context, material);
+		}
 
-				for (int i = 0; i < all_renderables.size(); i++)
-				{
-					all_renderables[i]->Draw(context, camera_);
-				}
+		if (state_cache.Apply(DrawStateCache::SlotMesh, draw.mesh))
+		{
+			if (positions_only == true)
+			{
+				draw.mesh->SetPositions(context);
 			}
 			else
 			{
-				std::vector<OctreeObject*> all_nodes;
-				Get::Octree()->GetContainedObjects(camera_->GetFrustum(), all_nodes);
-
-				for (int i = 0; i < all_nodes.size(); i++)
-				{
-					all_nodes[i]->renderable->Draw(context, all_nodes[i], camera_);
-				}
+				draw.mesh->Set(context);
 			}
 		}
 
+		draw.mesh->DrawRange(context, draw.lod, num_instances);
+	}
+
+	//------------------------------------------------------------------------------------------------------
+	void Renderer::DrawSkinned(GraphicsContext& context, uint32_t index, bool positions_only)
+	{
+		const PacketSkinned& skinned = packet_->skinned[index];
+
+		for (uint32_t i = skinned.first_mesh; i < skinned.first_mesh + skinned.num_meshes; i++)
 		{
-			context.SetRootSignature(Graphics::root_signature_default);
-			if (depthpass_ == true)
+			const PacketSkinnedMesh& skinned_mesh = packet_->skinned_meshes[i];
+
+			ObjectConstants constants;
+			DrawPlanner::ComputeObjectConstants(packet_->view, skinned_mesh.world, constants);
+
+			context.SetConstantBuffer(0, GetFrameResource().AllocateConstants(constants));
+
+			// the depth pre-pass root signature takes the bones right after the object constants
+			if (positions_only == true)
 			{
-				context.SetPipelineState(GraphicsPSO::Get("render_lit_prepass_skinned"));
+				context.SetBufferSRV(1, bone_data_[index]);
 			}
 			else
 			{
-				context.SetPipelineState(GraphicsPSO::Get("render_lit_skinned"));
+				BindMaterial(context, skinned_mesh.mesh->GetMaterial());
+				context.SetBufferSRV(15, bone_data_[index]);
 			}
-			context.SetConstantBuffer(1, pass_constants_.GetRootCBV());
-			context.SetBufferSRV(3, light_buffer_);
 
-			shadow_renderer_.UploadData(context);
+			skinned_mesh.mesh->Draw(context);
+		}
+	}
 
-			auto& skinned_renderables = SGNode::FindAllComponents<SkinnedRenderable>();
-			for (int i = 0; i < skinned_renderables.size(); i++)
-			{
-				skinned_renderables[i]->Draw(context, camera_);
-			}
+	//------------------------------------------------------------------------------------------------------
+	void Renderer::BindMaterial(GraphicsContext& context, Material* material)
+	{
+		if (material == nullptr)
+		{
+			return;
 		}
-		
-		DrawDebugVolumes(context, debug_volumes_);
-		
-		particle_renderer_.Draw(context, camera_);
-		sprite_renderer_.Draw(context);
-		font_renderer_.Draw(context);
-		
-		context.TransitionResource(swap_chain_.GetBackBuffer(), D3D12_RESOURCE_STATE_PRESENT);
-		
-		CheckDeviceRemoved();
-		
-		context.Finish(true);
 
-		swap_chain_.Present(false);
+		MaterialConstants mat_constants;
+
+		mat_constants.global_ambient = DirectX::XMFLOAT4(0.2f, 0.2f, 0.2f, 1.0f);
+		mat_constants.ambient_color = DirectX::XMFLOAT4(material->ambient_reflectance.x, material->ambient_reflectance.y, material->ambient_reflectance.z, 1.0f);
+		mat_constants.emissive_color = DirectX::XMFLOAT4(material->emissive.x, material->emissive.y, material->emissive.z, 1.0f);
+		mat_constants.diffuse_color = DirectX::XMFLOAT4(material->diffuse.x, material->diffuse.y, material->diffuse.z, 1.0f);
+		mat_constants.specular_color = DirectX::XMFLOAT4(material->specular.x, material->specular.y, material->specular.z, 1.0f);
+		mat_constants.reflectance = DirectX::XMFLOAT4(material->ambient_reflectance.x, material->ambient_reflectance.y, material->ambient_reflectance.z, 1.0f);
+		mat_constants.opacity = 1.0f;
+		mat_constants.specular_power = 5.0f;
+		mat_constants.index_of_refraction = 1.0f;
+		mat_constants.has_ambient_texture = false;
+		mat_constants.has_emissive_texture = false;
+		mat_constants.has_diffuse_texture = material->use_diffuse_map;
+		mat_constants.has_specular_texture = false;
+		mat_constants.has_specular_power_texture = false;
+		mat_constants.has_normal_texture = material->use_normal_map;
+		mat_constants.has_bump_texture = false;
+		mat_constants.has_opacity_texture = false;
+		mat_constants.bump_intensity = 1.0f;
+		mat_constants.specular_scale = 1.0f;
+		mat_constants.alpha_threshold = 0.05f;
+		mat_constants.padding[0] = mat_constants.padding[1] = 0.0f;
+
+		context.SetConstantBuffer(2, Get::Renderer()->GetFrameResource().AllocateConstants(mat_constants));
+
+		DescriptorHeap& srv_heap = Get::CbvSrvUavHeap();
+
+		if (material->use_ambient_map == true)
+		{
+			context.SetDescriptorTable(4, srv_heap.GetGPUDescriptorById(material->ambient_map->GetSRV()));
+		}
+
+		if (material->use_emissive_map == true)
+		{
+			context.SetDescriptorTable(5, srv_heap.GetGPUDescriptorById(material->emissive_map->GetSRV()));
+		}
+
+		if (material->use_diffuse_map == true)
+		{
+			context.SetDescriptorTable(6, srv_heap.GetGPUDescriptorById(material->diffuse_map->GetSRV()));
+		}
 
-		for (int i = static_cast<int>(debug_volumes_.size()) - 1; i >= 0; i--)
+		if (material->use_specular_map == true)
 		{
-//			delete debug_volumes_[i].mesh;
+			context.SetDescriptorTable(7, srv_heap.GetGPUDescriptorById(material->specular_map->GetSRV()));
+		}
 
-			debug_volumes_.erase(debug_volumes_.begin() + i);
+		if (material->use_shininess_map == true)
+		{
+			context.SetDescriptorTable(8, srv_heap.GetGPUDescriptorById(material->shininess_map->GetSRV()));
+		}
+
+		if (material->use_normal_map == true)
+		{
+			context.SetDescriptorTable(9, srv_heap.GetGPUDescriptorById(material->normal_map->GetSRV()));
 		}
 	}
 
 	//------------------------------------------------------------------------------------------------------
-	void Renderer::FlushCommandQueue()
+	void Renderer::UploadBones()
 	{
-		Get::CommandManager()->WaitForIdleGPU();
+		FrameResource& frame = GetFrameResource();
+
+		bone_data_.clear();
+
+		// every renderable gets its own copy, the previous frame's copy may still be read by the GPU
+		for (uint32_t i = 0; i < packet_->skinned.size; i++)
+		{
+			const PacketSkinned& skinned = packet_->skinned[i];
+			UINT num_bytes = static_cast<UINT>(skinned.num_bones * sizeof(DirectX::XMFLOAT4X4));
+
+			UploadAllocation allocation = frame.Allocate(num_bytes);
+			memcpy(allocation.cpu_address, &packet_->bones[skinned.first_bone], num_bytes);
+
+			bone_data_.push_back(allocation.gpu_address);
+		}
 	}
 
 	//------------------------------------------------------------------------------------------------------
-	void Renderer::DrawDebugVolumes(GraphicsContext& context, std::vector<DebugVolume>& debug_volumes)
+	void Renderer::BindSceneTargets(GraphicsContext& context, bool color)
 	{
-		context.SetRootSignature(Graphics::root_signature_default);
-		context.SetPipelineState(GraphicsPSO::Get("default_debug"));
-		
-		for (int i = 0; i < static_cast<int>(debug_volumes.size()); i++)
-		{
-			DebugVolume& current = debug_volumes[i];
+		ID3D12DescriptorHeap* heaps[2] = { cbv_srv_uav_heap_.Get(), sampler_heap_.Get() };
+		D3D12_DESCRIPTOR_HEAP_TYPE heap_types[2] = { D3D12_DESCRIPTOR_HEAP_TYPE_CBV_SRV_UAV, D3D12_DESCRIPTOR_HEAP_TYPE_SAMPLER };
+
+		context.SetDescriptorHeaps(2, heap_types, heaps);
 
-			current.mesh->Draw(context);
+		if (color == true)
+		{
+			context.SetRenderTarget(swap_chain_.GetBackBuffer().GetRTV(), depth_buffer_.GetDSV());
+		}
+		else
+		{
+			context.SetDepthStencilTarget(depth_buffer_.GetDSV());
 		}
+
+		context.SetViewportAndScissor(0, 0, swap_chain_.GetBufferWidth(), swap_chain_.GetBufferHeight());
 	}
 
 	//------------------------------------------------------------------------------------------------------
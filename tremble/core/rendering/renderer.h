@@ -9,10 +9,19 @@
 #include "descriptor_heap.h"
 #include "buffer_manager.h"
 #include "upload_buffer.h"
+#include "frame_resource.h"
+#include "upload_manager.h"
 #include "interface_sprite_renderer.h"
 #include "interface_font_renderer.h"
 #include "shadow_renderer.h"
 #include "particle_renderer.h"
+#include "draw_planner.h"
+#include "light_grid.h"
+#include "parallel_recorder.h"
+#include "render_backend.h"
+#include "frame_packet.h"
+
+#define FRAMES_IN_FLIGHT 2
 
 namespace tremble
 {
@@ -21,6 +30,7 @@ namespace tremble
 	class Shader;
 	class Camera;
 	class Renderable;
+	class SkinnedRenderable;
 	class Light;
 	struct Material;
 	class Timer;
@@ -30,13 +40,17 @@ namespace tremble
 	class CommandContext;
 	class GraphicsContext;
 	class FreeListAllocator;
+	struct OctreeObject;
 	
 	/**
 	* @class tremble::Renderer
 	* @author Riko Ophorst
 	* @brief Forward DirectX 12 renderer
+	*
+	* The renderer only ever reads the frame packets it's handed, so it may run on the render thread while the
+	* simulation extracts the next frame.
 	*/
-	class Renderer
+	class Renderer : public RenderBackend
 	{
 	public:
 		/**
@@ -55,18 +69,20 @@ namespace tremble
 		void Startup();
 
 		/**
-		* @brief Makes the renderer draw to screen
-		* @param[in] gt The timer the game is running with
+		* @brief Makes the renderer draw a frame packet to screen
+		* @param[in] packet The extracted frame
 		*/
-		void Draw(Timer* gt);
+		void Render(const FramePacket& packet) override;
 
 		void SetCamera(Camera* camera);
         Camera* GetCamera() const { return camera_; }
 
 		void RenderDebugVolume(const DebugVolume& volume);
+		std::vector<DebugVolume>& GetDebugVolumes() { return debug_volumes_; } //!< The debug volumes that were queued since the last extraction
 
 		Device& GetDevice() { return device_; } //!< Get the underlying device
 		const Device& GetDevice() const { return device_; } //!< Get the underlying device
+		bool HasDevice() const { return device_.Get() != nullptr; } //!< Whether the device was created, it isn't when the null render backend is used
 		
 		DescriptorHeap& GetRtvHeap() { return rtv_heap_; }
 		DescriptorHeap& GetDsvHeap() { return dsv_heap_; }
@@ -78,23 +94,17 @@ namespace tremble
 		inline BufferManager& GetBufferManager() { return buffer_manager_; }
 
 		InterfaceFontRenderer* GetFontRenderer() { return &font_renderer_; }
+		InterfaceSpriteRenderer* GetSpriteRenderer() { return &sprite_renderer_; }
 
 		void SetVirtualSize(int x, int y) { virtual_size_x_ = x; virtual_size_y_ = y; }
 		int GetVirtualSizeX() { return virtual_size_x_; }
 		int GetVirtualSizeY() { return virtual_size_y_; }
 
-		UploadBuffer& GetPassConstantsBuffer() { return pass_constants_; }
 		UploadBuffer& GetDebugConstantsBuffer() { return debug_constants_; }
 
-		UploadBuffer& GetMaterialConstantsBuffer() { return material_constants_; }
-		UINT GetNumMaterialCbs() { return num_material_cbs_; }
-		void SetNumMaterialCbs(UINT num_material_cbs) { num_material_cbs_ = num_material_cbs; }
-		UINT GetNewMaterialConstantBufferID() { return num_material_cbs_++; }
-
-		UploadBuffer& GetObjectConstantsBuffer() { return object_constants_; }
-		UINT GetNumObjectCbs() { return num_object_cbs_; }
-		void SetNumObjectCbs(UINT num_object_cbs) { num_object_cbs_ = num_object_cbs; }
-		UINT GetNewObjectConstantBufferID() { return num_object_cbs_++; }
+		FrameResource& GetFrameResource() { return frame_resources_[frame_index_]; } //!< The upload memory of the frame that is currently being recorded
+		UploadManager& GetUploadManager() { return upload_manager_; } //!< Streams initial resource data through the copy queue
+		ShadowRenderer& GetShadowRenderer() { return shadow_renderer_; } //!< Renders the shadow maps, exposes the per-light shadow statistics
 
 	protected:
 		void CreateDevice(); //!< Creates the Direct3D device
@@ -105,7 +115,80 @@ namespace tremble
 		void CreateBaseResources(); //!< Creates all the buffered frame resources
 		void FlushCommandQueue(); //!< Informs the renderer to flush the entire command queue
 
-		void DrawDebugVolumes(GraphicsContext& context, std::vector<DebugVolume>& debug_volumes);
+		/**
+		* @brief Fences the current frame resource & moves on to the next one, waiting until the GPU is done with it
+		* @param[in] fence The fence value of the frame's last submission
+		*/
+		void AdvanceFrame(uint64_t fence);
+
+		void DrawDebugVolumes(GraphicsContext& context); //!< Draws the meshes of the packet's debug volumes
+
+		void GatherDraws(); //!< Plans the packet's draws & writes the object constants of the instanced batches
+
+		/**
+		* @brief Records a range of a pass' draws in sorted order, the pipeline state & root signature must be set already
+		*
+		* This only reads the draw list, the draw packets & the instanced batches, so several ranges of the same pass
+		* may be recorded on different threads at once.
+		*
+		* @param[in] context The context to record the draws into
+		* @param[in] pass The pass of which the draws should be recorded
+		* @param[in] begin The first draw of the range, relative to the pass (see DrawPlanner::GetNumPassDraws)
+		* @param[in] end One past the last draw of the range
+		*/
+		void RecordDraws(GraphicsContext& context, DrawList::Pass pass, size_t begin, size_t end);
+
+		/**
+		* @brief Draws a single mesh, only binding its material & buffers when they differ from the previous draw
+		* @param[in] context The context to record the draw into
+		* @param[in] draw The mesh, its LOD & transform
+		* @param[in] positions_only Whether only the position stream should be bound, for depth-only passes
+		* @param[in] state_cache The state bound by the previous draw on this context
+		*/
+		void DrawMesh(GraphicsContext& context, const PacketMeshDraw& draw, bool positions_only, DrawStateCache& state_cache);
+
+		/**
+		* @brief Draws instances of a single mesh, the per-instance data has to be bound already
+		* @param[in] context The context to record the draw into
+		* @param[in] draw The mesh & its LOD
+		* @param[in] num_instances The number of instances that should be drawn
+		* @param[in] positions_only Whether only the position stream should be bound, for depth-only passes
+		* @param[in] state_cache The state bound by the previous draw on this context
+		*/
+		void DrawInstances(GraphicsContext& context, const PacketMeshDraw& draw, UINT num_instances, bool positions_only, DrawStateCache& state_cache);
+
+		/**
+		* @brief Draws all meshes of a skinned renderable with its bones
+		* @param[in] context The context to record the draws into
+		* @param[in] index The index of the renderable in the packet's skinned renderables
+		* @param[in] positions_only Whether the depth pre-pass root signature is bound, which takes no material
+		*/
+		void DrawSkinned(GraphicsContext& context, uint32_t index, bool positions_only);
+
+		/**
+		* @brief Uploads a material's constants & binds them together with its textures
+		* @param[in] context The context to bind the material on
+		* @param[in] material The material that should be bound, may be nullptr
+		*/
+		static void BindMaterial(GraphicsContext& context, Material* material);
+
+		void UploadBones(); //!< Copies the bone transforms of the packet's skinned renderables into this frame's upload memory
+
+		/**
+		* @brief Binds the descriptor heaps, the scene's render targets & the viewport on a context
+		* @param[in] context The context to bind the state on
+		* @param[in] color Whether the back buffer should be bound as well, otherwise only the depth buffer is
+		*/
+		void BindSceneTargets(GraphicsContext& context, bool color);
+
+		void UpdateLights(); //!< Orders this frame's lights, bins the local lights into the light grid & writes all light data to frame memory
+
+		/**
+		* @brief Binds the light data written by UpdateLights, the default root signature must be set already
+		* @param[in] context The context to bind the light data on
+		*/
+		void BindLights(GraphicsContext& context);
+
 		void CheckDeviceRemoved(); //!< Check whether the ID3D12Device was removed and for what reason (outputs to console)
 
 	private:
@@ -118,21 +201,32 @@ namespace tremble
 		DescriptorHeap cbv_srv_uav_heap_; //!< Heap to store descriptors of shader resource views
 		DescriptorHeap sampler_heap_; //!< Heap to store descriptors of sampler states
 
-		UploadBuffer pass_constants_;
 		UploadBuffer debug_constants_;
 
-		UploadBuffer material_constants_;
-		UINT num_material_cbs_;
-		UploadBuffer object_constants_;
-		UINT num_object_cbs_;
+		FrameResource frame_resources_[FRAMES_IN_FLIGHT]; //!< The upload memory of every frame that may be in flight
+		UINT frame_index_; //!< The frame resource that is currently being recorded
+		UploadManager upload_manager_; //!< Batches the copies of initial buffer & texture data
 
 		BufferManager buffer_manager_;
-		UploadBuffer light_upload_buffer_;
-		StructuredBuffer light_buffer_;
 
 		std::vector<DebugVolume> debug_volumes_; //!< The queue of debug volumes that will be rendered each frame
 
 		Camera* camera_; //!< The camera that is used to render the scene with
+		const FramePacket* packet_; //!< The packet that is being rendered
+
+		DrawPlanner planner_; //!< The sorted draw records & instanced batches of this frame
+		std::vector<D3D12_GPU_VIRTUAL_ADDRESS> bone_data_; //!< This frame's copy of the bones of every skinned renderable of the packet
+		ParallelRecorder recorder_; //!< Records the chunks of the scene passes on worker threads
+
+		UploadAllocation instance_data_; //!< The per-instance object constants of this frame's instanced batches, room for one instance per draw record
+
+		LightGrid light_grid_; //!< Bins this frame's local lights into clusters
+		std::vector<const PacketLight*> frame_lights_; //!< This frame's lights, directional lights first
+		std::vector<ClusterLight> cluster_lights_; //!< The bounding spheres of this frame's local lights, in the same order as frame_lights_
+		D3D12_GPU_VIRTUAL_ADDRESS light_constants_; //!< The constants of this frame's lights
+		D3D12_GPU_VIRTUAL_ADDRESS cluster_ranges_; //!< The light range of every cluster
+		D3D12_GPU_VIRTUAL_ADDRESS cluster_indices_; //!< The light index list of all clusters
+		D3D12_GPU_VIRTUAL_ADDRESS cluster_constants_; //!< The dimensions of the light grid & the number of directional lights
 
 		InterfaceSpriteRenderer sprite_renderer_;
 		InterfaceFontRenderer font_renderer_; 
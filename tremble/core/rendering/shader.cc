@@ -157,6 +157,15 @@ namespace tremble
 		shader_byte_code_.pShaderBytecode = byte_code;
 		shader_byte_code_.BytecodeLength = byte_code_size;
 	}
+
+	//------------------------------------------------------------------------------------------------------
+	void Shader::CreateFromByteCode(std::vector<BYTE>&& byte_code)
+	{
+		owned_byte_code_ = std::move(byte_code);
+
+		shader_byte_code_.pShaderBytecode = owned_byte_code_.data();
+		shader_byte_code_.BytecodeLength = owned_byte_code_.size();
+	}
 	
 	//------------------------------------------------------------------------------------------------------
 	void Shader::Reload()
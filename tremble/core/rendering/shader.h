@@ -19,6 +19,7 @@ namespace tremble
 		void CompileFromFile(const std::string& shader_path, ShaderType shader_type);
 		void CompileFromSource(const std::string& shader_code, ShaderType shader_type);
 		void CreateFromByteCode(const BYTE byte_code[], UINT byte_code_size);
+		void CreateFromByteCode(std::vector<BYTE>&& byte_code); //!< Takes ownership of the byte code, so it can be swapped out in-place when hot reloading
 
 		void Reload();
 		
@@ -41,5 +42,7 @@ namespace tremble
 
 		ID3DBlob* shader_blob_;
 		ID3DBlob* error_blob_;
+
+		std::vector<BYTE> owned_byte_code_;
 	};
 }
\ No newline at end of file
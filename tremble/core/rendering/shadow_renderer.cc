@@ -3,17 +3,13 @@
 #include "color_buffer.h"
 #include "depth_buffer.h"
 #include "renderer.h"
-#include "interface_font_renderer.h"
-#include "../components/rendering/renderable.h"
-#include "../components/rendering/skinned_renderable.h"
+#include "frame_packet.h"
 #include "vertex.h"
-#include "../scene_graph/scene_graph.h"
-#include "../../components/rendering/camera.h"
 #include "../resources/mesh.h"
-#include "../resources/model.h"
 #include "shader.h"
 #include "descriptor_heap.h"
 #include "texture.h"
+#include "../utilities/stopwatch.h"
 
 // needed for vector * float
 using namespace DirectX;
@@ -21,7 +17,10 @@ using namespace DirectX;
 namespace tremble
 {
 	//------------------------------------------------------------------------------------------------------
-	ShadowRenderer::ShadowRenderer() : depth_buffer_(1)
+	ShadowRenderer::ShadowRenderer() :
+		depth_buffer_(1),
+		packet_(nullptr),
+		bone_data_(nullptr)
 	{
 	}
 
@@ -30,15 +29,13 @@ namespace tremble
 	{
 
 		rendered_maps_ = 0;
+		cached_maps_ = 0;
+		record_time_ = 0.0f;
 
 		vertex_shader_ = Get::ResourceManager()->GetShader("shadow_vs.cso");
 		pixel_shader_ = Get::ResourceManager()->GetShader("shadow_ps.cso");
 
-		info_constants_.Create(L"ShadowInfoConstants", 1U, (sizeof(ShadowInfoConstants) + 255) & ~255);
-
-		map_buffer_.Create(L"ShadowMapData", max_maps_, sizeof(ShadowPassConstants));
-
-		map_data_ = (ShadowPassConstants*)malloc(max_maps_ * sizeof(ShadowPassConstants));
+		map_data_address_ = 0;
 
 		depth_buffer_.Create(L"DepthMap", render_width_, render_height_, DXGI_FORMAT_D32_FLOAT);
 
@@ -77,173 +74,76 @@ namespace tremble
 	}
 
 	//------------------------------------------------------------------------------------------------------
-	void ShadowRenderer::Draw()
+	void ShadowRenderer::Draw(const FramePacket& packet, const std::vector<D3D12_GPU_VIRTUAL_ADDRESS>& bone_data)
 	{
-		DirectX::XMMATRIX view, projection;
+		packet_ = &packet;
+		bone_data_ = &bone_data;
 
-		int rendered = 0;
-		rendered_maps_ = 0;
+		rendered_maps_ = static_cast<int>(packet.shadow_maps.size);
+		cached_maps_ = 0;
+		jobs_.clear();
+		light_stats_.clear();
 
-		std::vector<Light*> lights = SGNode::FindAllComponents<Light>();
-		for (int i = 0; i < lights.size(); i++)
+		// the maps were assigned, culled & checked against the cache during extraction
+		for (uint32_t i = 0; i < packet.shadow_lights.size; i++)
 		{
-			lights[i]->SetShadowRange(0, 0);
+			const PacketShadowLight& light = packet.shadow_lights[i];
+			light_stats_.push_back({ light.light, static_cast<int>(light.num_maps), static_cast<int>(light.num_rendered_maps), static_cast<int>(light.num_casters), light.cpu_time });
+		}
 
-			// map limit
-			if (rendered >= max_maps_) continue;
+		for (uint32_t i = 0; i < packet.shadow_maps.size; i++)
+		{
+			if (packet.shadow_maps[i].render)
+			{
+				jobs_.push_back(i);
+			}
+			else
+			{
+				cached_maps_++;
+			}
+		}
 
-			// not casting shadow
-			if (!lights[i]->GetShadowCasting()) continue;
+		Stopwatch stopwatch;
+		RenderMaps();
+		record_time_ = stopwatch.Output() * 1000.0f;
 
-			// not compatible light
-			if (lights[i]->GetLightType() != LightTypeDirectional && lights[i]->GetLightType() != LightTypePoint) continue;
+		// the map data is written once per frame, every pass that samples the maps binds the same copy
+		map_data_address_ = 0;
 
-			switch (lights[i]->GetLightType())
-			{
-				case LightTypePoint: 
-				{
-					lights[i]->SetShadowRange(rendered, 6);
-					DirectX::XMVECTOR direction = { 1, 0, 0 };
-					DirectX::XMVECTOR center = lights[i]->GetNode()->GetPosition();
-					float fov = 95 * 3.14f / 180.0f;
-
-					view = DirectX::XMMatrixLookAtLH(center, center + direction, { 0, 1, 0 });
-					projection = DirectX::XMMatrixPerspectiveFovLH(fov, 1, 0.1f, 100.0f);
-
-					RenderMap(rendered, view, projection);
-					rendered++;
-
-					direction = { -1, 0, 0 };
-					view = DirectX::XMMatrixLookAtLH(center, center + direction, { 0, 1, 0 });
-					RenderMap(rendered, view, projection);
-					rendered++;
-
-					direction = { 0, 0, 1 };
-					view = DirectX::XMMatrixLookAtLH(center, center + direction, { 0, 1, 0 });
-					RenderMap(rendered, view, projection);
-					rendered++;
-
-					direction = { 0, 0, -1 };
-					view = DirectX::XMMatrixLookAtLH(center, center + direction, { 0, 1, 0 });
-					RenderMap(rendered, view, projection);
-					rendered++;
-
-					direction = { 0.001f, 1, 0 };
-					view = DirectX::XMMatrixLookAtLH(center, center + direction, { 0, 1, 0 });
-					RenderMap(rendered, view, projection);
-					rendered++;
-
-					direction = { 0.001f, -1, 0 };
-					view = DirectX::XMMatrixLookAtLH(center, center + direction, { 0, 1, 0 });
-					RenderMap(rendered, view, projection);
-					rendered++;
-
-					break; 
-				}
+		if (rendered_maps_ > 0)
+		{
+			UploadAllocation allocation = Get::Renderer()->GetFrameResource().Allocate(rendered_maps_ * sizeof(ShadowPassConstants), 16);
+			ShadowPassConstants* map_data = reinterpret_cast<ShadowPassConstants*>(allocation.cpu_address);
 
-				case LightTypeDirectional: 
-				{
-					std::vector<Renderable*> objects = SGNode::FindAllComponents<Renderable>();
-					
-					// Get all points in scene
-					std::vector<DirectX::XMFLOAT3> all_points;
-					for (int o = 0; o < objects.size(); o++) 
-					{
-						std::vector<OctreeObject*> octreeObjects = objects[o]->GetOctreeObjects();
-						for (int b = 0; b < octreeObjects.size(); b++) 
-						{
-							if (!octreeObjects[b]->alive) continue;
-							DirectX::XMFLOAT3 corners[8];
-							octreeObjects[b]->bounds.GetCorners(&corners[0]);
-							all_points.insert(all_points.end(), corners, corners + 8);
-						}
-					}
-
-					// Create scene bounding box
-					DirectX::BoundingBox box;
-					DirectX::BoundingBox::CreateFromPoints(box, all_points.size(), &all_points[0], sizeof(DirectX::XMFLOAT3));
-
-					DirectX::XMVECTOR boxCorners[8];
-					DirectX::XMVECTOR boxCenter = DirectX::XMLoadFloat3(&box.Center);
-
-					DirectX::XMFLOAT3 boxCornerFloats[8];
-					box.GetCorners(&boxCornerFloats[0]);
-					for (int bc = 0; bc < 8; bc++) {
-						boxCorners[bc] = DirectX::XMLoadFloat3(&boxCornerFloats[bc]);
-					}
-
-					// Transform scene bounds into shadow direction
-					DirectX::XMMATRIX cameraView = DirectX::XMMatrixLookAtLH({0, 0, 0}, lights[i]->GetDirection().Normalize(), { 0, 1, 0 });
-					for (int c = 0; c < 8; c++) 
-					{
-						boxCorners[c] = DirectX::XMVector3Transform(boxCorners[c], cameraView);
-					}
-
-					// Get frustum dimensions
-					
-					float xMin = DirectX::XMVectorGetX(boxCorners[0]), xMax = DirectX::XMVectorGetX(boxCorners[0]);
-					float yMin = DirectX::XMVectorGetY(boxCorners[0]), yMax = DirectX::XMVectorGetY(boxCorners[0]);
-					float zMin = DirectX::XMVectorGetZ(boxCorners[0]), zMax = DirectX::XMVectorGetZ(boxCorners[0]);
-					for (int c = 0; c < 8; c++)
-					{
-						xMin = std::min(xMin, DirectX::XMVectorGetX(boxCorners[c]));
-						xMax = std::max(xMax, DirectX::XMVectorGetX(boxCorners[c]));
-
-						yMin = std::min(yMin, DirectX::XMVectorGetY(boxCorners[c]));
-						yMax = std::max(yMax, DirectX::XMVectorGetY(boxCorners[c]));
-
-						zMin = std::min(zMin, DirectX::XMVectorGetZ(boxCorners[c]));
-						zMax = std::max(zMax, DirectX::XMVectorGetZ(boxCorners[c]));
-					}
-
-					DirectX::XMVECTOR direction = -lights[i]->GetDirection();
-
-					// Create view and projection
-					view = DirectX::XMMatrixLookAtLH(boxCenter + direction * -zMin, boxCenter, { 0, 1, 0 });
-					projection = DirectX::XMMatrixOrthographicLH(xMax - xMin, yMax - yMin, 0.01f, 1000);
-
-					// Render map
-					lights[i]->SetShadowRange(rendered, 1);
-					RenderMap(rendered, view, projection);
-					rendered++;
-
-					break; 
-				}
+			for (int i = 0; i < rendered_maps_; i++)
+			{
+				shadow_maps_[i].view_projection_ = DirectX::XMLoadFloat4x4(&packet.shadow_maps[i].view) * DirectX::XMLoadFloat4x4(&packet.shadow_maps[i].projection);
+				map_data[i].view_projection = shadow_maps_[i].view_projection_;
 			}
 
-			
+			map_data_address_ = allocation.gpu_address;
 		}
-
-		rendered_maps_ = rendered;
 	}
 
 	void ShadowRenderer::UploadData(GraphicsContext& context)
 	{
-		for (size_t i = 0; i < rendered_maps_; i++) {
-			
-			map_data_[i].view_projection = shadow_maps_[i].view_projection_;
-		}
-
 		ShadowInfoConstants info;
 		info.shadow_count = (unsigned int)rendered_maps_;
-		info_constants_.InsertDataByElement(0, &info);
 
 		DescriptorHeap& srv_heap = Get::CbvSrvUavHeap();
 
 		if (rendered_maps_ > 0) {
 			context.SetDescriptorTable(12, srv_heap.GetGPUDescriptorById(shadow_map_array_->GetSRV()));
-			CommandContext::InitializeBuffer(map_buffer_, map_data_, (unsigned int)rendered_maps_ * sizeof(ShadowPassConstants), false, 0);
-			context.SetBufferSRV(13, map_buffer_, 0);
+			context.SetBufferSRV(13, map_data_address_);
 		}
 
-		context.SetConstantBuffer(14, info_constants_.GetAddressByElement(0));
+		context.SetConstantBuffer(14, Get::Renderer()->GetFrameResource().AllocateConstants(info));
 	}
 
 	//------------------------------------------------------------------------------------------------------
 	void ShadowRenderer::Destroy()
 	{
 		delete shadow_map_array_;
-		delete map_data_;
 	}
 
 	//------------------------------------------------------------------------------------------------------
@@ -323,13 +223,20 @@ namespace tremble
 
 		GraphicsPSO& pipeline_state2 = GraphicsPSO::Get("shadow_object_render_skinned");
 		pipeline_state2.SetRootSignature(root_signature_skinned_);
-		pipeline_state2.SetVertexShader(Get::ResourceManager()->GetShader("shadow_skinned_vs.cso")->GetShaderByteCode());
+		pipeline_state2.SetVertexShader(Get::ResourceManager()->GetShader(Get::Config().compressed_vertices ? "shadow_skinned_compressed_vs.cso" : "shadow_skinned_vs.cso")->GetShaderByteCode());
 		pipeline_state2.SetPixelShader(Get::ResourceManager()->GetShader("shadow_ps.cso")->GetShaderByteCode());
 		pipeline_state2.SetBlendState(blend_state_);
 		pipeline_state2.SetDepthStencilState(depth_stencil_state_);
 		pipeline_state2.SetRasterizerState(rasterizer_state_);
 		pipeline_state2.SetPrimitiveTopologyType(D3D12_PRIMITIVE_TOPOLOGY_TYPE_TRIANGLE);
-		pipeline_state2.SetInputLayout(_countof(input_element_vertex_desc), input_element_vertex_desc);
+		if (Get::Config().compressed_vertices)
+		{
+			pipeline_state2.SetInputLayout(_countof(input_element_compressed_vertex_desc), input_element_compressed_vertex_desc);
+		}
+		else
+		{
+			pipeline_state2.SetInputLayout(_countof(input_element_vertex_desc), input_element_vertex_desc);
+		}
 		pipeline_state2.SetSampleMask(0xFFFFFFFF);
 		pipeline_state2.SetRenderTargetFormat(DXGI_FORMAT_R32G32B32A32_FLOAT, DXGI_FORMAT_D32_FLOAT);
 		pipeline_state2.Finalize();
@@ -351,46 +258,105 @@ namespace tremble
 	}
 
 	//------------------------------------------------------------------------------------------------------
-	void ShadowRenderer::RenderMap(int index, DirectX::XMMATRIX view, DirectX::XMMATRIX projection)
+	void ShadowRenderer::RenderMaps()
 	{
-		ShadowData map;
-		map.depth_map_ = shadow_maps_[index].depth_map_;
-		map.view_projection_ = DirectX::XMMatrixMultiply(view, projection);
-
-		GraphicsContext& context = GraphicsContext::Begin(L"ShadowMap");
+		if (jobs_.empty())
+		{
+			return;
+		}
 
-		ID3D12DescriptorHeap* heaps[2] = { Get::CbvSrvUavHeap().Get(), Get::SamplerHeap().Get() };
-		D3D12_DESCRIPTOR_HEAP_TYPE heap_types[2] = { D3D12_DESCRIPTOR_HEAP_TYPE_CBV_SRV_UAV, D3D12_DESCRIPTOR_HEAP_TYPE_SAMPLER };
-		context.SetDescriptorHeaps(2, heap_types, heaps);
+		// the maps are transitioned up front, so the chunks never change the state of a resource
+		GraphicsContext& context = GraphicsContext::Begin(L"ShadowMapBarriers");
 
-		context.TransitionResource(*map.depth_map_, D3D12_RESOURCE_STATE_RENDER_TARGET);
-		context.SetRenderTarget(map.depth_map_->GetRTV(), depth_buffer_.GetDSV());
+		for (size_t i = 0; i < jobs_.size(); i++)
+		{
+			context.TransitionResource(*shadow_maps_[jobs_[i]].depth_map_, D3D12_RESOURCE_STATE_RENDER_TARGET);
+		}
 
-		context.ClearColor(*map.depth_map_);
-		context.ClearDepth(depth_buffer_);
-		context.SetViewportAndScissor(0, 0, render_width_, render_height_);
-		context.FlushResourceBarriers();
+		context.Finish();
 
-		context.SetRootSignature(root_signature_);
-		context.SetPipelineState(GraphicsPSO::Get("shadow_object_render"));
+		const GraphicsPSO* pso = &GraphicsPSO::Get("shadow_object_render");
+		const GraphicsPSO* skinned_pso = &GraphicsPSO::Get("shadow_object_render_skinned");
 
-		std::vector<Renderable*> all_renderables = SGNode::FindAllComponents<Renderable>();
-		for (int i = 0; i < all_renderables.size(); i++)
+		// all maps share one depth buffer, so a map can't be split up & its depth is cleared by the map's own command list
+		for (size_t i = 0; i < jobs_.size(); i++)
 		{
-			all_renderables[i]->DrawBasic(context, view, projection);
+			const PacketShadowMap* map = &packet_->shadow_maps[jobs_[i]];
+			ColorBuffer* target = shadow_maps_[jobs_[i]].depth_map_;
+
+			recorder_.AddPass(L"ShadowMap", map->num_casters + map->num_skinned_casters, [this, target, pso](GraphicsContext& chunk)
+			{
+				ID3D12DescriptorHeap* heaps[2] = { Get::CbvSrvUavHeap().Get(), Get::SamplerHeap().Get() };
+				D3D12_DESCRIPTOR_HEAP_TYPE heap_types[2] = { D3D12_DESCRIPTOR_HEAP_TYPE_CBV_SRV_UAV, D3D12_DESCRIPTOR_HEAP_TYPE_SAMPLER };
+				chunk.SetDescriptorHeaps(2, heap_types, heaps);
+
+				chunk.SetRenderTarget(target->GetRTV(), depth_buffer_.GetDSV());
+				chunk.ClearColor(*target);
+				chunk.ClearDepth(depth_buffer_);
+				chunk.SetViewportAndScissor(0, 0, render_width_, render_height_);
+
+				chunk.SetRootSignature(root_signature_);
+				chunk.SetPipelineState(*pso);
+			},
+			[this, map, skinned_pso](GraphicsContext& chunk, size_t begin, size_t end)
+			{
+				DrawCasters(chunk, *map, *skinned_pso);
+			}, false);
 		}
 
-		context.SetRootSignature(root_signature_skinned_);
-		context.SetPipelineState(GraphicsPSO::Get("shadow_object_render_skinned"));
+		recorder_.Record();
 
-		std::vector<SkinnedRenderable*> all_renderables2 = SGNode::FindAllComponents<SkinnedRenderable>();
-		for (int i = 0; i < all_renderables2.size(); i++)
+		// every draw writes its constants to fresh upload memory, so the maps don't have to wait for each other
+		recorder_.Submit();
+	}
+
+	//------------------------------------------------------------------------------------------------------
+	void ShadowRenderer::DrawCasters(GraphicsContext& context, const PacketShadowMap& map, const GraphicsPSO& skinned_pso)
+	{
+		DirectX::XMMATRIX view = DirectX::XMLoadFloat4x4(&map.view);
+		DirectX::XMMATRIX projection = DirectX::XMLoadFloat4x4(&map.projection);
+		FrameResource& frame = Get::Renderer()->GetFrameResource();
+
+		for (uint32_t i = map.first_caster; i < map.first_caster + map.num_casters; i++)
 		{
-			all_renderables2[i]->DrawBasic(context, view, projection);
+			const PacketShadowCaster& caster = packet_->shadow_casters[i];
+
+			ObjectConstants constants;
+			constants.world = DirectX::XMLoadFloat4x4(&caster.world);
+			constants.world_view = constants.world * view;
+			constants.world_view_projection = constants.world * view * projection;
+
+			context.SetConstantBuffer(0, frame.AllocateConstants(constants));
+
+			caster.mesh->DrawPositions(context);
 		}
 
-		context.Finish(true);
+		if (map.num_skinned_casters > 0)
+		{
+			context.SetRootSignature(root_signature_skinned_);
+			context.SetPipelineState(skinned_pso);
+
+			for (uint32_t i = map.first_skinned_caster; i < map.first_skinned_caster + map.num_skinned_casters; i++)
+			{
+				uint32_t index = packet_->shadow_skinned_casters[i];
+				const PacketSkinned& skinned = packet_->skinned[index];
+
+				context.SetBufferSRV(1, (*bone_data_)[index]);
+
+				for (uint32_t j = skinned.first_mesh; j < skinned.first_mesh + skinned.num_meshes; j++)
+				{
+					const PacketSkinnedMesh& mesh = packet_->skinned_meshes[j];
+
+					ObjectConstants constants;
+					constants.world = DirectX::XMLoadFloat4x4(&mesh.world);
+					constants.world_view = constants.world * view;
+					constants.world_view_projection = constants.world * view * projection;
+
+					context.SetConstantBuffer(0, frame.AllocateConstants(constants));
 
-		shadow_maps_[index] = map;
+					mesh.mesh->Draw(context);
+				}
+			}
+		}
 	}
 }
\ No newline at end of file
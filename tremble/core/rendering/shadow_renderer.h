@@ -6,17 +6,43 @@
 #include "../math/math.h"
 #include "depth_buffer.h"
 #include "color_buffer.h"
+#include "../utilities/octree.h"
+#include "parallel_recorder.h"
+
+#define SHADOW_MAP_SIZE 1024 // the width & height of every shadow map
+#define SHADOW_MAX_MAPS 24 // the number of maps in the shadow map array
+#define SHADOW_MAX_CASCADES 4
+#define SHADOW_CASCADE_DISTANCE 150.0f // the distance from the camera up to which the cascades are fitted
+#define SHADOW_CASCADE_SPLIT_BLEND 0.75f // blends the cascade splits between uniform (0) & logarithmic (1)
+#define SHADOW_CASCADE_CASTER_DEPTH 500.0f // how far cascades reach back towards the light, for casters outside of the view
+#define SHADOW_SKINNED_BOUNDS_SCALE 1.5f // skinned bounds are only known in bind pose, so they're scaled up to cover animations
 
 namespace tremble
 {
 	class Shader;
 	class Texture;
+	class Light;
+	struct FramePacket;
+	struct PacketShadowMap;
 
 	struct ShadowData {
 		DirectX::XMMATRIX view_projection_;
 		ColorBuffer* depth_map_;
 	};
 
+	/**
+	* @struct tremble::ShadowLightStats
+	* @brief The shadow rendering cost of a single light in the last frame
+	*/
+	struct ShadowLightStats
+	{
+		const Light* light; //!< The light the statistics are of
+		int num_maps; //!< The number of maps the light uses
+		int num_rendered_maps; //!< The number of maps that had to be rendered again, the others came from the cache
+		int num_casters; //!< The number of meshes that were drawn into the rendered maps
+		float cpu_time; //!< The CPU time spent culling & preparing the light's maps during extraction in milliseconds, the maps are recorded in parallel afterwards
+	};
+
 	struct ShadowPassConstants {
 		DirectX::XMMATRIX view_projection;
 	};
@@ -34,8 +60,12 @@ namespace tremble
 		/// Initializes shadow renderer
 		void Startup();
 
-		/// Render shadow components to depth maps
-		void Draw();
+		/**
+		* @brief Renders the maps of a frame packet that aren't cached & writes the view projections of all its maps to frame memory
+		* @param[in] packet The packet the maps were planned in
+		* @param[in] bone_data The bone transforms of every skinned renderable of the packet, in frame memory
+		*/
+		void Draw(const FramePacket& packet, const std::vector<D3D12_GPU_VIRTUAL_ADDRESS>& bone_data);
 
 		/// Upload depth maps for shadow rendering
 		void UploadData(GraphicsContext&);
@@ -43,21 +73,31 @@ namespace tremble
 		/// Frees up memory used by shadow renderer
 		void Destroy();
 
+		const std::vector<ShadowLightStats>& GetLightStats() const { return light_stats_; } //!< The cost of every shadow casting light in the last frame
+		int GetNumCachedMaps() const { return cached_maps_; } //!< The number of maps that were reused in the last frame
+		float GetRecordTime() const { return record_time_; } //!< The CPU time spent recording & submitting the maps in the last frame, in milliseconds
+
 	private:
 		void CreateRenderResources();
 		void CreatePSO();
 		void CreateRootSignature();
-		void RenderMap(int index, DirectX::XMMATRIX view, DirectX::XMMATRIX projection);
 
-		UploadBuffer info_constants_;
-		StructuredBuffer map_buffer_;
+		void RenderMaps(); //!< Records the maps that have to be rendered again on worker threads, one command list per map, & submits them
+
+		/**
+		* @brief Draws the culled casters of a map, the map's targets & state must be bound already
+		* @param[in] context The context to record the draws into
+		* @param[in] map The map & the ranges of its casters
+		* @param[in] skinned_pso The pipeline state of the skinned casters, resolved before recording starts
+		*/
+		void DrawCasters(GraphicsContext& context, const PacketShadowMap& map, const GraphicsPSO& skinned_pso);
 
 		Shader* pixel_shader_;
 		Shader* vertex_shader_;
 
-		int render_width_ = 1024;
-		int render_height_ = 1024;
-		int max_maps_ = 24;
+		int render_width_ = SHADOW_MAP_SIZE;
+		int render_height_ = SHADOW_MAP_SIZE;
+		int max_maps_ = SHADOW_MAX_MAPS;
 
 		DepthBuffer depth_buffer_;
 		Texture* shadow_map_array_;
@@ -69,8 +109,16 @@ namespace tremble
 		D3D12_DEPTH_STENCIL_DESC depth_stencil_state_;
 		D3D12_RASTERIZER_DESC rasterizer_state_;
 
-		ShadowPassConstants* map_data_;
+		D3D12_GPU_VIRTUAL_ADDRESS map_data_address_; //!< The frame memory the view projections of this frame's maps were written to
 		std::vector<ShadowData> shadow_maps_;
+		const FramePacket* packet_; //!< The packet that is being rendered
+		const std::vector<D3D12_GPU_VIRTUAL_ADDRESS>* bone_data_; //!< The bone transforms of the packet's skinned renderables
+		std::vector<uint32_t> jobs_; //!< The maps that have to be rendered again this frame
+		ParallelRecorder recorder_; //!< Records the maps on worker threads
+		float record_time_; //!< The CPU time spent recording & submitting the maps in the last frame, in milliseconds
+
+		std::vector<ShadowLightStats> light_stats_; //!< The cost of every shadow casting light in the last frame
+		int cached_maps_; //!< The number of maps that were reused in the last frame
 
 		int rendered_maps_;
 	};
@@ -0,0 +1,213 @@
+#include "sprite_atlas.h"
+
+#include "texture.h"
+#include "command_manager.h"
+#include "../get.h"
+
+#include "stb/stb_image.h"
+#include <stb_rect_pack.h>
+
+namespace tremble
+{
+	//------------------------------------------------------------------------------------------------------
+	SpriteAtlas::SpriteAtlas()
+	{
+
+	}
+
+	//------------------------------------------------------------------------------------------------------
+	SpriteAtlas::~SpriteAtlas()
+	{
+		for (int i = 0; i < pages_.size(); i++)
+		{
+			delete pages_[i];
+		}
+	}
+
+	//------------------------------------------------------------------------------------------------------
+	bool SpriteAtlas::Add(Texture* texture)
+	{
+		if (texture == nullptr || texture->GetFilePath().empty())
+		{
+			return false;
+		}
+
+		if (std::find(sources_.begin(), sources_.end(), texture) != sources_.end())
+		{
+			return false;
+		}
+
+		sources_.push_back(texture);
+		return true;
+	}
+
+	//------------------------------------------------------------------------------------------------------
+	void SpriteAtlas::Build(int page_size)
+	{
+		ReleasePages();
+		regions_.clear();
+
+		struct Image
+		{
+			Texture* source;
+			unsigned char* pixels;
+			int width, height;
+		};
+
+		std::vector<Image> images;
+		std::vector<stbrp_rect> rects;
+
+		// the gpu copies of the textures can't be read back, so the pixels come from their files again
+		for (int i = 0; i < sources_.size(); i++)
+		{
+			int width, height, comp;
+			unsigned char* pixels = stbi_load(sources_[i]->GetFilePath().c_str(), &width, &height, &comp, STBI_rgb_alpha);
+
+			if (pixels == nullptr)
+			{
+				continue;
+			}
+
+			if (width + padding_ * 2 > page_size || height + padding_ * 2 > page_size)
+			{
+				DLOG((std::string("Warning: ") + sources_[i]->GetFilePath() + std::string(" is too large for the sprite atlas, it will be drawn on its own.")).c_str());
+				stbi_image_free(pixels);
+				continue;
+			}
+
+			stbrp_rect rect = {};
+			rect.id = static_cast<int>(images.size());
+			rect.w = width + padding_ * 2;
+			rect.h = height + padding_ * 2;
+			rects.push_back(rect);
+
+			images.push_back({ sources_[i], pixels, width, height });
+		}
+
+		std::vector<stbrp_node> nodes(page_size);
+		std::vector<unsigned char> page_pixels;
+
+		// every rect fits on an empty page, so each iteration packs at least one of them
+		while (!rects.empty())
+		{
+			stbrp_context context;
+			stbrp_init_target(&context, page_size, page_size, nodes.data(), page_size);
+			stbrp_pack_rects(&context, rects.data(), static_cast<int>(rects.size()));
+
+			// shrink the page to the area that was actually used
+			int page_width = 0, page_height = 0;
+			for (int i = 0; i < rects.size(); i++)
+			{
+				if (rects[i].was_packed)
+				{
+					page_width = std::max(page_width, rects[i].x + rects[i].w);
+					page_height = std::max(page_height, rects[i].y + rects[i].h);
+				}
+			}
+
+			page_pixels.assign(page_width * page_height * 4, 0);
+
+			std::vector<stbrp_rect> remaining;
+			std::vector<int> packed_images;
+
+			for (int i = 0; i < rects.size(); i++)
+			{
+				if (!rects[i].was_packed)
+				{
+					remaining.push_back(rects[i]);
+					continue;
+				}
+
+				const Image& image = images[rects[i].id];
+				int x = rects[i].x + padding_;
+				int y = rects[i].y + padding_;
+
+				for (int row = 0; row < image.height; row++)
+				{
+					memcpy(&page_pixels[((y + row) * page_width + x) * 4], &image.pixels[row * image.width * 4], image.width * 4);
+				}
+
+				packed_images.push_back(rects[i].id);
+			}
+
+			// create texture from data
+			WICLoadedData image_data;
+			image_data.image_width = page_width;
+			image_data.image_height = page_height;
+			image_data.image_data = page_pixels.data();
+			image_data.image_data_byte_size = page_width * page_height * 4;
+			image_data.bytes_per_row = page_width * 4;
+			image_data.dxgi_format = DXGI_FORMAT_R8G8B8A8_UNORM;
+			image_data.success = true;
+
+			Texture* page = new Texture(image_data);
+			page->BuildBuffers();
+			pages_.push_back(page);
+
+			for (int i = 0; i < rects.size(); i++)
+			{
+				if (rects[i].was_packed)
+				{
+					const Image& image = images[rects[i].id];
+					float x = static_cast<float>(rects[i].x + padding_);
+					float y = static_cast<float>(rects[i].y + padding_);
+
+					Region region;
+					region.page = page;
+					region.uv_min = { x / page_width, y / page_height };
+					region.uv_max = { (x + image.width) / page_width, (y + image.height) / page_height };
+					regions_[image.source] = region;
+				}
+			}
+
+			rects.swap(remaining);
+		}
+
+		for (int i = 0; i < images.size(); i++)
+		{
+			stbi_image_free(images[i].pixels);
+		}
+
+		std::cout << "Packed " << regions_.size() << " of " << sources_.size() << " interface texture(s) into " << pages_.size() << " atlas page(s)" << std::endl;
+	}
+
+	//------------------------------------------------------------------------------------------------------
+	bool SpriteAtlas::Find(Texture* texture, Region& out_region) const
+	{
+		auto result = regions_.find(texture);
+		if (result == regions_.end())
+		{
+			return false;
+		}
+
+		out_region = result->second;
+		return true;
+	}
+
+	//------------------------------------------------------------------------------------------------------
+	void SpriteAtlas::Clear()
+	{
+		ReleasePages();
+		regions_.clear();
+		sources_.clear();
+	}
+
+	//------------------------------------------------------------------------------------------------------
+	void SpriteAtlas::ReleasePages()
+	{
+		if (pages_.empty())
+		{
+			return;
+		}
+
+		// previous frames may still be sampling from the pages
+		Get::CommandManager()->WaitForIdleGPU();
+
+		for (int i = 0; i < pages_.size(); i++)
+		{
+			delete pages_[i];
+		}
+
+		pages_.clear();
+	}
+}
\ No newline at end of file
@@ -0,0 +1,67 @@
+#pragma once
+
+namespace tremble
+{
+	class Texture;
+
+	/**
+	* @class tremble::SpriteAtlas
+	* @brief Packs interface textures into shared atlas pages, so sprites using different textures can be batched
+	*
+	* Textures are registered once at load time & packed with stb_rect_pack when Build is called. The source
+	* textures stay untouched, components keep referencing them and the sprite renderer remaps them to their
+	* page & uv rectangle through Find. Textures that don't fit on a page are simply left out of the atlas.
+	*/
+	class SpriteAtlas
+	{
+	public:
+		/**
+		* @struct tremble::SpriteAtlas::Region
+		* @brief The location of a packed texture inside of the atlas
+		*/
+		struct Region
+		{
+			Texture* page; //!< The atlas page the texture was packed into
+			DirectX::XMFLOAT2 uv_min; //!< The top-left uv of the texture on the page
+			DirectX::XMFLOAT2 uv_max; //!< The bottom-right uv of the texture on the page
+		};
+
+		SpriteAtlas(); //!< Default constructor
+		~SpriteAtlas(); //!< Default destructor, frees all pages
+
+		/**
+		* @brief Registers a texture to be packed by the next Build, textures without a file path are ignored
+		* @param[in] texture The texture that should be packed
+		* @return Whether the texture wasn't registered before
+		*/
+		bool Add(Texture* texture);
+
+		/**
+		* @brief Packs all registered textures into new pages, replacing the previous ones
+		* @param[in] page_size The maximum width & height of a page in pixels
+		*/
+		void Build(int page_size = 2048);
+
+		/**
+		* @brief Looks up where a texture was packed
+		* @param[in] texture The source texture
+		* @param[out] out_region The page & uv rectangle of the texture
+		* @return Whether the texture is part of the atlas
+		*/
+		bool Find(Texture* texture, Region& out_region) const;
+
+		void Clear(); //!< Frees all pages & forgets every registered texture
+
+		size_t GetNumPages() const { return pages_.size(); }
+
+	private:
+		void ReleasePages(); //!< Frees all pages, waiting for the GPU if it may still be sampling them
+
+	private:
+		static const int padding_ = 1; //!< Empty pixels around every packed texture, so neighbours never bleed into each other
+
+		std::vector<Texture*> sources_; //!< All registered textures
+		std::unordered_map<Texture*, Region> regions_; //!< The regions of all packed textures
+		std::vector<Texture*> pages_; //!< The atlas pages
+	};
+}
\ No newline at end of file
@@ -0,0 +1,54 @@
+#include "sprite_batcher.h"
+
+namespace tremble
+{
+	//------------------------------------------------------------------------------------------------------
+	void SpriteBatcher::Clear()
+	{
+		entries_.clear();
+		pages_.clear();
+		sprites_.clear();
+		instances_.clear();
+		batches_.clear();
+	}
+
+	//------------------------------------------------------------------------------------------------------
+	void SpriteBatcher::Add(const InterfaceSpriteObjectConstants& data, Texture* texture, float layer)
+	{
+		int page = pages_.insert(std::make_pair(texture, static_cast<int>(pages_.size()))).first->second;
+		entries_.push_back({ layer, texture, page, static_cast<int>(sprites_.size()) });
+		sprites_.push_back(data);
+	}
+
+	//------------------------------------------------------------------------------------------------------
+	void SpriteBatcher::Build()
+	{
+		instances_.clear();
+		batches_.clear();
+
+		// stable, so sprites on the same layer & page keep the order they were added in
+		std::stable_sort(entries_.begin(), entries_.end(), [](const Entry& a, const Entry& b)
+		{
+			if (a.layer != b.layer)
+			{
+				return a.layer < b.layer;
+			}
+
+			return a.page < b.page;
+		});
+
+		instances_.reserve(entries_.size());
+
+		for (size_t i = 0; i < entries_.size(); i++)
+		{
+			// sprites on different layers may share a batch, the layer only ends up in the depth of the transform
+			if (batches_.empty() || batches_.back().texture != entries_[i].texture)
+			{
+				batches_.push_back({ entries_[i].texture, static_cast<int>(instances_.size()), 0 });
+			}
+
+			instances_.push_back(sprites_[entries_[i].index]);
+			batches_.back().count++;
+		}
+	}
+}
\ No newline at end of file
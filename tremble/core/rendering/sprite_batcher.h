@@ -0,0 +1,67 @@
+#pragma once
+
+#include "interface_buffers.h"
+
+namespace tremble
+{
+	class Texture;
+
+	/**
+	* @class tremble::SpriteBatcher
+	* @brief Sorts interface sprites by layer & texture and merges them into instanced batches
+	*
+	* The batcher only shuffles CPU data around and never touches the GPU, the texture pointers are used as
+	* opaque keys. After Build, every batch is a contiguous range of GetInstances that shares a texture, so
+	* it can be drawn with a single instanced draw call. Textures are numbered as pages in the order they were
+	* first added, so sprites on the same layer are ordered the same way every run instead of by address.
+	*/
+	class SpriteBatcher
+	{
+	public:
+		/**
+		* @struct tremble::SpriteBatcher::Batch
+		* @brief A range of sprite instances that share the same texture
+		*/
+		struct Batch
+		{
+			Texture* texture; //!< The texture (or atlas page) every sprite in the batch samples from
+			int offset; //!< The index of the first instance of the batch
+			int count; //!< The number of instances in the batch
+		};
+
+		void Clear(); //!< Removes all sprites & batches
+
+		/**
+		* @brief Adds a sprite to be batched
+		* @param[in] data The per-instance data of the sprite
+		* @param[in] texture The texture the sprite samples from
+		* @param[in] layer The render layer of the sprite, lower layers are drawn first
+		*/
+		void Add(const InterfaceSpriteObjectConstants& data, Texture* texture, float layer);
+
+		void Build(); //!< Sorts all added sprites by layer & texture and builds the batches
+
+		const std::vector<InterfaceSpriteObjectConstants>& GetInstances() const { return instances_; } //!< The sorted instance data, valid after Build
+		const std::vector<Batch>& GetBatches() const { return batches_; } //!< The batches, valid after Build
+		size_t GetNumSprites() const { return entries_.size(); }
+
+	private:
+		/**
+		* @struct tremble::SpriteBatcher::Entry
+		* @brief The sort key of an added sprite
+		*/
+		struct Entry
+		{
+			float layer; //!< The render layer of the sprite
+			Texture* texture; //!< The texture of the sprite
+			int page; //!< The order in which the texture of the sprite was first added
+			int index; //!< The index of the sprite's data in sprites_
+		};
+
+		std::vector<Entry> entries_; //!< The sort keys of all added sprites
+		std::unordered_map<Texture*, int> pages_; //!< The page of every added texture
+		std::vector<InterfaceSpriteObjectConstants> sprites_; //!< The instance data in the order it was added
+		std::vector<InterfaceSpriteObjectConstants> instances_; //!< The instance data in batch order
+		std::vector<Batch> batches_; //!< The batches built from the sorted sprites
+	};
+}
\ No newline at end of file
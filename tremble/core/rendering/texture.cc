@@ -16,6 +16,7 @@ namespace tremble
 	//------------------------------------------------------------------------------------------------------
 	Texture::Texture(const std::string& file_path) :
 		file_path_(file_path),
+		srv_id_(DESCRIPTOR_ID_UNKNOWN),
 		buffers_built_(false),
 		is_render_target_(false),
 		array_size_(1)
@@ -25,6 +26,7 @@ namespace tremble
 
 	//------------------------------------------------------------------------------------------------------
 	Texture::Texture(WICLoadedData loaded_data, int array_count, bool as_render_target) :
+		srv_id_(DESCRIPTOR_ID_UNKNOWN),
 		buffers_built_(false),
 		is_render_target_(as_render_target)
 	{
@@ -88,6 +90,22 @@ namespace tremble
 		}
 	}
 
+	//------------------------------------------------------------------------------------------------------
+	void Texture::Reload()
+	{
+		// textures created from memory have nothing to reload from
+		if (file_path_.empty())
+		{
+			return;
+		}
+
+		// the caller is responsible for making sure the GPU is no longer using the old resource
+		Destroy();
+		buffers_built_ = false;
+
+		LoadFromFile(file_path_);
+	}
+
 	//------------------------------------------------------------------------------------------------------
 	void Texture::LoadFromMemory(WICLoadedData loaded_data, int array_count)
 	{
@@ -104,6 +122,13 @@ namespace tremble
 			return;
 		}
 
+		// the null render backend runs without a device, the texture is only referenced by the packets then
+		if (Get::Renderer()->HasDevice() == false)
+		{
+			buffers_built_ = true;
+			return;
+		}
+
 		D3D12_RESOURCE_DESC desc;
 		desc.Dimension = D3D12_RESOURCE_DIMENSION_TEXTURE2D;
 		desc.Alignment = 0;
@@ -124,13 +149,13 @@ namespace tremble
 				&CD3DX12_HEAP_PROPERTIES(D3D12_HEAP_TYPE_DEFAULT),
 				D3D12_HEAP_FLAG_NONE,
 				&desc,
-				D3D12_RESOURCE_STATE_COPY_DEST,
+				D3D12_RESOURCE_STATE_COMMON,
 				nullptr,
 				IID_PPV_ARGS(&resource_)
 			)
 		);
 		resource_->SetName(L"Texture");
-		usage_state_ = D3D12_RESOURCE_STATE_COPY_DEST;
+		usage_state_ = D3D12_RESOURCE_STATE_COMMON;
 
 		D3D12_SUBRESOURCE_DATA resource_data = {};
 		resource_data.pData = &texture_data_.image_data[0];
@@ -159,7 +184,15 @@ namespace tremble
 			srv_desc.Texture2DArray.FirstArraySlice = 0;
 		}
 
-		srv_id_ = Get::CbvSrvUavHeap().CreateShaderResourceView(resource_, &srv_desc);
+		if (srv_id_ == DESCRIPTOR_ID_UNKNOWN)
+		{
+			srv_id_ = Get::CbvSrvUavHeap().CreateShaderResourceView(resource_, &srv_desc);
+		}
+		else
+		{
+			// rebuilding (e.g. after a reload), overwrite the existing descriptor so every material keeps pointing at the right slot
+			device->CreateShaderResourceView(resource_, &srv_desc, Get::CbvSrvUavHeap().GetCPUDescriptorById(srv_id_));
+		}
 
 		buffers_built_ = true;
 	}
@@ -15,12 +15,14 @@ namespace tremble
 		~Texture();
 
 		void LoadFromFile(const std::string& file_path);
+		void Reload(); //!< Re-reads the texture from its file, keeping the same SRV slot so materials referencing this texture pick up the new contents
 		void LoadFromMemory(WICLoadedData loaded_data, int array_count);
 		void BuildBuffers();
 		bool AreBuffersBuilt() const { return buffers_built_; }
 
 		const WICLoadedData& GetTextureData() const { return texture_data_; };
 		const UINT& GetSRV() const { return srv_id_; }
+		const std::string& GetFilePath() const { return file_path_; }
 	private:
 		std::string file_path_;
 
@@ -60,6 +60,8 @@ namespace tremble
 		* @param[in] element_id The index (id) of the element you want the address of
 		*/
 		D3D12_GPU_VIRTUAL_ADDRESS GetAddressByElement(UINT element_id);
+
+		BYTE* GetMappedData() { return mapped_data_; } //!< The CPU address of the start of the buffer, nullptr when the buffer isn't mapped
 	private:
 		bool is_mapped_ = false; //!< Is the buffer currently mapped to CPU memory?
 		BYTE* mapped_data_ = nullptr; //!< The data that is mapped to CPU memory - can be freely written to and read from when it is mapped
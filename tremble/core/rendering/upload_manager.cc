@@ -0,0 +1,300 @@
+#include "upload_manager.h"
+
+#include "gpu_resource.h"
+#include "command_manager.h"
+#include "command_queue.h"
+#include "device.h"
+#include "../get.h"
+
+namespace tremble
+{
+	//------------------------------------------------------------------------------------------------------
+	UploadManager::UploadManager() :
+		ring_size_(0),
+		head_(0),
+		tail_(0),
+		used_bytes_(0),
+		list_(nullptr),
+		allocator_(nullptr),
+		num_pending_copies_(0),
+		last_fence_(0),
+		num_uploaded_bytes_(0),
+		num_stalls_(0)
+	{
+
+	}
+
+	//------------------------------------------------------------------------------------------------------
+	UploadManager::~UploadManager()
+	{
+		Shutdown();
+	}
+
+	//------------------------------------------------------------------------------------------------------
+	void UploadManager::Startup(UINT ring_size)
+	{
+		ring_size_ = (ring_size + D3D12_TEXTURE_DATA_PLACEMENT_ALIGNMENT - 1) & ~(D3D12_TEXTURE_DATA_PLACEMENT_ALIGNMENT - 1);
+		ring_.Create(L"UploadRing", ring_size_ / D3D12_TEXTURE_DATA_PLACEMENT_ALIGNMENT, D3D12_TEXTURE_DATA_PLACEMENT_ALIGNMENT);
+
+		head_ = 0;
+		tail_ = 0;
+		used_bytes_ = 0;
+
+		Get::CommandManager()->CreateCommandList(D3D12_COMMAND_LIST_TYPE_COPY, &list_, &allocator_);
+		list_->SetName(L"UploadCommandList");
+	}
+
+	//------------------------------------------------------------------------------------------------------
+	void UploadManager::Shutdown()
+	{
+		std::lock_guard<std::recursive_mutex> lock(mutex_);
+
+		if (list_ == nullptr)
+		{
+			return;
+		}
+
+		WaitForIdle();
+
+		// the allocator still holds the (empty) open list, hand it back as if it was submitted
+		Get::CommandManager()->GetCopyQueue()->DiscardAllocator(last_fence_, allocator_);
+		allocator_ = nullptr;
+
+		SAFE_RELEASE(list_);
+		ring_.Destroy();
+	}
+
+	//------------------------------------------------------------------------------------------------------
+	void UploadManager::CopyToBuffer(GpuResource& dest_resource, const void* data, UINT num_bytes, UINT dest_offset, const std::function<void()>& on_complete)
+	{
+		std::lock_guard<std::recursive_mutex> lock(mutex_);
+
+		Allocation allocation = Allocate(num_bytes, 16);
+		memcpy(allocation.cpu_address, data, num_bytes);
+
+		list_->CopyBufferRegion(dest_resource, dest_offset, allocation.resource, allocation.offset, num_bytes);
+
+		// copy queue accesses promote from & decay back to the common state
+		dest_resource.usage_state_ = D3D12_RESOURCE_STATE_COMMON;
+
+		if (on_complete != nullptr)
+		{
+			pending_.callbacks.push_back(on_complete);
+		}
+
+		num_pending_copies_++;
+		num_uploaded_bytes_ += num_bytes;
+	}
+
+	//------------------------------------------------------------------------------------------------------
+	void UploadManager::CopyToTexture(GpuResource& dest_resource, UINT first_subresource, UINT num_subresources, D3D12_SUBRESOURCE_DATA subresource_data[], const std::function<void()>& on_complete)
+	{
+		std::lock_guard<std::recursive_mutex> lock(mutex_);
+
+		UINT64 num_bytes;
+		Get::Device().Get()->GetCopyableFootprints(&dest_resource->GetDesc(), first_subresource, num_subresources, 0, nullptr, nullptr, nullptr, &num_bytes);
+
+		Allocation allocation = Allocate(num_bytes, D3D12_TEXTURE_DATA_PLACEMENT_ALIGNMENT);
+
+		// lays the subresources out in the upload block & records the copies of every subresource
+		UpdateSubresources(list_, dest_resource.Get(), allocation.resource, allocation.offset, first_subresource, num_subresources, subresource_data);
+
+		dest_resource.usage_state_ = D3D12_RESOURCE_STATE_COMMON;
+
+		if (on_complete != nullptr)
+		{
+			pending_.callbacks.push_back(on_complete);
+		}
+
+		num_pending_copies_++;
+		num_uploaded_bytes_ += num_bytes;
+	}
+
+	//------------------------------------------------------------------------------------------------------
+	uint64_t UploadManager::Flush()
+	{
+		std::lock_guard<std::recursive_mutex> lock(mutex_);
+
+		if (list_ == nullptr || num_pending_copies_ == 0)
+		{
+			return last_fence_;
+		}
+
+		CommandQueue* queue = Get::CommandManager()->GetCopyQueue();
+
+		last_fence_ = queue->ExecuteCommandList(list_);
+
+		queue->DiscardAllocator(last_fence_, allocator_);
+		allocator_ = queue->RequestAllocator();
+		list_->Reset(allocator_, nullptr);
+
+		pending_.fence = last_fence_;
+		pending_.ring_end = head_;
+		batches_.push_back(std::move(pending_));
+
+		pending_ = Batch();
+		num_pending_copies_ = 0;
+
+		return last_fence_;
+	}
+
+	//------------------------------------------------------------------------------------------------------
+	void UploadManager::Update()
+	{
+		// callbacks are collected first, so they may schedule new uploads themselves
+		std::vector<std::function<void()>> callbacks;
+
+		{
+			std::lock_guard<std::recursive_mutex> lock(mutex_);
+
+			RetireBatches();
+			callbacks.swap(finished_callbacks_);
+		}
+
+		for (int i = 0; i < callbacks.size(); i++)
+		{
+			callbacks[i]();
+		}
+	}
+
+	//------------------------------------------------------------------------------------------------------
+	void UploadManager::WaitForIdle()
+	{
+		std::lock_guard<std::recursive_mutex> lock(mutex_);
+
+		Get::CommandManager()->WaitForFence(Flush());
+		Update();
+	}
+
+	//------------------------------------------------------------------------------------------------------
+	UploadManager::Allocation UploadManager::Allocate(UINT64 num_bytes, UINT alignment)
+	{
+		Allocation allocation;
+
+		// blocks that could never fit in the ring get an upload resource of their own
+		if (num_bytes + alignment > ring_size_)
+		{
+			ID3D12Resource* resource = nullptr;
+
+			CHECKHR(
+				Get::Device().Get()->CreateCommittedResource(
+					&CD3DX12_HEAP_PROPERTIES(D3D12_HEAP_TYPE_UPLOAD),
+					D3D12_HEAP_FLAG_NONE,
+					&CD3DX12_RESOURCE_DESC::Buffer(num_bytes),
+					D3D12_RESOURCE_STATE_GENERIC_READ,
+					nullptr,
+					IID_PPV_ARGS(&resource)
+				)
+			);
+			resource->SetName(L"UploadDedicated");
+
+			void* mapped_data;
+			resource->Map(0, nullptr, &mapped_data);
+
+			pending_.dedicated_resources.push_back(resource);
+
+			allocation.cpu_address = static_cast<BYTE*>(mapped_data);
+			allocation.resource = resource;
+			allocation.offset = 0;
+			return allocation;
+		}
+
+		UINT offset;
+		while (TryAllocate(static_cast<UINT>(num_bytes), alignment, offset) == false)
+		{
+			// the ring is full, the oldest batch has to finish before its space can be reused
+			if (batches_.empty() == true)
+			{
+				Flush();
+			}
+
+			num_stalls_++;
+			Get::CommandManager()->WaitForFence(batches_.front().fence);
+			RetireBatches();
+		}
+
+		allocation.cpu_address = ring_.GetMappedData() + offset;
+		allocation.resource = ring_.Get();
+		allocation.offset = offset;
+		return allocation;
+	}
+
+	//------------------------------------------------------------------------------------------------------
+	bool UploadManager::TryAllocate(UINT num_bytes, UINT alignment, UINT& out_offset)
+	{
+		if (used_bytes_ == 0)
+		{
+			head_ = 0;
+			tail_ = 0;
+		}
+		else if (head_ == tail_)
+		{
+			return false;
+		}
+
+		UINT offset = (head_ + alignment - 1) & ~(alignment - 1);
+		UINT consumed;
+
+		if (head_ > tail_ || used_bytes_ == 0)
+		{
+			// the free space is [head, size) followed by [0, tail)
+			if (offset + num_bytes <= ring_size_)
+			{
+				consumed = offset + num_bytes - head_;
+			}
+			else if (num_bytes <= tail_)
+			{
+				// wrap around, the end of the ring is wasted until the tail passes it
+				offset = 0;
+				consumed = ring_size_ - head_ + num_bytes;
+			}
+			else
+			{
+				return false;
+			}
+		}
+		else
+		{
+			// the free space is [head, tail)
+			if (offset + num_bytes <= tail_)
+			{
+				consumed = offset + num_bytes - head_;
+			}
+			else
+			{
+				return false;
+			}
+		}
+
+		used_bytes_ += consumed;
+		pending_.ring_bytes += consumed;
+		head_ = (offset + num_bytes) % ring_size_;
+
+		out_offset = offset;
+		return true;
+	}
+
+	//------------------------------------------------------------------------------------------------------
+	void UploadManager::RetireBatches()
+	{
+		while (batches_.empty() == false && Get::CommandManager()->IsFenceComplete(batches_.front().fence) == true)
+		{
+			Batch& batch = batches_.front();
+
+			tail_ = batch.ring_end;
+			used_bytes_ -= batch.ring_bytes;
+
+			for (int i = 0; i < batch.dedicated_resources.size(); i++)
+			{
+				batch.dedicated_resources[i]->Release();
+			}
+
+			for (int i = 0; i < batch.callbacks.size(); i++)
+			{
+				finished_callbacks_.push_back(batch.callbacks[i]);
+			}
+
+			batches_.pop_front();
+		}
+	}
+}
\ No newline at end of file
@@ -0,0 +1,137 @@
+#pragma once
+
+#include "upload_buffer.h"
+
+#include <mutex>
+
+namespace tremble
+{
+	class GpuResource;
+
+	/**
+	* @class tremble::UploadManager
+	* @brief Streams initial buffer & texture data to the GPU through a persistent upload ring & the copy queue
+	*
+	* Data is written into one persistently mapped ring of upload memory and the copy commands are recorded into a
+	* single copy command list. All copies recorded since the last flush are submitted together; graphics & compute
+	* submissions wait for them on the GPU (see CommandContext::Finish), so the CPU never has to stall for an upload.
+	* Ring space is reclaimed once the copy queue passed the fence of the batch that used it. Uploads that don't fit
+	* in the ring at all get a dedicated upload resource that is released in the same way.
+	*
+	* The copy queue accesses resources in the common state, so the destination resources must not be in use by
+	* other queues while they're being uploaded to; this is meant for initializing new resources, per-frame data
+	* should go through the renderer's frame resources instead.
+	*
+	* All public functions are thread safe: buffers are built on the simulation thread during frame extraction while
+	* the render thread flushes & retires batches.
+	*/
+	class UploadManager
+	{
+	public:
+		UploadManager(); //!< Default constructor
+		~UploadManager(); //!< Destructor
+
+		/**
+		* @brief Creates the upload ring & the copy command list
+		* @param[in] ring_size The size of the upload ring in bytes
+		*/
+		void Startup(UINT ring_size);
+
+		void Shutdown(); //!< Waits for all uploads to finish & releases the ring & the command list
+
+		/**
+		* @brief Schedules a copy of data into a buffer
+		* @param[in] dest_resource The buffer to copy the data into
+		* @param[in] data The data to copy, it is copied into upload memory right away so it may be freed afterwards
+		* @param[in] num_bytes The number of bytes to copy
+		* @param[in] dest_offset The offset in the destination buffer
+		* @param[in] on_complete (optional) Called from Update() once the GPU finished the copy
+		*/
+		void CopyToBuffer(GpuResource& dest_resource, const void* data, UINT num_bytes, UINT dest_offset = 0, const std::function<void()>& on_complete = nullptr);
+
+		/**
+		* @brief Schedules a copy of data into the subresources of a texture
+		* @param[in] dest_resource The texture to copy the data into
+		* @param[in] first_subresource The first subresource to copy into
+		* @param[in] num_subresources The number of subresources to copy into
+		* @param[in] subresource_data The data of every subresource, it is copied into upload memory right away
+		* @param[in] on_complete (optional) Called from Update() once the GPU finished the copy
+		*/
+		void CopyToTexture(GpuResource& dest_resource, UINT first_subresource, UINT num_subresources, D3D12_SUBRESOURCE_DATA subresource_data[], const std::function<void()>& on_complete = nullptr);
+
+		/**
+		* @brief Submits all copies that were scheduled since the last flush to the copy queue
+		* @return The fence value that has to be waited for before the uploaded resources may be used, 0 if nothing was ever submitted
+		*/
+		uint64_t Flush();
+
+		void Update(); //!< Reclaims the memory of finished batches & calls their completion callbacks, never blocks
+		void WaitForIdle(); //!< Submits all pending copies & blocks until they're finished
+
+		uint64_t GetNumUploadedBytes() const { return num_uploaded_bytes_; } //!< The total number of bytes that were uploaded
+		UINT GetNumStalls() const { return num_stalls_; } //!< The number of times the CPU had to wait for the ring to free up
+
+	private:
+		/**
+		* @struct tremble::UploadManager::Allocation
+		* @brief A block of upload memory that copy commands can read from
+		*/
+		struct Allocation
+		{
+			BYTE* cpu_address; //!< The address the CPU writes the data to
+			ID3D12Resource* resource; //!< The upload resource the block lives in
+			UINT64 offset; //!< The offset of the block in the upload resource
+		};
+
+		/**
+		* @struct tremble::UploadManager::Batch
+		* @brief The copies of a single flush
+		*/
+		struct Batch
+		{
+			uint64_t fence; //!< The copy queue fence value of the batch
+			UINT ring_end; //!< The ring offset after the last block of the batch
+			UINT ring_bytes; //!< The ring bytes used by the batch, including padding
+			std::vector<ID3D12Resource*> dedicated_resources; //!< The dedicated upload resources of the batch
+			std::vector<std::function<void()>> callbacks; //!< The completion callbacks of the batch
+		};
+
+		/**
+		* @brief Allocates a block of upload memory, waiting for older batches to finish when the ring is full
+		* @param[in] num_bytes The size of the block
+		* @param[in] alignment The alignment of the block
+		*/
+		Allocation Allocate(UINT64 num_bytes, UINT alignment);
+
+		/**
+		* @brief Tries to allocate a block from the ring without waiting
+		* @param[in] num_bytes The size of the block
+		* @param[in] alignment The alignment of the block
+		* @param[out] out_offset The ring offset of the block
+		* @return Whether the block fit in the ring
+		*/
+		bool TryAllocate(UINT num_bytes, UINT alignment, UINT& out_offset);
+
+		void RetireBatches(); //!< Retires all batches the copy queue has finished, in submission order
+
+		UploadBuffer ring_; //!< The persistently mapped upload ring
+		UINT ring_size_; //!< The size of the upload ring in bytes
+		UINT head_; //!< The ring offset the next block is allocated after
+		UINT tail_; //!< The ring offset of the oldest block that is still in use
+		UINT used_bytes_; //!< The ring bytes that are in use, including padding
+
+		ID3D12GraphicsCommandList* list_; //!< The copy command list the copies are recorded into
+		ID3D12CommandAllocator* allocator_; //!< The allocator of the copy command list
+
+		Batch pending_; //!< The copies that are recorded but not submitted yet
+		UINT num_pending_copies_; //!< The number of copies in the pending batch
+		std::deque<Batch> batches_; //!< The submitted batches that haven't been retired yet, oldest first
+		uint64_t last_fence_; //!< The fence value of the last submitted batch
+		std::vector<std::function<void()>> finished_callbacks_; //!< The callbacks of retired batches, called from Update()
+
+		uint64_t num_uploaded_bytes_; //!< The total number of bytes that were uploaded
+		UINT num_stalls_; //!< The number of times the CPU had to wait for the ring to free up
+
+		std::recursive_mutex mutex_; //!< Guards the ring & the batches, Flush is called again from within the other functions
+	};
+}
\ No newline at end of file
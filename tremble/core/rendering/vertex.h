@@ -1,7 +1,18 @@
 #pragma once
 
+#include <DirectXPackedVector.h>
+
 namespace tremble
 {
+	/**
+	* @brief The vertex layouts a mesh can store its vertices in on the GPU
+	*/
+	enum VertexFormat
+	{
+		VertexFormatFull = 0, //!< Full-float interleaved Vertex, bound to slot 0
+		VertexFormatCompressed = 1 //!< Position stream in slot 0, CompressedVertex attribute stream in slot 1
+	};
+
 	struct Vertex
 	{
 		DirectX::XMFLOAT3 position;
@@ -58,4 +69,34 @@ namespace tremble
 		{ "BONE_IDS",		0, DXGI_FORMAT_R32_UINT,			0, 72,	D3D12_INPUT_CLASSIFICATION_PER_VERTEX_DATA, 0 },
 		{ "BONE_WEIGHTS",	0, DXGI_FORMAT_R32G32B32A32_FLOAT,	0, 76,	D3D12_INPUT_CLASSIFICATION_PER_VERTEX_DATA, 0 }
 	};
+
+	/**
+	* @struct tremble::CompressedVertex
+	* @brief Quantized vertex attributes; the position lives in a separate stream of DirectX::XMFLOAT3
+	*/
+	struct CompressedVertex
+	{
+		DirectX::PackedVector::XMSHORTN2 normal; //!< Octahedral encoded normal
+		DirectX::PackedVector::XMSHORTN2 tangent; //!< Octahedral encoded tangent
+		DirectX::PackedVector::XMSHORTN2 bitangent; //!< Octahedral encoded bitangent
+		DirectX::PackedVector::XMHALF2 uv; //!< Half-float texture coordinates
+		DirectX::PackedVector::XMUBYTEN4 color; //!< 8-bit vertex color
+		uint8_t bone_ids[4]; //!< Bone indices, packed the same way as in Vertex
+		DirectX::PackedVector::XMUBYTEN4 bone_weights; //!< 8-bit bone weights, which still sum up to 255
+	};
+
+	const static D3D12_INPUT_ELEMENT_DESC input_element_position_desc[] = {
+		{ "POSITION",		0, DXGI_FORMAT_R32G32B32_FLOAT,		0, 0,	D3D12_INPUT_CLASSIFICATION_PER_VERTEX_DATA, 0 }
+	};
+
+	const static D3D12_INPUT_ELEMENT_DESC input_element_compressed_vertex_desc[] = {
+		{ "POSITION",		0, DXGI_FORMAT_R32G32B32_FLOAT,		0, 0,	D3D12_INPUT_CLASSIFICATION_PER_VERTEX_DATA, 0 },
+		{ "NORMAL",			0, DXGI_FORMAT_R16G16_SNORM,		1, 0,	D3D12_INPUT_CLASSIFICATION_PER_VERTEX_DATA, 0 },
+		{ "TANGENT",		0, DXGI_FORMAT_R16G16_SNORM,		1, 4,	D3D12_INPUT_CLASSIFICATION_PER_VERTEX_DATA, 0 },
+		{ "BITANGENT",		0, DXGI_FORMAT_R16G16_SNORM,		1, 8,	D3D12_INPUT_CLASSIFICATION_PER_VERTEX_DATA, 0 },
+		{ "UV",				0, DXGI_FORMAT_R16G16_FLOAT,		1, 12,	D3D12_INPUT_CLASSIFICATION_PER_VERTEX_DATA, 0 },
+		{ "COLOR",			0, DXGI_FORMAT_R8G8B8A8_UNORM,		1, 16,	D3D12_INPUT_CLASSIFICATION_PER_VERTEX_DATA, 0 },
+		{ "BONE_IDS",		0, DXGI_FORMAT_R32_UINT,			1, 20,	D3D12_INPUT_CLASSIFICATION_PER_VERTEX_DATA, 0 },
+		{ "BONE_WEIGHTS",	0, DXGI_FORMAT_R8G8B8A8_UNORM,		1, 24,	D3D12_INPUT_CLASSIFICATION_PER_VERTEX_DATA, 0 }
+	};
 }
\ No newline at end of file
@@ -0,0 +1,118 @@
+#include "vertex_compression.h"
+
+namespace tremble
+{
+	//------------------------------------------------------------------------------------------------------
+	VertexCompression::VertexCompression()
+	{
+
+	}
+
+	//------------------------------------------------------------------------------------------------------
+	VertexCompression::~VertexCompression()
+	{
+
+	}
+
+	//------------------------------------------------------------------------------------------------------
+	DirectX::PackedVector::XMSHORTN2 VertexCompression::EncodeOctahedral(const DirectX::XMFLOAT3& v)
+	{
+		float length = std::abs(v.x) + std::abs(v.y) + std::abs(v.z);
+
+		if (length == 0.0f)
+		{
+			return DirectX::PackedVector::XMSHORTN2(0.0f, 0.0f);
+		}
+
+		float x = v.x / length;
+		float y = v.y / length;
+
+		// fold the lower hemisphere over the diagonals
+		if (v.z < 0.0f)
+		{
+			float fx = (1.0f - std::abs(y)) * (x >= 0.0f ? 1.0f : -1.0f);
+			float fy = (1.0f - std::abs(x)) * (y >= 0.0f ? 1.0f : -1.0f);
+			x = fx;
+			y = fy;
+		}
+
+		return DirectX::PackedVector::XMSHORTN2(x, y);
+	}
+
+	//------------------------------------------------------------------------------------------------------
+	DirectX::XMFLOAT3 VertexCompression::DecodeOctahedral(const DirectX::PackedVector::XMSHORTN2& encoded)
+	{
+		DirectX::XMFLOAT2 e;
+		DirectX::XMStoreFloat2(&e, DirectX::PackedVector::XMLoadShortN2(&encoded));
+
+		DirectX::XMFLOAT3 v(e.x, e.y, 1.0f - std::abs(e.x) - std::abs(e.y));
+
+		if (v.z < 0.0f)
+		{
+			v.x = (1.0f - std::abs(e.y)) * (e.x >= 0.0f ? 1.0f : -1.0f);
+			v.y = (1.0f - std::abs(e.x)) * (e.y >= 0.0f ? 1.0f : -1.0f);
+		}
+
+		DirectX::XMStoreFloat3(&v, DirectX::XMVector3Normalize(DirectX::XMLoadFloat3(&v)));
+		return v;
+	}
+
+	//------------------------------------------------------------------------------------------------------
+	CompressedVertex VertexCompression::Compress(const Vertex& vertex)
+	{
+		CompressedVertex compressed;
+
+		compressed.normal = EncodeOctahedral(vertex.normal);
+		compressed.tangent = EncodeOctahedral(vertex.tangent);
+		compressed.bitangent = EncodeOctahedral(vertex.bitangent);
+		compressed.uv = DirectX::PackedVector::XMHALF2(vertex.uv.x, vertex.uv.y);
+		compressed.color = DirectX::PackedVector::XMUBYTEN4(vertex.color.x, vertex.color.y, vertex.color.z, vertex.color.w);
+
+		// quantize the bone weights so they still add up to exactly 255, the rounding error goes to the heaviest bone
+		int weights[4];
+		int total = 0;
+		int heaviest = 0;
+
+		for (int i = 0; i < 4; i++)
+		{
+			compressed.bone_ids[i] = vertex.bone_ids[i];
+
+			// unskinned meshes can end up with NaN weights after normalization, those are treated as unweighted
+			float weight = vertex.bone_weights[i] > 0.0f ? std::min(vertex.bone_weights[i], 1.0f) : 0.0f;
+			weights[i] = static_cast<int>(weight * 255.0f + 0.5f);
+			total += weights[i];
+
+			if (weights[i] > weights[heaviest])
+			{
+				heaviest = i;
+			}
+		}
+
+		if (total > 0)
+		{
+			weights[heaviest] += 255 - total;
+		}
+
+		compressed.bone_weights = DirectX::PackedVector::XMUBYTEN4(
+			static_cast<uint8_t>(weights[0]), 
+			static_cast<uint8_t>(weights[1]), 
+			static_cast<uint8_t>(weights[2]), 
+			static_cast<uint8_t>(weights[3])
+		);
+
+		return compressed;
+	}
+
+	//------------------------------------------------------------------------------------------------------
+	void VertexCompression::Compress(const std::vector<Vertex>& vertices, std::vector<DirectX::XMFLOAT3>& out_positions, std::vector<CompressedVertex>& out_attributes)
+	{
+		out_positions.resize(vertices.size());
+		out_attributes.resize(vertices.size());
+
+		for (size_t i = 0; i < vertices.size(); i++)
+		{
+			out_positions[i] = vertices[i].position;
+			out_attributes[i] = Compress(vertices[i]);
+		}
+	}
+}
\ No newline at end of file
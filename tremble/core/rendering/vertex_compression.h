@@ -0,0 +1,44 @@
+#pragma once
+
+#include "vertex.h"
+
+namespace tremble
+{
+	/**
+	* @class tremble::VertexCompression
+	* @brief Converts full-float vertices into the quantized CompressedVertex layout
+	*/
+	class VertexCompression
+	{
+	private:
+		VertexCompression(); //!< Default constructor
+		~VertexCompression(); //!< Default destructor
+
+	public:
+		/**
+		* @brief Encodes a unit vector onto an octahedron, unfolded into the [-1, 1] square
+		* @param[in] v The (not necessarily normalized) vector to encode
+		*/
+		static DirectX::PackedVector::XMSHORTN2 EncodeOctahedral(const DirectX::XMFLOAT3& v);
+
+		/**
+		* @brief Decodes an octahedral encoded unit vector
+		* @param[in] encoded The encoded vector
+		*/
+		static DirectX::XMFLOAT3 DecodeOctahedral(const DirectX::PackedVector::XMSHORTN2& encoded);
+
+		/**
+		* @brief Quantizes the attributes of a single vertex (everything but the position)
+		* @param[in] vertex The vertex to compress
+		*/
+		static CompressedVertex Compress(const Vertex& vertex);
+
+		/**
+		* @brief Splits an array of vertices into a position stream & a compressed attribute stream
+		* @param[in] vertices The vertices to compress
+		* @param[out] out_positions The position of every vertex
+		* @param[out] out_attributes The compressed attributes of every vertex
+		*/
+		static void Compress(const std::vector<Vertex>& vertices, std::vector<DirectX::XMFLOAT3>& out_positions, std::vector<CompressedVertex>& out_attributes);
+	};
+}
\ No newline at end of file
@@ -0,0 +1,107 @@
+#include "hot_reload_manager.h"
+
+#include "../get.h"
+#include "../config/config_manager.h"
+#include "../rendering/command_manager.h"
+#include "../rendering/render_thread.h"
+#include "../utilities/stopwatch.h"
+#include "resource_manager.h"
+
+namespace tremble
+{
+	//------------------------------------------------------------------------------------------------------
+	HotReloadManager::HotReloadManager() :
+		enabled_(Get::Config().hot_reload)
+	{
+		if (enabled_)
+		{
+			file_watcher_.Start(Get::Config().hot_reload_interval);
+		}
+	}
+
+	//------------------------------------------------------------------------------------------------------
+	HotReloadManager::~HotReloadManager()
+	{
+		file_watcher_.Stop();
+	}
+
+	//------------------------------------------------------------------------------------------------------
+	void HotReloadManager::Watch(const std::string& file_path, AssetType asset_type)
+	{
+		if (!enabled_ || file_path.empty())
+		{
+			return;
+		}
+
+		assets_[file_path] = asset_type;
+		file_watcher_.Watch(file_path);
+	}
+
+	//------------------------------------------------------------------------------------------------------
+	void HotReloadManager::Update()
+	{
+		if (!enabled_)
+		{
+			return;
+		}
+
+		std::vector<std::string> changed_files;
+		file_watcher_.GetChangedFiles(changed_files);
+
+		if (changed_files.empty())
+		{
+			return;
+		}
+
+		Stopwatch stopwatch;
+
+		// everything below swaps GPU resources & pipeline states in-place, so nothing may still be in flight,
+		// which includes a packet the render thread is still recording
+		Get::RenderThread()->WaitForIdle();
+		Get::CommandManager()->WaitForIdleGPU();
+
+		for (int i = 0; i < changed_files.size(); i++)
+		{
+			auto asset = assets_.find(changed_files[i]);
+			if (asset != assets_.end())
+			{
+				Reload(asset->first, asset->second);
+			}
+		}
+
+		std::cout << "Hot reloaded " << changed_files.size() << " file(s) in " << stopwatch.Output() * 1000.0f << "ms" << std::endl;
+	}
+
+	//------------------------------------------------------------------------------------------------------
+	void HotReloadManager::Reload(const std::string& file_path, AssetType asset_type)
+	{
+		switch (asset_type)
+		{
+		case AssetTypeShader:
+		{
+			int num_psos = Get::ResourceManager()->ReloadShader(file_path);
+			if (num_psos >= 0)
+			{
+				std::cout << "Reloaded shader \"" << file_path << "\", recreated " << num_psos << " pipeline state(s)" << std::endl;
+			}
+			break;
+		}
+		case AssetTypeTexture:
+		{
+			int num_textures = Get::ResourceManager()->ReloadTexture(file_path);
+			std::cout << "Reloaded texture \"" << file_path << "\" (" << num_textures << " instance(s))" << std::endl;
+			break;
+		}
+		case AssetTypeModel:
+			if (Get::ResourceManager()->ReloadModel(file_path))
+			{
+				std::cout << "Reloaded model \"" << file_path << "\"" << std::endl;
+			}
+			break;
+		case AssetTypeConfig:
+			Get::ConfigManager()->Reload();
+			std::cout << "Reloaded config \"" << file_path << "\"" << std::endl;
+			break;
+		}
+	}
+}
\ No newline at end of file
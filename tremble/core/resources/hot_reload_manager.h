@@ -0,0 +1,56 @@
+#pragma once
+
+#include "../utilities/file_watcher.h"
+
+namespace tremble
+{
+	/**
+	* @class tremble::HotReloadManager
+	* @brief Reloads shaders, textures, models & the config when their files change on disk
+	*
+	* Resources register their files when they're loaded. Changes are picked up by a FileWatcher on a background
+	* thread & queued; Update drains that queue at the start of a frame, waits for the GPU once & then reloads
+	* only the changed assets in-place, so every Shader, Texture & Model pointer stays valid.
+	*/
+	class HotReloadManager
+	{
+	public:
+		/**
+		* @brief The kind of asset a watched file contains
+		*/
+		enum AssetType
+		{
+			AssetTypeShader,
+			AssetTypeTexture,
+			AssetTypeModel,
+			AssetTypeConfig
+		};
+
+		HotReloadManager(); //!< Default constructor, starts watching if hot reloading is enabled in the config
+		~HotReloadManager(); //!< Default destructor
+
+		/**
+		* @brief Starts watching an asset's file, does nothing if hot reloading is disabled
+		* @param[in] file_path The location of the file on disk, exactly as the resource manager stores it
+		* @param[in] asset_type The kind of asset the file contains
+		*/
+		void Watch(const std::string& file_path, AssetType asset_type);
+
+		void Update(); //!< Reloads every asset that changed since the last update, should be called at a frame boundary
+
+		bool IsEnabled() const { return enabled_; }
+
+	private:
+		/**
+		* @brief Reloads a single asset
+		* @param[in] file_path The location of the file on disk
+		* @param[in] asset_type The kind of asset the file contains
+		*/
+		void Reload(const std::string& file_path, AssetType asset_type);
+
+	private:
+		bool enabled_; //!< Whether hot reloading is enabled
+		FileWatcher file_watcher_; //!< Watches all registered files on a background thread
+		std::unordered_map<std::string, AssetType> assets_; //!< The asset type of every watched file
+	};
+}
\ No newline at end of file
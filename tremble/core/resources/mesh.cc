@@ -10,17 +10,21 @@
 #include "../rendering/texture.h"
 #include "../../components/rendering/renderable.h"
 #include "../memory/memory_includes.h"
-#include "../physics/physics_triangle_mesh_geometry.h"
+#include "mesh_optimizer.h"
+#include "../rendering/vertex_compression.h"
 
 namespace tremble
 {
 	//------------------------------------------------------------------------------------------------------
 	Mesh::Mesh(const MeshData& mesh_data) :
 		buffers_built_(false),
+		vertex_format_(VertexFormatFull),
+		release_mesh_data_after_build_(false),
+		mesh_data_released_(false),
+		num_vertices_(static_cast<UINT>(mesh_data.vertices.size())),
+		short_indices_(false),
 		topology_(mesh_data.topology),
-        material_(nullptr),
-        collider_allocator_(nullptr),
-        triangle_mesh_geometry_(nullptr)
+        material_(nullptr)
 	{
 		mesh_data_ = std::move(mesh_data);
 	}
@@ -28,21 +32,14 @@ namespace tremble
 	//------------------------------------------------------------------------------------------------------
 	Mesh::~Mesh()
 	{
-        if (triangle_mesh_geometry_ != nullptr)
-        {
-            collider_allocator_->Delete(triangle_mesh_geometry_);
-        }
 
-        if (collider_allocator_ != nullptr)
-        {
-            Get::MemoryManager()->DeleteAllocator(collider_allocator_);
-        }
 	}
 
 	//------------------------------------------------------------------------------------------------------
 	void Mesh::SetVertices(const std::vector<Vertex>& vertices)
 	{
 		mesh_data_.vertices = std::move(vertices);
+		num_vertices_ = static_cast<UINT>(mesh_data_.vertices.size());
 	}
 
 	//------------------------------------------------------------------------------------------------------
@@ -54,26 +51,100 @@ namespace tremble
 	//------------------------------------------------------------------------------------------------------
 	void Mesh::BuildBuffers()
 	{
-		vertex_buffer_.Create(L"VertexBuffer", static_cast<UINT>(mesh_data_.vertices.size()), sizeof(Vertex), &mesh_data_.vertices[0], false);
+		ASSERT(!mesh_data_released_);
+
+		num_vertices_ = static_cast<UINT>(mesh_data_.vertices.size());
+
+		// the null render backend runs without a device, only the LOD ranges & bounds are needed by the frame extractor then
+		bool has_device = Get::Renderer()->HasDevice();
+
+		if (has_device == true)
+		{
+			std::vector<DirectX::XMFLOAT3> positions;
+
+			if (vertex_format_ == VertexFormatCompressed)
+			{
+				std::vector<CompressedVertex> attributes;
+				VertexCompression::Compress(mesh_data_.vertices, positions, attributes);
+
+				vertex_buffer_.Create(L"VertexBuffer", num_vertices_, sizeof(CompressedVertex), &attributes[0], false);
 
-		vertex_buffer_view_ = {};
-		vertex_buffer_view_.StrideInBytes = sizeof(Vertex);
-		vertex_buffer_view_.SizeInBytes = static_cast<UINT>(mesh_data_.vertices.size() * sizeof(Vertex));
-		vertex_buffer_view_.BufferLocation = vertex_buffer_->GetGPUVirtualAddress();
+				vertex_buffer_view_ = {};
+				vertex_buffer_view_.StrideInBytes = sizeof(CompressedVertex);
+				vertex_buffer_view_.SizeInBytes = static_cast<UINT>(num_vertices_ * sizeof(CompressedVertex));
+				vertex_buffer_view_.BufferLocation = vertex_buffer_->GetGPUVirtualAddress();
+			}
+			else
+			{
+				positions.resize(num_vertices_);
+				for (UINT i = 0; i < num_vertices_; i++)
+				{
+					positions[i] = mesh_data_.vertices[i].position;
+				}
+
+				vertex_buffer_.Create(L"VertexBuffer", num_vertices_, sizeof(Vertex), &mesh_data_.vertices[0], false);
+
+				vertex_buffer_view_ = {};
+				vertex_buffer_view_.StrideInBytes = sizeof(Vertex);
+				vertex_buffer_view_.SizeInBytes = static_cast<UINT>(num_vertices_ * sizeof(Vertex));
+				vertex_buffer_view_.BufferLocation = vertex_buffer_->GetGPUVirtualAddress();
+			}
+
+			// depth-only passes (depth pre-pass & shadow maps) only fetch positions, so they get their own tightly packed stream
+			position_buffer_.Create(L"PositionBuffer", num_vertices_, sizeof(DirectX::XMFLOAT3), &positions[0], false);
+
+			position_buffer_view_ = {};
+			position_buffer_view_.StrideInBytes = sizeof(DirectX::XMFLOAT3);
+			position_buffer_view_.SizeInBytes = static_cast<UINT>(num_vertices_ * sizeof(DirectX::XMFLOAT3));
+			position_buffer_view_.BufferLocation = position_buffer_->GetGPUVirtualAddress();
+		}
 
 		if (mesh_data_.indices.size() > 0)
 		{
-			index_buffer_.Create(L"IndexBuffer", static_cast<UINT>(mesh_data_.indices.size()), static_cast<UINT>(sizeof(uint32_t)), &mesh_data_.indices[0], false);
+			// all LODs live in a single index buffer, right after LOD 0
+			std::vector<uint32_t> indices = mesh_data_.indices;
+			lod_ranges_.clear();
+			lod_ranges_.push_back(std::make_pair(0U, static_cast<UINT>(mesh_data_.indices.size())));
+
+			for (int i = 0; i < mesh_data_.lods.size(); i++)
+			{
+				const std::vector<uint32_t>& lod_indices = mesh_data_.lods[i].indices;
+				lod_ranges_.push_back(std::make_pair(static_cast<UINT>(indices.size()), static_cast<UINT>(lod_indices.size())));
+				indices.insert(indices.end(), lod_indices.begin(), lod_indices.end());
+			}
+
+			short_indices_ = MeshOptimizer::CanUse16BitIndices(mesh_data_.vertices.size());
+
+			if (has_device == true && short_indices_)
+			{
+				std::vector<uint16_t> short_indices(indices.begin(), indices.end());
+
+				// keep the buffer size a multiple of 4 bytes
+				if (short_indices.size() % 2 != 0)
+				{
+					short_indices.push_back(0);
+				}
+
+				index_buffer_.Create(L"IndexBuffer", static_cast<UINT>(short_indices.size()), static_cast<UINT>(sizeof(uint16_t)), &short_indices[0], false);
 
-			index_buffer_view_ = {};
-			index_buffer_view_.Format = DXGI_FORMAT_R32_UINT;
-			index_buffer_view_.SizeInBytes = static_cast<UINT>(mesh_data_.indices.size() * sizeof(uint32_t));
-			index_buffer_view_.BufferLocation = index_buffer_->GetGPUVirtualAddress();
+				index_buffer_view_ = {};
+				index_buffer_view_.Format = DXGI_FORMAT_R16_UINT;
+				index_buffer_view_.SizeInBytes = static_cast<UINT>(short_indices.size() * sizeof(uint16_t));
+				index_buffer_view_.BufferLocation = index_buffer_->GetGPUVirtualAddress();
+			}
+			else if (has_device == true)
+			{
+				index_buffer_.Create(L"IndexBuffer", static_cast<UINT>(indices.size()), static_cast<UINT>(sizeof(uint32_t)), &indices[0], false);
+
+				index_buffer_view_ = {};
+				index_buffer_view_.Format = DXGI_FORMAT_R32_UINT;
+				index_buffer_view_.SizeInBytes = static_cast<UINT>(indices.size() * sizeof(uint32_t));
+				index_buffer_view_.BufferLocation = index_buffer_->GetGPUVirtualAddress();
+			}
 		}
 
 		DirectX::BoundingSphere::CreateFromPoints(bounds_, mesh_data_.vertices.size(), &mesh_data_.vertices[0].position, sizeof(Vertex));
-
-		UINT obj_cb_byte_size = (sizeof(ObjectConstants) + 255) & ~255;
+		DirectX::BoundingBox::CreateFromPoints(bounding_box_, mesh_data_.vertices.size(), &mesh_data_.vertices[0].position, sizeof(Vertex));
 
 		if (material_ != nullptr)
 		{
@@ -83,38 +154,71 @@ namespace tremble
 			if (material_->normal_map != nullptr	&& !material_->normal_map->AreBuffersBuilt())	{ material_->normal_map->BuildBuffers(); }
 			if (material_->shininess_map != nullptr && !material_->shininess_map->AreBuffersBuilt()){ material_->shininess_map->BuildBuffers(); }
 			if (material_->specular_map != nullptr	&& !material_->specular_map->AreBuffersBuilt())	{ material_->specular_map->BuildBuffers(); }
+		}
+
+		buffers_built_ = true;
 
-			int material_constant_buffer_id_ = Get::Renderer()->GetNewMaterialConstantBufferID();
+		if (release_mesh_data_after_build_)
+		{
+			ReleaseMeshData();
+		}
+	}
+
+	//------------------------------------------------------------------------------------------------------
+	void Mesh::ReleaseMeshData()
+	{
+		ASSERT(buffers_built_);
 
-			D3D12_CONSTANT_BUFFER_VIEW_DESC mat_cbv_desc;
-			mat_cbv_desc.BufferLocation = Get::Renderer()->GetMaterialConstantsBuffer().GetAddressByElement(material_constant_buffer_id_);
-			mat_cbv_desc.SizeInBytes = obj_cb_byte_size;
+		// swap with empty vectors, clear() alone would keep the capacity around
+		std::vector<Vertex>().swap(mesh_data_.vertices);
+		std::vector<uint32_t>().swap(mesh_data_.indices);
 
-			material_->renderer_material_cb_id = material_constant_buffer_id_;
-			material_->renderer_material_descriptor_id = Get::CbvSrvUavHeap().CreateConstantBufferView(&mat_cbv_desc);
+		for (int i = 0; i < mesh_data_.lods.size(); i++)
+		{
+			std::vector<uint32_t>().swap(mesh_data_.lods[i].indices);
 		}
 
-		buffers_built_ = true;
+		mesh_data_released_ = true;
 	}
-	
+
 	//------------------------------------------------------------------------------------------------------
-	void Mesh::Set(GraphicsContext& context)
+	Mesh::MemoryUsage Mesh::GetMemoryUsage() const
 	{
-		if (!AreBuffersBuilt())
+		MemoryUsage usage;
+
+		size_t num_indices = 0;
+
+		if (buffers_built_)
 		{
-			BuildBuffers();
+			for (int i = 0; i < lod_ranges_.size(); i++)
+			{
+				num_indices += lod_ranges_[i].second;
+			}
+		}
+		else
+		{
+			num_indices = mesh_data_.indices.size();
+			for (int i = 0; i < mesh_data_.lods.size(); i++)
+			{
+				num_indices += mesh_data_.lods[i].indices.size();
+			}
 		}
 
-		context.SetPrimitiveTopology(topology_);
-		context.SetVertexBuffer(0, vertex_buffer_view_);
-		if (mesh_data_.indices.size() > 0)
+		usage.cpu_bytes = mesh_data_.vertices.capacity() * sizeof(Vertex) + mesh_data_.indices.capacity() * sizeof(uint32_t);
+		for (int i = 0; i < mesh_data_.lods.size(); i++)
 		{
-			context.SetIndexBuffer(index_buffer_view_);
+			usage.cpu_bytes += mesh_data_.lods[i].indices.capacity() * sizeof(uint32_t);
 		}
-	}
 
+		usage.vertex_bytes = num_vertices_ * (vertex_format_ == VertexFormatCompressed ? sizeof(CompressedVertex) : sizeof(Vertex));
+		usage.position_bytes = num_vertices_ * sizeof(DirectX::XMFLOAT3);
+		usage.index_bytes = num_indices * (MeshOptimizer::CanUse16BitIndices(num_vertices_) ? sizeof(uint16_t) : sizeof(uint32_t));
+
+		return usage;
+	}
+	
 	//------------------------------------------------------------------------------------------------------
-	void Mesh::Draw(GraphicsContext& context)
+	void Mesh::Set(GraphicsContext& context)
 	{
 		if (!AreBuffersBuilt())
 		{
@@ -122,96 +226,104 @@ namespace tremble
 		}
 
 		context.SetPrimitiveTopology(topology_);
-		context.SetVertexBuffer(0, vertex_buffer_view_);
 
-		if (mesh_data_.indices.size() > 0)
+		if (vertex_format_ == VertexFormatCompressed)
 		{
-			context.SetIndexBuffer(index_buffer_view_);
-			context.DrawIndexedInstanced(static_cast<UINT>(mesh_data_.indices.size()), 1, 0, 0, 0);
+			D3D12_VERTEX_BUFFER_VIEW views[2] = { position_buffer_view_, vertex_buffer_view_ };
+			context.SetVertexBuffers(0, 2, views);
 		}
 		else
 		{
-			context.DrawInstanced(static_cast<UINT>(mesh_data_.vertices.size()), 1);
+			context.SetVertexBuffer(0, vertex_buffer_view_);
 		}
-	}
 
-	//------------------------------------------------------------------------------------------------------
-	UINT Mesh::CreateObjectConstantBufferID(Renderable* renderable)
-	{
-		UINT id = Get::Renderer()->GetNewObjectConstantBufferID();
-		object_constant_buffer_ids_[renderable] = id;
-		return id;
+		if (lod_ranges_.size() > 0)
+		{
+			context.SetIndexBuffer(index_buffer_view_);
+		}
 	}
 
 	//------------------------------------------------------------------------------------------------------
-	void Mesh::SetObjectConstantBufferID(Renderable* renderable, UINT id)
+	int Mesh::SelectLOD(float screen_size) const
 	{
-		object_constant_buffer_ids_[renderable] = id;
+		int lod = 0;
+
+		for (int i = 0; i < mesh_data_.lods.size(); i++)
+		{
+			if (screen_size < mesh_data_.lods[i].screen_size)
+			{
+				lod = i + 1;
+			}
+		}
+
+		return lod;
 	}
 
 	//------------------------------------------------------------------------------------------------------
-	UINT Mesh::GetObjectConstantBufferID(Renderable* renderable)
+	void Mesh::Draw(GraphicsContext& context, int lod)
 	{
-		auto& find = object_constant_buffer_ids_.find(renderable);
-		if (find == object_constant_buffer_ids_.end())
-		{
-			return DESCRIPTOR_ID_UNKNOWN;
-		}
-		else
-		{
-			return find->second;
-		}
+		Set(context);
+		DrawRange(context, lod);
 	}
 
 	//------------------------------------------------------------------------------------------------------
-	UINT Mesh::CreateObjectConstantBufferID(SkinnedRenderable* renderable)
+	void Mesh::DrawPositions(GraphicsContext& context, int lod)
 	{
-		UINT id = Get::Renderer()->GetNewObjectConstantBufferID();
-		skinned_object_constant_buffer_ids_[renderable] = id;
-		return id;
+		SetPositions(context);
+		DrawRange(context, lod);
 	}
 
 	//------------------------------------------------------------------------------------------------------
-	void Mesh::SetObjectConstantBufferID(SkinnedRenderable* renderable, UINT id)
+	void Mesh::SetPositions(GraphicsContext& context)
 	{
-		skinned_object_constant_buffer_ids_[renderable] = id;
+		if (!AreBuffersBuilt())
+		{
+			BuildBuffers();
+		}
+
+		context.SetPrimitiveTopology(topology_);
+		context.SetVertexBuffer(0, position_buffer_view_);
+
+		if (lod_ranges_.size() > 0)
+		{
+			context.SetIndexBuffer(index_buffer_view_);
+		}
 	}
 
 	//------------------------------------------------------------------------------------------------------
-	UINT Mesh::GetObjectConstantBufferID(SkinnedRenderable* renderable)
+	void Mesh::DrawRange(GraphicsContext& context, int lod, UINT num_instances)
 	{
-		auto& find = skinned_object_constant_buffer_ids_.find(renderable);
-		if (find == skinned_object_constant_buffer_ids_.end())
+		if (lod_ranges_.size() > 0)
 		{
-			return DESCRIPTOR_ID_UNKNOWN;
+			const std::pair<UINT, UINT>& range = lod_ranges_[std::min(std::max(lod, 0), static_cast<int>(lod_ranges_.size()) - 1)];
+			context.DrawIndexedInstanced(range.second, num_instances, range.first, 0, 0);
 		}
 		else
 		{
-			return find->second;
+			context.DrawInstanced(num_vertices_, num_instances);
 		}
 	}
 
     //------------------------------------------------------------------------------------------------------
     PhysicsTriangleMeshGeometry* Mesh::GetPhysicsTriangleMeshGeometry()
     {
-        if(triangle_mesh_geometry_ == nullptr)
+        if(triangle_mesh_geometry_.IsCooked() == false)
         {
+            // cooking reads the CPU-side vertices, so it has to happen before they get released
+            ASSERT(!mesh_data_released_);
             CookColliderGeometry();
         }
-        return triangle_mesh_geometry_;
+        return &triangle_mesh_geometry_;
     }
 
     //------------------------------------------------------------------------------------------------------
     void Mesh::CookColliderGeometry()
     {
-        if (triangle_mesh_geometry_ != nullptr)
+        if (triangle_mesh_geometry_.IsCooked() == true)
             return;
 
-        unsigned int allocation_size = FreeListAllocator::GetRecommendedMemoryPoolSize(sizeof(PhysicsTriangleMeshGeometry), 1);
-
-        ASSERT(collider_allocator_ == nullptr);
-        collider_allocator_ = Get::MemoryManager()->GetNewAllocator<FreeListAllocator>(allocation_size);
-        triangle_mesh_geometry_ = collider_allocator_->New<PhysicsTriangleMeshGeometry>(this);
-        ASSERT(triangle_mesh_geometry_ != nullptr);
+        // the triangle mesh is shared with every other mesh with the same triangles, the cache owns it
+        triangle_mesh_geometry_.cookTriangleMeshGeometry(this);
+        ASSERT(triangle_mesh_geometry_.IsCooked() == true);
     }
-}
+}
\ No newline at end of file
@@ -6,14 +6,12 @@
 #include "../rendering/graphics_context.h"
 #include "../math/math.h"
 #include "core/memory/allocators/free_list_allocator.h"
+#include "../physics/physics_triangle_mesh_geometry.h"
 
 namespace tremble
 {
 	struct Material;
 	class Texture;
-	class Renderable;
-	class SkinnedRenderable;
-    class PhysicsTriangleMeshGeometry;
 
 	/**
 	* @class tremble::Mesh
@@ -30,9 +28,32 @@ namespace tremble
 		*/
 		struct MeshData
 		{
+			/**
+			* @struct tremble::Mesh::MeshData::LOD
+			* @brief A simplified version of the mesh that indexes into the same vertices as LOD 0
+			*/
+			struct LOD
+			{
+				std::vector<uint32_t> indices; //!< All indices of this LOD
+				float screen_size; //!< The projected screen size (fraction of the screen height) below which this LOD is used
+			};
+
 			std::vector<Vertex> vertices; //!< All vertices in this mesh
-			std::vector<uint32_t> indices; //!< All indices in this mesh
+			std::vector<uint32_t> indices; //!< All indices in this mesh (LOD 0)
 			D3D_PRIMITIVE_TOPOLOGY topology; //!< Topology of this mesh
+			std::vector<LOD> lods; //!< Simplified LODs of this mesh, ordered from most to least detailed
+		};
+
+		/**
+		* @struct tremble::Mesh::MemoryUsage
+		* @brief Describes how much memory a mesh occupies, in bytes
+		*/
+		struct MemoryUsage
+		{
+			size_t cpu_bytes; //!< The CPU-side copy of the mesh data
+			size_t vertex_bytes; //!< The GPU vertex (attribute) stream
+			size_t position_bytes; //!< The GPU position-only stream
+			size_t index_bytes; //!< The GPU index buffer, including all LODs
 		};
 
 		/**
@@ -54,30 +75,77 @@ namespace tremble
 
 		size_t GetIndexCount() const { return mesh_data_.indices.size(); }
 
+		/**
+		* @brief Get the number of LODs this mesh has, including LOD 0
+		*/
+		int GetLODCount() const { return static_cast<int>(mesh_data_.lods.size()) + 1; }
+
+		/**
+		* @brief Selects the LOD that should be used for a given projected size
+		* @param[in] screen_size The projected size of the mesh' bounds, as a fraction of the screen height
+		*/
+		int SelectLOD(float screen_size) const;
+
+		void SetVertexFormat(VertexFormat vertex_format) { vertex_format_ = vertex_format; }
+		VertexFormat GetVertexFormat() const { return vertex_format_; }
+
+		/**
+		* @brief Drop the CPU-side mesh data as soon as the GPU buffers have been built
+		* @param[in] release Whether the mesh data should be released
+		* @remarks Collision geometry has to be cooked before the buffers get built, as cooking reads the CPU-side vertices
+		*/
+		void SetReleaseMeshDataAfterBuild(bool release) { release_mesh_data_after_build_ = release; }
+		bool IsMeshDataReleased() const { return mesh_data_released_; }
+
+		/**
+		* @brief Frees the CPU-side vertices & indices, only the GPU buffers (and the bounds) remain
+		*/
+		void ReleaseMeshData();
+
+		/**
+		* @brief Computes the memory this mesh occupies (or will occupy once its buffers are built)
+		*/
+		MemoryUsage GetMemoryUsage() const;
+
 		void SetTopology(D3D12_PRIMITIVE_TOPOLOGY topology) { topology_ = topology; }
 		D3D12_PRIMITIVE_TOPOLOGY GetTopology() const { return topology_; }
 
 		void BuildBuffers();
 
 		void Set(GraphicsContext& context);
-		void Draw(GraphicsContext& context);
+		void Draw(GraphicsContext& context, int lod = 0);
+
+		/**
+		* @brief Draws the mesh with only its position stream bound to slot 0, for depth-only passes
+		* @param[in] context The context to record the draw into
+		* @param[in] lod The LOD that should be drawn
+		*/
+		void DrawPositions(GraphicsContext& context, int lod = 0);
+
+		/**
+		* @brief Binds only the position stream of the mesh to slot 0, the depth-only counterpart of Set
+		* @param[in] context The context to bind the buffers on
+		*/
+		void SetPositions(GraphicsContext& context);
+
+		/**
+		* @brief Draws a LOD of the mesh, expects the mesh's buffers to be bound already by Set or SetPositions
+		* @param[in] context The context to record the draw into
+		* @param[in] lod The LOD that should be drawn
+		* @param[in] num_instances The number of instances that should be drawn
+		*/
+		void DrawRange(GraphicsContext& context, int lod, UINT num_instances = 1);
 
 		bool AreBuffersBuilt() const { return buffers_built_; }
+		bool UsesShortIndices() const { return short_indices_; }
 
 		const DirectX::BoundingSphere& GetBounds() const { return bounds_; }
+		const DirectX::BoundingBox& GetBoundingBox() const { return bounding_box_; }
 
 		void SetMaterial(Material* material) { material_ = material; }
 		const Material* GetMaterial() const { return material_; }
 		Material* GetMaterial() { return material_; }
 
-		UINT CreateObjectConstantBufferID(Renderable* renderable);
-		void SetObjectConstantBufferID(Renderable* renderable, UINT id);
-		UINT GetObjectConstantBufferID(Renderable* renderable);
-
-		UINT CreateObjectConstantBufferID(SkinnedRenderable* renderable);
-		void SetObjectConstantBufferID(SkinnedRenderable* renderable, UINT id);
-		UINT GetObjectConstantBufferID(SkinnedRenderable* renderable);
-
         PhysicsTriangleMeshGeometry* GetPhysicsTriangleMeshGeometry();
 
 	protected:
@@ -85,23 +153,29 @@ namespace tremble
 
 		bool buffers_built_;
 		MeshData mesh_data_;
+		VertexFormat vertex_format_;
+		bool release_mesh_data_after_build_;
+		bool mesh_data_released_;
+		UINT num_vertices_; //!< The number of vertices, which remains valid after the mesh data has been released
 
 		D3D12_PRIMITIVE_TOPOLOGY topology_;
 
 		StructuredBuffer vertex_buffer_;
 		D3D12_VERTEX_BUFFER_VIEW vertex_buffer_view_;
 
+		StructuredBuffer position_buffer_;
+		D3D12_VERTEX_BUFFER_VIEW position_buffer_view_;
+
 		ByteAddressBuffer index_buffer_;
 		D3D12_INDEX_BUFFER_VIEW index_buffer_view_;
+		bool short_indices_; //!< Whether the index buffer is stored with 16-bit indices
+		std::vector<std::pair<UINT, UINT>> lod_ranges_; //!< Start index & index count of every LOD inside of the index buffer
 
 		DirectX::BoundingSphere bounds_;
+		DirectX::BoundingBox bounding_box_;
 		Material* material_;
 
-		std::unordered_map<Renderable*, UINT> object_constant_buffer_ids_; //!< All object constant buffer IDs per renderable that uses this mesh
-		std::unordered_map<SkinnedRenderable*, UINT> skinned_object_constant_buffer_ids_; //!< All object constant buffer IDs per renderable that uses this mesh
-
-        FreeListAllocator* collider_allocator_;
-        PhysicsTriangleMeshGeometry* triangle_mesh_geometry_;
+        PhysicsTriangleMeshGeometry triangle_mesh_geometry_; //!< The collision geometry, empty until it's first requested
 
 	};
 }
@@ -0,0 +1,494 @@
+#include "mesh_optimizer.h"
+
+#include "../utilities/debug.h"
+
+namespace tremble
+{
+	namespace
+	{
+		const unsigned int kMaxCacheSize = 64; //!< The largest cache size the Forsyth scoring tables are built for
+		const float kCacheDecayPower = 1.5f;
+		const float kLastTriScore = 0.75f;
+		const float kValenceBoostScale = 2.0f;
+		const float kValenceBoostPower = 0.5f;
+
+		//------------------------------------------------------------------------------------------------------
+		float ForsythVertexScore(int cache_position, unsigned int remaining_valence, unsigned int cache_size)
+		{
+			if (remaining_valence == 0)
+			{
+				return -1.0f;
+			}
+
+			float score = 0.0f;
+
+			if (cache_position >= 0)
+			{
+				if (cache_position < 3)
+				{
+					// the vertices of the last triangle get a fixed score, so we don't favour whichever one of them happened to be inserted first
+					score = kLastTriScore;
+				}
+				else
+				{
+					float scaler = 1.0f / (cache_size - 3);
+					score = std::pow(1.0f - (cache_position - 3) * scaler, kCacheDecayPower);
+				}
+			}
+
+			score += kValenceBoostScale * std::pow(static_cast<float>(remaining_valence), -kValenceBoostPower);
+			return score;
+		}
+	}
+
+	//------------------------------------------------------------------------------------------------------
+	MeshOptimizer::MeshOptimizer()
+	{
+
+	}
+
+	//------------------------------------------------------------------------------------------------------
+	MeshOptimizer::~MeshOptimizer()
+	{
+
+	}
+
+	//------------------------------------------------------------------------------------------------------
+	void MeshOptimizer::Optimize(Mesh::MeshData& mesh_data, const Settings& settings)
+	{
+		if (mesh_data.topology != D3D_PRIMITIVE_TOPOLOGY_TRIANGLELIST || mesh_data.indices.size() < 3 || mesh_data.vertices.size() == 0)
+		{
+			return;
+		}
+
+		mesh_data.lods.clear();
+
+		if (settings.num_lods > 0)
+		{
+			GenerateLODs(mesh_data, settings);
+		}
+
+		if (settings.optimize_vertex_cache)
+		{
+			OptimizeVertexCache(mesh_data.indices, mesh_data.vertices.size(), settings.cache_size);
+
+			for (int i = 0; i < mesh_data.lods.size(); i++)
+			{
+				OptimizeVertexCache(mesh_data.lods[i].indices, mesh_data.vertices.size(), settings.cache_size);
+			}
+		}
+
+		if (settings.optimize_vertex_fetch)
+		{
+			OptimizeVertexFetch(mesh_data);
+		}
+	}
+
+	//------------------------------------------------------------------------------------------------------
+	void MeshOptimizer::OptimizeVertexCache(std::vector<uint32_t>& indices, size_t num_vertices, unsigned int cache_size)
+	{
+		size_t num_triangles = indices.size() / 3;
+
+		if (num_triangles == 0)
+		{
+			return;
+		}
+
+		cache_size = std::max(4U, std::min(cache_size, kMaxCacheSize));
+
+		// build vertex -> triangle adjacency
+		std::vector<unsigned int> valence(num_vertices, 0);
+		for (size_t i = 0; i < num_triangles * 3; i++)
+		{
+			valence[indices[i]]++;
+		}
+
+		std::vector<unsigned int> adjacency_offsets(num_vertices + 1, 0);
+		for (size_t i = 0; i < num_vertices; i++)
+		{
+			adjacency_offsets[i + 1] = adjacency_offsets[i] + valence[i];
+		}
+
+		std::vector<unsigned int> adjacency(num_triangles * 3);
+		std::vector<unsigned int> fill(adjacency_offsets.begin(), adjacency_offsets.end() - 1);
+		for (size_t i = 0; i < num_triangles; i++)
+		{
+			for (int k = 0; k < 3; k++)
+			{
+				adjacency[fill[indices[i * 3 + k]]++] = static_cast<unsigned int>(i);
+			}
+		}
+
+		std::vector<int> cache_position(num_vertices, -1);
+		std::vector<float> vertex_score(num_vertices);
+		for (size_t i = 0; i < num_vertices; i++)
+		{
+			vertex_score[i] = ForsythVertexScore(-1, valence[i], cache_size);
+		}
+
+		std::vector<bool> emitted(num_triangles, false);
+
+		std::vector<uint32_t> output;
+		output.reserve(indices.size());
+
+		// the cache has room for a full triangle on top of its size, the overflow is evicted after every step
+		std::vector<uint32_t> cache;
+		cache.reserve(cache_size + 3);
+		std::vector<uint32_t> new_cache;
+		new_cache.reserve(cache_size + 3);
+
+		size_t linear_cursor = 0;
+		int best_triangle = -1;
+
+		for (size_t emitted_count = 0; emitted_count < num_triangles; emitted_count++)
+		{
+			if (best_triangle < 0)
+			{
+				// no candidate in the cache, fall back to the next unemitted triangle in input order
+				while (emitted[linear_cursor])
+				{
+					linear_cursor++;
+				}
+
+				best_triangle = static_cast<int>(linear_cursor);
+			}
+
+			const uint32_t* tri = &indices[best_triangle * 3];
+			output.push_back(tri[0]);
+			output.push_back(tri[1]);
+			output.push_back(tri[2]);
+			emitted[best_triangle] = true;
+
+			// remove the triangle from the adjacency of its vertices
+			for (int k = 0; k < 3; k++)
+			{
+				uint32_t v = tri[k];
+				unsigned int begin = adjacency_offsets[v];
+				unsigned int end = begin + valence[v];
+
+				for (unsigned int a = begin; a < end; a++)
+				{
+					if (adjacency[a] == static_cast<unsigned int>(best_triangle))
+					{
+						std::swap(adjacency[a], adjacency[end - 1]);
+						break;
+					}
+				}
+
+				valence[v]--;
+			}
+
+			// move the triangle's vertices to the front of the cache
+			new_cache.clear();
+			new_cache.push_back(tri[0]);
+			new_cache.push_back(tri[1]);
+			new_cache.push_back(tri[2]);
+
+			for (size_t c = 0; c < cache.size(); c++)
+			{
+				uint32_t v = cache[c];
+				if (v != tri[0] && v != tri[1] && v != tri[2])
+				{
+					new_cache.push_back(v);
+				}
+			}
+
+			for (size_t c = cache_size; c < new_cache.size(); c++)
+			{
+				cache_position[new_cache[c]] = -1;
+			}
+
+			if (new_cache.size() > cache_size)
+			{
+				new_cache.resize(cache_size);
+			}
+
+			std::swap(cache, new_cache);
+
+			// update the scores of everything in the cache & find the best triangle adjacent to it
+			for (size_t c = 0; c < cache.size(); c++)
+			{
+				cache_position[cache[c]] = static_cast<int>(c);
+			}
+
+			for (size_t c = 0; c < cache.size(); c++)
+			{
+				uint32_t v = cache[c];
+				vertex_score[v] = ForsythVertexScore(cache_position[v], valence[v], cache_size);
+			}
+
+			// the evicted vertices also changed score
+			for (size_t c = 0; c < new_cache.size(); c++)
+			{
+				uint32_t v = new_cache[c];
+				if (cache_position[v] < 0)
+				{
+					vertex_score[v] = ForsythVertexScore(-1, valence[v], cache_size);
+				}
+			}
+
+			best_triangle = -1;
+			float best_score = -1.0f;
+
+			for (size_t c = 0; c < cache.size(); c++)
+			{
+				uint32_t v = cache[c];
+				unsigned int begin = adjacency_offsets[v];
+				unsigned int end = begin + valence[v];
+
+				for (unsigned int a = begin; a < end; a++)
+				{
+					unsigned int t = adjacency[a];
+					const uint32_t* adj = &indices[t * 3];
+					float score = vertex_score[adj[0]] + vertex_score[adj[1]] + vertex_score[adj[2]];
+
+					if (score > best_score)
+					{
+						best_score = score;
+						best_triangle = static_cast<int>(t);
+					}
+				}
+			}
+		}
+
+		indices = std::move(output);
+	}
+
+	//------------------------------------------------------------------------------------------------------
+	void MeshOptimizer::OptimizeVertexFetch(Mesh::MeshData& mesh_data)
+	{
+		const uint32_t kUnmapped = 0xFFFFFFFF;
+
+		std::vector<uint32_t> remap(mesh_data.vertices.size(), kUnmapped);
+		uint32_t next = 0;
+
+		auto assign = [&](const std::vector<uint32_t>& indices)
+		{
+			for (size_t i = 0; i < indices.size(); i++)
+			{
+				if (remap[indices[i]] == kUnmapped)
+				{
+					remap[indices[i]] = next++;
+				}
+			}
+		};
+
+		assign(mesh_data.indices);
+		for (int i = 0; i < mesh_data.lods.size(); i++)
+		{
+			assign(mesh_data.lods[i].indices);
+		}
+
+		// unreferenced vertices are kept at the back, so vertex counts (and bounds) don't change
+		for (size_t i = 0; i < remap.size(); i++)
+		{
+			if (remap[i] == kUnmapped)
+			{
+				remap[i] = next++;
+			}
+		}
+
+		std::vector<Vertex> vertices(mesh_data.vertices.size());
+		for (size_t i = 0; i < remap.size(); i++)
+		{
+			vertices[remap[i]] = mesh_data.vertices[i];
+		}
+		mesh_data.vertices = std::move(vertices);
+
+		for (size_t i = 0; i < mesh_data.indices.size(); i++)
+		{
+			mesh_data.indices[i] = remap[mesh_data.indices[i]];
+		}
+
+		for (int i = 0; i < mesh_data.lods.size(); i++)
+		{
+			std::vector<uint32_t>& lod_indices = mesh_data.lods[i].indices;
+			for (size_t j = 0; j < lod_indices.size(); j++)
+			{
+				lod_indices[j] = remap[lod_indices[j]];
+			}
+		}
+	}
+
+	//------------------------------------------------------------------------------------------------------
+	void MeshOptimizer::GenerateLODs(Mesh::MeshData& mesh_data, const Settings& settings)
+	{
+		const std::vector<uint32_t>* source = &mesh_data.indices;
+		float screen_size = settings.lod_screen_size;
+
+		// start with a grid that roughly has as many cells along the longest axis as the mesh has triangles along one side
+		float grid_size = std::sqrt(static_cast<float>(mesh_data.indices.size() / 3));
+
+		for (unsigned int i = 0; i < settings.num_lods; i++)
+		{
+			size_t source_triangles = source->size() / 3;
+
+			if (source_triangles < settings.min_lod_triangles)
+			{
+				break;
+			}
+
+			size_t target_triangles = static_cast<size_t>(source_triangles * settings.lod_reduction);
+
+			Mesh::MeshData::LOD lod;
+			lod.screen_size = screen_size;
+
+			// coarsen the grid until the triangle budget for this LOD is met
+			do
+			{
+				grid_size *= 0.85f;
+				SimplifyByClustering(mesh_data.vertices, *source, static_cast<unsigned int>(grid_size), lod.indices);
+			}
+			while (lod.indices.size() / 3 > target_triangles && grid_size >= 2.0f);
+
+			// stop once clustering doesn't gain us anything anymore, or when it has collapsed the mesh entirely
+			if (lod.indices.size() == 0 || lod.indices.size() >= source->size())
+			{
+				break;
+			}
+
+			mesh_data.lods.push_back(std::move(lod));
+			source = &mesh_data.lods.back().indices;
+			screen_size *= 0.5f;
+		}
+	}
+
+	//------------------------------------------------------------------------------------------------------
+	void MeshOptimizer::SimplifyByClustering(const std::vector<Vertex>& vertices, const std::vector<uint32_t>& indices, unsigned int grid_size, std::vector<uint32_t>& out_indices)
+	{
+		out_indices.clear();
+
+		const float kFloatMax = std::numeric_limits<float>::max();
+		DirectX::XMFLOAT3 min(kFloatMax, kFloatMax, kFloatMax);
+		DirectX::XMFLOAT3 max(-kFloatMax, -kFloatMax, -kFloatMax);
+
+		for (size_t i = 0; i < indices.size(); i++)
+		{
+			const DirectX::XMFLOAT3& p = vertices[indices[i]].position;
+			min.x = std::min(min.x, p.x); min.y = std::min(min.y, p.y); min.z = std::min(min.z, p.z);
+			max.x = std::max(max.x, p.x); max.y = std::max(max.y, p.y); max.z = std::max(max.z, p.z);
+		}
+
+		float extent = std::max(max.x - min.x, std::max(max.y - min.y, max.z - min.z));
+		if (extent <= 0.0f)
+		{
+			return;
+		}
+
+		float inv_cell_size = static_cast<float>(grid_size) / extent;
+		uint32_t max_cell = grid_size - 1;
+
+		// every referenced vertex is collapsed onto the first referenced vertex in its cell, so LODs keep using the LOD 0 vertex buffer
+		std::unordered_map<uint64_t, uint32_t> cell_representative;
+		std::vector<uint32_t> collapse(vertices.size(), 0xFFFFFFFF);
+
+		for (size_t i = 0; i < indices.size(); i++)
+		{
+			uint32_t v = indices[i];
+
+			if (collapse[v] != 0xFFFFFFFF)
+			{
+				continue;
+			}
+
+			const DirectX::XMFLOAT3& p = vertices[v].position;
+			uint64_t cx = std::min(static_cast<uint32_t>((p.x - min.x) * inv_cell_size), max_cell);
+			uint64_t cy = std::min(static_cast<uint32_t>((p.y - min.y) * inv_cell_size), max_cell);
+			uint64_t cz = std::min(static_cast<uint32_t>((p.z - min.z) * inv_cell_size), max_cell);
+			uint64_t key = (cx << 42) | (cy << 21) | cz;
+
+			auto result = cell_representative.insert(std::make_pair(key, v));
+			collapse[v] = result.first->second;
+		}
+
+		// drop degenerate & duplicate triangles, the remaining two corners of every kept triangle are listed under its smallest index
+		std::vector<std::vector<std::pair<uint32_t, uint32_t>>> seen(vertices.size());
+		out_indices.reserve(indices.size());
+
+		for (size_t i = 0; i + 2 < indices.size(); i += 3)
+		{
+			uint32_t a = collapse[indices[i]];
+			uint32_t b = collapse[indices[i + 1]];
+			uint32_t c = collapse[indices[i + 2]];
+
+			if (a == b || b == c || a == c)
+			{
+				continue;
+			}
+
+			// rotate the triangle so the smallest index comes first, which preserves the winding order
+			while (a > b || a > c)
+			{
+				uint32_t t = a; a = b; b = c; c = t;
+			}
+
+			// a clustered vertex is shared by only a handful of triangles, so the lists stay short
+			std::vector<std::pair<uint32_t, uint32_t>>& kept = seen[a];
+			if (std::find(kept.begin(), kept.end(), std::make_pair(b, c)) != kept.end())
+			{
+				continue;
+			}
+			kept.push_back(std::make_pair(b, c));
+
+			out_indices.push_back(a);
+			out_indices.push_back(b);
+			out_indices.push_back(c);
+		}
+	}
+
+	//------------------------------------------------------------------------------------------------------
+	MeshOptimizer::CacheStatistics MeshOptimizer::AnalyzeVertexCache(const std::vector<uint32_t>& indices, size_t num_vertices, unsigned int cache_size)
+	{
+		CacheStatistics stats = { 0.0f, 0.0f, 0 };
+
+		if (indices.size() < 3)
+		{
+			return stats;
+		}
+
+		// a FIFO cache, which is what most hardware actually implements
+		std::vector<unsigned int> timestamps(num_vertices, 0);
+		std::vector<bool> referenced(num_vertices, false);
+		unsigned int time = cache_size + 1;
+		unsigned int unique_vertices = 0;
+
+		for (size_t i = 0; i < indices.size(); i++)
+		{
+			uint32_t v = indices[i];
+
+			if (!referenced[v])
+			{
+				referenced[v] = true;
+				unique_vertices++;
+			}
+
+			if (time - timestamps[v] > cache_size)
+			{
+				timestamps[v] = time++;
+				stats.num_misses++;
+			}
+		}
+
+		stats.acmr = static_cast<float>(stats.num_misses) / static_cast<float>(indices.size() / 3);
+		stats.atvr = unique_vertices > 0 ? static_cast<float>(stats.num_misses) / static_cast<float>(unique_vertices) : 0.0f;
+
+		return stats;
+	}
+
+	//------------------------------------------------------------------------------------------------------
+	void MeshOptimizer::Report(const std::string& name, const Mesh::MeshData& mesh_data, unsigned int cache_size)
+	{
+		CacheStatistics stats = AnalyzeVertexCache(mesh_data.indices, mesh_data.vertices.size(), cache_size);
+
+		std::cout << "Mesh \"" << name << "\": " << mesh_data.vertices.size() << " vertices, "
+			<< (CanUse16BitIndices(mesh_data.vertices.size()) ? "16" : "32") << "-bit indices" << std::endl;
+		std::cout << "  LOD 0: " << mesh_data.indices.size() / 3 << " triangles, ACMR " << stats.acmr << ", ATVR " << stats.atvr << std::endl;
+
+		for (int i = 0; i < mesh_data.lods.size(); i++)
+		{
+			stats = AnalyzeVertexCache(mesh_data.lods[i].indices, mesh_data.vertices.size(), cache_size);
+			std::cout << "  LOD " << i + 1 << ": " << mesh_data.lods[i].indices.size() / 3 << " triangles, ACMR " << stats.acmr << ", ATVR " << stats.atvr
+				<< ", screen size < " << mesh_data.lods[i].screen_size << std::endl;
+		}
+	}
+}
\ No newline at end of file
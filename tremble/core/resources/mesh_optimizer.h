@@ -0,0 +1,107 @@
+#pragma once
+
+#include "mesh.h"
+
+namespace tremble
+{
+	/**
+	* @class tremble::MeshOptimizer
+	* @brief Post-processing stage for mesh data (vertex cache/fetch ordering, LOD generation & index format selection)
+	*
+	* Every function in here works on plain Mesh::MeshData and never touches the GPU, so it can run
+	* inside of the ModelLoader as well as from an offline cooker.
+	*/
+	class MeshOptimizer
+	{
+	private:
+		MeshOptimizer(); //!< Default constructor
+		~MeshOptimizer(); //!< Default destructor
+
+	public:
+		/**
+		* @struct tremble::MeshOptimizer::Settings
+		* @brief Describes which steps should be applied when optimizing a mesh
+		*/
+		struct Settings
+		{
+			bool optimize_vertex_cache = true; //!< Reorder triangles for post-transform vertex cache locality
+			bool optimize_vertex_fetch = true; //!< Reorder vertices in the order they are first referenced
+			unsigned int cache_size = 32; //!< The size of the simulated post-transform vertex cache
+			unsigned int num_lods = 3; //!< The number of simplified LODs that should be generated (excluding LOD 0)
+			float lod_reduction = 0.5f; //!< The target triangle count of every LOD relative to the previous one
+			float lod_screen_size = 0.25f; //!< The projected screen size (fraction of the screen height) below which LOD 1 kicks in
+			unsigned int min_lod_triangles = 64; //!< Meshes (or LODs) with fewer triangles than this do not get simplified any further
+		};
+
+		/**
+		* @struct tremble::MeshOptimizer::CacheStatistics
+		* @brief Describes how well an index buffer makes use of a post-transform vertex cache
+		*/
+		struct CacheStatistics
+		{
+			float acmr; //!< Average cache miss ratio: transformed vertices per triangle (0.5 is optimal, 3.0 is worst)
+			float atvr; //!< Average transformed vertex ratio: transformed vertices per unique vertex (1.0 is optimal)
+			unsigned int num_misses; //!< The total number of cache misses
+		};
+
+		/**
+		* @brief Runs every enabled optimization step on the given mesh data
+		* @param[in] mesh_data The mesh data that should be optimized in-place
+		* @param[in] settings The optimization settings that should be used
+		*/
+		static void Optimize(Mesh::MeshData& mesh_data, const Settings& settings);
+
+		/**
+		* @brief Reorders triangles to maximize post-transform vertex cache hits, using Forsyth's linear-speed algorithm
+		* @param[in] indices The triangle list indices that should be reordered in-place
+		* @param[in] num_vertices The number of vertices the indices refer to
+		* @param[in] cache_size The size of the simulated vertex cache
+		*/
+		static void OptimizeVertexCache(std::vector<uint32_t>& indices, size_t num_vertices, unsigned int cache_size);
+
+		/**
+		* @brief Reorders vertices in the order they are first referenced by the index buffer(s)
+		* @param[in] mesh_data The mesh data of which the vertices should be reordered; the main index list & all LOD index lists are remapped
+		*/
+		static void OptimizeVertexFetch(Mesh::MeshData& mesh_data);
+
+		/**
+		* @brief Generates a chain of simplified LODs using vertex clustering; every LOD shares the vertex buffer of LOD 0
+		* @param[in] mesh_data The mesh data for which LODs should be generated
+		* @param[in] settings The settings that control the number & aggressiveness of the LODs
+		*/
+		static void GenerateLODs(Mesh::MeshData& mesh_data, const Settings& settings);
+
+		/**
+		* @brief Simulates a FIFO post-transform vertex cache over a triangle list
+		* @param[in] indices The triangle list indices to analyze
+		* @param[in] num_vertices The number of vertices the indices refer to
+		* @param[in] cache_size The size of the simulated vertex cache
+		*/
+		static CacheStatistics AnalyzeVertexCache(const std::vector<uint32_t>& indices, size_t num_vertices, unsigned int cache_size);
+
+		/**
+		* @brief Whether a mesh with the given number of vertices can be indexed with 16-bit indices
+		* @param[in] num_vertices The number of vertices in the mesh
+		*/
+		static bool CanUse16BitIndices(size_t num_vertices) { return num_vertices <= 0xFFFF; }
+
+		/**
+		* @brief Outputs the ACMR/ATVR of the main index list & every LOD to the console
+		* @param[in] name The name that identifies the mesh in the report
+		* @param[in] mesh_data The mesh data that should be reported on
+		* @param[in] cache_size The size of the simulated vertex cache
+		*/
+		static void Report(const std::string& name, const Mesh::MeshData& mesh_data, unsigned int cache_size);
+
+	protected:
+		/**
+		* @brief Simplifies a triangle list by snapping vertices to a uniform grid & collapsing every cell into a single vertex
+		* @param[in] vertices The vertices the indices refer to
+		* @param[in] indices The triangle list indices that should be simplified
+		* @param[in] grid_size The number of cells along the longest axis of the mesh' bounds
+		* @param[out] out_indices The simplified triangle list, referencing the original vertices
+		*/
+		static void SimplifyByClustering(const std::vector<Vertex>& vertices, const std::vector<uint32_t>& indices, unsigned int grid_size, std::vector<uint32_t>& out_indices);
+	};
+}
\ No newline at end of file
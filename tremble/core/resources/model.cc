@@ -57,6 +57,23 @@ namespace tremble
 		}
 	}
 
+	//------------------------------------------------------------------------------------------------------
+	void Model::Swap(Model& other)
+	{
+		std::swap(meshes_, other.meshes_);
+		std::swap(materials_, other.materials_);
+		std::swap(textures_, other.textures_);
+		std::swap(root_node_, other.root_node_);
+		std::swap(nodes_, other.nodes_);
+		std::swap(animations_, other.animations_);
+		std::swap(name_to_bone_mapping_, other.name_to_bone_mapping_);
+		std::swap(bones_, other.bones_);
+		std::swap(node_allocator_, other.node_allocator_);
+		std::swap(mesh_allocator_, other.mesh_allocator_);
+		std::swap(material_allocator_, other.material_allocator_);
+		std::swap(texture_allocator_, other.texture_allocator_);
+	}
+
 	//------------------------------------------------------------------------------------------------------
 	void Model::Iterate(ModelNode* node, std::vector<std::pair<Mesh*, Mat44>>& out_pairs)
 	{
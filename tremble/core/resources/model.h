@@ -53,6 +53,12 @@ namespace tremble
 		Model();
 		~Model();
 
+		/**
+		* @brief Exchanges the entire contents (meshes, materials, textures, nodes, animations & their allocators) with another model
+		* @param[in] other The model to swap contents with
+		*/
+		void Swap(Model& other);
+
 		std::vector<std::pair<Mesh*, Mat44>> GetMeshesWithTransforms();
 
 		void GetBoneTransforms(float animation_time_in_seconds, const Animation& animation, const DirectX::XMMATRIX& world_transform, std::vector<Mat44>& output);
@@ -3,6 +3,7 @@
 #include "../rendering/texture.h"
 #include "../resources/model.h"
 #include "../resources/resource_manager.h"
+#include "../resources/mesh_optimizer.h"
 #include "../get.h"
 
 namespace tremble
@@ -20,7 +21,7 @@ namespace tremble
 	}
 	
 	//------------------------------------------------------------------------------------------------------
-	Model* ModelLoader::LoadModel(const std::string& model_path, Allocator* model_allocator)
+	Model* ModelLoader::LoadModel(const std::string& model_path, Allocator* model_allocator, bool allow_failure)
 	{
 		std::cout << "Loading model \"" << model_path << "\" using Assimp (v" << aiGetVersionMajor() << "." << aiGetVersionMinor() << "." << aiGetVersionRevision() << ").." << std::endl;
 
@@ -44,10 +45,21 @@ namespace tremble
 		if (scene == nullptr)
 		{
 			DLOG(importer.GetErrorString());
+
+			if (allow_failure)
+			{
+				return nullptr;
+			}
+
 			system("PAUSE");
 			exit(-1);
 		}
 
+		if (allow_failure && !scene->HasMeshes())
+		{
+			return nullptr;
+		}
+
 		assert(scene);
 		assert(scene->HasMeshes());
 
@@ -104,6 +116,11 @@ namespace tremble
 		model->SetBones(bones);
 		model->SetNameToBoneMapping(name_to_bone_mapping);
 
+		if (Get::Config().mesh_memory_report)
+		{
+			ReportMemoryUsage(model_path, meshes);
+		}
+
 		return model;
 	}
 	
@@ -232,7 +249,29 @@ namespace tremble
 				}
 			}
 
-			out_meshes.push_back(allocator->New<Mesh>(mesh_data));
+			if (Get::Config().optimize_meshes)
+			{
+				MeshOptimizer::Settings settings;
+
+				// skinned meshes deform, so clustering them in bind pose would produce visibly broken LODs
+				if (mesh->HasBones())
+				{
+					settings.num_lods = 0;
+				}
+
+				MeshOptimizer::Optimize(mesh_data, settings);
+
+				if (Get::Config().mesh_optimization_report)
+				{
+					MeshOptimizer::Report(mesh->mName.C_Str(), mesh_data, settings.cache_size);
+				}
+			}
+
+			Mesh* out_mesh = allocator->New<Mesh>(mesh_data);
+			out_mesh->SetVertexFormat(Get::Config().compressed_vertices ? VertexFormatCompressed : VertexFormatFull);
+			out_mesh->SetReleaseMeshDataAfterBuild(Get::Config().release_mesh_data);
+
+			out_meshes.push_back(out_mesh);
 		}
 	}
 	
@@ -436,6 +475,29 @@ namespace tremble
 		}
 	}
 	
+	//------------------------------------------------------------------------------------------------------
+	void ModelLoader::ReportMemoryUsage(const std::string& model_path, const std::vector<Mesh*>& meshes)
+	{
+		Mesh::MemoryUsage total = { 0, 0, 0, 0 };
+
+		for (int i = 0; i < meshes.size(); i++)
+		{
+			Mesh::MemoryUsage usage = meshes[i]->GetMemoryUsage();
+			total.cpu_bytes += usage.cpu_bytes;
+			total.vertex_bytes += usage.vertex_bytes;
+			total.position_bytes += usage.position_bytes;
+			total.index_bytes += usage.index_bytes;
+		}
+
+		bool released = Get::Config().release_mesh_data;
+
+		std::cout << "Memory usage of model \"" << model_path << "\" (" << meshes.size() << " meshes, " << (Get::Config().compressed_vertices ? "compressed" : "full") << " vertices):" << std::endl;
+		std::cout << "  CPU mesh data:   " << total.cpu_bytes / 1024 << " KB" << (released ? " (released once the GPU buffers are built)" : "") << std::endl;
+		std::cout << "  GPU vertices:    " << total.vertex_bytes / 1024 << " KB" << std::endl;
+		std::cout << "  GPU positions:   " << total.position_bytes / 1024 << " KB" << std::endl;
+		std::cout << "  GPU indices:     " << total.index_bytes / 1024 << " KB" << std::endl;
+	}
+
 	//------------------------------------------------------------------------------------------------------
 	int ModelLoader::CountNodes(aiNode* node, int current_count)
 	{
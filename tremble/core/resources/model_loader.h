@@ -48,8 +48,9 @@ namespace tremble
 		* @brief Loads a model into memory using the supplied model allocator
 		* @param[in] model_path The path to the model you wish to load
 		* @param[in] model_allocator The allocator that should be used to allocate the actual Model structure
+		* @param[in] allow_failure Whether a model that fails to import should return nullptr instead of exiting the application (used when hot reloading)
 		*/
-		static Model* LoadModel(const std::string& model_path, Allocator* model_allocator);
+		static Model* LoadModel(const std::string& model_path, Allocator* model_allocator, bool allow_failure = false);
 
 	protected:
 		/**
@@ -97,6 +98,13 @@ namespace tremble
 
 		static void ProcessAnimations(aiAnimation** animations, unsigned int num_animations, const std::vector<Model::ModelNode*>& model_nodes, std::vector<Animation>& out_animations);
 
+		/**
+		* @brief Outputs the CPU & GPU memory that the meshes of a model occupy to the console
+		* @param[in] model_path The path of the model, used to identify it in the report
+		* @param[in] meshes All meshes of the model
+		*/
+		static void ReportMemoryUsage(const std::string& model_path, const std::vector<Mesh*>& meshes);
+
 		/**
 		* @brief Counts all the nodes that live in the scene hierarchy
 		* @param[in] node The node from which all child nodes should be counted
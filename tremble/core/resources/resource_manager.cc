@@ -1,6 +1,7 @@
 #include "resource_manager.h"
 
 #include "../game_manager.h"
+#include "../get.h"
 #include "../../core/resources/mesh.h"
 #include "../../core/resources/model_loader.h"
 #include "../../core/rendering/texture.h"
@@ -8,6 +9,13 @@
 #include "../../core/rendering/shader.h"
 #include "../../core/memory/memory_includes.h"
 #include "../../core/audio/audio_clip.h"
+#include "../../core/rendering/pipeline_state.h"
+#include "../../core/rendering/command_manager.h"
+#include "../../core/scene_graph/component_manager.h"
+#include "../../components/rendering/renderable.h"
+#include "../../components/rendering/skinned_renderable.h"
+#include "model.h"
+#include "hot_reload_manager.h"
 
 namespace tremble
 {
@@ -83,9 +91,46 @@ namespace tremble
 		// cache the loaded texture in a local variable to avoid an unnecessary & costly unordered_map find-operation
 		Texture* loaded_texture = texture_allocator_->New<Texture>(location);
 		textures_[location] = loaded_texture;
+
+		Get::HotReloadManager()->Watch(location, HotReloadManager::AssetTypeTexture);
+
 		return loaded_texture;
 	}
 
+	//------------------------------------------------------------------------------------------------------
+	int ResourceManager::ReloadTexture(const std::string& texture_location)
+	{
+		int num_reloaded = 0;
+
+		auto result = textures_.find(texture_location);
+		if (result != textures_.end() && result->second != nullptr)
+		{
+			result->second->Reload();
+			num_reloaded++;
+		}
+
+		// models own their textures, so those have to be found by their file location
+		for (auto model = models_.begin(); model != models_.end(); model++)
+		{
+			if (model->second == nullptr)
+			{
+				continue;
+			}
+
+			const std::vector<Texture*> textures = model->second->GetTextures();
+			for (int i = 0; i < textures.size(); i++)
+			{
+				if (textures[i] != nullptr && textures[i]->GetFilePath() == texture_location)
+				{
+					textures[i]->Reload();
+					num_reloaded++;
+				}
+			}
+		}
+
+		return num_reloaded;
+	}
+
 	//------------------------------------------------------------------------------------------------------
 	void ResourceManager::UnloadTexture(const std::string& texture_location, bool use_texture_directory)
 	{
@@ -94,6 +139,8 @@ namespace tremble
 		auto result = textures_.find(location);
 		if (result != textures_.end())
 		{
+			// frames that are still in flight may sample the texture
+			Get::CommandManager()->WaitForIdleGPU();
 			texture_allocator_->Delete<Texture>(result->second);
 			textures_[location] = nullptr;
 		}
@@ -150,9 +197,72 @@ namespace tremble
 		// cache the loaded model in a local variable to avoid an unnecessary & costly unordered_map find-operation
 		Model* loaded_model = ModelLoader::LoadModel(location, model_allocator_);
 		models_[location] = loaded_model;
+
+		Get::HotReloadManager()->Watch(location, HotReloadManager::AssetTypeModel);
+
+		const std::vector<Texture*> textures = loaded_model->GetTextures();
+		for (int i = 0; i < textures.size(); i++)
+		{
+			if (textures[i] != nullptr)
+			{
+				Get::HotReloadManager()->Watch(textures[i]->GetFilePath(), HotReloadManager::AssetTypeTexture);
+			}
+		}
+
 		return loaded_model;
 	}
 
+	//------------------------------------------------------------------------------------------------------
+	bool ResourceManager::ReloadModel(const std::string& model_location)
+	{
+		auto result = models_.find(model_location);
+		if (result == models_.end() || result->second == nullptr)
+		{
+			return false;
+		}
+
+		Model* reloaded_model = ModelLoader::LoadModel(model_location, model_allocator_, true);
+		if (reloaded_model == nullptr)
+		{
+			std::cout << "Failed to reload a model (" << model_location << "), keeping the old version." << std::endl;
+			return false;
+		}
+
+		// swap the contents so every renderable keeps its model pointer, the reloaded model now holds the old meshes
+		Model* model = result->second;
+		model->Swap(*reloaded_model);
+
+		const std::vector<Renderable*>& renderables = Get::ComponentManager()->GetComponents<Renderable>();
+		for (int i = 0; i < renderables.size(); i++)
+		{
+			if (renderables[i]->GetModel() == model)
+			{
+				renderables[i]->ReloadModel(*reloaded_model);
+			}
+		}
+
+		const std::vector<SkinnedRenderable*>& skinned_renderables = Get::ComponentManager()->GetComponents<SkinnedRenderable>();
+		for (int i = 0; i < skinned_renderables.size(); i++)
+		{
+			if (skinned_renderables[i]->GetModel() == model)
+			{
+				skinned_renderables[i]->ReloadModel(*reloaded_model);
+			}
+		}
+
+		const std::vector<Texture*> textures = model->GetTextures();
+		for (int i = 0; i < textures.size(); i++)
+		{
+			if (textures[i] != nullptr)
+			{
+				Get::HotReloadManager()->Watch(textures[i]->GetFilePath(), HotReloadManager::AssetTypeTexture);
+			}
+		}
+
+		model_allocator_->Delete<Model>(reloaded_model);
+		return true;
+	}
+
 	//------------------------------------------------------------------------------------------------------
 	void ResourceManager::UnloadModel(const std::string& model_location, bool use_model_directory)
 	{
@@ -161,6 +271,8 @@ namespace tremble
 		auto result = models_.find(location);
 		if (result != models_.end())
 		{
+			// frames that are still in flight may draw the model's meshes
+			Get::CommandManager()->WaitForIdleGPU();
 			model_allocator_->Delete<Model>(result->second);
 			models_[location] = nullptr;
 		}
@@ -214,20 +326,9 @@ namespace tremble
 			shader_allocator_->Delete<Shader>(result->second);
 		}
 
-		std::ifstream input(location, std::ios::in | std::ios::ate | std::ios::binary);
-
-		char* shader_byte_code = nullptr;
-		std::streampos shader_byte_size;
+		std::vector<BYTE> shader_byte_code;
 
-		if (input.is_open())
-		{
-			shader_byte_size = input.tellg();
-			shader_byte_code = new char[shader_byte_size];
-			input.seekg(0, std::ios::beg);
-			input.read(shader_byte_code, shader_byte_size);
-			input.close();
-		}
-		else
+		if (!ReadShaderByteCode(location, shader_byte_code))
 		{
 			std::cout << "Failed to load a shader (" << location << "). Exiting." << std::endl;
 			system("PAUSE");
@@ -236,11 +337,58 @@ namespace tremble
 
 		// cache the loaded shader in a local variable to avoid an unnecessary & costly unordered_map find-operation
 		Shader* loaded_shader = shader_allocator_->New<Shader>();
-		loaded_shader->CreateFromByteCode(reinterpret_cast<BYTE*>(shader_byte_code), shader_byte_size);
+		loaded_shader->CreateFromByteCode(std::move(shader_byte_code));
 		shaders_[location] = loaded_shader;
+
+		Get::HotReloadManager()->Watch(location, HotReloadManager::AssetTypeShader);
+
 		return loaded_shader;
 	}
 
+	//------------------------------------------------------------------------------------------------------
+	int ResourceManager::ReloadShader(const std::string& shader_location)
+	{
+		auto result = shaders_.find(shader_location);
+		if (result == shaders_.end() || result->second == nullptr)
+		{
+			return -1;
+		}
+
+		std::vector<BYTE> shader_byte_code;
+
+		// unlike the initial load, a shader that can't be read keeps its old byte code
+		if (!ReadShaderByteCode(shader_location, shader_byte_code) || shader_byte_code.empty())
+		{
+			std::cout << "Failed to reload a shader (" << shader_location << "), keeping the old version." << std::endl;
+			return -1;
+		}
+
+		Shader* shader = result->second;
+		D3D12_SHADER_BYTECODE previous = shader->GetShaderByteCode();
+		shader->CreateFromByteCode(std::move(shader_byte_code));
+
+		// only the pipeline states that reference this shader's byte code get recreated
+		return GraphicsPSO::ReplaceShader(previous, shader->GetShaderByteCode()) + ComputePSO::ReplaceShader(previous, shader->GetShaderByteCode());
+	}
+
+	//------------------------------------------------------------------------------------------------------
+	bool ResourceManager::ReadShaderByteCode(const std::string& location, std::vector<BYTE>& out_byte_code)
+	{
+		std::ifstream input(location, std::ios::in | std::ios::ate | std::ios::binary);
+
+		if (!input.is_open())
+		{
+			return false;
+		}
+
+		out_byte_code.resize(static_cast<size_t>(input.tellg()));
+		input.seekg(0, std::ios::beg);
+		input.read(reinterpret_cast<char*>(out_byte_code.data()), out_byte_code.size());
+		input.close();
+
+		return true;
+	}
+
 	//------------------------------------------------------------------------------------------------------
 	void ResourceManager::UnloadShader(const std::string& shader_location, bool use_shader_directory)
 	{
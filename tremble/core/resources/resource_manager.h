@@ -64,6 +64,14 @@ namespace tremble
 		*/
 		bool IsTextureLoaded(const std::string& texture_location, bool use_texture_directory = true);
 
+		/**
+		* @brief Re-reads every loaded texture with the given file location (including the ones owned by models) in-place, so existing texture pointers stay valid
+		* @param[in] texture_location The full location of the texture file on disk, as passed to the hot reload manager
+		* @return The number of textures that were reloaded
+		* @pre The GPU is idle
+		*/
+		int ReloadTexture(const std::string& texture_location);
+
 	public:
 		//------------------------------------------------------------------------------------------------------
 		//-------------------------------------------- MODEL LOADING -------------------------------------------
@@ -108,6 +116,14 @@ namespace tremble
 		*/
 		bool IsModelLoaded(const std::string& model_location, bool use_model_directory = true);
 
+		/**
+		* @brief Re-imports a loaded model & swaps its contents in-place, so the model pointer held by renderables stays valid
+		* @param[in] model_location The full location of the model file on disk, as passed to the hot reload manager
+		* @return Whether the model was reloaded; a model that fails to import keeps its old contents
+		* @pre The GPU is idle
+		*/
+		bool ReloadModel(const std::string& model_location);
+
 	public:
 		//------------------------------------------------------------------------------------------------------
 		//-------------------------------------------- SHADER LOADING ------------------------------------------
@@ -152,6 +168,23 @@ namespace tremble
 		*/
 		bool IsShaderLoaded(const std::string& shader_location, bool use_shader_directory = true);
 
+		/**
+		* @brief Re-reads a loaded shader's byte code in-place & recreates every pipeline state that uses it
+		* @param[in] shader_location The full location of the compiled shader file on disk, as passed to the hot reload manager
+		* @return The number of pipeline states that were recreated, or -1 if the shader couldn't be reloaded
+		* @pre The GPU is idle
+		*/
+		int ReloadShader(const std::string& shader_location);
+
+	private:
+		/**
+		* @brief Reads a compiled shader from disk
+		* @param[in] location The location of the compiled shader file
+		* @param[out] out_byte_code The shader byte code
+		* @return Whether the file could be read
+		*/
+		bool ReadShaderByteCode(const std::string& location, std::vector<BYTE>& out_byte_code);
+
 	public:
 		//------------------------------------------------------------------------------------------------------
 		//-------------------------------------------- AUDIO CLIP LOADING --------------------------------------
@@ -169,7 +202,7 @@ namespace tremble
 		const std::string& GetAudioClipDirectory();
 
 		/**
-		* @brief Force (re-)loads a audio_clip into the resource manager.
+		* @brief Force (re-)loads a audio_clip into the resource manager. The clip loads in the background, it can be played right away & starts once it's ready.
 		* @param[in] audio_clip_location The location of the audio_clip file on disk
 		* @param[in] use_audio_clip_directory Whether the audio_clip directory should be prefixed to the audio_clip location
 		*/
@@ -8,6 +8,9 @@
 #include "core/physics/physics_sphere_geometry.h"
 #include "../../../game/components/line_rederer.h"
 #include "core/physics/physics_convex_mesh_geometry.h"
+#include "core/physics/physics_manager.h"
+#include "core/physics/collision_cache.h"
+#include "core/physics/static_geometry_merger.h"
 
 namespace tremble
 {
@@ -64,11 +67,30 @@ namespace tremble
 
         if(scene_data["SGNodes"].is_array())
         {
+            // cooking the whole scene's collision meshes at once spreads it over worker threads, attaching the rigidbodies then only looks them up
+            bool merge_static = Get::Config().merge_static_geometry;
+            std::vector<Mesh*> meshes;
+            std::vector<std::vector<physx::PxVec3>> convex_vertices;
+            CollectColliders(scene_data["SGNodes"], merge_static, meshes, convex_vertices);
+            Get::PhysicsManager()->GetCollisionCache()->Prepare(meshes, convex_vertices);
+
+            // the static brushes attached below are merged into a few large actors once the whole scene is loaded
+            StaticGeometryMerger* merger = Get::PhysicsManager()->GetStaticGeometryMerger();
+            if (merge_static)
+            {
+                merger->Begin();
+            }
+
             for(nlohmann::json::iterator it = scene_data["SGNodes"].begin(); it != scene_data["SGNodes"].end(); ++it)
             {
                 nlohmann::json node_data = *it;
                 AttachNewNodeFromJsonData(node_data, scene_root_node);
             }
+
+            if (merge_static)
+            {
+                merger->End();
+            }
         }
     }
 
@@ -210,19 +232,7 @@ namespace tremble
                 nlohmann::json convex_data = *it;
                 if(HasNode(convex_data, "Vertices") && convex_data["Vertices"].is_array())
                 {
-                    nlohmann::json vert_data = convex_data["Vertices"];
-                    std::vector<physx::PxVec3> verts(vert_data.size());
-                    int counter = 0;
-                    for (nlohmann::json::iterator vert_it = vert_data.begin(); vert_it != vert_data.end(); ++vert_it)
-                    {
-                        nlohmann::json vert = *vert_it;
-                        verts[counter] = physx::PxVec3(
-                            vert["X"].get<float>(),
-                            vert["Y"].get<float>(),
-                            vert["Z"].get<float>()
-                        );
-                        counter++;
-                    }
+                    std::vector<physx::PxVec3> verts = ExtractConvexVertices(convex_data["Vertices"]);
                     AttachRigidbodyToNode(is_static, &ConvexMeshGeometry(verts), sg_node);
                 }
             }
@@ -318,6 +328,64 @@ namespace tremble
         }
     }
 
+    //------------------------------------------------------------------------------------------------------
+    void SceneLoader::CollectColliders(const nlohmann::json& nodes, bool merge_static, std::vector<Mesh*>& meshes, std::vector<std::vector<physx::PxVec3>>& convex_vertices)
+    {
+        for (nlohmann::json::const_iterator it = nodes.begin(); it != nodes.end(); ++it)
+        {
+            const nlohmann::json& node_data = *it;
+
+            if (HasNode(node_data, "Children") && node_data["Children"].is_array())
+            {
+                CollectColliders(node_data["Children"], merge_static, meshes, convex_vertices);
+            }
+
+            if (!HasNode(node_data, "Model") || !node_data["Model"].is_string())
+                continue;
+
+            bool has_colliders = HasNode(node_data, "Colliders");
+            bool is_brush = node_data["NameID"].get<std::string>() == "Brush";
+
+            // the same model as AttachNewNodeFromJsonData loads, the resource manager hands out the same instance later on
+            bool is_merged = merge_static && node_data["IsStatic"].get<bool>();
+            if (!is_merged && (is_brush || (has_colliders && HasNode(node_data["Colliders"], "TriangleMesh"))))
+            {
+                Model* model = Get::ResourceManager()->GetModel(folder_name_ + node_data["Model"].get<std::string>(), false);
+                meshes.insert(meshes.end(), model->GetMeshes().begin(), model->GetMeshes().end());
+            }
+
+            if (has_colliders && HasNode(node_data["Colliders"], "Convex") && node_data["Colliders"]["Convex"].is_array())
+            {
+                const nlohmann::json& convex_colliders = node_data["Colliders"]["Convex"];
+                for (nlohmann::json::const_iterator convex_it = convex_colliders.begin(); convex_it != convex_colliders.end(); ++convex_it)
+                {
+                    if (HasNode(*convex_it, "Vertices") && (*convex_it)["Vertices"].is_array())
+                    {
+                        convex_vertices.push_back(ExtractConvexVertices((*convex_it)["Vertices"]));
+                    }
+                }
+            }
+        }
+    }
+
+    //------------------------------------------------------------------------------------------------------
+    std::vector<physx::PxVec3> SceneLoader::ExtractConvexVertices(const nlohmann::json& vert_data)
+    {
+        std::vector<physx::PxVec3> verts(vert_data.size());
+        int counter = 0;
+        for (nlohmann::json::const_iterator vert_it = vert_data.begin(); vert_it != vert_data.end(); ++vert_it)
+        {
+            const nlohmann::json& vert = *vert_it;
+            verts[counter] = physx::PxVec3(
+                vert["X"].get<float>(),
+                vert["Y"].get<float>(),
+                vert["Z"].get<float>()
+            );
+            counter++;
+        }
+        return verts;
+    }
+
     //------------------------------------------------------------------------------------------------------
     void SceneLoader::ExecuteTagCallbacks(SGNode* node, const nlohmann::json& node_data)
     {
@@ -3,6 +3,7 @@
 namespace tremble
 {
     class PhysicsGeometry;
+    class Mesh;
     class SGNode;
     class Vector3;
 
@@ -98,6 +99,21 @@ namespace tremble
         void AttachRigidbodyToNode(bool is_static, PhysicsGeometry* physics_geometry, SGNode* node);
         void AttachTriangleMeshCollider(bool is_static, SGNode* node);
 
+        /**
+         * @brief Collects the collision meshes of nodes & their children, so they can be cooked at once before any rigidbody is attached
+         * @param[in] nodes A nlohmann::json array of SGNode data
+         * @param[in] merge_static Whether static geometry gets merged, its meshes are then cooked as part of the merged chunks instead
+         * @param[out] meshes The meshes of the models that get a triangle mesh collider
+         * @param[out] convex_vertices The vertices of every convex collider
+         */
+        void CollectColliders(const nlohmann::json& nodes, bool merge_static, std::vector<Mesh*>& meshes, std::vector<std::vector<physx::PxVec3>>& convex_vertices);
+
+        /**
+         * @brief Extracts the vertices of a convex collider
+         * @param[in] vert_data A nlohmann::json array of vertices
+         */
+        std::vector<physx::PxVec3> ExtractConvexVertices(const nlohmann::json& vert_data);
+
         /**
         * @brief Loads tags and tagdata if there is any, and executes callbacks
         * @param[in] node The SGNode you want to pass back to the callback function
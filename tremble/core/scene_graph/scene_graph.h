@@ -164,6 +164,7 @@ namespace tremble
         void DoTriggerExitCallbacks(const Component& other_component);
 
         void AssociateWithPeer(PeerID associate_with) { associated_with_ = associate_with; };
+        PeerID GetAssociatedPeer() const { return associated_with_; } //!< Get the peer this node was associated with, an invalid id for nodes that aren't
 
 	protected:
         PeerID associated_with_ = -69;
@@ -0,0 +1,191 @@
+#include "file_watcher.h"
+
+namespace tremble
+{
+	//------------------------------------------------------------------------------------------------------
+	FileWatcher::FileWatcher() :
+		running_(false),
+		poll_interval_ms_(250)
+	{
+		stop_event_ = CreateEvent(nullptr, TRUE, FALSE, nullptr);
+	}
+
+	//------------------------------------------------------------------------------------------------------
+	FileWatcher::~FileWatcher()
+	{
+		Stop();
+
+		for (auto it = directories_.begin(); it != directories_.end(); it++)
+		{
+			if (it->second != INVALID_HANDLE_VALUE)
+			{
+				FindCloseChangeNotification(it->second);
+			}
+		}
+
+		CloseHandle(stop_event_);
+	}
+
+	//------------------------------------------------------------------------------------------------------
+	void FileWatcher::Start(unsigned int poll_interval_ms)
+	{
+		if (running_)
+		{
+			return;
+		}
+
+		poll_interval_ms_ = poll_interval_ms;
+		running_ = true;
+
+		ResetEvent(stop_event_);
+		thread_ = std::thread(&FileWatcher::Run, this);
+	}
+
+	//------------------------------------------------------------------------------------------------------
+	void FileWatcher::Stop()
+	{
+		if (!running_)
+		{
+			return;
+		}
+
+		running_ = false;
+		SetEvent(stop_event_);
+
+		if (thread_.joinable())
+		{
+			thread_.join();
+		}
+	}
+
+	//------------------------------------------------------------------------------------------------------
+	void FileWatcher::Watch(const std::string& file_path)
+	{
+		WatchedFile file;
+		file.write_time = 0;
+		file.size = 0;
+		file.pending = false;
+
+		// a file that doesn't exist yet is still watched, it gets reported once it's created
+		QueryFile(file_path, file.write_time, file.size);
+
+		std::lock_guard<std::mutex> lock(mutex_);
+
+		if (files_.find(file_path) != files_.end())
+		{
+			return;
+		}
+
+		files_[file_path] = file;
+
+		std::string directory = GetDirectory(file_path);
+		if (directories_.find(directory) == directories_.end())
+		{
+			// directories that don't support change notifications are left to the poll interval
+			directories_[directory] = FindFirstChangeNotificationA(directory.c_str(), FALSE, FILE_NOTIFY_CHANGE_LAST_WRITE | FILE_NOTIFY_CHANGE_FILE_NAME | FILE_NOTIFY_CHANGE_SIZE);
+		}
+	}
+
+	//------------------------------------------------------------------------------------------------------
+	void FileWatcher::GetChangedFiles(std::vector<std::string>& out_changed_files)
+	{
+		std::lock_guard<std::mutex> lock(mutex_);
+
+		out_changed_files.insert(out_changed_files.end(), changed_files_.begin(), changed_files_.end());
+		changed_files_.clear();
+	}
+
+	//------------------------------------------------------------------------------------------------------
+	void FileWatcher::Run()
+	{
+		std::vector<HANDLE> handles;
+
+		while (running_)
+		{
+			handles.clear();
+			handles.push_back(stop_event_);
+
+			{
+				std::lock_guard<std::mutex> lock(mutex_);
+				for (auto it = directories_.begin(); it != directories_.end() && handles.size() < MAXIMUM_WAIT_OBJECTS; it++)
+				{
+					if (it->second != INVALID_HANDLE_VALUE)
+					{
+						handles.push_back(it->second);
+					}
+				}
+			}
+
+			DWORD result = WaitForMultipleObjects(static_cast<DWORD>(handles.size()), handles.data(), FALSE, poll_interval_ms_);
+
+			if (!running_)
+			{
+				break;
+			}
+
+			if (result > WAIT_OBJECT_0 && result < WAIT_OBJECT_0 + handles.size())
+			{
+				// re-arm the notification before scanning, so changes made during the scan aren't missed
+				FindNextChangeNotification(handles[result - WAIT_OBJECT_0]);
+			}
+
+			Scan();
+		}
+	}
+
+	//------------------------------------------------------------------------------------------------------
+	void FileWatcher::Scan()
+	{
+		std::lock_guard<std::mutex> lock(mutex_);
+
+		for (auto it = files_.begin(); it != files_.end(); it++)
+		{
+			WatchedFile& file = it->second;
+
+			uint64_t write_time, size;
+			if (!QueryFile(it->first, write_time, size))
+			{
+				// most editors save by deleting & renaming, so a missing file is usually about to come back
+				continue;
+			}
+
+			if (write_time != file.write_time || size != file.size)
+			{
+				file.write_time = write_time;
+				file.size = size;
+				file.pending = true;
+			}
+			else if (file.pending)
+			{
+				file.pending = false;
+				changed_files_.push_back(it->first);
+			}
+		}
+	}
+
+	//------------------------------------------------------------------------------------------------------
+	bool FileWatcher::QueryFile(const std::string& file_path, uint64_t& out_write_time, uint64_t& out_size)
+	{
+		WIN32_FILE_ATTRIBUTE_DATA data;
+		if (!GetFileAttributesExA(file_path.c_str(), GetFileExInfoStandard, &data))
+		{
+			return false;
+		}
+
+		out_write_time = (static_cast<uint64_t>(data.ftLastWriteTime.dwHighDateTime) << 32) | data.ftLastWriteTime.dwLowDateTime;
+		out_size = (static_cast<uint64_t>(data.nFileSizeHigh) << 32) | data.nFileSizeLow;
+		return true;
+	}
+
+	//------------------------------------------------------------------------------------------------------
+	std::string FileWatcher::GetDirectory(const std::string& file_path)
+	{
+		size_t separator = file_path.find_last_of("/\\");
+		if (separator == std::string::npos)
+		{
+			return ".";
+		}
+
+		return file_path.substr(0, separator + 1);
+	}
+}
\ No newline at end of file
@@ -0,0 +1,87 @@
+#pragma once
+
+#include <thread>
+#include <mutex>
+#include <atomic>
+
+namespace tremble
+{
+	/**
+	* @class tremble::FileWatcher
+	* @brief Watches a set of files for modifications on a background thread
+	*
+	* The thread sleeps on directory change notifications of the watched files' directories and rescans the
+	* watched files when woken. It also rescans after every poll interval, which acts as the fallback for
+	* directories that can't be watched (e.g. network shares). A file is only reported once its write time &
+	* size have stayed the same for a full scan, so files that are still being written aren't picked up halfway.
+	*/
+	class FileWatcher
+	{
+	public:
+		FileWatcher(); //!< Default constructor
+		~FileWatcher(); //!< Default destructor, stops the watcher thread
+
+		/**
+		* @brief Starts the watcher thread
+		* @param[in] poll_interval_ms The maximum time between two scans, in milliseconds
+		*/
+		void Start(unsigned int poll_interval_ms);
+
+		void Stop(); //!< Stops the watcher thread & releases all change notifications
+
+		/**
+		* @brief Starts watching a file, files that are already watched are ignored
+		* @param[in] file_path The path to the file
+		*/
+		void Watch(const std::string& file_path);
+
+		/**
+		* @brief Moves all files that changed since the last call into the output
+		* @param[out] out_changed_files The paths of the changed files
+		*/
+		void GetChangedFiles(std::vector<std::string>& out_changed_files);
+
+		bool IsRunning() const { return running_; }
+
+	private:
+		/**
+		* @struct tremble::FileWatcher::WatchedFile
+		* @brief The last known state of a watched file
+		*/
+		struct WatchedFile
+		{
+			uint64_t write_time; //!< The last write time of the file
+			uint64_t size; //!< The size of the file in bytes
+			bool pending; //!< Whether the file changed, but hasn't been stable for a full scan yet
+		};
+
+		void Run(); //!< The watcher thread's main loop
+		void Scan(); //!< Checks all watched files for changes
+
+		/**
+		* @brief Queries a file's last write time & size
+		* @param[in] file_path The path to the file
+		* @param[out] out_write_time The last write time of the file
+		* @param[out] out_size The size of the file in bytes
+		* @return Whether the file exists & could be queried
+		*/
+		static bool QueryFile(const std::string& file_path, uint64_t& out_write_time, uint64_t& out_size);
+
+		/**
+		* @brief Gets the directory part of a file path
+		* @param[in] file_path The path to the file
+		*/
+		static std::string GetDirectory(const std::string& file_path);
+
+	private:
+		std::thread thread_; //!< The watcher thread
+		std::atomic<bool> running_; //!< Whether the watcher thread should keep running
+		unsigned int poll_interval_ms_; //!< The maximum time between two scans, in milliseconds
+		HANDLE stop_event_; //!< Signaled to wake the watcher thread up when stopping
+
+		std::mutex mutex_; //!< Guards all members below
+		std::unordered_map<std::string, WatchedFile> files_; //!< All watched files by their path
+		std::unordered_map<std::string, HANDLE> directories_; //!< Change notification handles by directory, INVALID_HANDLE_VALUE if the directory can only be polled
+		std::vector<std::string> changed_files_; //!< Files that changed since the last GetChangedFiles call
+	};
+}
\ No newline at end of file
@@ -15,8 +15,17 @@
 #include "core/rendering/debug_volume.h"
 #include "core/rendering/descriptor_heap.h"
 #include "core/rendering/dynamic_descriptor_heap.h"
-#include "core/rendering/dynamic_upload_buffer.h"
 #include "core/rendering/frame_resource.h"
+#include "core/rendering/upload_manager.h"
+#include "core/rendering/light_grid.h"
+#include "core/rendering/parallel_recorder.h"
+#include "core/rendering/draw_planner.h"
+#include "core/rendering/particle_pool.h"
+#include "core/rendering/frame_packet.h"
+#include "core/rendering/render_backend.h"
+#include "core/rendering/render_thread.h"
+#include "core/rendering/null_render_backend.h"
+#include "core/rendering/frame_extractor.h"
 #include "core/rendering/material.h"
 #include "core/rendering/pipeline_state.h"
 #include "core/rendering/root_signature.h"
@@ -61,6 +70,12 @@
 #include "components/rendering/particle_system.h"
 
 #include "core/physics/physics_manager.h"
+#include "core/physics/physics_layers.h"
+#include "core/physics/physics_stats.h"
+#include "core/physics/scene_query_batch.h"
+#include "core/physics/lag_compensation.h"
+#include "core/physics/collision_cache.h"
+#include "core/physics/static_geometry_merger.h"
 #include "core/physics/physics_material.h"
 #include "core/physics/physics_geometry.h"
 #include "core/physics/physics_box_geometry.h"
@@ -75,6 +90,8 @@
 
 #include "components/audio/audio_source.h"
 #include "core/audio/audio_clip.h"
+#include "core/audio/voice_manager.h"
+#include "core/audio/audio_clip_cache.h"
 #include "components/audio/audio_listener.h"
 
 #include "core/resources/model_loader.h"
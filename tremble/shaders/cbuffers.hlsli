@@ -49,6 +49,21 @@ struct Light
 StructuredBuffer<Light> lights : register(t8);
 StructuredBuffer<float4x4> bones : register(t11);
 
+// clustered lighting, see tremble::LightGrid
+cbuffer cbClusterInfo : register(b4)
+{
+    uint cluster_tiles_x;
+    uint cluster_tiles_y;
+    uint cluster_slices;
+    uint num_global_lights; // directional lights, stored in front of the clustered lights & applied everywhere
+    float2 cluster_tiles_per_pixel;
+    float cluster_depth_scale;
+    float cluster_depth_bias;
+}
+
+StructuredBuffer<uint2> cluster_ranges : register(t13); // offset & count in cluster_light_indices per cluster
+StructuredBuffer<uint> cluster_light_indices : register(t14); // relative to the first clustered light
+
 struct Material
 {
     float4 GlobalAmbient; //-- 16 bytes
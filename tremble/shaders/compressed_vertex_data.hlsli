@@ -0,0 +1,27 @@
+#ifndef COMPRESSEDVERTEXDATAHLSL
+#define COMPRESSEDVERTEXDATAHLSL
+
+// Matches input_element_compressed_vertex_desc, position comes from its own stream
+struct CompressedVertexIn
+{
+	float3 PosL : POSITION;
+	float2 Normal : NORMAL;
+	float2 Tangent : TANGENT;
+	float2 Bitangent : BITANGENT;
+	float2 UV : UV;
+	float4 Color : COLOR;
+	uint BoneID : BONE_IDS;
+	float4 BoneWeights : BONE_WEIGHTS;
+};
+
+// Decodes an octahedral encoded unit vector (see VertexCompression::EncodeOctahedral)
+float3 DecodeOctahedral(float2 e)
+{
+	float3 v = float3(e.x, e.y, 1.0f - abs(e.x) - abs(e.y));
+	float t = saturate(-v.z);
+	v.x += v.x >= 0.0f ? -t : t;
+	v.y += v.y >= 0.0f ? -t : t;
+	return normalize(v);
+}
+
+#endif
\ No newline at end of file
@@ -66,7 +66,8 @@ float4 main(VertexOut pin) : SV_TARGET
 		to_eye,
 		mat,
 		float3(0.2, 0.2, 0.2),
-        lights
+        pin.PosH.xy,
+        mul(pin.PosW, view).z
 	), 1.0f);
     
     return color;
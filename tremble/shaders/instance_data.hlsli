@@ -0,0 +1,14 @@
+#ifndef INSTANCEDATAHLSL
+#define INSTANCEDATAHLSL
+
+// per-instance object constants, laid out exactly like cbPerObject
+struct InstanceData
+{
+    float4x4 World;
+    float4x4 WorldView;
+    float4x4 WorldViewProj;
+};
+
+StructuredBuffer<InstanceData> instances : register(t12);
+
+#endif
\ No newline at end of file
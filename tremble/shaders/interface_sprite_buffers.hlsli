@@ -7,7 +7,7 @@ cbuffer ViewData : register(b0)
 	float4x4 ViewMatrix;
 };
 
-cbuffer SpriteData : register(b1)
+struct SpriteData
 {
 	float4x4 TransformMatrix;
     float4 Color;
@@ -19,16 +19,19 @@ struct PSin
 {
 	float4 position : SV_POSITION;
 	float2 uv : TEXCOORD;
+    float4 color : COLOR;
 };
 
 struct VSin
 {
 	float4 position : POSITION;
 	float2 uv : TEXCOORD;
+    uint instance : SV_InstanceID;
 };
 
 SamplerState SpriteSampler : register(s0);
 
-Texture2D SpriteTexture : register(t0);
+StructuredBuffer<SpriteData> sprites : register(t0);
+Texture2D SpriteTexture : register(t1);
 
 #endif
\ No newline at end of file
@@ -2,6 +2,5 @@
 
 float4 main(PSin input) : SV_TARGET
 {
-    float2 uv = uvMin + (input.uv * (uvMax - uvMin));
-	return SpriteTexture.Sample(SpriteSampler, uv) * Color;
+	return SpriteTexture.Sample(SpriteSampler, input.uv) * input.color;
 }
\ No newline at end of file
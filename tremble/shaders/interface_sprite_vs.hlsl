@@ -2,8 +2,11 @@
 
 PSin main(VSin input)
 {
+    SpriteData sprite = sprites[input.instance];
+
 	PSin output;
-    output.position = mul(input.position, mul(TransformMatrix, mul(ProjectionMatrix, ViewMatrix)));
-	output.uv = input.uv;
+    output.position = mul(input.position, mul(sprite.TransformMatrix, mul(ProjectionMatrix, ViewMatrix)));
+	output.uv = sprite.uvMin + (input.uv * (sprite.uvMax - sprite.uvMin));
+    output.color = sprite.Color;
 	return output;
 }
\ No newline at end of file
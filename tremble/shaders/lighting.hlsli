@@ -6,7 +6,6 @@
 #ifndef LIGHTINGHLSL
 #define LIGHTINGHLSL
 
-#define NUM_LIGHTS 64
 #define DIRECTIONAL_LIGHT 0
 #define POINT_LIGHT 1
 #define SPOT_LIGHT 2
@@ -110,6 +109,40 @@ float3 ComputeDualConeSpotLight(Light light, float3 ambient, MaterialData mat, f
 
 }
 
+float3 ComputeLight(Light light, float4 world_position, float3 position, float3 normal, float3 to_eye, MaterialData mat, float3 ambient)
+{
+    if (light.Type != DIRECTIONAL_LIGHT && length(light.PositionWS.xyz - position) > light.Range)
+    {
+        return float3(0.0f, 0.0f, 0.0f);
+    }
+
+    float shadow = 1.0f;
+    for (int s = 0; s < light.ShadowRange && s < 6; s++)
+    {
+        shadow = min(shadow, GetShadowAmountPerMap(world_position, light.ShadowIndex + s));
+    }
+
+    switch (light.Type)
+    {
+        case DIRECTIONAL_LIGHT:
+            return ComputeDirectionalLight(light, ambient, mat, normal, to_eye) * shadow;
+        case POINT_LIGHT:
+            return ComputePointLight(light, ambient, mat, position, normal, to_eye) * shadow;
+        case SPOT_LIGHT:
+            return ComputeSpotLight(light, ambient, mat, position, normal, to_eye) * shadow;
+    }
+
+    return float3(0.0f, 0.0f, 0.0f);
+}
+
+uint ComputeClusterIndex(float2 screen_position, float view_depth)
+{
+    uint2 tile = min(uint2(screen_position * cluster_tiles_per_pixel), uint2(cluster_tiles_x - 1, cluster_tiles_y - 1));
+    uint slice = uint(clamp(floor(log(max(view_depth, near_z)) * cluster_depth_scale - cluster_depth_bias), 0.0f, float(cluster_slices - 1)));
+
+    return (slice * cluster_tiles_y + tile.y) * cluster_tiles_x + tile.x;
+}
+
 float3 ComputeLighting(
 	float3 position,
     float4 world_position,
@@ -117,64 +150,24 @@ float3 ComputeLighting(
 	float3 to_eye,
 	MaterialData mat,
 	float3 ambient,
-	StructuredBuffer<Light> lights
+	float2 screen_position,
+	float view_depth
 )
 {
     float3 color = float3(0.0f, 0.0f, 0.0f);
 
-    float shadow;
+    for (uint i = 0; i < num_global_lights; i++)
+    {
+        color += ComputeLight(lights[i], world_position, position, normal, to_eye, mat, ambient);
+    }
+
+    // only the lights that were binned into this pixel's cluster
+    uint2 range = cluster_ranges[ComputeClusterIndex(screen_position, view_depth)];
 
-    for (int i = 0; i < NUM_LIGHTS; i++)
+    for (uint j = 0; j < range.y; j++)
     {
-        if (lights[i].Enabled)
-        {
-
-            if (lights[i].Type != DIRECTIONAL_LIGHT && length(lights[i].PositionWS.xyz - position) > lights[i].Range)
-            {
-            }
-            else
-            {
-                shadow = 1.0f;
-                if (lights[i].ShadowRange != 0)
-                {
-					shadow = min(shadow, GetShadowAmountPerMap(world_position, lights[i].ShadowIndex + 0));
-					if (lights[i].ShadowRange > 1)
-					{
-						shadow = min(shadow, GetShadowAmountPerMap(world_position, lights[i].ShadowIndex + 1));
-						if (lights[i].ShadowRange > 2)
-						{
-							shadow = min(shadow, GetShadowAmountPerMap(world_position, lights[i].ShadowIndex + 2));
-							if (lights[i].ShadowRange > 3)
-							{
-								shadow = min(shadow, GetShadowAmountPerMap(world_position, lights[i].ShadowIndex + 3));
-								if (lights[i].ShadowRange > 4)
-								{
-									shadow = min(shadow, GetShadowAmountPerMap(world_position, lights[i].ShadowIndex + 4));
-									if (lights[i].ShadowRange > 5)
-									{
-										shadow = min(shadow, GetShadowAmountPerMap(world_position, lights[i].ShadowIndex + 5));
-									}
-								}
-							}
-							
-						}
-					}
-				}
-
-                switch (lights[i].Type)
-                {
-                    case DIRECTIONAL_LIGHT:
-                        color += ComputeDirectionalLight(lights[i], ambient, mat, normal, to_eye) * shadow;
-                        break;
-                    case POINT_LIGHT:
-                        color += ComputePointLight(lights[i], ambient, mat, position, normal, to_eye) * shadow;
-                        break;
-                    case SPOT_LIGHT:
-                        color += ComputeSpotLight(lights[i], ambient, mat, position, normal, to_eye) * shadow;
-                        break;
-                }
-            }
-        }
+        uint light_index = num_global_lights + cluster_light_indices[range.x + j];
+        color += ComputeLight(lights[light_index], world_position, position, normal, to_eye, mat, ambient);
     }
 
 	return clamp(color, float3(0.0f, 0.0f, 0.0f), float3(1.0f, 1.0f, 1.0f));
@@ -0,0 +1,6 @@
+#include "instance_data.hlsli"
+
+float4 main(float3 input : POSITION, uint instance_id : SV_InstanceID) : SV_POSITION
+{
+    return mul(float4(input, 1), instances[instance_id].WorldViewProj);
+}
\ No newline at end of file